@@ -48,6 +48,8 @@ public:
     Return = 0x0F,
     Call = 0x10,
     Call_indirect = 0x11,
+    Return_call = 0x12,
+    Return_call_indirect = 0x13,
 
     /// Parametric Instructions
     Drop = 0x1A,
@@ -216,9 +218,29 @@ public:
     I32__reinterpret_f32 = 0xBC,
     I64__reinterpret_f64 = 0xBD,
     F32__reinterpret_i32 = 0xBE,
-    F64__reinterpret_i64 = 0xBF
+    F64__reinterpret_i64 = 0xBF,
+
+    /// Bulk memory instructions. In binary they are encoded as the 0xFC prefix
+    /// byte followed by an u32 sub-opcode. They are mapped into the unused
+    /// single byte range here to keep the OpCode in one byte.
+    Memory__init = 0xC8,
+    Data__drop = 0xC9,
+    Memory__copy = 0xCA,
+    Memory__fill = 0xCB,
+
+    /// SIMD instructions. The 0xFD prefix byte is kept as the OpCode, and the
+    /// u32 sub-opcode is decoded into the SIMDCode of the instruction node.
+    SIMD = 0xFD,
+
+    /// Atomic memory instructions. The 0xFE prefix byte is kept as the OpCode,
+    /// and the u32 sub-opcode is decoded into the AtomicCode of the
+    /// instruction node.
+    Atomic = 0xFE
   };
 
+  /// Prefix byte of the bulk memory instructions in binary.
+  static constexpr uint8_t PrefixFC = 0xFC;
+
   /// Constructor assigns the OpCode.
   Instruction(const OpCode &Byte) : Code(Byte) {}
   virtual ~Instruction() noexcept = default;
@@ -234,6 +256,266 @@ protected:
   const OpCode Code;
 };
 
+/// Sub-opcodes of the SIMD instructions after the 0xFD prefix.
+///
+/// This is a partial subset of the fixed-width SIMD proposal: the v128 full
+/// width loads, stores and constants, shuffles, splats, lane accesses,
+/// comparisons, bitwise operations, shifts, the plain integer and float
+/// arithmetic, and the i32x4/f32x4 conversions. The saturating arithmetic,
+/// narrowing and extending, q15mulr, popcnt, float rounding, the splatting,
+/// extending, zero-filling and lane loads and stores, and the f32x4/f64x2
+/// promotion and demotion are not supported yet.
+enum class SIMDCode : uint8_t {
+  V128__load = 0x00,
+  V128__store = 0x0B,
+  V128__const = 0x0C,
+  I8x16__shuffle = 0x0D,
+  I8x16__swizzle = 0x0E,
+  I8x16__splat = 0x0F,
+  I16x8__splat = 0x10,
+  I32x4__splat = 0x11,
+  I64x2__splat = 0x12,
+  F32x4__splat = 0x13,
+  F64x2__splat = 0x14,
+  I8x16__extract_lane_s = 0x15,
+  I8x16__extract_lane_u = 0x16,
+  I8x16__replace_lane = 0x17,
+  I16x8__extract_lane_s = 0x18,
+  I16x8__extract_lane_u = 0x19,
+  I16x8__replace_lane = 0x1A,
+  I32x4__extract_lane = 0x1B,
+  I32x4__replace_lane = 0x1C,
+  I64x2__extract_lane = 0x1D,
+  I64x2__replace_lane = 0x1E,
+  F32x4__extract_lane = 0x1F,
+  F32x4__replace_lane = 0x20,
+  F64x2__extract_lane = 0x21,
+  F64x2__replace_lane = 0x22,
+  I8x16__eq = 0x23,
+  I8x16__ne = 0x24,
+  I8x16__lt_s = 0x25,
+  I8x16__lt_u = 0x26,
+  I8x16__gt_s = 0x27,
+  I8x16__gt_u = 0x28,
+  I8x16__le_s = 0x29,
+  I8x16__le_u = 0x2A,
+  I8x16__ge_s = 0x2B,
+  I8x16__ge_u = 0x2C,
+  I16x8__eq = 0x2D,
+  I16x8__ne = 0x2E,
+  I16x8__lt_s = 0x2F,
+  I16x8__lt_u = 0x30,
+  I16x8__gt_s = 0x31,
+  I16x8__gt_u = 0x32,
+  I16x8__le_s = 0x33,
+  I16x8__le_u = 0x34,
+  I16x8__ge_s = 0x35,
+  I16x8__ge_u = 0x36,
+  I32x4__eq = 0x37,
+  I32x4__ne = 0x38,
+  I32x4__lt_s = 0x39,
+  I32x4__lt_u = 0x3A,
+  I32x4__gt_s = 0x3B,
+  I32x4__gt_u = 0x3C,
+  I32x4__le_s = 0x3D,
+  I32x4__le_u = 0x3E,
+  I32x4__ge_s = 0x3F,
+  I32x4__ge_u = 0x40,
+  F32x4__eq = 0x41,
+  F32x4__ne = 0x42,
+  F32x4__lt = 0x43,
+  F32x4__gt = 0x44,
+  F32x4__le = 0x45,
+  F32x4__ge = 0x46,
+  F64x2__eq = 0x47,
+  F64x2__ne = 0x48,
+  F64x2__lt = 0x49,
+  F64x2__gt = 0x4A,
+  F64x2__le = 0x4B,
+  F64x2__ge = 0x4C,
+  V128__not = 0x4D,
+  V128__and = 0x4E,
+  V128__andnot = 0x4F,
+  V128__or = 0x50,
+  V128__xor = 0x51,
+  V128__bitselect = 0x52,
+  V128__any_true = 0x53,
+  I8x16__abs = 0x60,
+  I8x16__neg = 0x61,
+  I8x16__all_true = 0x63,
+  I8x16__bitmask = 0x64,
+  I8x16__shl = 0x6B,
+  I8x16__shr_s = 0x6C,
+  I8x16__shr_u = 0x6D,
+  I8x16__add = 0x6E,
+  I8x16__sub = 0x71,
+  I8x16__min_s = 0x76,
+  I8x16__min_u = 0x77,
+  I8x16__max_s = 0x78,
+  I8x16__max_u = 0x79,
+  I8x16__avgr_u = 0x7B,
+  I16x8__abs = 0x80,
+  I16x8__neg = 0x81,
+  I16x8__all_true = 0x83,
+  I16x8__bitmask = 0x84,
+  I16x8__shl = 0x8B,
+  I16x8__shr_s = 0x8C,
+  I16x8__shr_u = 0x8D,
+  I16x8__add = 0x8E,
+  I16x8__sub = 0x91,
+  I16x8__mul = 0x95,
+  I16x8__min_s = 0x96,
+  I16x8__min_u = 0x97,
+  I16x8__max_s = 0x98,
+  I16x8__max_u = 0x99,
+  I16x8__avgr_u = 0x9B,
+  I32x4__abs = 0xA0,
+  I32x4__neg = 0xA1,
+  I32x4__all_true = 0xA3,
+  I32x4__bitmask = 0xA4,
+  I32x4__shl = 0xAB,
+  I32x4__shr_s = 0xAC,
+  I32x4__shr_u = 0xAD,
+  I32x4__add = 0xAE,
+  I32x4__sub = 0xB1,
+  I32x4__mul = 0xB5,
+  I32x4__min_s = 0xB6,
+  I32x4__min_u = 0xB7,
+  I32x4__max_s = 0xB8,
+  I32x4__max_u = 0xB9,
+  I32x4__dot_i16x8_s = 0xBA,
+  I64x2__abs = 0xC0,
+  I64x2__neg = 0xC1,
+  I64x2__all_true = 0xC3,
+  I64x2__bitmask = 0xC4,
+  I64x2__shl = 0xCB,
+  I64x2__shr_s = 0xCC,
+  I64x2__shr_u = 0xCD,
+  I64x2__add = 0xCE,
+  I64x2__sub = 0xD1,
+  I64x2__mul = 0xD5,
+  I64x2__eq = 0xD6,
+  I64x2__ne = 0xD7,
+  I64x2__lt_s = 0xD8,
+  I64x2__gt_s = 0xD9,
+  I64x2__le_s = 0xDA,
+  I64x2__ge_s = 0xDB,
+  F32x4__abs = 0xE0,
+  F32x4__neg = 0xE1,
+  F32x4__sqrt = 0xE3,
+  F32x4__add = 0xE4,
+  F32x4__sub = 0xE5,
+  F32x4__mul = 0xE6,
+  F32x4__div = 0xE7,
+  F32x4__min = 0xE8,
+  F32x4__max = 0xE9,
+  F32x4__pmin = 0xEA,
+  F32x4__pmax = 0xEB,
+  F64x2__abs = 0xEC,
+  F64x2__neg = 0xED,
+  F64x2__sqrt = 0xEF,
+  F64x2__add = 0xF0,
+  F64x2__sub = 0xF1,
+  F64x2__mul = 0xF2,
+  F64x2__div = 0xF3,
+  F64x2__min = 0xF4,
+  F64x2__max = 0xF5,
+  F64x2__pmin = 0xF6,
+  F64x2__pmax = 0xF7,
+  I32x4__trunc_sat_f32x4_s = 0xF8,
+  I32x4__trunc_sat_f32x4_u = 0xF9,
+  F32x4__convert_i32x4_s = 0xFA,
+  F32x4__convert_i32x4_u = 0xFB
+};
+
+/// Check the SIMD sub-opcode is in the supported subset.
+///
+/// The sub-opcodes of the SIMD proposal out of the subset described in
+/// SIMDCode are rejected in loading as the unknown ones.
+///
+/// \param Code the sub-opcode read after the 0xFD prefix.
+///
+/// \returns true if Code is one of the SIMDCode.
+bool isSIMDCode(const uint32_t Code);
+
+/// Sub-opcodes of the atomic memory instructions after the 0xFE prefix.
+enum class AtomicCode : uint8_t {
+  Memory__atomic__notify = 0x00,
+  Memory__atomic__wait32 = 0x01,
+  Memory__atomic__wait64 = 0x02,
+  Atomic__fence = 0x03,
+  I32__atomic__load = 0x10,
+  I64__atomic__load = 0x11,
+  I32__atomic__load8_u = 0x12,
+  I32__atomic__load16_u = 0x13,
+  I64__atomic__load8_u = 0x14,
+  I64__atomic__load16_u = 0x15,
+  I64__atomic__load32_u = 0x16,
+  I32__atomic__store = 0x17,
+  I64__atomic__store = 0x18,
+  I32__atomic__store8_u = 0x19,
+  I32__atomic__store16_u = 0x1A,
+  I64__atomic__store8_u = 0x1B,
+  I64__atomic__store16_u = 0x1C,
+  I64__atomic__store32_u = 0x1D,
+  I32__atomic__rmw__add = 0x1E,
+  I64__atomic__rmw__add = 0x1F,
+  I32__atomic__rmw8__add_u = 0x20,
+  I32__atomic__rmw16__add_u = 0x21,
+  I64__atomic__rmw8__add_u = 0x22,
+  I64__atomic__rmw16__add_u = 0x23,
+  I64__atomic__rmw32__add_u = 0x24,
+  I32__atomic__rmw__sub = 0x25,
+  I64__atomic__rmw__sub = 0x26,
+  I32__atomic__rmw8__sub_u = 0x27,
+  I32__atomic__rmw16__sub_u = 0x28,
+  I64__atomic__rmw8__sub_u = 0x29,
+  I64__atomic__rmw16__sub_u = 0x2A,
+  I64__atomic__rmw32__sub_u = 0x2B,
+  I32__atomic__rmw__and = 0x2C,
+  I64__atomic__rmw__and = 0x2D,
+  I32__atomic__rmw8__and_u = 0x2E,
+  I32__atomic__rmw16__and_u = 0x2F,
+  I64__atomic__rmw8__and_u = 0x30,
+  I64__atomic__rmw16__and_u = 0x31,
+  I64__atomic__rmw32__and_u = 0x32,
+  I32__atomic__rmw__or = 0x33,
+  I64__atomic__rmw__or = 0x34,
+  I32__atomic__rmw8__or_u = 0x35,
+  I32__atomic__rmw16__or_u = 0x36,
+  I64__atomic__rmw8__or_u = 0x37,
+  I64__atomic__rmw16__or_u = 0x38,
+  I64__atomic__rmw32__or_u = 0x39,
+  I32__atomic__rmw__xor = 0x3A,
+  I64__atomic__rmw__xor = 0x3B,
+  I32__atomic__rmw8__xor_u = 0x3C,
+  I32__atomic__rmw16__xor_u = 0x3D,
+  I64__atomic__rmw8__xor_u = 0x3E,
+  I64__atomic__rmw16__xor_u = 0x3F,
+  I64__atomic__rmw32__xor_u = 0x40,
+  I32__atomic__rmw__xchg = 0x41,
+  I64__atomic__rmw__xchg = 0x42,
+  I32__atomic__rmw8__xchg_u = 0x43,
+  I32__atomic__rmw16__xchg_u = 0x44,
+  I64__atomic__rmw8__xchg_u = 0x45,
+  I64__atomic__rmw16__xchg_u = 0x46,
+  I64__atomic__rmw32__xchg_u = 0x47,
+  I32__atomic__rmw__cmpxchg = 0x48,
+  I64__atomic__rmw__cmpxchg = 0x49,
+  I32__atomic__rmw8__cmpxchg_u = 0x4A,
+  I32__atomic__rmw16__cmpxchg_u = 0x4B,
+  I64__atomic__rmw8__cmpxchg_u = 0x4C,
+  I64__atomic__rmw16__cmpxchg_u = 0x4D,
+  I64__atomic__rmw32__cmpxchg_u = 0x4E
+};
+
+/// Check the atomic sub-opcode is supported.
+///
+/// \param Code the sub-opcode read after the 0xFE prefix.
+///
+/// \returns true if Code is one of the AtomicCode.
+bool isAtomicCode(const uint32_t Code);
+
 /// Derived control instruction node.
 class ControlInstruction : public Instruction {
 public:
@@ -312,6 +594,18 @@ private:
   /// @}
 };
 
+/// Value stack adjustment of a branch, which is resolved in validation.
+struct BranchTarget {
+  /// Count of values under the results to be erased from the stack.
+  uint32_t StackErase = 0;
+  /// Count of the result values of the target label.
+  uint32_t Arity = 0;
+};
+
+/// Branch targets of a function body in the order of the branches. The
+/// targets of `br_table` are followed by the one of the default label.
+using BranchTargetVec = std::vector<BranchTarget>;
+
 /// Derived branch control instruction node.
 class BrControlInstruction : public Instruction {
 public:
@@ -395,6 +689,18 @@ public:
   /// Getter of the index
   uint32_t getFuncIndex() const { return FuncIdx; }
 
+  /// Check the call is indirect.
+  bool isIndirect() const {
+    return Code == OpCode::Call_indirect ||
+           Code == OpCode::Return_call_indirect;
+  }
+
+  /// Check the call is a tail call which returns the callee's results.
+  bool isTailCall() const {
+    return Code == OpCode::Return_call ||
+           Code == OpCode::Return_call_indirect;
+  }
+
 private:
   /// Call function index.
   uint32_t FuncIdx = 0;
@@ -441,12 +747,14 @@ public:
   MemoryInstruction(const OpCode &Byte) : Instruction(Byte) {}
   /// Copy constructor.
   MemoryInstruction(const MemoryInstruction &Instr)
-      : Instruction(Instr.Code), Align(Instr.Align), Offset(Instr.Offset) {}
+      : Instruction(Instr.Code), Align(Instr.Align), Offset(Instr.Offset),
+        DataIdx(Instr.DataIdx) {}
 
   /// Load binary from file manager.
   ///
   /// Inheritted and overrided from Instruction.
-  /// Read the memory arguments: alignment and offset.
+  /// Read the memory arguments: alignment and offset, or the data index and
+  /// memory index of bulk memory instructions.
   ///
   /// \param Mgr the file manager reference.
   ///
@@ -457,11 +765,15 @@ public:
   uint32_t getMemoryAlign() const { return Align; }
   uint32_t getMemoryOffset() const { return Offset; }
 
+  /// Getter of data segment index of memory.init and data.drop.
+  uint32_t getDataIndex() const { return DataIdx; }
+
 private:
-  /// \name Data of memory instruction: Alignment and offset.
+  /// \name Data of memory instruction: Alignment, offset, and data index.
   /// @{
   uint32_t Align = 0;
   uint32_t Offset = 0;
+  uint32_t DataIdx = 0;
   /// @}
 };
 
@@ -512,6 +824,107 @@ public:
       : Instruction(Instr.Code) {}
 };
 
+/// Derived SIMD instruction node.
+class SIMDInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  SIMDInstruction(const OpCode &Byte) : Instruction(Byte) {}
+  /// Copy constructor.
+  SIMDInstruction(const SIMDInstruction &Instr)
+      : Instruction(Instr.Code), SubCode(Instr.SubCode), Align(Instr.Align),
+        Offset(Instr.Offset), Lane(Instr.Lane), Value(Instr.Value) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the sub-opcode and the immediates: memory arguments, lane index,
+  /// 128-bit constant, or the lane indices of shuffle.
+  ///
+  /// \param Mgr the file manager reference.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr) override;
+
+  /// Getter of sub-opcode.
+  SIMDCode getSIMDCode() const { return SubCode; }
+
+  /// Getters of memory align and offset.
+  uint32_t getMemoryAlign() const { return Align; }
+  uint32_t getMemoryOffset() const { return Offset; }
+
+  /// Getter of lane index.
+  uint8_t getLaneIndex() const { return Lane; }
+
+  /// Getter of the constant value or the shuffle lane indices.
+  uint128_t getValue() const { return Value; }
+
+  /// Getter of the count of operands popped from stack.
+  uint32_t getOperandNum() const;
+
+  /// Getter of whether a result is pushed. Only `v128.store` has no result.
+  bool hasResult() const { return SubCode != SIMDCode::V128__store; }
+
+private:
+  /// \name Data of SIMD instruction.
+  /// @{
+  SIMDCode SubCode = SIMDCode::V128__load;
+  uint32_t Align = 0;
+  uint32_t Offset = 0;
+  uint8_t Lane = 0;
+  uint128_t Value = 0;
+  /// @}
+};
+
+/// Derived atomic memory instruction node.
+class AtomicMemoryInstruction : public Instruction {
+public:
+  /// Call base constructor to initialize OpCode.
+  AtomicMemoryInstruction(const OpCode &Byte) : Instruction(Byte) {}
+  /// Copy constructor.
+  AtomicMemoryInstruction(const AtomicMemoryInstruction &Instr)
+      : Instruction(Instr.Code), SubCode(Instr.SubCode), Align(Instr.Align),
+        Offset(Instr.Offset) {}
+
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Instruction.
+  /// Read the sub-opcode and the memory arguments, or the reserved byte of
+  /// `atomic.fence`.
+  ///
+  /// \param Mgr the file manager reference.
+  ///
+  /// \returns void when success, ErrMsg when failed.
+  Expect<void> loadBinary(FileMgr &Mgr) override;
+
+  /// Getter of sub-opcode.
+  AtomicCode getAtomicCode() const { return SubCode; }
+
+  /// Getters of memory align and offset.
+  uint32_t getMemoryAlign() const { return Align; }
+  uint32_t getMemoryOffset() const { return Offset; }
+
+  /// Getter of the accessed bytes in memory. 0 for `atomic.fence`.
+  uint32_t getAccessSize() const;
+
+  /// Getter of whether the value operand and the result are i64.
+  bool isI64() const;
+
+  /// Getter of the count of operands popped from stack.
+  uint32_t getOperandNum() const;
+
+  /// Getter of whether a result is pushed. The stores and `atomic.fence`
+  /// have no result.
+  bool hasResult() const;
+
+private:
+  /// \name Data of atomic memory instruction.
+  /// @{
+  AtomicCode SubCode = AtomicCode::Memory__atomic__notify;
+  uint32_t Align = 0;
+  uint32_t Offset = 0;
+  /// @}
+};
+
 template <typename T>
 auto dispatchInstruction(Instruction::OpCode Code, T &&Visitor) {
   switch (Code) {
@@ -537,6 +950,8 @@ auto dispatchInstruction(Instruction::OpCode Code, T &&Visitor) {
 
   case Instruction::OpCode::Call:
   case Instruction::OpCode::Call_indirect:
+  case Instruction::OpCode::Return_call:
+  case Instruction::OpCode::Return_call_indirect:
     return Visitor(Support::tag<CallControlInstruction>());
 
   case Instruction::OpCode::Drop:
@@ -575,6 +990,10 @@ auto dispatchInstruction(Instruction::OpCode Code, T &&Visitor) {
   case Instruction::OpCode::I64__store32:
   case Instruction::OpCode::Memory__size:
   case Instruction::OpCode::Memory__grow:
+  case Instruction::OpCode::Memory__init:
+  case Instruction::OpCode::Data__drop:
+  case Instruction::OpCode::Memory__copy:
+  case Instruction::OpCode::Memory__fill:
     return Visitor(Support::tag<MemoryInstruction>());
 
   case Instruction::OpCode::I32__const:
@@ -711,6 +1130,12 @@ auto dispatchInstruction(Instruction::OpCode Code, T &&Visitor) {
   case Instruction::OpCode::F64__copysign:
     return Visitor(Support::tag<BinaryNumericInstruction>());
 
+  case Instruction::OpCode::SIMD:
+    return Visitor(Support::tag<SIMDInstruction>());
+
+  case Instruction::OpCode::Atomic:
+    return Visitor(Support::tag<AtomicMemoryInstruction>());
+
   default:
     return Visitor(Support::tag<void>());
   }
@@ -738,5 +1163,14 @@ makeInstructionNode(const Instruction::OpCode &Code);
 Expect<std::unique_ptr<Instruction>>
 makeInstructionNode(const Instruction &Instr);
 
+/// Read the OpCode of the next instruction.
+///
+/// Read one byte and decode the prefixed instructions into the OpCode.
+///
+/// \param Mgr the file manager reference.
+///
+/// \returns OpCode if success, ErrMsg when failed.
+Expect<Instruction::OpCode> loadOpCode(FileMgr &Mgr);
+
 } // namespace AST
 } // namespace SSVM
@@ -48,6 +48,7 @@ public:
   ElementSection *getElementSection() const { return ElementSec.get(); }
   CodeSection *getCodeSection() const { return CodeSec.get(); }
   DataSection *getDataSection() const { return DataSec.get(); }
+  DataCountSection *getDataCountSection() const { return DataCountSec.get(); }
 
 protected:
   /// The node type should be Attr::Module.
@@ -74,6 +75,7 @@ private:
   std::unique_ptr<ElementSection> ElementSec;
   std::unique_ptr<CodeSection> CodeSec;
   std::unique_ptr<DataSection> DataSec;
+  std::unique_ptr<DataCountSection> DataCountSec;
   /// @}
 };
 
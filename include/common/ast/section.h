@@ -313,5 +313,23 @@ private:
   std::vector<std::unique_ptr<DataSegment>> Content;
 };
 
+/// AST DataCountSection node.
+class DataCountSection : public Section {
+public:
+  /// Getter of content.
+  uint32_t getContent() const { return Content; }
+
+protected:
+  /// Overrided content loading of data count section.
+  virtual Expect<void> loadContent(FileMgr &Mgr);
+
+  /// The node type should be Attr::Sec_DataCount.
+  Attr NodeAttr = Attr::Sec_DataCount;
+
+private:
+  /// Count of data segments.
+  uint32_t Content = 0;
+};
+
 } // namespace AST
 } // namespace SSVM
@@ -141,7 +141,8 @@ public:
   /// Load binary from file manager.
   ///
   /// Inheritted and overrided from Base.
-  /// Read the memory index, offset expression, and initialization data.
+  /// Read the segment flag, memory index, offset expression, and
+  /// initialization data. Passive segments have no memory index and offset.
   ///
   /// \param Mgr the file manager reference.
   ///
@@ -151,6 +152,9 @@ public:
   /// Getter of memory index.
   uint32_t getIdx() const { return MemoryIdx; }
 
+  /// Getter of passive flag. Passive segments are only used by memory.init.
+  bool isPassive() const { return IsPassive; }
+
   /// Getter of data.
   const Bytes &getData() const { return Data; }
 
@@ -162,6 +166,7 @@ private:
   /// \name Data of DataSegment node.
   /// @{
   uint32_t MemoryIdx = 0;
+  bool IsPassive = false;
   Bytes Data;
   /// @}
 };
@@ -24,12 +24,18 @@ namespace AST {
 class Limit : public Base {
 public:
   /// Limit type enumeration class.
-  enum class LimitType : uint8_t { HasMin = 0x00, HasMinMax = 0x01 };
+  /// The shared limit is only for memories and must have the max.
+  enum class LimitType : uint8_t {
+    HasMin = 0x00,
+    HasMinMax = 0x01,
+    SharedHasMinMax = 0x03
+  };
 
   Limit() {}
   Limit(const uint32_t MinVal) : Type(LimitType::HasMin), Min(MinVal) {}
-  Limit(const uint32_t MinVal, const uint32_t MaxVal)
-      : Type(LimitType::HasMinMax), Min(MinVal), Max(MaxVal) {}
+  Limit(const uint32_t MinVal, const uint32_t MaxVal, const bool Shared = false)
+      : Type(Shared ? LimitType::SharedHasMinMax : LimitType::HasMinMax),
+        Min(MinVal), Max(MaxVal) {}
 
   /// Load binary from file manager.
   ///
@@ -43,7 +49,10 @@ public:
   Expect<void> loadBinary(FileMgr &Mgr) override;
 
   /// Getter of having max in limit.
-  bool hasMax() const { return Type == LimitType::HasMinMax; }
+  bool hasMax() const { return Type != LimitType::HasMin; }
+
+  /// Getter of shared flag in limit.
+  bool isShared() const { return Type == LimitType::SharedHasMinMax; }
 
   /// Getter of min.
   uint32_t getMin() const { return Min; }
@@ -53,7 +53,10 @@ enum class ErrCode : unsigned char {
   CallFunctionError,       /// Arguement not match function type.
   CostLimitExceeded,       /// Exceeded cost limit (out of gas).
   Revert,                  /// Revert by evm.
-  ModuleNameConflict       /// Module name conflicted when importing.
+  ModuleNameConflict,      /// Module name conflicted when importing.
+  StackOverflow,           /// Exceeded the capacity of value stack.
+  UnalignedAtomicAccess,   /// Unaligned address of atomic memory access.
+  ExpectSharedMemory       /// Waiting on the memory not shared.
 };
 
 /// Type aliasing for Expected<T, ErrMsg>.
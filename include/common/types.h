@@ -15,13 +15,17 @@
 
 namespace SSVM {
 
+/// 128-bit unsigned integer for the v128 values.
+__extension__ typedef unsigned __int128 uint128_t;
+
 /// Value types enumeration class.
 enum class ValType : uint8_t {
   None = 0x40,
   I32 = 0x7F,
   I64 = 0x7E,
   F32 = 0x7D,
-  F64 = 0x7C
+  F64 = 0x7C,
+  V128 = 0x7B
 };
 
 /// Element types enumeration class.
@@ -34,6 +34,9 @@ public:
   /// Set the function type in module instance.
   ErrCode setFuncType(const ModuleInstance::FType *Type);
 
+  /// Set the store-wide function type ID.
+  ErrCode setTypeID(unsigned int ID);
+
   /// Set the host function class.
   ErrCode setHostFuncAddr(unsigned int Addr);
 
@@ -46,6 +49,9 @@ public:
   /// Getter of function type.
   const ModuleInstance::FType *getFuncType() const { return FuncType; }
 
+  /// Getter of store-wide function type ID.
+  unsigned int getTypeID() const { return TypeID; }
+
   /// Getter of module address of this function instance.
   unsigned int getModuleAddr() const { return ModuleAddr; }
 
@@ -65,6 +71,7 @@ public:
 
 private:
   bool IsHostFunction;
+  unsigned int TypeID = 0;
 
   /// \name Data of function instance for native function.
   /// @{
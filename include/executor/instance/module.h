@@ -31,11 +31,14 @@ public:
   struct FType {
     std::vector<ValType> Params;
     std::vector<ValType> Returns;
+    /// Store-wide ID of this function type.
+    unsigned int TypeID = 0;
   };
 
   /// Copy the function types in type section to module instance.
   ErrCode addFuncType(const std::vector<ValType> &Params,
-                      const std::vector<ValType> &Returns);
+                      const std::vector<ValType> &Returns,
+                      unsigned int TypeID);
 
   /// Map the external instences between Module and Store.
   ErrCode addFuncAddr(unsigned int StoreFuncAddr);
@@ -14,14 +14,24 @@
 #include "common/types.h"
 #include "executor/common.h"
 #include "executor/instance/entity.h"
+#include <cstdint>
 #include <vector>
 
 namespace SSVM {
 namespace Executor {
 namespace Instance {
 
+class FunctionInstance;
+
 class TableInstance : public Entity {
 public:
+  /// Table entry of function reference. The uninitialized entry has the
+  /// invalid type ID and matches no function type.
+  struct FuncElem {
+    unsigned int TypeID = UINT32_MAX;
+    FunctionInstance *Func = nullptr;
+  };
+
   TableInstance() = default;
 
   /// Set the element type.
@@ -31,10 +41,10 @@ public:
   ErrCode setLimit(unsigned int Min, bool HasMax, unsigned int Max);
 
   /// Set the initialization list.
-  ErrCode setInitList(unsigned int Offset, std::vector<unsigned int> &Addrs);
+  ErrCode setInitList(unsigned int Offset, std::vector<FuncElem> &Elems);
 
-  /// Get the elem address.
-  ErrCode getElemAddr(unsigned int Idx, unsigned int &Addr);
+  /// Get the function reference entry.
+  ErrCode getElem(unsigned int Idx, FuncElem *&Elem);
 
 private:
   /// \name Data of table instance.
@@ -43,7 +53,7 @@ private:
   bool HasMaxSize = false;
   unsigned int MinSize = 0;
   unsigned int MaxSize = 0;
-  std::vector<unsigned int> FuncElem;
+  std::vector<FuncElem> FuncElems;
   /// @}
 };
 
@@ -18,8 +18,10 @@
 #include "instance/module.h"
 #include "instance/table.h"
 
+#include <map>
 #include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace SSVM {
@@ -81,6 +83,8 @@ public:
   inline ErrCode
   insertFunctionInst(std::unique_ptr<Instance::FunctionInstance> &Func,
                      unsigned int &NewId) {
+    Func->setTypeID(getTypeID(Func->getFuncType()->Params,
+                              Func->getFuncType()->Returns));
     return insertInstance(Func, FuncInsts, NewId);
   }
 
@@ -137,6 +141,23 @@ public:
   /// Getter counts of global instances.
   inline unsigned int getGlobalInstsCnt() { return GlobInsts.size(); }
 
+  /// Get function type ID.
+  ///
+  /// Intern the function type into the store-wide ID. Identical signatures
+  /// share the same ID, so the type checking of indirect calls is an integer
+  /// compare.
+  ///
+  /// \param Params the parameter types of function type.
+  /// \param Returns the return types of function type.
+  ///
+  /// \returns the function type ID.
+  inline unsigned int getTypeID(const std::vector<ValType> &Params,
+                                const std::vector<ValType> &Returns) {
+    return TypeIDs
+        .try_emplace(std::make_pair(Params, Returns), TypeIDs.size())
+        .first->second;
+  }
+
   /// Get instance from store manager.
   ///
   /// Get the module instance by supplying module address.
@@ -269,6 +290,7 @@ public:
     TabInsts.clear();
     MemInsts.clear();
     GlobInsts.clear();
+    TypeIDs.clear();
     return ErrCode::Success;
   }
 
@@ -300,6 +322,11 @@ private:
   std::vector<std::unique_ptr<Instance::MemoryInstance>> MemInsts;
   std::vector<std::unique_ptr<Instance::GlobalInstance>> GlobInsts;
   /// @}
+
+  /// Interned function types.
+  std::map<std::pair<std::vector<ValType>, std::vector<ValType>>,
+           unsigned int>
+      TypeIDs;
 };
 
 } // namespace Executor
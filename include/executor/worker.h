@@ -126,6 +126,8 @@ private:
   ErrCode execute(AST::ConstInstruction &);
   ErrCode execute(AST::UnaryNumericInstruction &);
   ErrCode execute(AST::BinaryNumericInstruction &);
+  ErrCode execute(AST::SIMDInstruction &);
+  ErrCode execute(AST::AtomicMemoryInstruction &);
 
 private:
   /// Execute Wasm bytecode with given input data.
@@ -155,6 +157,7 @@ private:
   ///
   /// \returns None.
   ErrCode invokeFunction(unsigned int FuncAddr);
+  ErrCode invokeFunction(Instance::FunctionInstance *FuncInst);
 
   /// Helper function for return from functions.
   ErrCode returnFunction();
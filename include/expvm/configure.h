@@ -23,6 +23,22 @@ public:
   /// VM type enum class.
   enum class VMType : uint8_t { Wasm = 0, Ewasm, Wasi, ONNC };
 
+  /// Interpreter tier enum class. The register tier runs the functions in
+  /// register-based byte code. The cached stack tier runs the stack-based byte
+  /// code with the top value of stack cached in a local variable. The tiered
+  /// one starts in the stack-based byte code, and promotes the hot functions
+  /// to the register-based byte code.
+  enum class InterpreterTier : uint8_t {
+    Stack = 0,
+    Register,
+    CachedStack,
+    Tiered
+  };
+
+  /// Measurement mode enum class. The metered mode counts instructions,
+  /// charges gas, and records time. The count mode counts instructions only.
+  enum class MeasureMode : uint8_t { None = 0, Count, Metered };
+
   Configure() { Types.insert(VMType::Wasm); }
   ~Configure() = default;
 
@@ -34,8 +50,24 @@ public:
     return ((Types.find(Type) != Types.end()) ? true : false);
   }
 
+  void setInterpreterTier(const InterpreterTier T) { Tier = T; }
+
+  InterpreterTier getInterpreterTier() const { return Tier; }
+
+  /// Setter and getter of the value stack capacity in values.
+  void setStackCapacity(const uint32_t Capacity) { StackCapacity = Capacity; }
+
+  uint32_t getStackCapacity() const { return StackCapacity; }
+
+  void setMeasureMode(const MeasureMode M) { Mode = M; }
+
+  MeasureMode getMeasureMode() const { return Mode; }
+
 private:
   std::unordered_set<VMType> Types;
+  InterpreterTier Tier = InterpreterTier::Stack;
+  uint32_t StackCapacity = 1U << 20;
+  MeasureMode Mode = MeasureMode::Metered;
 };
 
 } // namespace ExpVM
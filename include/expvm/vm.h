@@ -23,9 +23,11 @@
 #include "support/measure.h"
 #include "validator/validator.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace SSVM {
@@ -75,6 +77,37 @@ public:
   execute(const std::string &Mod, const std::string &Func,
           const std::vector<ValVariant> &Params = {});
 
+  /// Execute wasm function in threads, one for each of the given inputs.
+  ///
+  /// The threads share the instantiated store and communicate through the
+  /// shared memory. Each thread runs in its own interpreter with its own
+  /// stack and measurement in the configured mode, and the instruction
+  /// counts and costs are added to the measurement of VM. The cost limit
+  /// applies to the threads in total.
+  ///
+  /// \returns the results of each thread in the order of inputs, or the
+  /// first error of threads.
+  Expect<std::vector<std::vector<ValVariant>>>
+  executeParallel(const std::string &Func,
+                  const std::vector<std::vector<ValVariant>> &ParamsList);
+
+  /// Clone the instantiated store for executing in isolated copy-on-write
+  /// memories.
+  ///
+  /// The images of memories are taken at the first clone, and are taken again
+  /// after the store of VM executed or instantiated. The changes through the
+  /// store getter are not tracked. The store of VM should not be cleaned up
+  /// while the clones are alive, because they share the function instances.
+  /// Executing a clone after that fails with `ErrCode::WrongVMWorkflow`.
+  ///
+  /// \returns the cloned store, or ErrCode when failed.
+  Expect<std::unique_ptr<Runtime::StoreManager>> cloneStore();
+
+  /// Execute wasm with given input in the store cloned by `cloneStore()`.
+  Expect<std::vector<ValVariant>>
+  execute(Runtime::StoreManager &Clone, const std::string &Func,
+          const std::vector<ValVariant> &Params = {});
+
   /// ======= Functions which are stageless. =======
   /// Clean up VM status
   void cleanup();
@@ -102,6 +135,10 @@ private:
   enum class VMStage : uint8_t { Inited, Loaded, Validated, Instantiated };
 
   void initVM();
+  void setEngineModes(Interpreter::Interpreter &Engine);
+  Expect<std::vector<ValVariant>>
+  invoke(Runtime::StoreManager &S, const uint32_t FuncAddr,
+         const std::vector<ValVariant> &Params);
   Expect<void> registerModule(const std::string &Name,
                               const AST::Module &Module);
   Expect<std::vector<ValVariant>>
@@ -112,6 +149,8 @@ private:
   Configure &Config;
   Support::Measurement Measure;
   VMStage Stage;
+  /// The store changed after the last images of memories.
+  bool ImageStale = true;
 
   /// VM runners.
   Loader::Loader LoaderEngine;
@@ -121,6 +160,8 @@ private:
 
   /// VM Storage.
   std::unique_ptr<AST::Module> Mod;
+  /// Branch targets of the function bodies of the validated module.
+  std::vector<AST::BranchTargetVec> BranchTargets;
   std::unique_ptr<Runtime::StoreManager> Store;
   Runtime::StoreManager &StoreRef;
   std::map<Configure::VMType, std::unique_ptr<Runtime::ImportObject>> ImpObjs;
@@ -12,7 +12,6 @@ TypeB<T> Interpreter::runAddOp(ValVariant &Val1, const ValVariant &Val2) const {
   /// Integer case: Return the result of (v1 + v2) modulo 2^N.
   /// Floating case: NaN, inf, and zeros are handled.
   retrieveValue<T>(Val1) += retrieveValue<T>(Val2);
-  return {};
 }
 
 template <typename T>
@@ -20,7 +19,6 @@ TypeB<T> Interpreter::runSubOp(ValVariant &Val1, const ValVariant &Val2) const {
   /// Integer case: Return the result of (v1 - v2) modulo 2^N.
   /// Floating case: NaN, inf, and zeros are handled.
   retrieveValue<T>(Val1) -= retrieveValue<T>(Val2);
-  return {};
 }
 
 template <typename T>
@@ -28,11 +26,11 @@ TypeB<T> Interpreter::runMulOp(ValVariant &Val1, const ValVariant &Val2) const {
   /// Integer case: Return the result of (v1 * v2) modulo 2^N.
   /// Floating case: NaN, inf, and zeros are handled.
   retrieveValue<T>(Val1) *= retrieveValue<T>(Val2);
-  return {};
 }
 
 template <typename T>
-TypeT<T> Interpreter::runDivOp(ValVariant &Val1, const ValVariant &Val2) const {
+TypeT<T, Expect<void>> Interpreter::runDivOp(ValVariant &Val1,
+                                              const ValVariant &Val2) const {
   T &V1 = retrieveValue<T>(Val1);
   const T &V2 = retrieveValue<T>(Val2);
   if (!std::is_floating_point_v<T>) {
@@ -55,7 +53,8 @@ TypeT<T> Interpreter::runDivOp(ValVariant &Val1, const ValVariant &Val2) const {
 }
 
 template <typename T>
-TypeI<T> Interpreter::runRemOp(ValVariant &Val1, const ValVariant &Val2) const {
+TypeI<T, Expect<void>> Interpreter::runRemOp(ValVariant &Val1,
+                                              const ValVariant &Val2) const {
   T &I1 = retrieveValue<T>(Val1);
   const T &I2 = retrieveValue<T>(Val2);
   /// If i2 is 0, then the result is undefined.
@@ -76,28 +75,24 @@ template <typename T>
 TypeU<T> Interpreter::runAndOp(ValVariant &Val1, const ValVariant &Val2) const {
   /// Return the bitwise conjunction of i1 and i2.
   retrieveValue<T>(Val1) &= retrieveValue<T>(Val2);
-  return {};
 }
 
 template <typename T>
 TypeU<T> Interpreter::runOrOp(ValVariant &Val1, const ValVariant &Val2) const {
   /// Return the bitwise disjunction of i1 and i2.
   retrieveValue<T>(Val1) |= retrieveValue<T>(Val2);
-  return {};
 }
 
 template <typename T>
 TypeU<T> Interpreter::runXorOp(ValVariant &Val1, const ValVariant &Val2) const {
   /// Return the bitwise exclusive disjunction of i1 and i2.
   retrieveValue<T>(Val1) ^= retrieveValue<T>(Val2);
-  return {};
 }
 
 template <typename T>
 TypeU<T> Interpreter::runShlOp(ValVariant &Val1, const ValVariant &Val2) const {
   /// Return the result of i1 << (i2 modulo N), modulo 2^N.
   retrieveValue<T>(Val1) <<= (retrieveValue<T>(Val2) % (sizeof(T) * 8));
-  return {};
 }
 
 template <typename T>
@@ -106,7 +101,6 @@ TypeI<T> Interpreter::runShrOp(ValVariant &Val1, const ValVariant &Val2) const {
   /// In signed case, extended with the sign bit of i1.
   /// In unsigned case, extended with 0 bits.
   retrieveValue<T>(Val1) >>= (retrieveValue<T>(Val2) % (sizeof(T) * 8));
-  return {};
 }
 
 template <typename T>
@@ -117,7 +111,6 @@ TypeU<T> Interpreter::runRotlOp(ValVariant &Val1,
   const T K = retrieveValue<T>(Val2) % (sizeof(T) * 8);
   /// Return the result of rotating i1 left by k bits.
   I1 = (I1 << K) | (I1 >> (sizeof(T) * 8 - K));
-  return {};
 }
 
 template <typename T>
@@ -128,7 +121,6 @@ TypeU<T> Interpreter::runRotrOp(ValVariant &Val1,
   const T K = retrieveValue<T>(Val2) % (sizeof(T) * 8);
   /// Return the result of rotating i1 left by k bits.
   I1 = (I1 >> K) | (I1 << (sizeof(T) * 8 - K));
-  return {};
 }
 
 template <typename T>
@@ -145,7 +137,6 @@ TypeF<T> Interpreter::runMinOp(ValVariant &Val1, const ValVariant &Val2) const {
     /// Else return the min of z1 and z2. (Inf case are handled.)
     Z1 = std::min(Z1, Z2);
   }
-  return {};
 }
 
 template <typename T>
@@ -162,7 +153,6 @@ TypeF<T> Interpreter::runMaxOp(ValVariant &Val1, const ValVariant &Val2) const {
     /// Else return the max of z1 and z2. (Inf case are handled.)
     Z1 = std::max(Z1, Z2);
   }
-  return {};
 }
 
 template <typename T>
@@ -172,7 +162,6 @@ TypeF<T> Interpreter::runCopysignOp(ValVariant &Val1,
   const T &Z2 = retrieveValue<T>(Val2);
   /// Return z1 with the same sign with z2.
   Z1 = std::copysign(Z1, Z2);
-  return {};
 }
 
 } // namespace Interpreter
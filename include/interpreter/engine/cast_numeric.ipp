@@ -11,11 +11,11 @@ namespace Interpreter {
 template <typename TIn, typename TOut>
 TypeUU<TIn, TOut> Interpreter::runWrapOp(ValVariant &Val) const {
   Val = static_cast<TOut>(retrieveValue<TIn>(Val));
-  return {};
 }
 
 template <typename TIn, typename TOut>
-TypeFI<TIn, TOut> Interpreter::runTruncateOp(ValVariant &Val) const {
+TypeFI<TIn, TOut, Expect<void>>
+Interpreter::runTruncateOp(ValVariant &Val) const {
   TIn Z = retrieveValue<TIn>(Val);
   /// If z is a NaN or an infinity, then the result is undefined.
   if (std::isnan(Z) || std::isinf(Z)) {
@@ -37,36 +37,32 @@ TypeFI<TIn, TOut> Interpreter::runTruncateOp(ValVariant &Val) const {
     }
   }
   /// Else, return trunc(z). Signed case handled.
-  retrieveValue<TOut>(Val) = Z;
+  emplaceValue<TOut>(Val, Z);
   return {};
 }
 
 template <typename TIn, typename TOut>
 TypeIU<TIn, TOut> Interpreter::runExtendOp(ValVariant &Val) const {
   /// Return i extend to TOut. Signed case handled.
-  retrieveValue<TOut>(Val) = retrieveValue<TIn>(Val);
-  return {};
+  emplaceValue<TOut>(Val, retrieveValue<TIn>(Val));
 }
 
 template <typename TIn, typename TOut>
 TypeIF<TIn, TOut> Interpreter::runConvertOp(ValVariant &Val) const {
   /// Return i convert to TOut. Signed case handled.
-  retrieveValue<TOut>(Val) = retrieveValue<TIn>(Val);
-  return {};
+  emplaceValue<TOut>(Val, retrieveValue<TIn>(Val));
 }
 
 template <typename TIn, typename TOut>
 TypeFF<TIn, TOut> Interpreter::runDemoteOp(ValVariant &Val) const {
   /// Return i convert to TOut. (NaN, inf, and zeros handled)
-  retrieveValue<TOut>(Val) = retrieveValue<TIn>(Val);
-  return {};
+  emplaceValue<TOut>(Val, retrieveValue<TIn>(Val));
 }
 
 template <typename TIn, typename TOut>
 TypeFF<TIn, TOut> Interpreter::runPromoteOp(ValVariant &Val) const {
   /// Return i convert to TOut. (NaN, inf, and zeros handled)
-  retrieveValue<TOut>(Val) = retrieveValue<TIn>(Val);
-  return {};
+  emplaceValue<TOut>(Val, retrieveValue<TIn>(Val));
 }
 
 template <typename TIn, typename TOut>
@@ -75,8 +71,7 @@ TypeBB<TIn, TOut> Interpreter::runReinterpretOp(ValVariant &Val) const {
   TOut VOut;
   TIn VIn = retrieveValue<TIn>(Val);
   std::memcpy(&VOut, &VIn, sizeof(TIn));
-  retrieveValue<TOut>(Val) = VOut;
-  return {};
+  emplaceValue<TOut>(Val, VOut);
 }
 
 } // namespace Interpreter
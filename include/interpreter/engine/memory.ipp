@@ -10,38 +10,55 @@ namespace SSVM {
 namespace Interpreter {
 
 template <typename T>
-TypeT<T> Interpreter::runLoadOp(Runtime::Instance::MemoryInstance &MemInst,
-                                const AST::MemoryInstruction &Instr,
-                                const uint32_t BitWidth) {
+TypeT<T, Expect<void>>
+Interpreter::runLoadOp(Runtime::Instance::MemoryInstance &MemInst,
+                       ValVariant &Val, const Runtime::ByteCode &Instr,
+                       const uint32_t BitWidth) {
   /// Calculate EA
-  ValVariant &Val = StackMgr.getTop();
   if (retrieveValue<uint32_t>(Val) >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+      std::numeric_limits<uint32_t>::max() - Instr.Index) {
     return Unexpect(ErrCode::AccessForbidMemory);
   }
-  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
+  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.Index;
 
   /// Value = Mem.Data[EA : N / 8]
-  return MemInst.loadValue(retrieveValue<T>(Val), EA, BitWidth / 8);
+  /// The accesses to the guarded memory are trapped by the fault handler.
+  T Value;
+  if (MemInst.isGuarded()) {
+    CurrentFault->setAccess(&Instr);
+    MemInst.loadValueUnchecked(Value, EA, BitWidth / 8);
+    CurrentFault->setAccess(nullptr);
+  } else if (auto Res = MemInst.loadValue(Value, EA, BitWidth / 8); !Res) {
+    return Unexpect(Res);
+  }
+  emplaceValue<T>(Val, Value);
+  return {};
 }
 
 template <typename T>
-TypeB<T> Interpreter::runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
-                                 const AST::MemoryInstruction &Instr,
-                                 const uint32_t BitWidth) {
-  /// Pop the value t.const c from the Stack
-  ValVariant C = StackMgr.pop();
-
+TypeB<T, Expect<void>>
+Interpreter::runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
+                        const ValVariant &Addr, const ValVariant &Val,
+                        const Runtime::ByteCode &Instr,
+                        const uint32_t BitWidth) {
   /// Calculate EA = i + offset
-  ValVariant I = StackMgr.pop();
-  if (retrieveValue<uint32_t>(I) >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
+  if (retrieveValue<uint32_t>(Addr) >
+      std::numeric_limits<uint32_t>::max() - Instr.Index) {
     return Unexpect(ErrCode::AccessForbidMemory);
   }
-  uint32_t EA = retrieveValue<uint32_t>(I) + Instr.getMemoryOffset();
+  uint32_t EA = retrieveValue<uint32_t>(Addr) + Instr.Index;
 
   /// Store value to bytes.
-  return MemInst.storeValue(retrieveValue<T>(C), EA, BitWidth / 8);
+  /// The accesses to the guarded memory are trapped by the fault handler. The
+  /// stores in checkpoints are checked and journaled instead, and fail with
+  /// the same code as the faults.
+  if (MemInst.canStoreUnchecked()) {
+    CurrentFault->setAccess(&Instr);
+    MemInst.storeValueUnchecked(retrieveValue<T>(Val), EA, BitWidth / 8);
+    CurrentFault->setAccess(nullptr);
+    return {};
+  }
+  return MemInst.storeValue(retrieveValue<T>(Val), EA, BitWidth / 8);
 }
 
 } // namespace Interpreter
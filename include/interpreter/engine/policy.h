@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/interpreter/engine/policy.h - Execution policies -------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the execution policies of interpreter, which select the
+/// measurement in the instruction dispatching loops at compile time.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+
+namespace SSVM {
+namespace Interpreter {
+
+/// Measurement mode enum class. The interpreter runs the dispatching loop
+/// specialized with the policy of the mode.
+enum class MeasureMode : uint8_t { None = 0, Count, Metered };
+
+/// No measurement.
+struct BarePolicy {
+  static constexpr bool CountInstr = false;
+  static constexpr bool ChargeCost = false;
+};
+
+/// Count the executed instructions only.
+struct CountPolicy {
+  static constexpr bool CountInstr = true;
+  static constexpr bool ChargeCost = false;
+};
+
+/// Count the executed instructions, charge the costs within the limit, and
+/// record the execution time.
+struct MeteredPolicy {
+  static constexpr bool CountInstr = true;
+  static constexpr bool ChargeCost = true;
+};
+
+} // namespace Interpreter
+} // namespace SSVM
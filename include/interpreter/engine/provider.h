@@ -12,8 +12,8 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
-#include "common/ast/instruction.h"
 #include "common/errcode.h"
+#include "runtime/bytecode.h"
 
 #include <memory>
 #include <vector>
@@ -24,13 +24,13 @@ namespace Interpreter {
 class InstrProvider {
 public:
   /// Enum class of instruction sequence type.
-  enum class SeqType : uint8_t { Expression = 0, Block, FunctionCall };
+  enum class SeqType : uint8_t { Expression = 0, FunctionCall };
 
   InstrProvider() = default;
   ~InstrProvider() = default;
 
   /// Get the next instruction.
-  const AST::Instruction *getNextInstr();
+  const Runtime::ByteCode *getNextInstr();
 
   /// Get sequence type of top scope.
   SeqType getTopScopeType() const {
@@ -41,13 +41,34 @@ public:
   uint32_t getScopeSize() const { return Iters.size(); }
 
   /// Push instruction sequence.
-  void pushInstrs(SeqType Type) {
-    Iters.emplace_back(Type, EmptyVec.cbegin(), EmptyVec.cend());
+  void pushInstrs(SeqType Type, const Runtime::ByteCodeSeq &Code) {
+    Iters.emplace_back(Type, Code);
   }
-  void pushInstrs(SeqType Type, const AST::InstrVec &Instrs) {
-    Iters.emplace_back(Type, Instrs.cbegin(), Instrs.cend());
+
+  /// Unsafe getter of the v128 constant of the instruction in the top
+  /// sequence.
+  const uint128_t &getV128(const Runtime::ByteCode &Instr) const {
+    return Iters.back().Code->V128[Instr.Index];
+  }
+
+  /// Unsafe getter of the charged instructions of the register-based
+  /// instruction in the top sequence.
+  const Runtime::ByteCodeSeq::ChargeList &
+  getCharges(const Runtime::ByteCode *Instr) const {
+    const auto &Scope = Iters.back();
+    return Scope.Code->Charges[Instr - Scope.Begin];
   }
 
+  /// Getter of the block gas metering of the instruction. The following
+  /// entries are of the following instructions. The instruction is searched
+  /// from the top sequence, and nullptr is returned if not in any sequence or
+  /// in a sequence with no metering.
+  const Runtime::ByteCodeMeter *
+  getMeter(const Runtime::ByteCode *Instr) const;
+
+  /// Unsafe jump to the target instruction in the top sequence.
+  void jump(const Runtime::ByteCode *Target) { Iters.back().Curr = Target; }
+
   /// Pop instruction sequence.
   Expect<void> popInstrs();
 
@@ -57,13 +78,15 @@ public:
 private:
   /// Stack of instruction sequences.
   struct InstrScope {
-    InstrScope(const SeqType Type, AST::InstrIter Curr, AST::InstrIter End)
-        : Type(Type), Curr(Curr), End(End) {}
+    InstrScope(const SeqType Type, const Runtime::ByteCodeSeq &Code)
+        : Type(Type), Code(&Code), Begin(Code.Instrs.data()), Curr(Begin),
+          End(Begin + Code.Instrs.size()) {}
     SeqType Type;
-    AST::InstrIter Curr;
-    AST::InstrIter End;
+    const Runtime::ByteCodeSeq *Code;
+    const Runtime::ByteCode *Begin;
+    const Runtime::ByteCode *Curr;
+    const Runtime::ByteCode *End;
   };
-  AST::InstrVec EmptyVec;
   std::vector<InstrScope> Iters;
 };
 
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/interpreter/engine/regtranslator.h - Register translator -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of register translator class, which
+/// converts the AST instruction trees of function bodies into register-based
+/// byte code for interpreter.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/ast/instruction.h"
+#include "common/errcode.h"
+#include "runtime/bytecode.h"
+#include "runtime/instance/function.h"
+#include "runtime/instance/module.h"
+
+#include <vector>
+
+namespace SSVM {
+namespace Interpreter {
+
+/// Register translator assigns every local and value stack position of a
+/// function a frame slot. `local.get` only refers to the slot of the local,
+/// and `local.set` redirects the result of the previous instruction if
+/// possible. The values of the outer blocks are copied to their stack
+/// position slots before entering a block, so that the slot contents agree at
+/// every join point.
+class RegisterTranslator {
+public:
+  RegisterTranslator(const Runtime::Instance::ModuleInstance &ModInst,
+                     const std::vector<const Runtime::Instance::FType *> &Types)
+      : ModInst(ModInst), FuncTypes(Types) {}
+  ~RegisterTranslator() = default;
+
+  /// Translate the function body into register-based byte code.
+  Expect<Runtime::ByteCodeSeq>
+  translate(const Runtime::Instance::FunctionInstance &Func);
+
+  /// Getter of count of frame slots of the translated function.
+  uint32_t getSlotNum() const { return LocalNum + MaxHeight; }
+
+  /// Getter of the beginnings of loop bodies of the translated function in
+  /// the order of loops. The unreachable loops have no beginnings.
+  const std::vector<uint32_t> &getLoopStarts() const { return LoopStarts; }
+
+  /// Position of the unreachable loops in the loop beginnings.
+  static inline constexpr const uint32_t NoLoopStart = UINT32_MAX;
+
+private:
+  /// \name Functions for instruction translation.
+  /// @{
+  Expect<void> translateInstrs(const AST::InstrVec &Instrs);
+  void skipInstrs(const AST::InstrVec &Instrs, const uint32_t Begin = 0);
+  Expect<void> translate(const AST::ControlInstruction &Instr);
+  Expect<void> translate(const AST::BlockControlInstruction &Instr);
+  Expect<void> translate(const AST::IfElseControlInstruction &Instr);
+  Expect<void> translate(const AST::BrControlInstruction &Instr);
+  Expect<void> translate(const AST::BrTableControlInstruction &Instr);
+  Expect<void> translate(const AST::CallControlInstruction &Instr);
+  Expect<void> translate(const AST::ParametricInstruction &Instr);
+  Expect<void> translate(const AST::VariableInstruction &Instr);
+  Expect<void> translate(const AST::MemoryInstruction &Instr);
+  Expect<void> translate(const AST::ConstInstruction &Instr);
+  Expect<void> translate(const AST::UnaryNumericInstruction &Instr);
+  Expect<void> translate(const AST::BinaryNumericInstruction &Instr);
+  Expect<void> translate(const AST::SIMDInstruction &Instr);
+  Expect<void> translate(const AST::AtomicMemoryInstruction &Instr);
+  /// @}
+
+  /// Helper function for appending a byte code with the pending charges and
+  /// return its position.
+  uint32_t emit(const AST::Instruction::OpCode Code);
+
+  /// Helper function for appending a branch to the label index and return its
+  /// position.
+  uint32_t emitBranch(const AST::Instruction::OpCode Code,
+                      const uint32_t LabelIdx);
+
+  /// Helper function for appending the pending charges as a `nop`.
+  void flushCharge();
+
+  /// Helper function for storing the top value into local by `local.set` or
+  /// `local.tee`.
+  void storeLocal(const AST::Instruction::OpCode Code, const uint32_t Idx);
+
+  /// \name Helper functions for operand slots.
+  /// @{
+  uint32_t pushOperand();
+  uint32_t popOperand();
+  /// Copy the value of local to the slot of stack position.
+  void materialize(const uint32_t Pos);
+  void materializeAll();
+  /// @}
+
+  /// \name Helper functions for labels of structured instructions.
+  /// @{
+  void enterLabel(const bool IsLoop, const ValType Type);
+  void leaveLabel();
+  /// @}
+
+  /// Label of structured instruction in translation.
+  struct Label {
+    /// Branch to loop jumps backward to the beginning of body.
+    bool IsLoop;
+    uint32_t Start;
+    /// Stack height at the beginning and the result arity.
+    uint32_t Height;
+    uint32_t Arity;
+    /// Forward branches to be resolved at the end of body.
+    std::vector<uint32_t> Pending;
+  };
+
+  /// Module instance for function types.
+  const Runtime::Instance::ModuleInstance &ModInst;
+  /// Function types by function index.
+  const std::vector<const Runtime::Instance::FType *> &FuncTypes;
+  /// Translated byte code, with the charged instructions of each byte code and
+  /// the v128 constants.
+  std::vector<Runtime::ByteCode> Code;
+  std::vector<Runtime::ByteCodeSeq::ChargeList> ChargeLists;
+  std::vector<uint128_t> V128;
+  /// Label stack.
+  std::vector<Label> Labels;
+  /// Slots of the values on stack. Slots less than LocalNum refer to locals.
+  std::vector<uint32_t> Operands;
+  /// Original instructions to be charged by the next byte code.
+  std::vector<AST::Instruction::OpCode> Charges;
+  /// Count of locals including parameters.
+  uint32_t LocalNum = 0;
+  /// Maximum height of stack.
+  uint32_t MaxHeight = 0;
+  /// Position of the last byte code which can redirect its result to local.
+  uint32_t LastResult = 0;
+  bool HasLastResult = false;
+  /// Following instructions in the block are unreachable.
+  bool IsDead = false;
+  /// Beginnings of loop bodies in the order of loops.
+  std::vector<uint32_t> LoopStarts;
+};
+
+} // namespace Interpreter
+} // namespace SSVM
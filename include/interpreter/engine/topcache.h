@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/interpreter/engine/topcache.h - Top value cache definition ---===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the value stack accessors of the stack-based dispatching
+/// loop, which optionally cache the top value of stack in a local variable.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/value.h"
+#include "runtime/stackmgr.h"
+
+#include <utility>
+
+namespace SSVM {
+namespace Interpreter {
+
+template <bool Enable> class TopCache;
+
+/// Access the value stack directly.
+template <> class TopCache<false> {
+public:
+  TopCache(Runtime::StackManager &Mgr) : StackMgr(Mgr) {}
+
+  ValVariant &getTop() { return StackMgr.getTop(); }
+  ValVariant pop() { return StackMgr.pop(); }
+  template <typename T> void push(T &&Val) {
+    StackMgr.push(std::forward<T>(Val));
+  }
+
+  /// Pop the top value to the destination, which may be the stack entry under
+  /// the top value.
+  void popTo(ValVariant &Dst) { Dst = StackMgr.pop(); }
+
+  /// Nothing to synchronize with the value stack.
+  void spill() {}
+  void reload() {}
+
+private:
+  Runtime::StackManager &StackMgr;
+};
+
+/// Cache the top value of stack in a local variable. The stack size is kept in
+/// the stack manager, and the top entry in memory is stale until spilled. The
+/// value stack should be spilled before the operations accessing the stack
+/// manager, and reloaded after them.
+template <> class TopCache<true> {
+public:
+  TopCache(Runtime::StackManager &Mgr) : StackMgr(Mgr) { reload(); }
+
+  ValVariant &getTop() { return Top; }
+  ValVariant pop() {
+    ValVariant Val = Top;
+    StackMgr.drop();
+    reload();
+    return Val;
+  }
+  template <typename T> void push(T &&Val) {
+    spill();
+    StackMgr.grow();
+    Top = std::forward<T>(Val);
+  }
+
+  /// Pop the top value to the destination, which may be the stack entry under
+  /// the top value.
+  void popTo(ValVariant &Dst) {
+    Dst = Top;
+    StackMgr.drop();
+    reload();
+  }
+
+  /// Write the top value back to the value stack.
+  void spill() { StackMgr.getTop() = Top; }
+
+  /// Load the top value from the value stack.
+  void reload() { Top = StackMgr.getTop(); }
+
+private:
+  Runtime::StackManager &StackMgr;
+  ValVariant Top;
+};
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/interpreter/engine/translator.h - Translator class -----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of translator class, which flattens the
+/// AST instruction trees into pre-decoded byte code for interpreter.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/ast/instruction.h"
+#include "common/errcode.h"
+#include "runtime/bytecode.h"
+#include "runtime/instance/module.h"
+#include "support/measure.h"
+
+#include <vector>
+
+namespace SSVM {
+namespace Interpreter {
+
+class Translator {
+public:
+  /// The block costs are taken from the cost table of the measurement.
+  /// Instruction pair counting makes every instruction a block, and disables
+  /// superinstructions.
+  Translator(const Support::Measurement *Measure = nullptr)
+      : Measure(Measure),
+        IsPairCounting(Measure && Measure->isPairCounting()) {}
+  ~Translator() = default;
+
+  /// Translate the validated instruction sequence into byte code with the
+  /// branch targets resolved by validator, and compute the maximum height of
+  /// value stack. The constant expressions have no branches and calls. Fail if
+  /// the targets do not match the branches.
+  Expect<Runtime::ByteCodeSeq>
+  translate(const AST::InstrVec &Instrs,
+            const AST::BranchTargetVec &Targets = {});
+
+  /// Emit the loop heads counting the iterations for the function of index in
+  /// tiered execution.
+  void setLoopCounting(const uint32_t FuncIdx) {
+    IsLoopCounting = true;
+    LoopFuncIdx = FuncIdx;
+  }
+
+  /// Set the function types of the module for the stack heights of calls.
+  void
+  setFuncTypes(const Runtime::Instance::ModuleInstance &Inst,
+               const std::vector<const Runtime::Instance::FType *> &Types) {
+    ModInst = &Inst;
+    FuncTypes = &Types;
+  }
+
+private:
+  /// \name Functions for instruction translation.
+  /// @{
+  Expect<void> translateInstrs(const AST::InstrVec &Instrs);
+  Expect<void> translate(const AST::ControlInstruction &Instr);
+  Expect<void> translate(const AST::BlockControlInstruction &Instr);
+  Expect<void> translate(const AST::IfElseControlInstruction &Instr);
+  Expect<void> translate(const AST::BrControlInstruction &Instr);
+  Expect<void> translate(const AST::BrTableControlInstruction &Instr);
+  Expect<void> translate(const AST::CallControlInstruction &Instr);
+  Expect<void> translate(const AST::ParametricInstruction &Instr);
+  Expect<void> translate(const AST::VariableInstruction &Instr);
+  Expect<void> translate(const AST::MemoryInstruction &Instr);
+  Expect<void> translate(const AST::ConstInstruction &Instr);
+  Expect<void> translate(const AST::UnaryNumericInstruction &Instr);
+  Expect<void> translate(const AST::BinaryNumericInstruction &Instr);
+  Expect<void> translate(const AST::SIMDInstruction &Instr);
+  Expect<void> translate(const AST::AtomicMemoryInstruction &Instr);
+  /// @}
+
+  /// Helper function for appending a byte code and return its position.
+  uint32_t emit(const AST::Instruction::OpCode Code);
+
+  /// Helper function for appending a branch to the label index with the next
+  /// branch target.
+  Expect<void> emitBranch(const AST::Instruction::OpCode Code,
+                          const uint32_t LabelIdx);
+
+  /// Helper function for precomputing the costs of straight-line blocks.
+  std::vector<Runtime::ByteCodeMeter> computeBlocks();
+
+  /// Helper function for replacing instruction sequences with superinstructions.
+  void fuseSuperInstrs(const std::vector<Runtime::ByteCodeMeter> &Meters);
+
+  /// Helper function for popping and pushing values on the stack height.
+  void updateHeight(const uint32_t PopNum, const uint32_t PushNum);
+
+  /// \name Helper functions for labels of structured instructions.
+  /// @{
+  void enterLabel(const bool IsLoop, const ValType Type);
+  void leaveLabel();
+  /// @}
+
+  /// Label of structured instruction in translation.
+  struct Label {
+    /// Branch to loop jumps backward to the beginning of body.
+    bool IsLoop;
+    uint32_t Start;
+    /// Stack height at the beginning and the result arity.
+    uint32_t Height;
+    uint32_t Arity;
+    /// Forward branches to be resolved at the end of body.
+    std::vector<uint32_t> Pending;
+  };
+
+  /// Pointer to measurement for the cost table.
+  const Support::Measurement *Measure;
+  /// Count instruction pairs, which needs the instructions charged one by one.
+  const bool IsPairCounting;
+  /// Count loop iterations of the function of index for tiered execution.
+  bool IsLoopCounting = false;
+  uint32_t LoopFuncIdx = 0;
+  uint32_t LoopCnt = 0;
+  /// Translated byte code and v128 constants.
+  std::vector<Runtime::ByteCode> Code;
+  std::vector<uint128_t> V128;
+  /// Label stack.
+  std::vector<Label> Labels;
+  /// Branch targets and the position of the next one.
+  const AST::BranchTargetVec *Targets = nullptr;
+  uint32_t TargetPos = 0;
+  /// Module instance and function types by function index for calls.
+  const Runtime::Instance::ModuleInstance *ModInst = nullptr;
+  const std::vector<const Runtime::Instance::FType *> *FuncTypes = nullptr;
+  /// Current and maximum height of stack.
+  uint32_t Height = 0;
+  uint32_t MaxHeight = 0;
+};
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -21,7 +21,6 @@ template <typename T> TypeU<T> Interpreter::runClzOp(ValVariant &Val) const {
   } else {
     Val = static_cast<T>(sizeof(T) * 8);
   }
-  return {};
 }
 
 template <typename T> TypeU<T> Interpreter::runCtzOp(ValVariant &Val) const {
@@ -38,7 +37,6 @@ template <typename T> TypeU<T> Interpreter::runCtzOp(ValVariant &Val) const {
   } else {
     Val = static_cast<T>(sizeof(T) * 8);
   }
-  return {};
 }
 
 template <typename T> TypeU<T> Interpreter::runPopcntOp(ValVariant &Val) const {
@@ -55,43 +53,35 @@ template <typename T> TypeU<T> Interpreter::runPopcntOp(ValVariant &Val) const {
     }
     Val = Cnt;
   }
-  return {};
 }
 
 template <typename T> TypeF<T> Interpreter::runAbsOp(ValVariant &Val) const {
   Val = std::fabs(retrieveValue<T>(Val));
-  return {};
 }
 
 template <typename T> TypeF<T> Interpreter::runNegOp(ValVariant &Val) const {
   Val = -retrieveValue<T>(Val);
-  return {};
 }
 
 template <typename T> TypeF<T> Interpreter::runCeilOp(ValVariant &Val) const {
   Val = std::ceil(retrieveValue<T>(Val));
-  return {};
 }
 
 template <typename T> TypeF<T> Interpreter::runFloorOp(ValVariant &Val) const {
   Val = std::floor(retrieveValue<T>(Val));
-  return {};
 }
 
 template <typename T> TypeF<T> Interpreter::runTruncOp(ValVariant &Val) const {
   Val = std::trunc(retrieveValue<T>(Val));
-  return {};
 }
 
 template <typename T>
 TypeF<T> Interpreter::runNearestOp(ValVariant &Val) const {
   Val = std::nearbyint(retrieveValue<T>(Val));
-  return {};
 }
 
 template <typename T> TypeF<T> Interpreter::runSqrtOp(ValVariant &Val) const {
   Val = std::sqrt(retrieveValue<T>(Val));
-  return {};
 }
 
 } // namespace Interpreter
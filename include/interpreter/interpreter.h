@@ -16,11 +16,14 @@
 #include "common/ast/module.h"
 #include "common/errcode.h"
 #include "common/value.h"
+#include "engine/policy.h"
 #include "engine/provider.h"
+#include "runtime/bytecode.h"
 #include "runtime/importobj.h"
 #include "runtime/stackmgr.h"
 #include "runtime/storemgr.h"
 #include "support/log.h"
+#include "support/fault.h"
 #include "support/measure.h"
 #include "support/time.h"
 
@@ -38,78 +41,109 @@ namespace {
 
 using OpCode = AST::Instruction::OpCode;
 
-/// Template return type aliasing
+/// Template return type aliasing. The handlers which never trap return nothing,
+/// and the others return `Expect<void>` as the R type.
 /// Accept unsigned integer types. (uint32_t, uint64_t)
-template <typename T>
-using TypeU =
-    typename std::enable_if_t<Support::IsWasmUnsignV<T>, Expect<void>>;
+template <typename T, typename R = void>
+using TypeU = typename std::enable_if_t<Support::IsWasmUnsignV<T>, R>;
 /// Accept integer types. (uint32_t, int32_t, uint64_t, int64_t)
-template <typename T>
-using TypeI = typename std::enable_if_t<Support::IsWasmIntV<T>, Expect<void>>;
+template <typename T, typename R = void>
+using TypeI = typename std::enable_if_t<Support::IsWasmIntV<T>, R>;
 /// Accept floating types. (float, double)
-template <typename T>
-using TypeF = typename std::enable_if_t<Support::IsWasmFloatV<T>, Expect<void>>;
+template <typename T, typename R = void>
+using TypeF = typename std::enable_if_t<Support::IsWasmFloatV<T>, R>;
 /// Accept all types. (uint32_t, int32_t, uint64_t, int64_t, float, double)
-template <typename T>
-using TypeT = typename std::enable_if_t<Support::IsWasmTypeV<T>, Expect<void>>;
+template <typename T, typename R = void>
+using TypeT = typename std::enable_if_t<Support::IsWasmTypeV<T>, R>;
 /// Accept Wasm built-in types. (uint32_t, uint64_t, float, double)
-template <typename T>
-using TypeB =
-    typename std::enable_if_t<Support::IsWasmBuiltInV<T>, Expect<void>>;
+template <typename T, typename R = void>
+using TypeB = typename std::enable_if_t<Support::IsWasmBuiltInV<T>, R>;
 
 /// Accept (unsigned integer types, unsigned integer types).
-template <typename T1, typename T2>
+template <typename T1, typename T2, typename R = void>
 using TypeUU = typename std::enable_if_t<
-    Support::IsWasmUnsignV<T1> && Support::IsWasmUnsignV<T2>, Expect<void>>;
+    Support::IsWasmUnsignV<T1> && Support::IsWasmUnsignV<T2>, R>;
 /// Accept (integer types, unsigned integer types).
-template <typename T1, typename T2>
+template <typename T1, typename T2, typename R = void>
 using TypeIU = typename std::enable_if_t<
-    Support::IsWasmIntV<T1> && Support::IsWasmUnsignV<T2>, Expect<void>>;
+    Support::IsWasmIntV<T1> && Support::IsWasmUnsignV<T2>, R>;
 /// Accept (floating types, floating types).
-template <typename T1, typename T2>
+template <typename T1, typename T2, typename R = void>
 using TypeFF = typename std::enable_if_t<
-    Support::IsWasmFloatV<T1> && Support::IsWasmFloatV<T2>, Expect<void>>;
+    Support::IsWasmFloatV<T1> && Support::IsWasmFloatV<T2>, R>;
 /// Accept (integer types, floating types).
-template <typename T1, typename T2>
+template <typename T1, typename T2, typename R = void>
 using TypeIF = typename std::enable_if_t<
-    Support::IsWasmIntV<T1> && Support::IsWasmFloatV<T2>, Expect<void>>;
+    Support::IsWasmIntV<T1> && Support::IsWasmFloatV<T2>, R>;
 /// Accept (floating types, integer types).
-template <typename T1, typename T2>
+template <typename T1, typename T2, typename R = void>
 using TypeFI = typename std::enable_if_t<
-    Support::IsWasmFloatV<T1> && Support::IsWasmIntV<T2>, Expect<void>>;
+    Support::IsWasmFloatV<T1> && Support::IsWasmIntV<T2>, R>;
 /// Accept (Wasm built-in types, Wasm built-in types).
-template <typename T1, typename T2>
-using TypeBB = typename std::enable_if_t<Support::IsWasmBuiltInV<T1> &&
-                                             Support::IsWasmBuiltInV<T2> &&
-                                             sizeof(T1) == sizeof(T2),
-                                         Expect<void>>;
+template <typename T1, typename T2, typename R = void>
+using TypeBB =
+    typename std::enable_if_t<Support::IsWasmBuiltInV<T1> &&
+                                  Support::IsWasmBuiltInV<T2> &&
+                                  sizeof(T1) == sizeof(T2),
+                              R>;
 
 } // namespace
 
 /// Executor flow control class.
 class Interpreter {
 public:
-  Interpreter(Support::Measurement *M = nullptr) : Measure(M) {}
+  /// Hotness of the calls and loop iterations of a function to promote it in
+  /// tiered execution.
+  static inline constexpr const uint32_t HotThreshold = 1024;
+
+  Interpreter(Support::Measurement *M = nullptr,
+              const uint32_t StackCapacity =
+                  Runtime::StackManager::DefaultCapacity)
+      : StackMgr(StackCapacity), Measure(M),
+        Mode(M ? MeasureMode::Metered : MeasureMode::None) {}
   ~Interpreter() = default;
 
-  /// Instantiate Wasm Module.
-  Expect<void> instantiateModule(Runtime::StoreManager &StoreMgr,
-                                 const AST::Module &Mod,
-                                 const std::string &Name = "");
+  /// Instantiate Wasm Module with the branch targets of function bodies
+  /// resolved by validator.
+  Expect<void>
+  instantiateModule(Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
+                    const std::vector<AST::BranchTargetVec> &Targets,
+                    const std::string &Name = "");
 
   /// Register host module.
   Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
                               const Runtime::ImportObject &Obj);
 
-  /// Register Wasm module.
+  /// Register Wasm module with the branch targets of function bodies resolved
+  /// by validator.
   Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
-                              const AST::Module &Mod, const std::string &Name);
+                              const AST::Module &Mod,
+                              const std::vector<AST::BranchTargetVec> &Targets,
+                              const std::string &Name);
 
   /// Invoke function by function address in Store manager.
   Expect<std::vector<ValVariant>> invoke(Runtime::StoreManager &StoreMgr,
                                          const uint32_t FuncAddr,
                                          const std::vector<ValVariant> &Params);
 
+  /// Run the Wasm functions in register-based byte code. Set before
+  /// instantiation, for the function instances translated then.
+  void setRegisterTier(const bool Enable) { RegisterTier = Enable; }
+
+  /// Cache the top value of stack in a local variable in the stack-based
+  /// dispatching loop.
+  void setTopCaching(const bool Enable) { TopCaching = Enable; }
+
+  /// Start the Wasm functions in stack-based byte code, and run the hot ones
+  /// in register-based byte code. Set before instantiation, for the function
+  /// instances translated then.
+  void setTiered(const bool Enable) { Tiered = Enable; }
+
+  /// Set the measurement mode. No measurement without the measurement.
+  void setMeasureMode(const MeasureMode NewMode) {
+    Mode = Measure ? NewMode : MeasureMode::None;
+  }
+
 private:
   /// Run Wasm bytecode expression for initialization.
   Expect<void> runExpression(Runtime::StoreManager &StoreMgr,
@@ -124,7 +158,9 @@ private:
   /// @{
   /// Instantiation of Module Instance.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
-                           const AST::Module &Mod, const std::string &Name);
+                           const AST::Module &Mod,
+                           const std::vector<AST::BranchTargetVec> &Targets,
+                           const std::string &Name);
 
   /// Instantiation of Import Section.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
@@ -135,7 +171,8 @@ private:
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
                            Runtime::Instance::ModuleInstance &ModInst,
                            const AST::FunctionSection &FuncSec,
-                           const AST::CodeSection &CodeSec);
+                           const AST::CodeSection &CodeSec,
+                           const std::vector<AST::BranchTargetVec> &Targets);
 
   /// Instantiation of Global Instances.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
@@ -184,102 +221,171 @@ private:
 
   /// \name Functions for instruction dispatchers.
   /// @{
+  /// Run the dispatching loop specialized with the policy of the mode.
   Expect<void> execute(Runtime::StoreManager &StoreMgr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::ControlInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::BlockControlInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::IfElseControlInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::BrControlInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::BrTableControlInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::CallControlInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::ParametricInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::VariableInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::MemoryInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::ConstInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::UnaryNumericInstruction &Instr);
-  Expect<void> execute(Runtime::StoreManager &StoreMgr,
-                       const AST::BinaryNumericInstruction &Instr);
+  Expect<void> executeRegister(Runtime::StoreManager &StoreMgr);
+  template <typename Policy, bool CacheTop>
+  Expect<void> execute(Runtime::StoreManager &StoreMgr);
+  template <typename Policy>
+  Expect<void> executeRegister(Runtime::StoreManager &StoreMgr);
   /// @}
 
   /// \name Helper Functions for block controls.
   /// @{
-  /// Helper function for entering blocks.
-  Expect<void> enterBlock(const uint32_t Arity,
-                          const AST::BlockControlInstruction *Instr,
-                          const AST::InstrVec &Seq);
-
-  /// Helper function for leaving blocks.
-  Expect<void> leaveBlock();
-
   /// Helper function for calling functions.
   Expect<void> enterFunction(Runtime::StoreManager &StoreMgr,
                              const Runtime::Instance::FunctionInstance &Func);
 
+  /// Helper function for calling native functions. The stack room for the
+  /// locals should be checked before.
+  void enterNativeFunction(Runtime::StoreManager &StoreMgr,
+                           const Runtime::Instance::FunctionInstance &Func);
+
   /// Helper function for return from functions.
   Expect<void> leaveFunction();
 
+  /// Helper function for calling native functions in tiered execution. The
+  /// calls are counted, and the hot functions run in the register-based byte
+  /// code with the args and the results on the top of stack. The hot function
+  /// tail called is only entered, and left to the runtime to run.
+  Expect<void>
+  enterTieredFunction(Runtime::StoreManager &StoreMgr,
+                      const Runtime::Instance::FunctionInstance &Func,
+                      const bool IsTail = false);
+
+  /// Helper function for on-stack replacement in tiered execution. Replace the
+  /// frame of the function in stack-based byte code with the promoted one at
+  /// the beginning of the loop body, and run it until it returns. The function
+  /// should be promoted with the loop reached in translation.
+  Expect<void>
+  runPromotedLoop(Runtime::StoreManager &StoreMgr,
+                  const Runtime::Instance::FunctionInstance &Func,
+                  const uint32_t Loop);
+
+  /// Helper function for translating the function into register-based byte
+  /// code in tiered execution. Wait on the function if it is promoting by
+  /// other thread.
+  Expect<void>
+  promoteFunction(Runtime::StoreManager &StoreMgr,
+                  const Runtime::Instance::FunctionInstance &Func);
+
+  /// Helper function for tail calling functions, which replaces the frame of
+  /// the current function with the callee's one.
+  Expect<void>
+  enterTailFunction(Runtime::StoreManager &StoreMgr,
+                    const Runtime::Instance::FunctionInstance &Func);
+
   /// Helper function for branching to label.
-  Expect<void> branchToLabel(const uint32_t Cnt);
+  Expect<void> branchToLabel(const uint32_t EraseCnt, const uint32_t Arity,
+                             const Runtime::ByteCode *Target);
+
+  /// Helper function for getting the function of `call_indirect`.
+  Expect<const Runtime::Instance::FunctionInstance *>
+  getIndirectFuncInst(Runtime::StoreManager &StoreMgr, const uint32_t TypeIdx,
+                      const uint32_t ElemIdx);
+  /// @}
+
+  /// \name Helper Functions for block gas metering.
+  /// @{
+  /// Helper function for adding the costs of the block beginning at the
+  /// instruction, or of the instructions before the one exceeding the limit.
+  template <typename Policy>
+  Expect<void> chargeBlock(const Runtime::ByteCode &Instr);
+
+  /// Helper function for returning the costs of the instructions not run in
+  /// the block of the trapping instruction, by the metering of it.
+  template <typename Policy>
+  ErrCode refundBlock(const Runtime::ByteCodeMeter *Meter, const ErrCode Code);
+  /// @}
+
+  /// \name Helper Functions for register-based byte code.
+  /// @{
+  /// Helper function for calling functions with arguments at the stack
+  /// offset.
+  Expect<void>
+  enterRegFunction(Runtime::StoreManager &StoreMgr,
+                   const Runtime::Instance::FunctionInstance &Func,
+                   const uint32_t Offset);
+
+  /// Helper function for return from functions with the results at slot 0.
+  Expect<void> leaveRegFunction(const uint32_t Arity);
+
+  /// Helper function for tail calling functions with arguments at the slot
+  /// index. The callee frame replaces the current one.
+  Expect<void>
+  enterRegTailFunction(Runtime::StoreManager &StoreMgr,
+                       const Runtime::Instance::FunctionInstance &Func,
+                       const uint32_t Idx);
+
+  /// Helper function for branching with the result slots.
+  void runRegBrOp(ValVariant *Slots, const Runtime::ByteCode &Instr);
   /// @}
 
   /// \name Helper Functions for getting instances.
   /// @{
   /// Helper function for get table instance by index.
-  Runtime::Instance::TableInstance *
-  getTabInstByIdx(Runtime::StoreManager &StoreMgr, const uint32_t Idx);
+  Runtime::Instance::TableInstance *getTabInstByIdx(const uint32_t Idx);
 
   /// Helper function for get memory instance by index.
-  Runtime::Instance::MemoryInstance *
-  getMemInstByIdx(Runtime::StoreManager &StoreMgr, const uint32_t Idx);
+  Runtime::Instance::MemoryInstance *getMemInstByIdx(const uint32_t Idx);
 
   /// Helper function for get global instance by index.
-  Runtime::Instance::GlobalInstance *
-  getGlobInstByIdx(Runtime::StoreManager &StoreMgr, const uint32_t Idx);
+  Runtime::Instance::GlobalInstance *getGlobInstByIdx(const uint32_t Idx);
   /// @}
 
   /// \name Run instructions functions
   /// @{
   /// ======= Control instructions =======
-  Expect<void> runBlockOp(const AST::BlockControlInstruction &Instr);
-  Expect<void> runLoopOp(const AST::BlockControlInstruction &Instr);
-  Expect<void> runIfElseOp(const AST::IfElseControlInstruction &Instr);
-  Expect<void> runBrOp(const AST::BrControlInstruction &Instr);
-  Expect<void> runBrIfOp(const AST::BrControlInstruction &Instr);
-  Expect<void> runBrTableOp(const AST::BrTableControlInstruction &Instr);
+  template <typename Policy>
+  Expect<void> runIfElseOp(const Runtime::ByteCode &Instr,
+                           const ValVariant &Cond);
+  Expect<void> runElseOp(const Runtime::ByteCode &Instr);
+  Expect<void> runBrOp(const Runtime::ByteCode &Instr);
+  Expect<void> runBrTableOp(const Runtime::ByteCode &Instr);
   Expect<void> runReturnOp();
   Expect<void> runCallOp(Runtime::StoreManager &StoreMgr,
-                         const AST::CallControlInstruction &Instr);
+                         const Runtime::ByteCode &Instr);
   Expect<void> runCallIndirectOp(Runtime::StoreManager &StoreMgr,
-                                 const AST::CallControlInstruction &Instr);
-  /// ======= Variable instructions =======
-  Expect<void> runLocalGetOp(const uint32_t Idx);
-  Expect<void> runLocalSetOp(const uint32_t Idx);
-  Expect<void> runLocalTeeOp(const uint32_t Idx);
-  Expect<void> runGlobalGetOp(Runtime::StoreManager &StoreMgr,
-                              const uint32_t Idx);
-  Expect<void> runGlobalSetOp(Runtime::StoreManager &StoreMgr,
-                              const uint32_t Idx);
+                                 const Runtime::ByteCode &Instr);
+  Expect<void> runReturnCallOp(Runtime::StoreManager &StoreMgr,
+                               const Runtime::ByteCode &Instr);
+  Expect<void> runReturnCallIndirectOp(Runtime::StoreManager &StoreMgr,
+                                       const Runtime::ByteCode &Instr);
   /// ======= Memory instructions =======
   template <typename T>
-  TypeT<T> runLoadOp(Runtime::Instance::MemoryInstance &MemInst,
-                     const AST::MemoryInstruction &Instr,
-                     const uint32_t BitWidth = sizeof(T) * 8);
+  TypeT<T, Expect<void>> runLoadOp(Runtime::Instance::MemoryInstance &MemInst,
+                                   ValVariant &Val,
+                                   const Runtime::ByteCode &Instr,
+                                   const uint32_t BitWidth = sizeof(T) * 8);
   template <typename T>
-  TypeB<T> runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
-                      const AST::MemoryInstruction &Instr,
-                      const uint32_t BitWidth = sizeof(T) * 8);
+  TypeB<T, Expect<void>> runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
+                                    const ValVariant &Addr,
+                                    const ValVariant &Val,
+                                    const Runtime::ByteCode &Instr,
+                                    const uint32_t BitWidth = sizeof(T) * 8);
   Expect<void> runMemorySizeOp(Runtime::Instance::MemoryInstance &MemInst);
-  Expect<void> runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst);
+  Expect<void> runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst,
+                               ValVariant &Val);
+  Expect<void>
+  runMemoryInitOp(Runtime::Instance::MemoryInstance &MemInst,
+                  const Runtime::Instance::ModuleInstance::DataSegment &Seg,
+                  const ValVariant &Dst, const ValVariant &Src,
+                  const ValVariant &Len);
+  void runDataDropOp(Runtime::Instance::ModuleInstance::DataSegment &Seg);
+  Expect<void> runMemoryCopyOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const ValVariant &Dst, const ValVariant &Src,
+                               const ValVariant &Len);
+  Expect<void> runMemoryFillOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const ValVariant &Dst, const ValVariant &Val,
+                               const ValVariant &Len);
+  /// ======= SIMD instructions =======
+  /// The operands are the consecutive values starting from Args, and the
+  /// result is stored to Args[0].
+  Expect<void> runSIMDOp(const Runtime::ByteCode &Instr, ValVariant *Args);
+  /// ======= Atomic memory instructions =======
+  /// The operands are the consecutive values starting from Args, and the
+  /// result is stored to Args[0].
+  Expect<void> runAtomicOp(const Runtime::ByteCode &Instr, ValVariant *Args);
   /// ======= Test and Relation Numeric instructions =======
   template <typename T> TypeU<T> runEqzOp(ValVariant &Val) const;
   template <typename T>
@@ -313,9 +419,11 @@ private:
   template <typename T>
   TypeB<T> runMulOp(ValVariant &Val1, const ValVariant &Val2) const;
   template <typename T>
-  TypeT<T> runDivOp(ValVariant &Val1, const ValVariant &Val2) const;
+  TypeT<T, Expect<void>> runDivOp(ValVariant &Val1,
+                                  const ValVariant &Val2) const;
   template <typename T>
-  TypeI<T> runRemOp(ValVariant &Val1, const ValVariant &Val2) const;
+  TypeI<T, Expect<void>> runRemOp(ValVariant &Val1,
+                                  const ValVariant &Val2) const;
   template <typename T>
   TypeU<T> runAndOp(ValVariant &Val1, const ValVariant &Val2) const;
   template <typename T>
@@ -340,7 +448,7 @@ private:
   template <typename TIn, typename TOut>
   TypeUU<TIn, TOut> runWrapOp(ValVariant &Val) const;
   template <typename TIn, typename TOut>
-  TypeFI<TIn, TOut> runTruncateOp(ValVariant &Val) const;
+  TypeFI<TIn, TOut, Expect<void>> runTruncateOp(ValVariant &Val) const;
   template <typename TIn, typename TOut>
   TypeIU<TIn, TOut> runExtendOp(ValVariant &Val) const;
   template <typename TIn, typename TOut>
@@ -363,6 +471,27 @@ private:
   InstrProvider InstrPdr;
   /// Pointer to measurement.
   Support::Measurement *Measure;
+  /// Measurement mode.
+  MeasureMode Mode;
+  /// Run in register-based byte code.
+  bool RegisterTier = false;
+  /// Cache the top value of stack in the stack-based byte code.
+  bool TopCaching = false;
+  /// Promote the hot functions to register-based byte code.
+  bool Tiered = false;
+  /// The promoted function tail called in the stack-based byte code is entered
+  /// and to be run by the runtime, and the stack size after it returns.
+  bool TailRegEntered = false;
+  uint32_t TailRegEnd = 0;
+  /// Fault handler of the running function, which marks the guarded memory
+  /// accesses with the accessing instructions.
+  Support::Fault *CurrentFault = nullptr;
+  /// The instruction to stop at when the costs of the block exceed the limit,
+  /// the count added there, and the costs not charged after it.
+  const Runtime::ByteCode *GasTrap = nullptr;
+  uint32_t GasTrapCnt = 0;
+  uint64_t GasUnchargedCost = 0;
+  uint32_t GasUnchargedCnt = 0;
 };
 
 } // namespace Interpreter
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/runtime/bytecode.h - Flat byte code definition ---------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the pre-decoded flat instruction,
+/// which is translated from the AST instruction tree of function bodies.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/ast/instruction.h"
+#include "common/value.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace SSVM {
+namespace Runtime {
+
+/// Pre-decoded instruction with inline immediates.
+///
+/// Structured instructions are flattened into a contiguous array. `block`,
+/// `loop`, and `if` are followed by their bodies without end markers. The
+/// `if` instruction with a non-empty else-statement has an `Else` marker
+/// between the two statements. The `br_table` instruction is followed by
+/// (label table size + 1) `Br` entries, and the last one is the default label.
+/// Branches carry their targets resolved by validator, so that a branch is a
+/// value stack erasing and a jump. Jump offsets are relative to the position
+/// of the instruction itself.
+///
+/// Straight-line blocks end at jump targets, and after branches, calls, and
+/// `unreachable`. The costs of a block are charged once at its beginning.
+///
+/// The register-based byte code shares this layout. Its operands and results
+/// are frame slots: the locals followed by the value stack positions of the
+/// function. Instructions folded away are charged by the remaining ones.
+///
+/// Only the operands used by the dispatch loops are kept here. The rare data
+/// are in the side tables of `ByteCodeSeq` at the same position.
+struct ByteCode {
+  /// Maximum count of the original instructions charged by one byte code.
+  static constexpr uint32_t MaxCharge = 6;
+
+  ByteCode(const AST::Instruction::OpCode C) noexcept : Code(C) {}
+
+  /// Getter of the scalar constant value.
+  ValVariant getNum() const noexcept {
+    ValVariant Val;
+    std::memcpy(&Val, &Num, sizeof(Num));
+    return Val;
+  }
+
+  /// Setter of the scalar constant value.
+  void setNum(const ValVariant &Val) noexcept {
+    std::memcpy(&Num, &Val, sizeof(Num));
+  }
+
+  /// OpCode of this instruction.
+  AST::Instruction::OpCode Code;
+  /// Sub-opcode of the SIMD instruction.
+  AST::SIMDCode SubCode = AST::SIMDCode::V128__load;
+  /// Sub-opcode of the atomic memory instruction.
+  AST::AtomicCode AtomicSubCode = AST::AtomicCode::Memory__atomic__notify;
+  /// Counts of the original instructions charged before and after running
+  /// the register-based byte code.
+  uint8_t PreCharge = 0;
+  uint8_t PostCharge = 0;
+  /// Beginning of a straight-line block of the stack-based byte code.
+  bool BlockBegin = false;
+  /// Result arity of the branch target, or operand count of SIMD and atomic
+  /// memory instructions.
+  uint32_t Arity = 0;
+  /// Function, type, local, or global index, memory offset, the label table
+  /// size of `br_table`, the condition slot of register-based `select`, the
+  /// lane index of SIMD instruction, or the index of v128 constant.
+  uint32_t Index = 0;
+  /// Count of values under the results to be erased when branching.
+  uint32_t StackErase = 0;
+  /// Offset to the `Else` marker, or to the continuation if no else-statement.
+  int32_t JumpElse = 0;
+  /// Offset to the continuation of the structured instruction or the branch.
+  int32_t JumpEnd = 0;
+  /// Frame slot indices of the result and the operands of the register-based
+  /// byte code.
+  uint32_t Dst = 0;
+  uint32_t Src1 = 0;
+  uint32_t Src2 = 0;
+  /// Bytes of the scalar constant value, which are the leading bytes of the
+  /// value variant.
+  uint64_t Num = 0;
+};
+
+static_assert(sizeof(ByteCode) <= 48, "ByteCode should be kept small");
+
+/// Data of the block gas metering of an instruction.
+struct ByteCodeMeter {
+  /// Costs and count of the instructions in the straight-line block beginning
+  /// at this instruction. Zero if not the beginning of a block.
+  uint64_t BlockCost = 0;
+  uint32_t BlockCnt = 0;
+  /// Count and costs of the instructions after this one in its block.
+  uint32_t RemainCnt = 0;
+  uint64_t RemainCost = 0;
+};
+
+/// Byte code sequence of a function body or an expression with the side
+/// tables of the rare data.
+struct ByteCodeSeq {
+  using ChargeList = std::array<AST::Instruction::OpCode, ByteCode::MaxCharge>;
+
+  /// Instructions.
+  std::vector<ByteCode> Instrs;
+  /// Block gas metering of the stack-based byte code, in the same order of
+  /// the instructions.
+  std::vector<ByteCodeMeter> Meters;
+  /// OpCodes of the original instructions charged by the register-based byte
+  /// code, in the same order of the instructions.
+  std::vector<ChargeList> Charges;
+  /// v128 constants and the lane indices of `i8x16.shuffle`.
+  std::vector<uint128_t> V128;
+  /// Maximum height of value stack above the locals of the stack-based byte
+  /// code.
+  uint32_t MaxHeight = 0;
+};
+
+/// Superinstructions of the common instruction sequences.
+///
+/// The translator replaces the opcode of the first instruction in a sequence
+/// with the superinstruction opcode, which uses the opcode values not defined
+/// in the wasm spec. The following instructions of the sequence are kept as
+/// they are to provide the immediates and the jump targets inside.
+namespace SuperCode {
+using OpCode = AST::Instruction::OpCode;
+/// local.get x; i32.const c; i32.add
+constexpr OpCode LocalGetI32ConstI32Add = static_cast<OpCode>(0xE0);
+/// local.get x; i32.const c; i32.sub
+constexpr OpCode LocalGetI32ConstI32Sub = static_cast<OpCode>(0xE1);
+/// local.get x; i32.const c
+constexpr OpCode LocalGetI32Const = static_cast<OpCode>(0xE2);
+/// local.get x; local.get y
+constexpr OpCode LocalGetLocalGet = static_cast<OpCode>(0xE3);
+/// i32.const c; i32.add
+constexpr OpCode I32ConstI32Add = static_cast<OpCode>(0xE4);
+/// i32.lt_s; if
+constexpr OpCode I32LtSIf = static_cast<OpCode>(0xE5);
+/// i32.eqz; br_if l
+constexpr OpCode I32EqzBrIf = static_cast<OpCode>(0xE6);
+/// The first and the last superinstruction opcodes.
+constexpr OpCode Begin = LocalGetI32ConstI32Add;
+constexpr OpCode Last = I32EqzBrIf;
+
+/// Count of the instructions in the sequence of the superinstruction.
+constexpr uint32_t getLength(const OpCode Code) {
+  return (Code == LocalGetI32ConstI32Add || Code == LocalGetI32ConstI32Sub)
+             ? 3
+             : 2;
+}
+} // namespace SuperCode
+
+/// Opcodes only used in the register-based byte code.
+namespace RegCode {
+using OpCode = AST::Instruction::OpCode;
+/// Copy the value of slot Src1 to slot Dst.
+constexpr OpCode Mov = static_cast<OpCode>(0xF0);
+} // namespace RegCode
+
+/// Opcodes only used in the stack-based byte code of tiered execution.
+namespace TierCode {
+using OpCode = AST::Instruction::OpCode;
+/// Count the iteration of loop for the function of index Index, and replace
+/// the frame with the promoted function when it becomes hot. Dst is the order
+/// of the loop in the function. It is at the beginning of loop body, and is
+/// not charged.
+constexpr OpCode LoopHead = static_cast<OpCode>(0xF8);
+} // namespace TierCode
+
+} // namespace Runtime
+} // namespace SSVM
@@ -55,6 +55,9 @@ public:
   }
 
 protected:
+  /// Call the body with the arguments read from the stack slots directly.
+  /// The result is written in place of the first argument, and the stack is
+  /// truncated once.
   ErrCode invoke(StackManager &StackMgr, Instance::MemoryInstance &MemInst) {
     using H = Helper<decltype(&T::body)>;
     using ArgsT = typename H::ArgsT;
@@ -62,25 +65,9 @@ protected:
     if (StackMgr.size() < kSize) {
       return ErrCode::CallFunctionError;
     }
-    auto GeneralArguments = std::tie(*static_cast<T *>(this), MemInst);
-    auto Tuple = popTuple<ArgsT>(StackMgr, StackMgr.size() - kSize,
-                                 std::make_index_sequence<kSize>());
-
-    if constexpr (H::hasReturn) {
-      using RetT = typename H::RetT;
-      RetT Ret;
-      ErrCode Status =
-          std::apply(&T::body, std::tuple_cat(std::move(GeneralArguments),
-                                              std::tie(Ret), std::move(Tuple)));
-
-      StackMgr.push(Ret);
-      return Status;
-    } else {
-      ErrCode Status =
-          std::apply(&T::body, std::tuple_cat(std::move(GeneralArguments),
-                                              std::move(Tuple)));
-      return Status;
-    }
+    const uint32_t Base = StackMgr.size() - kSize;
+    return trampoline(StackMgr, MemInst, Base,
+                      std::make_index_sequence<kSize>());
   }
 
   void initializeFuncType() {
@@ -108,17 +95,28 @@ private:
     static inline constexpr const bool hasReturn = false;
   };
 
-  template <typename U>
-  static U getBottomN(StackManager &StackMgr, std::size_t N) {
-    return retrieveValue<U>(StackMgr.getBottomN(N));
-  }
-  template <typename Tuple, std::size_t... Indices>
-  static Tuple popTuple(StackManager &StackMgr, std::size_t N,
-                        std::index_sequence<Indices...>) {
-    Tuple Result(getBottomN<std::tuple_element_t<Indices, Tuple>>(
-        StackMgr, N + Indices)...);
-    ((StackMgr.pop(), (void)Indices), ...);
-    return Result;
+  template <std::size_t... Indices>
+  ErrCode trampoline(StackManager &StackMgr, Instance::MemoryInstance &MemInst,
+                     const uint32_t Base, std::index_sequence<Indices...>) {
+    using H = Helper<decltype(&T::body)>;
+    using ArgsT = typename H::ArgsT;
+    [[maybe_unused]] ValVariant *Args = &StackMgr.getBottomN(Base);
+    if constexpr (H::hasReturn) {
+      typename H::RetT Ret;
+      ErrCode Status = static_cast<T *>(this)->body(
+          MemInst, Ret,
+          retrieveValue<std::tuple_element_t<Indices, ArgsT>>(
+              Args[Indices])...);
+      StackMgr.resize(Base + 1);
+      StackMgr.getBottomN(Base) = Ret;
+      return Status;
+    } else {
+      ErrCode Status = static_cast<T *>(this)->body(
+          MemInst, retrieveValue<std::tuple_element_t<Indices, ArgsT>>(
+                       Args[Indices])...);
+      StackMgr.resize(Base);
+      return Status;
+    }
   }
   template <typename Tuple, std::size_t... Indices>
   void pushValType(std::index_sequence<Indices...>) {
@@ -13,9 +13,13 @@
 
 #include "common/ast/instruction.h"
 #include "module.h"
+#include "runtime/bytecode.h"
 #include "runtime/hostfunc.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -30,8 +34,12 @@ public:
   FunctionInstance(const uint32_t ModAddr, const FType &Type,
                    const std::vector<std::pair<uint32_t, ValType>> &Locs,
                    const AST::InstrVec &Expr)
-      : IsHostFunction(false), FuncType(Type), ModuleAddr(ModAddr),
-        Locals(Locs) {
+      : IsHostFunction(false), FuncType(Type),
+        TypeID(Instance::getTypeID(Type.Params, Type.Returns)),
+        ModuleAddr(ModAddr), Locals(Locs) {
+    for (auto &Def : Locals) {
+      LocalNum += Def.first;
+    }
     /// Copy instructions
     for (auto &It : Expr) {
       if (auto Res = makeInstructionNode(*It.get())) {
@@ -41,8 +49,9 @@ public:
   }
   /// Constructor for host function. Module address will not be used.
   FunctionInstance(std::unique_ptr<HostFunctionBase> &Func)
-      : IsHostFunction(true), FuncType(Func->getFuncType()), ModuleAddr(0),
-        HostFunc(std::move(Func)) {}
+      : IsHostFunction(true), FuncType(Func->getFuncType()),
+        TypeID(Instance::getTypeID(FuncType.Params, FuncType.Returns)),
+        ModuleAddr(0), HostFunc(std::move(Func)) {}
   virtual ~FunctionInstance() = default;
 
   /// Getter of checking is host function.
@@ -57,32 +66,137 @@ public:
   /// Getter of function type.
   const FType &getFuncType() const { return FuncType; }
 
+  /// Getter of process-wide function type ID.
+  uint32_t getTypeID() const { return TypeID; }
+
   /// Getter of function body instrs.
   const std::vector<std::pair<uint32_t, ValType>> &getLocals() const {
     return Locals;
   }
 
+  /// Getter of count of local variables excluding parameters.
+  uint32_t getLocalNum() const { return LocalNum; }
+
   /// Getter of function body instrs.
   const AST::InstrVec &getInstrs() const { return Instrs; }
 
+  /// Getter of translated function body byte code.
+  const ByteCodeSeq &getByteCode() const { return Code; }
+
+  /// Getter of count of values a frame of stack-based byte code pushes, which
+  /// are the locals and the maximum height of stack.
+  uint32_t getFrameSize() const { return LocalNum + Code.MaxHeight; }
+
+  /// Setter of translated function body byte code.
+  void setByteCode(ByteCodeSeq &&ByteCode) { Code = std::move(ByteCode); }
+
+  /// Getter of register-based function body byte code.
+  const ByteCodeSeq &getRegCode() const { return RegCode; }
+
+  /// Getter of count of frame slots for register-based byte code.
+  uint32_t getSlotNum() const { return SlotNum; }
+
+  /// Setter of register-based function body byte code and its slot count.
+  void setRegCode(ByteCodeSeq &&ByteCode, const uint32_t Num) {
+    RegCode = std::move(ByteCode);
+    SlotNum = Num;
+  }
+
+  /// \name Tiered execution of native function. The states are updated on the
+  /// shared function instance during execution, and may be accessed by
+  /// threads.
+  /// @{
+  /// Add the hotness of calls or loop iterations and return the sum. The sum
+  /// is not exact when threads add at the same time.
+  uint32_t addHotness(const uint32_t N) const {
+    const uint32_t Sum = Hotness.load(std::memory_order_relaxed) + N;
+    Hotness.store(Sum, std::memory_order_relaxed);
+    return Sum;
+  }
+
+  /// Check the function is promoted with the register-based byte code.
+  bool isPromoted() const {
+    return Tier.load(std::memory_order_acquire) == TierState::Promoted;
+  }
+
+  /// Take the promotion of the function. Only one thread succeeds.
+  bool takePromotion() const {
+    TierState Expected = TierState::Baseline;
+    return Tier.compare_exchange_strong(Expected, TierState::Promoting,
+                                        std::memory_order_acq_rel);
+  }
+
+  /// Give up the promotion taken, and wake up the waiting threads.
+  void cancelPromotion() const {
+    publishTier(TierState::Baseline);
+  }
+
+  /// Wait until the promotion taken by other thread is published or given up.
+  void waitPromotion() const {
+    std::unique_lock<std::mutex> Lock(PromotionMutex);
+    PromotionCond.wait(Lock, [this] {
+      return Tier.load(std::memory_order_acquire) != TierState::Promoting;
+    });
+  }
+
+  /// Publish the promoted register-based byte code, its slot count, and the
+  /// beginnings of its loop bodies.
+  void setPromotedCode(ByteCodeSeq &&ByteCode, const uint32_t Num,
+                       const std::vector<uint32_t> &Starts) const {
+    RegCode = std::move(ByteCode);
+    SlotNum = Num;
+    LoopStarts = Starts;
+    publishTier(TierState::Promoted);
+  }
+
+  /// Getter of the beginning of the loop body in the promoted byte code.
+  uint32_t getLoopStart(const uint32_t Loop) const { return LoopStarts[Loop]; }
+  /// @}
+
   /// Getter of host function.
   HostFunctionBase &getHostFunc() const { return *HostFunc.get(); }
 
 private:
   const bool IsHostFunction;
   const FType &FuncType;
+  const uint32_t TypeID;
 
   /// \name Data of function instance for native function.
   /// @{
   uint32_t ModuleAddr;
   const std::vector<std::pair<uint32_t, ValType>> Locals;
+  uint32_t LocalNum = 0;
   AST::InstrVec Instrs;
+  ByteCodeSeq Code;
+  /// Register-based byte code, which may be promoted in tiered execution.
+  mutable ByteCodeSeq RegCode;
+  mutable uint32_t SlotNum = 0;
+  /// @}
+
+  /// \name Data of function instance for tiered execution.
+  /// @{
+  enum class TierState : uint8_t { Baseline = 0, Promoting, Promoted };
+  mutable std::atomic<uint32_t> Hotness = 0;
+  mutable std::atomic<TierState> Tier = TierState::Baseline;
+  mutable std::vector<uint32_t> LoopStarts;
+  mutable std::mutex PromotionMutex;
+  mutable std::condition_variable PromotionCond;
   /// @}
 
   /// \name Data of function instance for host function.
   /// @{
   std::unique_ptr<HostFunctionBase> HostFunc;
   /// @}
+
+  /// Leave the promoting state. The state is stored under the lock, so that
+  /// the waiting threads do not miss the notification.
+  void publishTier(const TierState State) const {
+    {
+      std::lock_guard<std::mutex> Lock(PromotionMutex);
+      Tier.store(State, std::memory_order_release);
+    }
+    PromotionCond.notify_all();
+  }
 };
 
 } // namespace Instance
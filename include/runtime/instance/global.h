@@ -13,6 +13,7 @@
 
 #include "common/types.h"
 #include "common/value.h"
+#include "runtime/journal.h"
 
 namespace SSVM {
 namespace Runtime {
@@ -35,6 +36,27 @@ public:
   /// Getter of value.
   ValVariant &getValue() { return Value; };
 
+  /// Setter of value. The old value is recorded in checkpoints.
+  void setValue(const ValVariant &Val) {
+    if (ValueJournal.isActive() && ValueJournal.isFirstWrite(0)) {
+      ValueJournal.record(0, Value);
+    }
+    Value = Val;
+  }
+
+  /// Begin a checkpoint of the journal. The writes by `setValue()` are
+  /// recorded until commit or rollback.
+  void begin() { ValueJournal.begin(1); }
+
+  /// Commit the current checkpoint into the outer one.
+  void commit() { ValueJournal.commit(); }
+
+  /// Roll back the value in the current checkpoint.
+  void rollback() {
+    ValueJournal.rollback(
+        [this](const uint32_t, const ValVariant &Old) { Value = Old; });
+  }
+
 private:
   /// \name Data of global instance.
   /// @{
@@ -42,6 +64,9 @@ private:
   const ValMut Mut;
   ValVariant Value;
   /// @}
+
+  /// Journal of the value in checkpoints.
+  Journal<ValVariant> ValueJournal;
 };
 
 } // namespace Instance
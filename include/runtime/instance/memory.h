@@ -14,24 +14,217 @@
 #include "common/ast/type.h"
 #include "common/errcode.h"
 #include "common/value.h"
+#include "runtime/journal.h"
+#include "runtime/mempool.h"
 #include "support/casting.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 namespace SSVM {
 namespace Runtime {
 namespace Instance {
 
 class MemoryInstance {
 public:
+  /// Size of a page in bytes.
+  static inline constexpr const uint64_t PageSize = MemoryPool::PageSize;
+  /// Size of a page in dirty tracking and journal in bytes.
+  static inline constexpr const uint32_t DirtyPageSize = 4096;
+
+  /// The data of memory instance never moves when growing.
+  ///
+  /// The guarded memory is a region from `MemoryPool`, which reserves the
+  /// whole address range and the guard region with the inaccessible pages,
+  /// and the pages are committed when growing. The accesses to the guarded
+  /// memory can skip the boundary checking, and the out-of-bound ones are
+  /// trapped by `Support::Fault`. If the address space is not enough, only
+  /// the max pages are reserved, and the accesses should be checked.
   MemoryInstance() = delete;
   MemoryInstance(const AST::Limit &Lim)
-      : HasMaxPage(Lim.hasMax()), MinPage(Lim.getMin()), MaxPage(Lim.getMax()),
-        CurrPage(Lim.getMin()) {}
-  virtual ~MemoryInstance() = default;
+      : HasMaxPage(Lim.hasMax()), Shared(Lim.isShared()), MinPage(Lim.getMin()),
+        MaxPage(Lim.getMax()), CurrPage(Lim.getMin()) {
+    if ((Data = MemoryPool::getInstance().acquire(MinPage)) != nullptr) {
+      Guarded = true;
+      StoreUnchecked = true;
+      Reserved = MemoryPool::RegionSize;
+      return;
+    }
+    Reserved = (HasMaxPage ? std::max(MaxPage, 1U) : 65536U) * PageSize;
+    void *Ptr = mmap(nullptr, Reserved, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (Ptr == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    Data = static_cast<uint8_t *>(Ptr);
+    if (!commitPages(0, MinPage)) {
+      releasePages();
+      throw std::bad_alloc();
+    }
+  }
+  virtual ~MemoryInstance() { releasePages(); }
+
+  /// Clone the memory instance with the same limit and pages.
+  ///
+  /// The guarded memory takes an image of its pages into a memory file at the
+  /// first clone or when refreshed, and maps the image copy-on-write for both
+  /// itself and the clones. The pages are copied only when written, so the
+  /// clones are made without copying the data. The clones see the pages when
+  /// the image was taken or last updated by `trackDirtyPages()`. The memory
+  /// not guarded is copied.
+  ///
+  /// \param Refresh take a new image of the current pages.
+  ///
+  /// \returns the cloned memory instance, or ErrCode when failed.
+  Expect<std::unique_ptr<MemoryInstance>> clone(const bool Refresh = false) {
+    const AST::Limit Lim = HasMaxPage ? AST::Limit(MinPage, MaxPage, Shared)
+                                      : AST::Limit(MinPage);
+    auto Inst = std::make_unique<MemoryInstance>(Lim);
+    if (!Guarded || !Inst->Guarded) {
+      /// Copy the pages in use.
+      const uint32_t Page = CurrPage.load(std::memory_order_acquire);
+      if (auto Res = Inst->growPage(Page - MinPage); !Res) {
+        return Unexpect(Res);
+      }
+      std::memcpy(Inst->Data, Data, Page * PageSize);
+      return Inst;
+    }
+    if (ImageFd < 0 || Refresh) {
+      if (auto Res = makeImage(); !Res) {
+        return Unexpect(Res);
+      }
+    }
+    if (ImagePages > 0) {
+      if (mmap(Inst->Data, ImagePages * PageSize, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_FIXED, ImageFd, 0) == MAP_FAILED) {
+        return Unexpect(ErrCode::InstantiateFailed);
+      }
+    }
+    Inst->CurrPage.store(ImagePages, std::memory_order_release);
+    Inst->MappedPages = ImagePages;
+    ImageCloned = true;
+    return Inst;
+  }
+
+  /// Start tracking the pages written from now on.
+  ///
+  /// The current pages become the base. The guarded memory maps an image of
+  /// them copy-on-write, so that the written pages are the ones no longer
+  /// backed by the image file in `/proc/self/pagemap`. The clear of soft-dirty
+  /// bits is process-wide, so it is not used. The memory not guarded keeps a
+  /// copy of the base pages instead.
+  ///
+  /// The image is taken once. When tracking again, only the dirty pages are
+  /// written back into the image and mapped from it again, so the cost is in
+  /// the size of the delta rather than the memory. The image mapped by the
+  /// clones is not updated, and a new one is taken instead.
+  Expect<void> trackDirtyPages() {
+    if (!Guarded) {
+      const std::vector<uint32_t> Pages = getDirtyPages();
+      BaseCopy.resize(getDataSize());
+      for (const uint32_t I : Pages) {
+        const uint64_t Offset = uint64_t(I) * DirtyPageSize;
+        std::memcpy(&BaseCopy[Offset], Data + Offset, DirtyPageSize);
+      }
+    } else if (!Tracking || ImageFd < 0 || ImageCloned ||
+               MappedPages < ImagePages) {
+      if (auto Res = makeImage(); !Res) {
+        return Unexpect(Res);
+      }
+    } else if (auto Res = updateImage(); !Res) {
+      return Unexpect(Res);
+    }
+    Tracking = true;
+    return {};
+  }
+
+  /// Get the pages written since `trackDirtyPages()`.
+  ///
+  /// The pages are in DirtyPageSize bytes. The grown pages are compared with
+  /// the zero pages. If the pagemap is not available, the pages are compared
+  /// with the base. All pages in use are dirty if not tracking.
+  ///
+  /// \returns the sorted indices of the dirty pages.
+  std::vector<uint32_t> getDirtyPages() const {
+    const uint32_t Cnt = getDataSize() / DirtyPageSize;
+    std::vector<uint32_t> Pages;
+    if (!Tracking) {
+      Pages.resize(Cnt);
+      for (uint32_t I = 0; I < Cnt; ++I) {
+        Pages[I] = I;
+      }
+      return Pages;
+    }
+    if (Guarded && getMappedDirtyPages(Cnt, Pages)) {
+      return Pages;
+    }
+    Pages.clear();
+    uint8_t Base[DirtyPageSize];
+    const uint64_t BaseSize =
+        Guarded ? ImagePages * PageSize : uint64_t(BaseCopy.size());
+    for (uint32_t I = 0; I < Cnt; ++I) {
+      const uint64_t Offset = uint64_t(I) * DirtyPageSize;
+      if (Offset >= BaseSize) {
+        std::memset(Base, 0, DirtyPageSize);
+      } else if (Guarded) {
+        if (pread(ImageFd, Base, DirtyPageSize, Offset) !=
+            static_cast<ssize_t>(DirtyPageSize)) {
+          Pages.push_back(I);
+          continue;
+        }
+      } else {
+        std::memcpy(Base, &BaseCopy[Offset], DirtyPageSize);
+      }
+      if (std::memcmp(Data + Offset, Base, DirtyPageSize) != 0) {
+        Pages.push_back(I);
+      }
+    }
+    return Pages;
+  }
+
+  /// Begin a checkpoint of the journal.
+  ///
+  /// The pages are recorded at their first writes until commit or rollback.
+  /// The writes through the pointers of `getPointer()` are only recorded for
+  /// the pointed objects. The shared memory should not be written by other
+  /// threads in checkpoints.
+  void begin() {
+    PageJournal.begin(getDataSize() / DirtyPageSize);
+    StoreUnchecked = false;
+  }
+
+  /// Commit the current checkpoint into the outer one.
+  void commit() {
+    PageJournal.commit();
+    StoreUnchecked = Guarded && !PageJournal.isActive();
+  }
+
+  /// Roll back the writes and the grown pages in the current checkpoint.
+  void rollback() {
+    const uint32_t Size = PageJournal.rollback(
+        [this](const uint32_t Idx, const PageRecord &Old) {
+          std::memcpy(Data + uint64_t(Idx) * DirtyPageSize, Old.data(),
+                      DirtyPageSize);
+        });
+    shrinkPage(Size / (PageSize / DirtyPageSize));
+    StoreUnchecked = Guarded && !PageJournal.isActive();
+  }
+
+  /// Getter of the count of nested checkpoints.
+  uint32_t getCheckpointDepth() const { return PageJournal.getDepth(); }
 
   /// Get page size of memory.data
   uint32_t getDataPageSize() const { return CurrPage; }
@@ -45,6 +238,16 @@ public:
   /// Getter of limit definition.
   uint32_t getMax() const { return MaxPage; }
 
+  /// Getter of shared flag.
+  bool isShared() const { return Shared; }
+
+  /// Getter of guarded flag.
+  bool isGuarded() const { return Guarded; }
+
+  /// Check if the stores can use `storeValueUnchecked()`. The guarded memory
+  /// stores by `storeValue()` in checkpoints, which records the pages.
+  bool canStoreUnchecked() const { return StoreUnchecked; }
+
   /// Check is out of bound.
   bool checkAccessBound(const uint32_t Offset) {
     return checkDataSize(Offset, 0);
@@ -52,16 +255,30 @@ public:
 
   /// Grow page
   Expect<void> growPage(const uint32_t Count) {
-    if ((HasMaxPage && Count + CurrPage > MaxPage) ||
-        Count + CurrPage > 65536) {
+    std::unique_lock<std::mutex> Lock(GrowMutex, std::defer_lock);
+    if (Shared) {
+      Lock.lock();
+    }
+    const uint32_t Page = CurrPage.load(std::memory_order_relaxed);
+    const uint64_t NewPage = static_cast<uint64_t>(Page) + Count;
+    if ((HasMaxPage && NewPage > MaxPage) || NewPage > 65536) {
+      return Unexpect(ErrCode::MemorySizeExceeded);
+    }
+    /// Commit the new pages before publishing them.
+    if (!commitPages(Page, Count)) {
       return Unexpect(ErrCode::MemorySizeExceeded);
     }
-    CurrPage += Count;
+    CurrPage.store(Page + Count, std::memory_order_release);
     return {};
   }
 
-  /// Get memory length.
-  const Bytes &getDataVector() const { return Data; }
+  /// Getter of the data of all pages in use.
+  const uint8_t *getDataPtr() const { return Data; }
+
+  /// Getter of the size of all pages in use in bytes.
+  uint64_t getDataSize() const {
+    return CurrPage.load(std::memory_order_acquire) * PageSize;
+  }
 
   /// Get slice of Data[Offset : Offset + Length - 1]
   Expect<Bytes> getBytes(const uint32_t Offset, const uint32_t Length) {
@@ -72,8 +289,7 @@ public:
     Bytes Slice;
     if (Length > 0) {
       Slice.resize(Length);
-      std::copy(Data.begin() + Offset, Data.begin() + Offset + Length,
-                Slice.begin());
+      std::copy(Data + Offset, Data + Offset + Length, Slice.begin());
     }
     return Slice;
   }
@@ -94,8 +310,9 @@ public:
 
     /// Copy data.
     if (Length > 0) {
+      recordPages(Offset, Length);
       std::copy(Slice.begin() + Start, Slice.begin() + Start + Length,
-                Data.begin() + Offset);
+                Data + Offset);
     }
     return {};
   }
@@ -114,7 +331,7 @@ public:
           Arr[I] = Data[Offset + Length - I - 1];
         }
       } else {
-        std::copy(Data.begin() + Offset, Data.begin() + Offset + Length, Arr);
+        std::copy(Data + Offset, Data + Offset + Length, Arr);
       }
     }
     return {};
@@ -128,25 +345,58 @@ public:
       return Unexpect(ErrCode::MemorySizeExceeded);
     }
     if (Length > 0) {
+      recordPages(Offset, Length);
       /// Copy data.
       if (IsReverse) {
         for (uint32_t I = 0; I < Length; I++) {
           Data[Offset + Length - I - 1] = Arr[I];
         }
       } else {
-        std::copy(Arr, Arr + Length, Data.begin() + Offset);
+        std::copy(Arr, Arr + Length, Data + Offset);
       }
     }
     return {};
   }
 
+  /// Copy Data[Src : Src + Length - 1] to Data[Dst : Dst + Length - 1]
+  ///
+  /// The two ranges may overlap. Both ranges are checked before any byte is
+  /// moved, so a trapped copy leaves the memory untouched.
+  Expect<void> copyBytes(const uint32_t Dst, const uint32_t Src,
+                         const uint32_t Length) {
+    /// Check memory boundary.
+    if (!checkDataSize(Dst, Length) || !checkDataSize(Src, Length)) {
+      return Unexpect(ErrCode::MemorySizeExceeded);
+    }
+    if (Length > 0) {
+      recordPages(Dst, Length);
+      std::memmove(&Data[Dst], &Data[Src], Length);
+    }
+    return {};
+  }
+
+  /// Fill Data[Offset : Offset + Length - 1] with the byte Val.
+  Expect<void> fillBytes(const uint32_t Offset, const uint8_t Val,
+                         const uint32_t Length) {
+    /// Check memory boundary.
+    if (!checkDataSize(Offset, Length)) {
+      return Unexpect(ErrCode::MemorySizeExceeded);
+    }
+    if (Length > 0) {
+      recordPages(Offset, Length);
+      std::memset(&Data[Offset], Val, Length);
+    }
+    return {};
+  }
+
   /// Get pointer to specific offset of memory or null.
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
   getPointerOrNull(const uint32_t Offset) {
-    if (Offset >= Data.size() || Offset == 0) {
+    if (Offset >= getDataSize() || Offset == 0) {
       return nullptr;
     }
+    recordPointee<T>(Offset);
     return reinterpret_cast<T>(&Data[Offset]);
   }
 
@@ -154,12 +404,98 @@ public:
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
   getPointer(const uint32_t Offset) {
-    if (Offset >= Data.size()) {
+    if (Offset >= getDataSize()) {
       return nullptr;
     }
+    recordPointee<T>(Offset);
     return reinterpret_cast<T>(&Data[Offset]);
   }
 
+  /// Get pointer to the integer at Data[Offset] for the atomic accesses.
+  ///
+  /// The offset should be aligned to the size of T.
+  template <typename T>
+  typename std::enable_if_t<std::is_integral_v<T>, Expect<T *>>
+  getAtomicPointer(const uint32_t Offset) {
+    /// Check memory boundary.
+    if (!checkDataSize(Offset, sizeof(T))) {
+      return Unexpect(ErrCode::MemorySizeExceeded);
+    }
+    /// Check alignment.
+    if (Offset % sizeof(T) != 0) {
+      return Unexpect(ErrCode::UnalignedAtomicAccess);
+    }
+    recordPages(Offset, sizeof(T));
+    return reinterpret_cast<T *>(&Data[Offset]);
+  }
+
+  /// Block the thread until notified if the integer at Data[Offset] equals to
+  /// Expected.
+  ///
+  /// \param Offset the start offset in data array.
+  /// \param Expected the value to compare with.
+  /// \param Timeout the timeout in nanoseconds. Negative for no timeout.
+  ///
+  /// \returns 0 when woken, 1 when not equal, 2 when timed out, and ErrCode
+  /// when trapped.
+  template <typename T>
+  typename std::enable_if_t<std::is_integral_v<T>, Expect<uint32_t>>
+  atomicWait(const uint32_t Offset, const T Expected, const int64_t Timeout) {
+    /// Only the shared memory can be waited on.
+    if (!Shared) {
+      return Unexpect(ErrCode::ExpectSharedMemory);
+    }
+    T *Ptr;
+    if (auto Res = getAtomicPointer<T>(Offset)) {
+      Ptr = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+
+    /// Compare under the lock so that the notify after the store will not be
+    /// missed.
+    std::unique_lock<std::mutex> Lock(WaitMutex);
+    if (__atomic_load_n(Ptr, __ATOMIC_SEQ_CST) != Expected) {
+      return 1;
+    }
+    Waiter W;
+    auto Iter = Waiters.emplace(Offset, &W);
+    const auto IsNotified = [&W]() { return W.Notified; };
+    if (Timeout < 0) {
+      W.CV.wait(Lock, IsNotified);
+    } else {
+      W.CV.wait_for(Lock, std::chrono::nanoseconds(Timeout), IsNotified);
+    }
+    if (!W.Notified) {
+      Waiters.erase(Iter);
+      return 2;
+    }
+    return 0;
+  }
+
+  /// Wake up at most Count threads waiting on Data[Offset].
+  ///
+  /// \returns the number of woken threads, or ErrCode when trapped.
+  Expect<uint32_t> atomicNotify(const uint32_t Offset, const uint32_t Count) {
+    if (auto Res = getAtomicPointer<uint32_t>(Offset); !Res) {
+      return Unexpect(Res);
+    }
+    /// No thread can wait on the memory not shared.
+    if (!Shared) {
+      return 0;
+    }
+    std::unique_lock<std::mutex> Lock(WaitMutex);
+    uint32_t Woken = 0;
+    auto Iter = Waiters.lower_bound(Offset);
+    while (Woken < Count && Iter != Waiters.end() && Iter->first == Offset) {
+      Iter->second->Notified = true;
+      Iter->second->CV.notify_one();
+      Iter = Waiters.erase(Iter);
+      ++Woken;
+    }
+    return Woken;
+  }
+
   /// Template of loading bytes and convert to a value.
   ///
   /// Load the length of vector and construct into a value.
@@ -182,25 +518,35 @@ public:
     if (!checkDataSize(Offset, Length)) {
       return Unexpect(ErrCode::MemorySizeExceeded);
     }
-    /// Load data to a value.
     if (Length > 0) {
-      if (std::is_floating_point_v<T>) {
-        /// Floating case. Do memory copy.
-        std::memcpy(&Value, &Data[Offset], sizeof(T));
-      } else {
-        uint64_t LoadVal = 0;
-        /// Integer case. Extends to result type.
-        std::memcpy(&LoadVal, &Data[Offset], Length);
-        if (std::is_signed_v<T> && (LoadVal >> (Length * 8 - 1))) {
-          /// Signed extend.
-          for (unsigned int I = Length; I < 8; I++) {
-            LoadVal |= 0xFFULL << (I * 8);
-          }
+      loadValueUnchecked(Value, Offset, Length);
+    }
+    return {};
+  }
+
+  /// Template of loading bytes without checking the boundary.
+  ///
+  /// Only for the guarded memory, and the out-of-bound accesses are trapped by
+  /// the fault handler. The length should be in [1, sizeof(T)].
+  template <typename T>
+  typename std::enable_if_t<Support::IsWasmTypeV<T>, void>
+  loadValueUnchecked(T &Value, const uint32_t Offset, const uint32_t Length) {
+    /// Load data to a value.
+    if (std::is_floating_point_v<T>) {
+      /// Floating case. Do memory copy.
+      std::memcpy(&Value, &Data[Offset], sizeof(T));
+    } else {
+      uint64_t LoadVal = 0;
+      /// Integer case. Extends to result type.
+      std::memcpy(&LoadVal, &Data[Offset], Length);
+      if (std::is_signed_v<T> && (LoadVal >> (Length * 8 - 1))) {
+        /// Signed extend.
+        for (unsigned int I = Length; I < 8; I++) {
+          LoadVal |= 0xFFULL << (I * 8);
         }
-        Value = static_cast<T>(LoadVal);
       }
+      Value = static_cast<T>(LoadVal);
     }
-    return {};
   }
 
   /// Template of loading bytes and convert to a value.
@@ -224,45 +570,307 @@ public:
     if (!checkDataSize(Offset, Length)) {
       return Unexpect(ErrCode::MemorySizeExceeded);
     }
-    /// Copy store data to value.
     if (Length > 0) {
-      std::memcpy(&Data[Offset], &Value, Length);
+      recordPages(Offset, Length);
+      storeValueUnchecked(Value, Offset, Length);
     }
     return {};
   }
 
+  /// Template of storing a value without checking the boundary.
+  ///
+  /// Only for the guarded memory, and the out-of-bound accesses are trapped by
+  /// the fault handler. The writes are not journaled, so it is only for the
+  /// memory with `canStoreUnchecked()`. The length should be in
+  /// [1, sizeof(T)].
+  template <typename T>
+  typename std::enable_if_t<Support::IsWasmBuiltInV<T>, void>
+  storeValueUnchecked(const T &Value, const uint32_t Offset,
+                      const uint32_t Length) {
+    /// Copy store data to value. Every length is stored at once, so that the
+    /// store across the end of memory writes nothing before trapped.
+    switch (Length) {
+    case 1:
+      storeBytes<uint8_t>(Value, Offset);
+      break;
+    case 2:
+      storeBytes<uint16_t>(Value, Offset);
+      break;
+    case 4:
+      storeBytes<uint32_t>(Value, Offset);
+      break;
+    default:
+      if constexpr (sizeof(T) == 8) {
+        storeBytes<uint64_t>(Value, Offset);
+      }
+      break;
+    }
+  }
+
 private:
-  /// Check access size is valid and adjust vector.
-  bool checkDataSize(uint32_t Offset, uint32_t Length) {
-    uint64_t AccessLen =
-        static_cast<uint64_t>(Offset) + static_cast<uint64_t>(Length);
-    if (AccessLen > CurrPage * 65536ULL) {
+  /// Check access size is valid.
+  bool checkDataSize(uint32_t Offset, uint32_t Length) const {
+    return static_cast<uint64_t>(Offset) + static_cast<uint64_t>(Length) <=
+           CurrPage.load(std::memory_order_acquire) * PageSize;
+  }
+
+  /// Store the lowest bytes of the value with the unsigned type U.
+  template <typename U, typename T>
+  void storeBytes(const T &Value, const uint32_t Offset) {
+    U Val;
+    std::memcpy(&Val, &Value, sizeof(U));
+    std::memcpy(&Data[Offset], &Val, sizeof(U));
+  }
+
+  /// Record the pages of Data[Offset : Offset + Length - 1] at their first
+  /// writes in the current checkpoint. The out-of-bound ones are trapped.
+  void recordPages(const uint32_t Offset, const uint32_t Length) {
+    if (!PageJournal.isActive() || !checkDataSize(Offset, Length) ||
+        Length == 0) {
+      return;
+    }
+    const uint32_t Last = (uint64_t(Offset) + Length - 1) / DirtyPageSize;
+    for (uint32_t I = Offset / DirtyPageSize; I <= Last; ++I) {
+      if (PageJournal.isFirstWrite(I)) {
+        PageRecord Old;
+        std::memcpy(Old.data(), Data + uint64_t(I) * DirtyPageSize,
+                    DirtyPageSize);
+        PageJournal.record(I, Old);
+      }
+    }
+  }
+
+  /// Record the object pointed by the pointer type T at Data[Offset].
+  template <typename T> void recordPointee(const uint32_t Offset) {
+    using U = std::remove_pointer_t<T>;
+    if constexpr (!std::is_const_v<U> && !std::is_void_v<U>) {
+      const uint64_t Size = std::min(uint64_t(sizeof(U)),
+                                     getDataSize() - uint64_t(Offset));
+      recordPages(Offset, static_cast<uint32_t>(Size));
+    }
+  }
+
+  /// Drop the pages from the Page-th page in rollback. The dropped pages are
+  /// reserved again, and are zero pages when grown again.
+  void shrinkPage(const uint32_t Page) {
+    const uint32_t Curr = CurrPage.load(std::memory_order_relaxed);
+    if (Page >= Curr) {
+      return;
+    }
+    CurrPage.store(Page, std::memory_order_release);
+    mmap(Data + Page * PageSize, (Curr - Page) * PageSize, PROT_NONE,
+         MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1, 0);
+    MappedPages = std::min(MappedPages, Page);
+  }
+
+  /// Make the Count pages from the Page-th page accessible.
+  bool commitPages(const uint32_t Page, const uint32_t Count) {
+    if (Count == 0) {
+      return true;
+    }
+    return mprotect(Data + Page * PageSize, Count * PageSize,
+                    PROT_READ | PROT_WRITE) == 0;
+  }
+
+  /// Look up the pages not backed by the image file from the pagemap. The
+  /// written pages are copied on write into the anonymous pages, which are
+  /// present or swapped.
+  ///
+  /// \returns false if the pagemap is not available.
+  bool getMappedDirtyPages(const uint32_t Cnt,
+                           std::vector<uint32_t> &Pages) const {
+    if (sysconf(_SC_PAGESIZE) != DirtyPageSize) {
       return false;
     }
-    /// Note: the vector size will <= CurrPage * 65536
-    if (Data.size() < Offset + Length) {
-      uint32_t TargetSize = (Offset + Length) / 8 + 1;
-      if (TargetSize < 32 * 65536) {
-        TargetSize *= 2;
-      } else {
-        TargetSize *= 1.1;
+    const int Fd = open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (Fd < 0) {
+      return false;
+    }
+    constexpr const uint64_t Present = 1ULL << 63;
+    constexpr const uint64_t Swapped = 1ULL << 62;
+    constexpr const uint64_t FilePage = 1ULL << 61;
+    uint64_t Entries[512];
+    const uint64_t First = reinterpret_cast<uintptr_t>(Data) / DirtyPageSize;
+    for (uint32_t I = 0; I < Cnt; I += 512) {
+      const uint32_t Num = std::min(Cnt - I, 512U);
+      const ssize_t Size = Num * sizeof(uint64_t);
+      if (pread(Fd, Entries, Size, (First + I) * sizeof(uint64_t)) != Size) {
+        close(Fd);
+        return false;
       }
-      if (TargetSize * 8 > CurrPage * 65536) {
-        Data.resize(CurrPage * 65536);
-      } else {
-        Data.resize(TargetSize * 8);
+      for (uint32_t J = 0; J < Num; ++J) {
+        const uint64_t E = Entries[J];
+        if (!(E & Swapped) && (!(E & Present) || (E & FilePage))) {
+          continue;
+        }
+        /// The grown pages only read are mapped to the zero page.
+        const uint64_t Offset = uint64_t(I + J) * DirtyPageSize;
+        if (Offset >= ImagePages * PageSize &&
+            std::all_of(Data + Offset, Data + Offset + DirtyPageSize,
+                        [](const uint8_t B) { return B == 0; })) {
+          continue;
+        }
+        Pages.push_back(I + J);
       }
     }
+    close(Fd);
     return true;
   }
 
+  /// Take an image of the pages in use into a memory file, and map it
+  /// copy-on-write in place. The zero pages are left as holes of the file.
+  ///
+  /// If nothing is mapped from an image yet, the pages never written are not
+  /// present in the pagemap, so only the present ones are copied, and the
+  /// cost is in the written pages rather than the memory.
+  Expect<void> makeImage() {
+    if (ImageFd >= 0) {
+      close(ImageFd);
+      ImageFd = -1;
+    }
+    const uint32_t Page = CurrPage.load(std::memory_order_acquire);
+    const int Fd = memfd_create("ssvm-memory", MFD_CLOEXEC);
+    if (Fd < 0) {
+      return Unexpect(ErrCode::InstantiateFailed);
+    }
+    static const uint8_t Zeros[PageSize] = {};
+    bool Failed = ftruncate(Fd, Page * PageSize) != 0;
+    std::vector<uint32_t> Pages;
+    if (MappedPages == 0 &&
+        getMappedDirtyPages(Page * (PageSize / DirtyPageSize), Pages)) {
+      for (uint32_t I = 0; I < Pages.size() && !Failed; ++I) {
+        const uint64_t Offset = uint64_t(Pages[I]) * DirtyPageSize;
+        Failed = pwrite(Fd, Data + Offset, DirtyPageSize, Offset) !=
+                 static_cast<ssize_t>(DirtyPageSize);
+      }
+    } else {
+      for (uint32_t I = 0; I < Page && !Failed; ++I) {
+        const uint8_t *Src = Data + I * PageSize;
+        if (std::memcmp(Src, Zeros, PageSize) != 0) {
+          Failed = pwrite(Fd, Src, PageSize, I * PageSize) !=
+                   static_cast<ssize_t>(PageSize);
+        }
+      }
+    }
+    if (!Failed && Page > 0) {
+      Failed = mmap(Data, Page * PageSize, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_FIXED, Fd, 0) == MAP_FAILED;
+    }
+    if (Failed) {
+      close(Fd);
+      return Unexpect(ErrCode::InstantiateFailed);
+    }
+    ImageFd = Fd;
+    ImagePages = Page;
+    MappedPages = Page;
+    ImageCloned = false;
+    return {};
+  }
+
+  /// Write the dirty pages back into the image, and map them and the grown
+  /// pages from it copy-on-write again. The pages not written are unchanged
+  /// in both the image and the mapping.
+  Expect<void> updateImage() {
+    const uint32_t Page = CurrPage.load(std::memory_order_acquire);
+    const std::vector<uint32_t> Pages = getDirtyPages();
+    bool Failed = Page > ImagePages && ftruncate(ImageFd, Page * PageSize) != 0;
+    for (uint32_t I = 0; I < Pages.size() && !Failed; ++I) {
+      const uint64_t Offset = uint64_t(Pages[I]) * DirtyPageSize;
+      Failed = pwrite(ImageFd, Data + Offset, DirtyPageSize, Offset) !=
+               static_cast<ssize_t>(DirtyPageSize);
+    }
+    /// Map the contiguous dirty pages in the image at once.
+    const uint64_t ImageSize = ImagePages * PageSize;
+    for (uint32_t Begin = 0; Begin < Pages.size() && !Failed;) {
+      const uint64_t Offset = uint64_t(Pages[Begin]) * DirtyPageSize;
+      if (Offset >= ImageSize) {
+        break;
+      }
+      uint32_t End = Begin + 1;
+      while (End < Pages.size() && Pages[End] == Pages[End - 1] + 1 &&
+             uint64_t(Pages[End]) * DirtyPageSize < ImageSize) {
+        ++End;
+      }
+      Failed = mmap(Data + Offset, (End - Begin) * DirtyPageSize,
+                    PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, ImageFd,
+                    Offset) == MAP_FAILED;
+      Begin = End;
+    }
+    if (!Failed && Page > ImagePages) {
+      Failed = mmap(Data + ImageSize, (Page - ImagePages) * PageSize,
+                    PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, ImageFd,
+                    ImageSize) == MAP_FAILED;
+    }
+    if (Failed) {
+      /// The mapping may be partially updated. Take a new image instead.
+      return makeImage();
+    }
+    ImagePages = Page;
+    MappedPages = Page;
+    return {};
+  }
+
+  /// Release the reserved address range. The guarded one is back to pool
+  /// after the pages mapped from image are replaced by the anonymous ones.
+  void releasePages() {
+    if (ImageFd >= 0) {
+      close(ImageFd);
+    }
+    if (!Guarded) {
+      munmap(Data, Reserved);
+      return;
+    }
+    if (MappedPages > 0 &&
+        mmap(Data, MappedPages * PageSize, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE, -1,
+             0) == MAP_FAILED) {
+      /// Not reusable. Keep the region reserved.
+      return;
+    }
+    MemoryPool::getInstance().release(Data, CurrPage);
+  }
+
   /// \name Data of memory instance.
   /// @{
   const bool HasMaxPage;
+  const bool Shared;
   const uint32_t MinPage;
   const uint32_t MaxPage;
-  uint32_t CurrPage;
-  Bytes Data;
+  std::atomic<uint32_t> CurrPage;
+  bool Guarded = false;
+  /// Guarded and no checkpoint is active.
+  bool StoreUnchecked = false;
+  uint64_t Reserved;
+  uint8_t *Data;
+  /// @}
+
+  /// \name Data of the image for cloning and dirty tracking.
+  /// @{
+  /// Memory file of the image, and its size in pages.
+  int ImageFd = -1;
+  uint32_t ImagePages = 0;
+  /// The image is mapped by the clones and should not be updated.
+  bool ImageCloned = false;
+  /// Count of the pages from the beginning mapped from an image.
+  uint32_t MappedPages = 0;
+  /// Tracking dirty pages, and the base pages if not guarded.
+  bool Tracking = false;
+  std::vector<uint8_t> BaseCopy;
+  /// @}
+
+  /// Journal of the pages in checkpoints.
+  using PageRecord = std::array<uint8_t, DirtyPageSize>;
+  Journal<PageRecord> PageJournal;
+
+  /// \name Synchronization of shared memory.
+  /// @{
+  struct Waiter {
+    std::condition_variable CV;
+    bool Notified = false;
+  };
+  std::mutex GrowMutex;
+  std::mutex WaitMutex;
+  std::multimap<uint32_t, Waiter *> Waiters;
   /// @}
 };
 
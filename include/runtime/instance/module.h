@@ -15,26 +15,71 @@
 #include "common/types.h"
 #include "type.h"
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 namespace SSVM {
 namespace Runtime {
+
+class StoreManager;
+
 namespace Instance {
 
+class FunctionInstance;
+class TableInstance;
+class MemoryInstance;
+class GlobalInstance;
+
 class ModuleInstance {
 public:
+  /// Data segment for memory.init. The bytes are kept when dropped, for the
+  /// other threads may be initializing memories from them. The dropped
+  /// segment is taken as empty.
+  struct DataSegment {
+    DataSegment(const Bytes &B, const bool D = false) : Data(B), Dropped(D) {}
+    const Bytes Data;
+    std::atomic<bool> Dropped;
+
+    /// Getter of the size of segment, which is 0 after dropped.
+    uint32_t getSize() const {
+      return Dropped.load(std::memory_order_acquire) ? 0 : Data.size();
+    }
+
+    /// Drop the segment.
+    void drop() { Dropped.store(true, std::memory_order_release); }
+  };
+
   ModuleInstance(const std::string &Name) : ModName(Name) {}
+  /// Copy the module instance and its data segments for cloning store. The
+  /// instances should be resolved again in the new store.
+  ModuleInstance(const ModuleInstance &Inst)
+      : Addr(Inst.Addr), ModName(Inst.ModName), FuncTypes(Inst.FuncTypes),
+        FuncTypeIDs(Inst.FuncTypeIDs), FuncAddrs(Inst.FuncAddrs),
+        TableAddrs(Inst.TableAddrs), MemAddrs(Inst.MemAddrs),
+        GlobalAddrs(Inst.GlobalAddrs), ExpFuncs(Inst.ExpFuncs),
+        ExpTables(Inst.ExpTables), ExpMems(Inst.ExpMems),
+        ExpGlobals(Inst.ExpGlobals), HasStartFunc(Inst.HasStartFunc),
+        StartAddr(Inst.StartAddr) {
+    Datas.reserve(Inst.Datas.size());
+    for (const auto &Data : Inst.Datas) {
+      Datas.push_back(std::make_unique<DataSegment>(
+          Data->Data, Data->Dropped.load(std::memory_order_acquire)));
+    }
+  }
+  ModuleInstance &operator=(const ModuleInstance &) = delete;
   ~ModuleInstance() = default;
 
   const std::string &getModuleName() const { return ModName; }
 
   /// Copy the function types in type section to module instance.
   void addFuncType(const std::vector<ValType> &Params,
-                   const std::vector<ValType> &Returns) {
+                   const std::vector<ValType> &Returns, const uint32_t TypeID) {
     FuncTypes.emplace_back(Params, Returns);
+    FuncTypeIDs.push_back(TypeID);
   }
 
   /// Map the external instences between Module and Store.
@@ -45,6 +90,11 @@ public:
     GlobalAddrs.push_back(GlobAddr);
   }
 
+  /// Copy the data segments to module instance.
+  void addData(const Bytes &Data) {
+    Datas.push_back(std::make_unique<DataSegment>(Data));
+  }
+
   /// Exports functions.
   void exportFuncion(const std::string &Name, const uint32_t Idx) {
     ExpFuncs[Name] = FuncAddrs[Idx];
@@ -80,6 +130,14 @@ public:
     }
     return &FuncTypes[Idx];
   }
+
+  /// Get the store-wide function type ID by index.
+  Expect<uint32_t> getFuncTypeID(const uint32_t Idx) const {
+    if (Idx >= FuncTypeIDs.size()) {
+      return Unexpect(ErrCode::WrongInstanceAddress);
+    }
+    return FuncTypeIDs[Idx];
+  }
   /// Get the external values by index. Addr will be address in Store.
   Expect<uint32_t> getFuncAddr(const uint32_t Idx) const {
     if (Idx >= FuncAddrs.size()) {
@@ -106,11 +164,24 @@ public:
     return GlobalAddrs[Idx];
   }
 
+  /// Unsafe getters of the resolved instances by index. The instance pointers
+  /// are resolved by store manager when the instantiation is done.
+  FunctionInstance *getFunc(const uint32_t Idx) const { return FuncInsts[Idx]; }
+  TableInstance *getTable(const uint32_t Idx) const { return TabInsts[Idx]; }
+  MemoryInstance *getMemory(const uint32_t Idx) const { return MemInsts[Idx]; }
+  GlobalInstance *getGlobal(const uint32_t Idx) const {
+    return GlobInsts[Idx];
+  }
+
+  /// Unsafe getter of the data segment by index.
+  DataSegment *getData(const uint32_t Idx) const { return Datas[Idx].get(); }
+
   /// Get the added external values' numbers.
   uint32_t getFuncNum() const { return FuncAddrs.size(); }
   uint32_t getTableNum() const { return TableAddrs.size(); }
   uint32_t getMemNum() const { return MemAddrs.size(); }
   uint32_t getGlobalNum() const { return GlobalAddrs.size(); }
+  uint32_t getDataNum() const { return Datas.size(); }
 
   /// Set start function index and find the address in Store.
   void setStartIdx(const uint32_t Idx) {
@@ -136,12 +207,25 @@ private:
   /// Function types.
   std::vector<FType> FuncTypes;
 
+  /// Process-wide IDs of function types.
+  std::vector<uint32_t> FuncTypeIDs;
+
+  /// Data segments for memory.init.
+  std::vector<std::unique_ptr<DataSegment>> Datas;
+
   /// Elements address index in this module in Store.
   std::vector<uint32_t> FuncAddrs;
   std::vector<uint32_t> TableAddrs;
   std::vector<uint32_t> MemAddrs;
   std::vector<uint32_t> GlobalAddrs;
 
+  /// Resolved instances of the addresses above.
+  friend class Runtime::StoreManager;
+  std::vector<FunctionInstance *> FuncInsts;
+  std::vector<TableInstance *> TabInsts;
+  std::vector<MemoryInstance *> MemInsts;
+  std::vector<GlobalInstance *> GlobInsts;
+
   /// Exports.
   std::map<std::string, uint32_t> ExpFuncs;
   std::map<std::string, uint32_t> ExpTables;
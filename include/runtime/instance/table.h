@@ -14,6 +14,7 @@
 #include "common/ast/type.h"
 #include "common/errcode.h"
 #include "common/types.h"
+#include "runtime/journal.h"
 
 #include <algorithm>
 #include <cstdint>
@@ -23,12 +24,21 @@ namespace SSVM {
 namespace Runtime {
 namespace Instance {
 
+class FunctionInstance;
+
 class TableInstance {
 public:
+  /// Table entry of function reference. The uninitialized entry has the
+  /// invalid type ID and matches no function type.
+  struct FuncElem {
+    uint32_t TypeID = UINT32_MAX;
+    const FunctionInstance *Func = nullptr;
+  };
+
   TableInstance() = delete;
   TableInstance(const ElemType &Elem, const AST::Limit &Lim)
       : Type(Elem), HasMaxSize(Lim.hasMax()), MinSize(Lim.getMin()),
-        MaxSize(Lim.getMax()), FuncElem(MinSize) {}
+        MaxSize(Lim.getMax()), FuncElems(MinSize) {}
   virtual ~TableInstance() = default;
 
   /// Getter of element type.
@@ -43,27 +53,48 @@ public:
   /// Getter of limit definition.
   uint32_t getMax() const { return MaxSize; }
 
-  /// Set the function index initialization list.
+  /// Set the function reference initialization list.
   Expect<void> setInitList(const uint32_t Offset,
-                           const std::vector<uint32_t> &Addrs) {
-    if (Offset + Addrs.size() > MinSize) {
+                           const std::vector<FuncElem> &Elems) {
+    if (Offset + Elems.size() > MinSize) {
       return Unexpect(ErrCode::TableSizeExceeded);
     }
-    std::copy(Addrs.begin(), Addrs.end(), FuncElem.begin() + Offset);
+    if (ElemJournal.isActive()) {
+      for (uint32_t I = Offset; I < Offset + Elems.size(); ++I) {
+        if (ElemJournal.isFirstWrite(I)) {
+          ElemJournal.record(I, FuncElems[I]);
+        }
+      }
+    }
+    std::copy(Elems.begin(), Elems.end(), FuncElems.begin() + Offset);
     return {};
   }
 
+  /// Begin a checkpoint of the journal. The elements are recorded at their
+  /// first writes until commit or rollback.
+  void begin() { ElemJournal.begin(FuncElems.size()); }
+
+  /// Commit the current checkpoint into the outer one.
+  void commit() { ElemJournal.commit(); }
+
+  /// Roll back the elements in the current checkpoint.
+  void rollback() {
+    ElemJournal.rollback([this](const uint32_t Idx, const FuncElem &Old) {
+      FuncElems[Idx] = Old;
+    });
+  }
+
   /// Check is out of bound.
   bool checkAccessBound(const uint32_t Offset) {
     return (Offset > MinSize) ? false : true;
   }
 
-  /// Get the elem address.
-  Expect<uint32_t> getElemAddr(const uint32_t Idx) const {
-    if (Idx >= FuncElem.size()) {
+  /// Get the function reference entry.
+  Expect<const FuncElem *> getElem(const uint32_t Idx) const {
+    if (Idx >= FuncElems.size()) {
       return Unexpect(ErrCode::AccessForbidMemory);
     }
-    return FuncElem[Idx];
+    return &FuncElems[Idx];
   }
 
 private:
@@ -73,8 +104,11 @@ private:
   const bool HasMaxSize;
   const uint32_t MinSize = 0;
   const uint32_t MaxSize = 0;
-  std::vector<uint32_t> FuncElem;
+  std::vector<FuncElem> FuncElems;
   /// @}
+
+  /// Journal of the elements in checkpoints.
+  Journal<FuncElem> ElemJournal;
 };
 
 } // namespace Instance
@@ -11,6 +11,11 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "common/types.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 namespace SSVM {
@@ -26,6 +31,20 @@ struct FType {
   std::vector<ValType> Returns;
 };
 
+/// Get the process-wide ID of function type. Identical signatures share the
+/// same ID in all stores, so that the type checking of indirect calls is an
+/// integer compare, also for the host functions and tables shared by stores.
+inline uint32_t getTypeID(const std::vector<ValType> &Params,
+                          const std::vector<ValType> &Returns) {
+  static std::mutex Mutex;
+  static std::map<std::pair<std::vector<ValType>, std::vector<ValType>>,
+                  uint32_t>
+      TypeIDs;
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return TypeIDs.try_emplace(std::make_pair(Params, Returns), TypeIDs.size())
+      .first->second;
+}
+
 } // namespace Instance
 } // namespace Runtime
 } // namespace SSVM
\ No newline at end of file
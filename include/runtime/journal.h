@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/runtime/journal.h - Journal definition -----------------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the journal of instance entries.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace SSVM {
+namespace Runtime {
+
+/// Journal of the writes to the entries of an instance in nested checkpoints.
+///
+/// The old value of an entry is recorded at its first write in a checkpoint,
+/// and the rollback restores the recorded values in the reverse order. Every
+/// checkpoint has a new epoch, and an entry is first written in the current
+/// checkpoint if its epoch is not the current one, so the costs are in the
+/// count of written entries. The entries from the size at the beginning of
+/// checkpoint are not recorded, because they are dropped in rollback.
+template <typename T> class Journal {
+public:
+  Journal() = default;
+  /// The copies of instances start with no checkpoint.
+  Journal(const Journal &) {}
+  Journal &operator=(const Journal &) = delete;
+
+  /// Checkpoint with the log size and the entry count at the beginning.
+  struct Checkpoint {
+    size_t LogSize;
+    uint32_t Epoch;
+    uint32_t Size;
+  };
+
+  /// Check if any checkpoint is active.
+  bool isActive() const { return !Checkpoints.empty(); }
+
+  /// Getter of the count of nested checkpoints.
+  uint32_t getDepth() const { return Checkpoints.size(); }
+
+  /// Begin a checkpoint with Size entries.
+  void begin(const uint32_t Size) {
+    Checkpoints.push_back(Checkpoint{Log.size(), ++LastEpoch, Size});
+  }
+
+  /// Check and mark the first write to the entry Idx in the current
+  /// checkpoint, which should be recorded by `record()`.
+  bool isFirstWrite(const uint32_t Idx) {
+    const Checkpoint &Curr = Checkpoints.back();
+    if (Idx >= Curr.Size) {
+      return false;
+    }
+    if (Idx >= Epochs.size()) {
+      /// Grow the epochs to the written entries only.
+      Epochs.resize(std::min(std::max(size_t(Idx) + 1, Epochs.size() * 2),
+                             size_t(Curr.Size)),
+                    0);
+    }
+    if (Epochs[Idx] == Curr.Epoch) {
+      return false;
+    }
+    Epochs[Idx] = Curr.Epoch;
+    return true;
+  }
+
+  /// Record the old value of the entry Idx.
+  void record(const uint32_t Idx, const T &Old) { Log.emplace_back(Idx, Old); }
+
+  /// Commit the current checkpoint. The records are kept for the outer one.
+  void commit() {
+    if (Checkpoints.empty()) {
+      return;
+    }
+    Checkpoints.pop_back();
+    if (Checkpoints.empty()) {
+      Log.clear();
+    }
+  }
+
+  /// Roll back the current checkpoint with Restore(Idx, Old) of the records.
+  ///
+  /// \returns the entry count at the beginning of the checkpoint, or
+  /// UINT32_MAX if no checkpoint.
+  template <typename F> uint32_t rollback(F &&Restore) {
+    if (Checkpoints.empty()) {
+      return UINT32_MAX;
+    }
+    const Checkpoint Curr = Checkpoints.back();
+    Checkpoints.pop_back();
+    for (size_t I = Log.size(); I > Curr.LogSize; --I) {
+      Restore(Log[I - 1].first, Log[I - 1].second);
+    }
+    Log.erase(Log.begin() + Curr.LogSize, Log.end());
+    return Curr.Size;
+  }
+
+private:
+  /// \name Data of journal.
+  /// @{
+  std::vector<Checkpoint> Checkpoints;
+  std::vector<std::pair<uint32_t, T>> Log;
+  /// Epoch of checkpoint of the last record of entries.
+  std::vector<uint32_t> Epochs;
+  uint32_t LastEpoch = 0;
+  /// @}
+};
+
+} // namespace Runtime
+} // namespace SSVM
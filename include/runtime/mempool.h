@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/runtime/mempool.h - Memory Pool definition -------------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the pool of guarded memory regions.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "support/fault.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <sys/mman.h>
+
+namespace SSVM {
+namespace Runtime {
+
+class MemoryPool {
+public:
+  /// Size of a page in bytes.
+  static inline constexpr const uint64_t PageSize = 65536ULL;
+  /// Size of the whole 32-bit address range.
+  static inline constexpr const uint64_t AddrSpace = 65536ULL * PageSize;
+  /// Size of the guard region after the address range. The effective address
+  /// never overflows 32 bits, so it only covers the widest access of 16 bytes.
+  static inline constexpr const uint64_t GuardSize = PageSize;
+  /// Size of a reserved region.
+  static inline constexpr const uint64_t RegionSize = AddrSpace + GuardSize;
+  /// Default count of the released regions kept for reuse.
+  static inline constexpr const uint32_t DefaultCapacity = 64;
+
+  /// Process-wide pool of the reserved regions of guarded memory.
+  ///
+  /// Every region reserves the whole address range and the guard region with
+  /// the inaccessible pages, and is registered to `Support::Fault`. The pages
+  /// from the beginning are committed for the memory in use. The released
+  /// regions are reset by `madvise(MADV_DONTNEED)`, which only reclaims the
+  /// touched pages, and are kept with the committed pages for the next memory
+  /// instance. The pool lives until the process exits.
+  static MemoryPool &getInstance() {
+    static MemoryPool *Pool = new MemoryPool();
+    return *Pool;
+  }
+  MemoryPool(const MemoryPool &) = delete;
+  MemoryPool &operator=(const MemoryPool &) = delete;
+
+  /// Acquire a region with the first Pages pages committed.
+  ///
+  /// \returns the beginning of region, or nullptr if failed.
+  uint8_t *acquire(const uint32_t Pages) {
+    if (!Enabled.load(std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    Region R{nullptr, 0};
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      if (!Free.empty()) {
+        R = Free.back();
+        Free.pop_back();
+      }
+    }
+    if (R.Data == nullptr) {
+      void *Ptr = mmap(nullptr, RegionSize, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (Ptr == MAP_FAILED) {
+        return nullptr;
+      }
+      R.Data = static_cast<uint8_t *>(Ptr);
+      if (!Support::Fault::registerRegion(R.Data, RegionSize)) {
+        munmap(R.Data, RegionSize);
+        return nullptr;
+      }
+    }
+
+    /// Adjust the committed pages.
+    int Res = 0;
+    if (R.Pages > Pages) {
+      Res = mprotect(R.Data + Pages * PageSize, (R.Pages - Pages) * PageSize,
+                     PROT_NONE);
+    } else if (R.Pages < Pages) {
+      Res = mprotect(R.Data + R.Pages * PageSize, (Pages - R.Pages) * PageSize,
+                     PROT_READ | PROT_WRITE);
+    }
+    if (Res != 0) {
+      unmap(R.Data);
+      return nullptr;
+    }
+    return R.Data;
+  }
+
+  /// Release a region with the first Pages pages committed.
+  void release(uint8_t *Data, const uint32_t Pages) {
+    if (isFull()) {
+      unmap(Data);
+      return;
+    }
+    /// Reclaim the touched pages out of the lock. They are zero pages when
+    /// accessed again.
+    if (Pages > 0 && madvise(Data, Pages * PageSize, MADV_DONTNEED) != 0) {
+      unmap(Data);
+      return;
+    }
+    /// Check again, because the other releases may fill the pool meanwhile.
+    std::unique_lock<std::mutex> Lock(Mutex);
+    if (Free.size() >= Capacity) {
+      Lock.unlock();
+      unmap(Data);
+      return;
+    }
+    Free.push_back(Region{Data, Pages});
+  }
+
+  /// Setter of the count of the released regions kept for reuse.
+  void setCapacity(const uint32_t Cap) {
+    std::vector<Region> Trimmed;
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      Capacity = Cap;
+      if (Free.size() > Capacity) {
+        Trimmed.assign(Free.begin() + Capacity, Free.end());
+        Free.resize(Capacity);
+      }
+    }
+    for (const auto &R : Trimmed) {
+      unmap(R.Data);
+    }
+  }
+
+  /// Getter of the count of the released regions kept for reuse.
+  uint32_t getCapacity() const {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    return Capacity;
+  }
+
+  /// Switch of the guarded memory. When disabled, no region is acquired and
+  /// the new memory instances are unguarded and checked.
+  void setEnabled(const bool Enable) {
+    Enabled.store(Enable, std::memory_order_relaxed);
+  }
+  bool isEnabled() const { return Enabled.load(std::memory_order_relaxed); }
+
+  /// Getter of the count of the released regions kept now.
+  uint32_t getFreeCount() const {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    return static_cast<uint32_t>(Free.size());
+  }
+
+private:
+  MemoryPool() { Free.reserve(DefaultCapacity); }
+
+  struct Region {
+    uint8_t *Data;
+    uint32_t Pages;
+  };
+
+  /// Check the released regions kept reach the capacity.
+  bool isFull() const {
+    std::unique_lock<std::mutex> Lock(Mutex);
+    return Free.size() >= Capacity;
+  }
+
+  /// Unregister and unmap a region.
+  static void unmap(uint8_t *Data) {
+    Support::Fault::unregisterRegion(Data);
+    munmap(Data, RegionSize);
+  }
+
+  /// \name Data of memory pool.
+  /// @{
+  mutable std::mutex Mutex;
+  std::vector<Region> Free;
+  uint32_t Capacity = DefaultCapacity;
+  std::atomic<bool> Enabled = true;
+  /// @}
+};
+
+} // namespace Runtime
+} // namespace SSVM
@@ -11,132 +11,177 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
-#include "common/ast/instruction.h"
 #include "common/value.h"
+#include "runtime/instance/module.h"
 #include "support/casting.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <new>
 #include <vector>
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 namespace SSVM {
 namespace Runtime {
 
 class StackManager {
 public:
-  struct Label {
-    Label() = delete;
-    Label(const uint32_t S, const uint32_t C,
-          const AST::BlockControlInstruction *Instr)
-        : StackSize(S), Coarity(C), Target(Instr) {}
-    uint32_t StackSize;
-    uint32_t Coarity;
-    const AST::BlockControlInstruction *Target;
-  };
-
   struct Frame {
     Frame() = delete;
-    Frame(const uint32_t Addr, const uint32_t VS, const uint32_t LS,
+    Frame(const Instance::ModuleInstance *Mod, const uint32_t VS,
           const uint32_t C)
-        : ModAddr(Addr), VStackSize(VS), LStackSize(LS), Coarity(C) {}
-    uint32_t ModAddr;
+        : Module(Mod), VStackSize(VS), Coarity(C) {}
+    const Instance::ModuleInstance *Module;
     uint32_t VStackSize;
-    uint32_t LStackSize;
     uint32_t Coarity;
   };
 
   using Value = ValVariant;
 
+  /// Default capacity of value stack in values.
+  static inline constexpr const uint32_t DefaultCapacity = 1U << 20;
+
   /// Stack manager provides the stack control for Wasm execution with VALIDATED
   /// modules. All operations of instructions passed validation, therefore no
   /// unexpect operations will occur.
-  StackManager() {
-    ValueStack.reserve(2048U);
-    LabelStack.reserve(64U);
-    FrameStack.reserve(16U);
+  ///
+  /// The value stack is a fixed-capacity array of 128-bit values allocated at
+  /// construction, followed by an inaccessible guard page. The first value is
+  /// a scratch entry under the stack bottom, so that the top entry of an empty
+  /// stack can be accessed. The frame stack holds up to 1/16 of the value
+  /// capacity. Operations do not check the capacity; function entries check it
+  /// with `hasRoom()` for the locals and the maximum height of stack.
+  StackManager(const uint32_t Capacity = DefaultCapacity) {
+    const size_t PageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    Bytes = (static_cast<size_t>(Capacity) * sizeof(Value) + PageSize - 1) /
+            PageSize * PageSize;
+    void *Ptr = mmap(nullptr, Bytes + PageSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (Ptr == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    Base = Top = static_cast<Value *>(Ptr) + 1;
+    End = Base - 1 + Bytes / sizeof(Value);
+    mprotect(End, PageSize, PROT_NONE);
+    Bytes += PageSize;
+    MaxFrame = std::max(Capacity / 16U, 16U);
+    FrameStack.reserve(MaxFrame);
   };
-  ~StackManager() = default;
+  ~StackManager() { munmap(Base - 1, Bytes); }
+  StackManager(const StackManager &) = delete;
+  StackManager &operator=(const StackManager &) = delete;
 
   /// Getter of stack size.
-  size_t size() const { return ValueStack.size(); }
+  size_t size() const { return static_cast<size_t>(Top - Base); }
+
+  /// Check the stack has room for a new frame with Count more values.
+  bool hasRoom(const uint32_t Count) const {
+    return FrameStack.size() < MaxFrame &&
+           static_cast<size_t>(End - Top) >= Count;
+  }
 
   /// Unsafe Getter of top entry of stack.
-  Value &getTop() { return ValueStack.back(); }
+  Value &getTop() { return *(Top - 1); }
 
   /// Unsafe Getter of bottom N-th value entry of stack.
-  Value &getBottomN(uint32_t N) { return ValueStack[N]; }
+  Value &getBottomN(uint32_t N) { return Base[N]; }
 
-  /// Push a new value entry to stack.
-  template <typename T> void push(T &&Val) {
-    ValueStack.push_back(std::forward<T>(Val));
-  }
+  /// Unsafe push a new value entry to stack.
+  template <typename T> void push(T &&Val) { *Top++ = std::forward<T>(Val); }
 
   /// Unsafe Pop and return the top entry.
-  Value pop() {
-    Value V = std::move(ValueStack.back());
-    ValueStack.pop_back();
-    return V;
-  }
+  Value pop() { return *--Top; }
+
+  /// Unsafe extend the stack by one entry. The value of the entry is undefined.
+  void grow() { ++Top; }
 
-  /// Push a new frame entry to stack.
-  void pushFrame(const uint32_t ModuleAddr, const uint32_t Arity,
-                 const uint32_t Coarity) {
-    FrameStack.emplace_back(ModuleAddr, ValueStack.size() - Arity,
-                            LabelStack.size(), Coarity);
+  /// Unsafe drop the top entry.
+  void drop() { --Top; }
+
+  /// Push a new frame entry to stack. The Arity args are on the top of stack,
+  /// and the LocalNum locals are zero-filled in one step.
+  void pushFrame(const Instance::ModuleInstance *Module, const uint32_t Arity,
+                 const uint32_t Coarity, const uint32_t LocalNum = 0) {
+    FrameStack.emplace_back(Module, size() - Arity, Coarity);
+    std::memset(Top, 0, LocalNum * sizeof(Value));
+    Top += LocalNum;
   }
 
-  /// Unsafe pop top frame. Return number of popped label.
-  uint32_t popFrame() {
-    uint32_t LabelPopped = LabelStack.size() - FrameStack.back().LStackSize;
-    LabelStack.erase(LabelStack.begin() + FrameStack.back().LStackSize,
-                     LabelStack.end());
-    ValueStack.erase(ValueStack.begin() + FrameStack.back().VStackSize,
-                     ValueStack.end() - FrameStack.back().Coarity);
+  /// Unsafe pop top frame. Move the results down to the frame base.
+  void popFrame() {
+    Value *Dst = Base + FrameStack.back().VStackSize;
+    const uint32_t Coarity = FrameStack.back().Coarity;
+    std::memmove(Dst, Top - Coarity, Coarity * sizeof(Value));
+    Top = Dst + Coarity;
     FrameStack.pop_back();
-    return LabelPopped;
   }
 
-  /// Push a new label entry to stack.
-  void pushLabel(const uint32_t Coarity,
-                 const AST::BlockControlInstruction *Instr = nullptr) {
-    LabelStack.emplace_back(ValueStack.size(), Coarity, Instr);
+  /// Unsafe pop top frame for tail call. Move the Arity args of the callee
+  /// down to the frame base, so that the callee frame replaces this one.
+  void popTailFrame(const uint32_t Arity) {
+    Value *Dst = Base + FrameStack.back().VStackSize;
+    std::memmove(Dst, Top - Arity, Arity * sizeof(Value));
+    Top = Dst + Arity;
+    FrameStack.pop_back();
   }
 
-  /// Unsafe pop top label.
-  void popLabel(const uint32_t Cnt = 1) {
-    const auto &L = getLabelWithCount(Cnt - 1);
-    ValueStack.erase(ValueStack.begin() + L.StackSize,
-                     ValueStack.end() - L.Coarity);
-    for (uint32_t I = 0; I < Cnt; ++I) {
-      LabelStack.pop_back();
+  /// Push a new frame of register-based function. The locals start from the
+  /// offset of stack, and the stack is extended to cover the frame slots.
+  void pushRegFrame(const Instance::ModuleInstance *Module,
+                    const uint32_t Offset, const uint32_t Coarity,
+                    const uint32_t SlotNum) {
+    FrameStack.emplace_back(Module, Offset, Coarity);
+    if (size() < Offset + SlotNum) {
+      Top = Base + Offset + SlotNum;
     }
   }
 
-  /// Unsafe getter of module address.
-  uint32_t getModuleAddr() const { return FrameStack.back().ModAddr; }
+  /// Unsafe pop top frame of register-based function and keep the stack.
+  void popRegFrame() { FrameStack.pop_back(); }
+
+  /// Unsafe getter of the frame slots of register-based function.
+  Value *getRegSlots() {
+    return Base + FrameStack.back().VStackSize;
+  }
+
+  /// Unsafe resize the stack. The values of extended entries are undefined.
+  void resize(const uint32_t Size) { Top = Base + Size; }
+
+  /// Unsafe erase the Count values under the top Arity values of stack.
+  void stackErase(const uint32_t Count, const uint32_t Arity) {
+    std::memmove(Top - Arity - Count, Top - Arity, Arity * sizeof(Value));
+    Top -= Count;
+  }
+
+  /// Unsafe getter of module instance.
+  const Instance::ModuleInstance *getModule() const {
+    return FrameStack.back().Module;
+  }
 
   /// Unsafe getter for stack offset of local values by index.
   uint32_t getOffset(uint32_t Idx) const {
     return FrameStack.back().VStackSize + Idx;
   }
 
-  /// Unsafe getter of the top count of label which index start from 0.
-  const Label &getLabelWithCount(const uint32_t Count) const {
-    return LabelStack[LabelStack.size() - Count - 1];
-  }
-
   /// Reset stack.
   void reset() {
-    ValueStack.clear();
-    LabelStack.clear();
+    Top = Base;
     FrameStack.clear();
   }
 
 private:
   /// \name Data of stack manager.
   /// @{
-  std::vector<Value> ValueStack;
-  std::vector<Label> LabelStack;
+  /// Value stack of [Base, Top) within [Base, End), and mapped bytes.
+  Value *Base;
+  Value *Top;
+  Value *End;
+  size_t Bytes;
   std::vector<Frame> FrameStack;
+  uint32_t MaxFrame;
   /// @}
 };
 
@@ -17,8 +17,10 @@
 #include "instance/module.h"
 #include "instance/table.h"
 
+#include <map>
 #include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace SSVM {
@@ -99,6 +101,15 @@ public:
     return importInstance(Glob, ImpGlobInsts, GlobInsts);
   }
 
+  /// Resolve the instance addresses of module into the instance pointers, for
+  /// accessing the instances by index in execution without looking up store.
+  void resolveModule(Instance::ModuleInstance &Mod) {
+    resolveInstances(Mod.FuncAddrs, FuncInsts, Mod.FuncInsts);
+    resolveInstances(Mod.TableAddrs, TabInsts, Mod.TabInsts);
+    resolveInstances(Mod.MemAddrs, MemInsts, Mod.MemInsts);
+    resolveInstances(Mod.GlobalAddrs, GlobInsts, Mod.GlobInsts);
+  }
+
   /// Pop temp. module. Dangerous function for used when instantiating only.
   void popModule() {
     if (NumMod > 0) {
@@ -108,6 +119,106 @@ public:
     }
   }
 
+  /// Clone the store with all instances in the same addresses.
+  ///
+  /// The modules, tables, memories, and globals owned by this store are copied,
+  /// and the memories are mapped copy-on-write. See `MemoryInstance::clone()`.
+  /// The functions and host instances are shared, so this store should outlive
+  /// the clones, and should not be reset while they are alive. The clones of
+  /// a clone share the ones of the first store. `isCloneValid()` of the clones
+  /// turns false when the first store is destructed or reset. The function
+  /// instances look up their modules by address in the store where they are
+  /// executed. The cloned store is for execution, and should not instantiate
+  /// other modules.
+  ///
+  /// \param Refresh take new images of the memories.
+  ///
+  /// \returns the cloned store, or ErrCode when failed.
+  Expect<std::unique_ptr<StoreManager>> clone(const bool Refresh = false) {
+    auto Store = std::make_unique<StoreManager>();
+    Store->Origin = IsClone ? Origin : Lifetime;
+    Store->IsClone = true;
+    Store->FuncInsts = FuncInsts;
+    Store->NumMod = NumMod;
+    Store->NumTab = NumTab;
+    Store->NumMem = NumMem;
+    Store->NumGlob = NumGlob;
+    const auto CopyInst = [](const auto &Inst) {
+      using T = std::decay_t<decltype(Inst)>;
+      return Expect<std::unique_ptr<T>>(std::make_unique<T>(Inst));
+    };
+    if (auto Res = cloneInstances(ImpTabInsts, TabInsts, Store->ImpTabInsts,
+                                  Store->TabInsts, CopyInst);
+        !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = cloneInstances(
+            ImpMemInsts, MemInsts, Store->ImpMemInsts, Store->MemInsts,
+            [Refresh](auto &Inst) { return Inst.clone(Refresh); });
+        !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = cloneInstances(ImpGlobInsts, GlobInsts, Store->ImpGlobInsts,
+                                  Store->GlobInsts, CopyInst);
+        !Res) {
+      return Unexpect(Res);
+    }
+    for (const auto &Mod : ImpModInsts) {
+      auto NewMod = std::make_unique<Instance::ModuleInstance>(*Mod);
+      Store->resolveModule(*NewMod);
+      Store->ModInsts.push_back(NewMod.get());
+      Store->ImpModInsts.push_back(std::move(NewMod));
+    }
+    return Store;
+  }
+
+  /// Check the store is not a clone, or the store cloned from is still alive
+  /// with the shared function instances.
+  bool isCloneValid() const { return !IsClone || !Origin.expired(); }
+
+  /// Begin a checkpoint of the tables, memories, and globals in store.
+  ///
+  /// The writes to them are journaled until commit or rollback, and the
+  /// checkpoints can be nested. The costs are in the written entries. The
+  /// instances added in the checkpoint are not removed in rollback.
+  void beginCheckpoint() {
+    for (auto *Tab : TabInsts) {
+      Tab->begin();
+    }
+    for (auto *Mem : MemInsts) {
+      Mem->begin();
+    }
+    for (auto *Glob : GlobInsts) {
+      Glob->begin();
+    }
+  }
+
+  /// Commit the current checkpoint into the outer one.
+  void commitCheckpoint() {
+    for (auto *Tab : TabInsts) {
+      Tab->commit();
+    }
+    for (auto *Mem : MemInsts) {
+      Mem->commit();
+    }
+    for (auto *Glob : GlobInsts) {
+      Glob->commit();
+    }
+  }
+
+  /// Roll back the changes in the current checkpoint.
+  void rollbackCheckpoint() {
+    for (auto *Tab : TabInsts) {
+      Tab->rollback();
+    }
+    for (auto *Mem : MemInsts) {
+      Mem->rollback();
+    }
+    for (auto *Glob : GlobInsts) {
+      Glob->rollback();
+    }
+  }
+
   /// Get instance from store manager by address.
   Expect<Instance::ModuleInstance *> getModule(const uint32_t Addr) {
     return getInstance(Addr, ModInsts);
@@ -125,6 +236,11 @@ public:
     return getInstance(Addr, GlobInsts);
   }
 
+  /// Unsafe getter of module instance by address.
+  const Instance::ModuleInstance *getModuleUnsafe(const uint32_t Addr) const {
+    return ModInsts[Addr];
+  }
+
   /// Get exported instances of instantiated module.
   const std::map<std::string, uint32_t> getFuncExports() const {
     if (NumMod > 0) {
@@ -171,6 +287,8 @@ public:
 
   /// Reset store.
   void reset(bool IsResetRegistered = false) {
+    /// Invalidate the clones sharing the function instances.
+    Lifetime = std::make_shared<const bool>(true);
     if (IsResetRegistered) {
       NumMod = 0;
       NumFunc = 0;
@@ -238,6 +356,45 @@ private:
     return Addr;
   }
 
+  /// Helper function for resolving instance addresses to instance pointers.
+  template <typename T>
+  std::enable_if_t<IsEntityV<T>, void>
+  resolveInstances(const std::vector<uint32_t> &Addrs,
+                   const std::vector<T *> &InstsVec,
+                   std::vector<T *> &ResolvedVec) {
+    ResolvedVec.clear();
+    ResolvedVec.reserve(Addrs.size());
+    for (const uint32_t Addr : Addrs) {
+      ResolvedVec.push_back(InstsVec[Addr]);
+    }
+  }
+
+  /// Helper function for cloning the owned instances by Clone and sharing the
+  /// others in the same addresses.
+  template <typename T, typename F>
+  std::enable_if_t<IsEntityV<T>, Expect<void>>
+  cloneInstances(const std::vector<std::unique_ptr<T>> &ImpInstsVec,
+                 const std::vector<T *> &InstsVec,
+                 std::vector<std::unique_ptr<T>> &NewImpInstsVec,
+                 std::vector<T *> &NewInstsVec, F &&Clone) {
+    std::map<const T *, T *> Cloned;
+    NewImpInstsVec.reserve(ImpInstsVec.size());
+    for (const auto &Inst : ImpInstsVec) {
+      if (auto Res = Clone(*Inst)) {
+        Cloned.emplace(Inst.get(), Res->get());
+        NewImpInstsVec.push_back(std::move(*Res));
+      } else {
+        return Unexpect(Res);
+      }
+    }
+    NewInstsVec.reserve(InstsVec.size());
+    for (T *Inst : InstsVec) {
+      auto It = Cloned.find(Inst);
+      NewInstsVec.push_back(It != Cloned.end() ? It->second : Inst);
+    }
+    return {};
+  }
+
   /// Helper function for getting instance from instance vector.
   template <typename T>
   std::enable_if_t<IsInstanceV<T>, Expect<T *>>
@@ -274,6 +431,15 @@ private:
   uint32_t NumMem;
   uint32_t NumGlob;
   /// @}
+
+  /// \name Lifetime of the shared instances of clones.
+  /// @{
+  /// Token owned by the store, renewed when reset.
+  std::shared_ptr<const bool> Lifetime = std::make_shared<const bool>(true);
+  /// Token of the first store cloned from.
+  std::weak_ptr<const bool> Origin;
+  bool IsClone = false;
+  /// @}
 };
 
 } // namespace Runtime
@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/support/fault.h - Memory fault handler definition ------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the fault handler of guarded memory.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <csetjmp>
+#include <cstddef>
+
+namespace SSVM {
+namespace Support {
+
+/// Fault handler of the guarded linear memories.
+///
+/// The guarded memory reserves its whole address range with the inaccessible
+/// pages, and the accesses to it are not checked. The accesses out of the
+/// committed pages raise SIGSEGV or SIGBUS, and the signal handler jumps back
+/// to the innermost active fault handler of the thread. The faults out of the
+/// registered regions, with no active handler, or out of the accesses marked
+/// by `setAccess` are passed to the previous signal handler.
+///
+/// The jump skips the frames between the jump point and the access without
+/// running their destructors, so the marked accesses should be done with no
+/// locks held and no objects to destruct in those frames.
+class Fault {
+public:
+  /// Activate this fault handler for the current thread.
+  Fault();
+  /// Deactivate and restore the previous fault handler of the thread.
+  ~Fault();
+  Fault(const Fault &) = delete;
+  Fault &operator=(const Fault &) = delete;
+
+  /// Getter of jump buffer. Set it with `PREPARE_FAULT`.
+  sigjmp_buf &getBuffer() { return Buffer; }
+
+  /// Mark the guarded access in progress with its accessor, or end it with
+  /// nullptr. The accessor is kept after jumping back from the fault.
+  void setAccess(const void *Accessor) {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    Access.store(Accessor, std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  }
+
+  /// Getter of the accessor of the guarded access in progress.
+  const void *getAccess() const {
+    return Access.load(std::memory_order_relaxed);
+  }
+
+  /// Register the address range of a guarded memory.
+  ///
+  /// The signal handler is installed at the first registration.
+  ///
+  /// \returns false if the registry is full.
+  static bool registerRegion(const void *Begin, const size_t Size);
+
+  /// Unregister the address range of a guarded memory.
+  static void unregisterRegion(const void *Begin);
+
+  /// Jump back to the active fault handler. Called by the signal handler.
+  [[noreturn]] void jump();
+
+private:
+  Fault *Prev;
+  std::atomic<const void *> Access = nullptr;
+  sigjmp_buf Buffer;
+};
+
+} // namespace Support
+} // namespace SSVM
+
+/// Set the jump point of the fault handler F. Returns 0 when set, and non-zero
+/// when jumped back from a fault. The signal mask is not saved, because the
+/// signal handler does not block the signals.
+#define PREPARE_FAULT(F) sigsetjmp((F).getBuffer(), 0)
@@ -12,9 +12,11 @@ namespace Support {
 class Measurement {
 public:
   Measurement(const uint64_t Lim = UINT64_MAX)
-      : CostTab(256, 0ULL), InstrCnt(0), CostLimit(Lim), CostSum(0) {}
+      : CostTab(256, 0ULL), SIMDCostTab(256, 0ULL), InstrCnt(0),
+        CostLimit(Lim), CostSum(0) {}
   Measurement(const std::vector<uint64_t> &Tab, const uint64_t Lim = UINT64_MAX)
-      : CostTab(Tab), InstrCnt(0), CostLimit(Lim), CostSum(0) {
+      : CostTab(Tab), SIMDCostTab(256, 0ULL), InstrCnt(0), CostLimit(Lim),
+        CostSum(0) {
     if (CostTab.size() < 256) {
       CostTab.resize(256);
     }
@@ -24,6 +26,10 @@ public:
   /// Increament of instruction counter.
   void incInstrCnt() { ++InstrCnt; }
 
+  /// Addition and subtraction of instruction counter.
+  void addInstrCnt(const uint64_t Cnt) { InstrCnt += Cnt; }
+  void subInstrCnt(const uint64_t Cnt) { InstrCnt -= Cnt; }
+
   /// Getter of instruction counter.
   uint64_t getInstrCnt() const { return InstrCnt; }
 
@@ -35,6 +41,26 @@ public:
     }
   }
 
+  /// Setter of cost table of SIMD instructions indexed by sub-opcode. A SIMD
+  /// instruction costs the cost of the 0xFD prefix opcode in the cost table
+  /// plus the cost of its sub-opcode here, which are 0 by default.
+  void setSIMDCostTable(const std::vector<uint64_t> &NewTable) {
+    SIMDCostTab = NewTable;
+    if (SIMDCostTab.size() < 256) {
+      SIMDCostTab.resize(256);
+    }
+  }
+
+  /// Getter of cost of instruction.
+  uint64_t getInstrCost(const AST::Instruction::OpCode &Code) const {
+    return CostTab[static_cast<uint64_t>(Code)];
+  }
+
+  /// Getter of cost of SIMD sub-opcode added to the prefix opcode.
+  uint64_t getSIMDCost(const AST::SIMDCode &Code) const {
+    return SIMDCostTab[static_cast<uint64_t>(Code)];
+  }
+
   /// Adder for instruction costs.
   bool addInstrCost(const AST::Instruction::OpCode &Code) {
     return addCost(CostTab[static_cast<uint64_t>(Code)]);
@@ -48,11 +74,11 @@ public:
 
   /// Add cost and return false if exceeded limit.
   bool addCost(const uint64_t &Cost) {
-    CostSum += Cost;
-    if (CostSum > CostLimit) {
+    if (CostSum > CostLimit || Cost > CostLimit - CostSum) {
       CostSum = CostLimit;
       return false;
     }
+    CostSum += Cost;
     return true;
   }
 
@@ -66,6 +92,25 @@ public:
     return false;
   }
 
+  /// Enable or disable the counting of executed instruction pairs.
+  void setPairCounting(const bool Enable) {
+    PairCnt.assign(Enable ? 65536 : 0, 0ULL);
+    PrevCode = 0;
+  }
+
+  /// Getter of instruction pair counting enabled.
+  bool isPairCounting() const { return !PairCnt.empty(); }
+
+  /// Count the pair of the previous and this executed instructions.
+  void countPair(const AST::Instruction::OpCode &Code) {
+    const uint8_t CurrCode = static_cast<uint8_t>(Code);
+    ++PairCnt[(static_cast<uint32_t>(PrevCode) << 8) | CurrCode];
+    PrevCode = CurrCode;
+  }
+
+  /// Getter of instruction pair counts indexed by (previous << 8 | current).
+  const std::vector<uint64_t> &getPairCount() const { return PairCnt; }
+
   /// Getter of time recorder.
   Support::TimeRecord &getTimeRecorder() { return TimeRecorder; }
 
@@ -78,10 +123,12 @@ public:
 private:
   Support::TimeRecord TimeRecorder;
   std::vector<uint64_t> CostTab;
+  std::vector<uint64_t> SIMDCostTab;
   uint64_t InstrCnt;
   uint64_t CostLimit;
   uint64_t CostSum;
-  /// TODO: Can add a instruction statistics for OpCodes.
+  std::vector<uint64_t> PairCnt;
+  uint8_t PrevCode = 0;
 };
 
 } // namespace Support
@@ -21,15 +21,15 @@ namespace SSVM {
 namespace Support {
 
 template <typename... Ts> union VariadicUnion {};
+/// The members are of the alternative types, so that the compilers know the
+/// copies of the union may write any of them.
 template <typename FirstT, typename... RestT>
 union VariadicUnion<FirstT, RestT...> {
   constexpr VariadicUnion() : Rest() {}
 
   template <typename... Args>
   constexpr VariadicUnion(std::in_place_index_t<0>, Args &&... Values)
-      : First() {
-    ::new (&First) FirstT(std::forward<Args>(Values)...);
-  }
+      : First(std::forward<Args>(Values)...) {}
 
   template <std::size_t N, typename... Args>
   constexpr VariadicUnion(std::in_place_index_t<N>, Args &&... Values)
@@ -37,34 +37,34 @@ union VariadicUnion<FirstT, RestT...> {
 
   template <typename T> constexpr const T &get() const &noexcept {
     if constexpr (std::is_same_v<T, FirstT>) {
-      return *reinterpret_cast<const FirstT *>(&First);
+      return First;
     } else {
       return Rest.template get<T>();
     }
   }
   template <typename T> constexpr T &get() & noexcept {
     if constexpr (std::is_same_v<T, FirstT>) {
-      return *reinterpret_cast<FirstT *>(&First);
+      return First;
     } else {
       return Rest.template get<T>();
     }
   }
   template <typename T> constexpr const T &&get() const &&noexcept {
     if constexpr (std::is_same_v<T, FirstT>) {
-      return std::move(*reinterpret_cast<const FirstT *>(&First));
+      return std::move(First);
     } else {
       return std::move(Rest).template get<T>();
     }
   }
   template <typename T> constexpr T &&get() && noexcept {
     if constexpr (std::is_same_v<T, FirstT>) {
-      return std::move(*reinterpret_cast<FirstT *>(&First));
+      return std::move(First);
     } else {
       return std::move(Rest).template get<T>();
     }
   }
 
-  std::aligned_storage_t<sizeof(FirstT), alignof(FirstT)> First;
+  FirstT First;
   VariadicUnion<RestT...> Rest;
 };
 
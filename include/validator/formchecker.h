@@ -24,7 +24,7 @@
 namespace SSVM {
 namespace Validator {
 
-enum class VType : uint32_t { Unknown, I32, I64, F32, F64 };
+enum class VType : uint32_t { Unknown, I32, I64, F32, F64, V128 };
 using OpCode = AST::Instruction::OpCode;
 
 /// TODO: Validator should update due to applying multi-value returns in spec.
@@ -46,6 +46,7 @@ public:
   void addTable(const AST::TableType &Tab);
   void addMemory(const AST::MemoryType &Mem);
   void addGlobal(const AST::GlobalType &Glob, const bool IsImport = false);
+  void addData(const uint32_t &Cnt);
   void addLocal(const ValType &V);
   void addLocal(const VType &V);
 
@@ -56,6 +57,9 @@ public:
   auto &getMemories() { return Mems; }
   auto &getGlobals() { return Globals; }
   uint32_t getNumImportGlobals() const { return NumImportGlobals; }
+  uint32_t getDataNum() const { return Datas; }
+  /// Getter of the branch targets of the last validated function body.
+  auto &getBranchTargets() { return BrTargets; }
 
 private:
   struct CtrlFrame {
@@ -79,6 +83,8 @@ private:
   Expect<void> checkInstr(const AST::ConstInstruction &Instr);
   Expect<void> checkInstr(const AST::UnaryNumericInstruction &Instr);
   Expect<void> checkInstr(const AST::BinaryNumericInstruction &Instr);
+  Expect<void> checkInstr(const AST::SIMDInstruction &Instr);
+  Expect<void> checkInstr(const AST::AtomicMemoryInstruction &Instr);
 
   /// Helper function
   VType ASTToVType(const ValType &V);
@@ -92,6 +98,7 @@ private:
   void pushCtrl(const std::vector<VType> &Label, const std::vector<VType> &Out);
   Expect<std::vector<VType>> popCtrl();
   Expect<void> unreachable();
+  AST::BranchTarget getBranchTarget(const uint32_t N) const;
   Expect<void> StackTrans(const std::vector<VType> &Take,
                           const std::vector<VType> &Put);
 
@@ -102,12 +109,16 @@ private:
   std::vector<uint32_t> Mems;
   std::vector<std::pair<VType, ValMut>> Globals;
   uint32_t NumImportGlobals = 0;
+  uint32_t Datas = 0;
   std::vector<VType> Locals;
   std::vector<VType> Returns;
 
   /// Running stack.
   std::deque<CtrlFrame> CtrlStack;
   std::deque<VType> ValStack;
+
+  /// Resolved branch targets.
+  AST::BranchTargetVec BrTargets;
 };
 
 } // namespace Validator
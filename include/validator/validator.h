@@ -30,6 +30,12 @@ public:
   /// Validate AST::Module.
   Expect<void> validate(const AST::Module &Mod);
 
+  /// Getter of the branch targets of the function bodies of the last
+  /// validated module in the order of code segments.
+  const std::vector<AST::BranchTargetVec> &getBranchTargets() const {
+    return BranchTargets;
+  }
+
 private:
   /// Validate AST::Types
   Expect<void> validate(const AST::Limit &Lim, const uint32_t K);
@@ -69,6 +75,7 @@ private:
   const uint32_t LIMIT_TABLETYPE = UINT32_MAX; // 2^32-1
   const uint32_t LIMIT_MEMORYTYPE = 1U << 16;
   FormChecker Checker;
+  std::vector<AST::BranchTargetVec> BranchTargets;
 };
 
 } // namespace Validator
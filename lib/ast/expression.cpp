@@ -11,8 +11,8 @@ Expect<void> Expression::loadBinary(FileMgr &Mgr) {
     Instruction::OpCode Code;
 
     /// Read the opcode and check if error.
-    if (auto Res = Mgr.readByte()) {
-      Code = static_cast<Instruction::OpCode>(*Res);
+    if (auto Res = loadOpCode(Mgr)) {
+      Code = *Res;
     } else {
       return Unexpect(Res);
     }
@@ -25,6 +25,7 @@ Expect<void> BlockControlInstruction::loadBinary(FileMgr &Mgr) {
     case ValType::I64:
     case ValType::F32:
     case ValType::F64:
+    case ValType::V128:
     case ValType::None:
       break;
     default:
@@ -39,8 +40,8 @@ Expect<void> BlockControlInstruction::loadBinary(FileMgr &Mgr) {
     OpCode Code;
 
     /// Read the opcode and check if error.
-    if (auto Res = Mgr.readByte()) {
-      Code = static_cast<Instruction::OpCode>(*Res);
+    if (auto Res = loadOpCode(Mgr)) {
+      Code = *Res;
     } else {
       return Unexpect(Res);
     }
@@ -93,6 +94,7 @@ Expect<void> IfElseControlInstruction::loadBinary(FileMgr &Mgr) {
     case ValType::I64:
     case ValType::F32:
     case ValType::F64:
+    case ValType::V128:
     case ValType::None:
       break;
     default:
@@ -108,8 +110,8 @@ Expect<void> IfElseControlInstruction::loadBinary(FileMgr &Mgr) {
     OpCode Code;
 
     /// Read the opcode and check if error.
-    if (auto Res = Mgr.readByte()) {
-      Code = static_cast<Instruction::OpCode>(*Res);
+    if (auto Res = loadOpCode(Mgr)) {
+      Code = *Res;
     } else {
       return Unexpect(Res);
     }
@@ -193,7 +195,7 @@ Expect<void> CallControlInstruction::loadBinary(FileMgr &Mgr) {
   }
 
   /// Read the 0x00 checking code in indirect_call case.
-  if (Code == OpCode::Call_indirect) {
+  if (isIndirect()) {
     if (auto Res = Mgr.readByte()) {
       if (*Res != 0x00) {
         return Unexpect(ErrCode::InvalidGrammar);
@@ -230,6 +232,42 @@ Expect<void> MemoryInstruction::loadBinary(FileMgr &Mgr) {
     }
   }
 
+  /// Read the data index and the 0x00 memory index in bulk memory cases.
+  if (Code == Instruction::OpCode::Memory__init ||
+      Code == Instruction::OpCode::Data__drop) {
+    if (auto Res = Mgr.readU32()) {
+      DataIdx = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+  }
+  uint32_t MemIdxCnt = 0;
+  switch (Code) {
+  case Instruction::OpCode::Memory__init:
+  case Instruction::OpCode::Memory__fill:
+    MemIdxCnt = 1;
+    break;
+  case Instruction::OpCode::Memory__copy:
+    MemIdxCnt = 2;
+    break;
+  case Instruction::OpCode::Data__drop:
+    return {};
+  default:
+    break;
+  }
+  if (MemIdxCnt > 0) {
+    for (uint32_t I = 0; I < MemIdxCnt; ++I) {
+      if (auto Res = Mgr.readByte()) {
+        if (*Res != 0x00) {
+          return Unexpect(ErrCode::InvalidGrammar);
+        }
+      } else {
+        return Unexpect(Res);
+      }
+    }
+    return {};
+  }
+
   /// Read memory arguments.
   if (auto Res = Mgr.readU32()) {
     Align = *Res;
@@ -283,6 +321,425 @@ Expect<void> ConstInstruction::loadBinary(FileMgr &Mgr) {
   return {};
 }
 
+/// Check SIMD sub-opcode. See "include/common/ast/instruction.h".
+bool isSIMDCode(const uint32_t Code) {
+  if (Code > 0xFFU) {
+    return false;
+  }
+  switch (static_cast<SIMDCode>(Code)) {
+  case SIMDCode::V128__load:
+  case SIMDCode::V128__store:
+  case SIMDCode::V128__const:
+  case SIMDCode::I8x16__shuffle:
+  case SIMDCode::I8x16__swizzle:
+  case SIMDCode::I8x16__splat:
+  case SIMDCode::I16x8__splat:
+  case SIMDCode::I32x4__splat:
+  case SIMDCode::I64x2__splat:
+  case SIMDCode::F32x4__splat:
+  case SIMDCode::F64x2__splat:
+  case SIMDCode::I8x16__extract_lane_s:
+  case SIMDCode::I8x16__extract_lane_u:
+  case SIMDCode::I8x16__replace_lane:
+  case SIMDCode::I16x8__extract_lane_s:
+  case SIMDCode::I16x8__extract_lane_u:
+  case SIMDCode::I16x8__replace_lane:
+  case SIMDCode::I32x4__extract_lane:
+  case SIMDCode::I32x4__replace_lane:
+  case SIMDCode::I64x2__extract_lane:
+  case SIMDCode::I64x2__replace_lane:
+  case SIMDCode::F32x4__extract_lane:
+  case SIMDCode::F32x4__replace_lane:
+  case SIMDCode::F64x2__extract_lane:
+  case SIMDCode::F64x2__replace_lane:
+  case SIMDCode::I8x16__eq:
+  case SIMDCode::I8x16__ne:
+  case SIMDCode::I8x16__lt_s:
+  case SIMDCode::I8x16__lt_u:
+  case SIMDCode::I8x16__gt_s:
+  case SIMDCode::I8x16__gt_u:
+  case SIMDCode::I8x16__le_s:
+  case SIMDCode::I8x16__le_u:
+  case SIMDCode::I8x16__ge_s:
+  case SIMDCode::I8x16__ge_u:
+  case SIMDCode::I16x8__eq:
+  case SIMDCode::I16x8__ne:
+  case SIMDCode::I16x8__lt_s:
+  case SIMDCode::I16x8__lt_u:
+  case SIMDCode::I16x8__gt_s:
+  case SIMDCode::I16x8__gt_u:
+  case SIMDCode::I16x8__le_s:
+  case SIMDCode::I16x8__le_u:
+  case SIMDCode::I16x8__ge_s:
+  case SIMDCode::I16x8__ge_u:
+  case SIMDCode::I32x4__eq:
+  case SIMDCode::I32x4__ne:
+  case SIMDCode::I32x4__lt_s:
+  case SIMDCode::I32x4__lt_u:
+  case SIMDCode::I32x4__gt_s:
+  case SIMDCode::I32x4__gt_u:
+  case SIMDCode::I32x4__le_s:
+  case SIMDCode::I32x4__le_u:
+  case SIMDCode::I32x4__ge_s:
+  case SIMDCode::I32x4__ge_u:
+  case SIMDCode::F32x4__eq:
+  case SIMDCode::F32x4__ne:
+  case SIMDCode::F32x4__lt:
+  case SIMDCode::F32x4__gt:
+  case SIMDCode::F32x4__le:
+  case SIMDCode::F32x4__ge:
+  case SIMDCode::F64x2__eq:
+  case SIMDCode::F64x2__ne:
+  case SIMDCode::F64x2__lt:
+  case SIMDCode::F64x2__gt:
+  case SIMDCode::F64x2__le:
+  case SIMDCode::F64x2__ge:
+  case SIMDCode::V128__not:
+  case SIMDCode::V128__and:
+  case SIMDCode::V128__andnot:
+  case SIMDCode::V128__or:
+  case SIMDCode::V128__xor:
+  case SIMDCode::V128__bitselect:
+  case SIMDCode::V128__any_true:
+  case SIMDCode::I8x16__abs:
+  case SIMDCode::I8x16__neg:
+  case SIMDCode::I8x16__all_true:
+  case SIMDCode::I8x16__bitmask:
+  case SIMDCode::I8x16__shl:
+  case SIMDCode::I8x16__shr_s:
+  case SIMDCode::I8x16__shr_u:
+  case SIMDCode::I8x16__add:
+  case SIMDCode::I8x16__sub:
+  case SIMDCode::I8x16__min_s:
+  case SIMDCode::I8x16__min_u:
+  case SIMDCode::I8x16__max_s:
+  case SIMDCode::I8x16__max_u:
+  case SIMDCode::I8x16__avgr_u:
+  case SIMDCode::I16x8__abs:
+  case SIMDCode::I16x8__neg:
+  case SIMDCode::I16x8__all_true:
+  case SIMDCode::I16x8__bitmask:
+  case SIMDCode::I16x8__shl:
+  case SIMDCode::I16x8__shr_s:
+  case SIMDCode::I16x8__shr_u:
+  case SIMDCode::I16x8__add:
+  case SIMDCode::I16x8__sub:
+  case SIMDCode::I16x8__mul:
+  case SIMDCode::I16x8__min_s:
+  case SIMDCode::I16x8__min_u:
+  case SIMDCode::I16x8__max_s:
+  case SIMDCode::I16x8__max_u:
+  case SIMDCode::I16x8__avgr_u:
+  case SIMDCode::I32x4__abs:
+  case SIMDCode::I32x4__neg:
+  case SIMDCode::I32x4__all_true:
+  case SIMDCode::I32x4__bitmask:
+  case SIMDCode::I32x4__shl:
+  case SIMDCode::I32x4__shr_s:
+  case SIMDCode::I32x4__shr_u:
+  case SIMDCode::I32x4__add:
+  case SIMDCode::I32x4__sub:
+  case SIMDCode::I32x4__mul:
+  case SIMDCode::I32x4__min_s:
+  case SIMDCode::I32x4__min_u:
+  case SIMDCode::I32x4__max_s:
+  case SIMDCode::I32x4__max_u:
+  case SIMDCode::I32x4__dot_i16x8_s:
+  case SIMDCode::I64x2__abs:
+  case SIMDCode::I64x2__neg:
+  case SIMDCode::I64x2__all_true:
+  case SIMDCode::I64x2__bitmask:
+  case SIMDCode::I64x2__shl:
+  case SIMDCode::I64x2__shr_s:
+  case SIMDCode::I64x2__shr_u:
+  case SIMDCode::I64x2__add:
+  case SIMDCode::I64x2__sub:
+  case SIMDCode::I64x2__mul:
+  case SIMDCode::I64x2__eq:
+  case SIMDCode::I64x2__ne:
+  case SIMDCode::I64x2__lt_s:
+  case SIMDCode::I64x2__gt_s:
+  case SIMDCode::I64x2__le_s:
+  case SIMDCode::I64x2__ge_s:
+  case SIMDCode::F32x4__abs:
+  case SIMDCode::F32x4__neg:
+  case SIMDCode::F32x4__sqrt:
+  case SIMDCode::F32x4__add:
+  case SIMDCode::F32x4__sub:
+  case SIMDCode::F32x4__mul:
+  case SIMDCode::F32x4__div:
+  case SIMDCode::F32x4__min:
+  case SIMDCode::F32x4__max:
+  case SIMDCode::F32x4__pmin:
+  case SIMDCode::F32x4__pmax:
+  case SIMDCode::F64x2__abs:
+  case SIMDCode::F64x2__neg:
+  case SIMDCode::F64x2__sqrt:
+  case SIMDCode::F64x2__add:
+  case SIMDCode::F64x2__sub:
+  case SIMDCode::F64x2__mul:
+  case SIMDCode::F64x2__div:
+  case SIMDCode::F64x2__min:
+  case SIMDCode::F64x2__max:
+  case SIMDCode::F64x2__pmin:
+  case SIMDCode::F64x2__pmax:
+  case SIMDCode::I32x4__trunc_sat_f32x4_s:
+  case SIMDCode::I32x4__trunc_sat_f32x4_u:
+  case SIMDCode::F32x4__convert_i32x4_s:
+  case SIMDCode::F32x4__convert_i32x4_u:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Load binary of SIMD instructions. See "include/common/ast/instruction.h".
+Expect<void> SIMDInstruction::loadBinary(FileMgr &Mgr) {
+  /// Read the sub-opcode.
+  if (auto Res = Mgr.readU32()) {
+    if (!isSIMDCode(*Res)) {
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+    SubCode = static_cast<SIMDCode>(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+
+  switch (SubCode) {
+  case SIMDCode::V128__load:
+  case SIMDCode::V128__store:
+    /// Read memory arguments.
+    if (auto Res = Mgr.readU32()) {
+      Align = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    if (auto Res = Mgr.readU32()) {
+      Offset = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    return {};
+
+  case SIMDCode::V128__const:
+  case SIMDCode::I8x16__shuffle:
+    /// Read the 16 bytes in little endian.
+    if (auto Res = Mgr.readBytes(16)) {
+      Value = 0;
+      for (uint32_t I = 0; I < 16; ++I) {
+        Value |= static_cast<uint128_t>((*Res)[I]) << (I * 8);
+      }
+    } else {
+      return Unexpect(Res);
+    }
+    return {};
+
+  case SIMDCode::I8x16__extract_lane_s:
+  case SIMDCode::I8x16__extract_lane_u:
+  case SIMDCode::I8x16__replace_lane:
+  case SIMDCode::I16x8__extract_lane_s:
+  case SIMDCode::I16x8__extract_lane_u:
+  case SIMDCode::I16x8__replace_lane:
+  case SIMDCode::I32x4__extract_lane:
+  case SIMDCode::I32x4__replace_lane:
+  case SIMDCode::I64x2__extract_lane:
+  case SIMDCode::I64x2__replace_lane:
+  case SIMDCode::F32x4__extract_lane:
+  case SIMDCode::F32x4__replace_lane:
+  case SIMDCode::F64x2__extract_lane:
+  case SIMDCode::F64x2__replace_lane:
+    /// Read the lane index.
+    if (auto Res = Mgr.readByte()) {
+      Lane = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    return {};
+
+  default:
+    return {};
+  }
+}
+
+/// Getter of operand count. See "include/common/ast/instruction.h".
+uint32_t SIMDInstruction::getOperandNum() const {
+  switch (SubCode) {
+  case SIMDCode::V128__const:
+    return 0;
+  case SIMDCode::V128__load:
+  case SIMDCode::I8x16__splat:
+  case SIMDCode::I16x8__splat:
+  case SIMDCode::I32x4__splat:
+  case SIMDCode::I64x2__splat:
+  case SIMDCode::F32x4__splat:
+  case SIMDCode::F64x2__splat:
+  case SIMDCode::I8x16__extract_lane_s:
+  case SIMDCode::I8x16__extract_lane_u:
+  case SIMDCode::I16x8__extract_lane_s:
+  case SIMDCode::I16x8__extract_lane_u:
+  case SIMDCode::I32x4__extract_lane:
+  case SIMDCode::I64x2__extract_lane:
+  case SIMDCode::F32x4__extract_lane:
+  case SIMDCode::F64x2__extract_lane:
+  case SIMDCode::V128__not:
+  case SIMDCode::V128__any_true:
+  case SIMDCode::I8x16__abs:
+  case SIMDCode::I8x16__neg:
+  case SIMDCode::I8x16__all_true:
+  case SIMDCode::I8x16__bitmask:
+  case SIMDCode::I16x8__abs:
+  case SIMDCode::I16x8__neg:
+  case SIMDCode::I16x8__all_true:
+  case SIMDCode::I16x8__bitmask:
+  case SIMDCode::I32x4__abs:
+  case SIMDCode::I32x4__neg:
+  case SIMDCode::I32x4__all_true:
+  case SIMDCode::I32x4__bitmask:
+  case SIMDCode::I64x2__abs:
+  case SIMDCode::I64x2__neg:
+  case SIMDCode::I64x2__all_true:
+  case SIMDCode::I64x2__bitmask:
+  case SIMDCode::F32x4__abs:
+  case SIMDCode::F32x4__neg:
+  case SIMDCode::F32x4__sqrt:
+  case SIMDCode::F64x2__abs:
+  case SIMDCode::F64x2__neg:
+  case SIMDCode::F64x2__sqrt:
+  case SIMDCode::I32x4__trunc_sat_f32x4_s:
+  case SIMDCode::I32x4__trunc_sat_f32x4_u:
+  case SIMDCode::F32x4__convert_i32x4_s:
+  case SIMDCode::F32x4__convert_i32x4_u:
+    return 1;
+  case SIMDCode::V128__bitselect:
+    return 3;
+  default:
+    return 2;
+  }
+}
+
+namespace {
+
+/// The atomic loads, stores, and read-modify-writes are in the groups of 7
+/// sub-opcodes from 0x10. The position in group decides the access width:
+/// i32, i64, i32 8-bit, i32 16-bit, i64 8-bit, i64 16-bit, and i64 32-bit.
+constexpr uint32_t AtomicGroupBegin = 0x10U;
+constexpr uint32_t AtomicGroupSize = 7U;
+constexpr uint32_t AtomicGroupWidth[AtomicGroupSize] = {4, 8, 1, 2, 1, 2, 4};
+constexpr bool AtomicGroupI64[AtomicGroupSize] = {false, true, false, false,
+                                                  true,  true, true};
+
+} // namespace
+
+/// Check atomic sub-opcode. See "include/common/ast/instruction.h".
+bool isAtomicCode(const uint32_t Code) {
+  constexpr auto Last = AtomicCode::I64__atomic__rmw32__cmpxchg_u;
+  return Code <= static_cast<uint32_t>(AtomicCode::Atomic__fence) ||
+         (Code >= static_cast<uint32_t>(AtomicCode::I32__atomic__load) &&
+          Code <= static_cast<uint32_t>(Last));
+}
+
+/// Load binary of atomic memory instructions. See
+/// "include/common/ast/instruction.h".
+Expect<void> AtomicMemoryInstruction::loadBinary(FileMgr &Mgr) {
+  /// Read the sub-opcode.
+  if (auto Res = Mgr.readU32()) {
+    if (!isAtomicCode(*Res)) {
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+    SubCode = static_cast<AtomicCode>(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+
+  if (SubCode == AtomicCode::Atomic__fence) {
+    /// Read the reserved 0x00 byte.
+    if (auto Res = Mgr.readByte()) {
+      if (*Res != 0x00) {
+        return Unexpect(ErrCode::InvalidGrammar);
+      }
+    } else {
+      return Unexpect(Res);
+    }
+    return {};
+  }
+
+  /// Read memory arguments.
+  if (auto Res = Mgr.readU32()) {
+    Align = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  if (auto Res = Mgr.readU32()) {
+    Offset = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+/// Getter of access size. See "include/common/ast/instruction.h".
+uint32_t AtomicMemoryInstruction::getAccessSize() const {
+  switch (SubCode) {
+  case AtomicCode::Memory__atomic__notify:
+  case AtomicCode::Memory__atomic__wait32:
+    return 4;
+  case AtomicCode::Memory__atomic__wait64:
+    return 8;
+  case AtomicCode::Atomic__fence:
+    return 0;
+  default:
+    return AtomicGroupWidth[(static_cast<uint32_t>(SubCode) -
+                             AtomicGroupBegin) %
+                            AtomicGroupSize];
+  }
+}
+
+/// Getter of value type. See "include/common/ast/instruction.h".
+bool AtomicMemoryInstruction::isI64() const {
+  switch (SubCode) {
+  case AtomicCode::Memory__atomic__notify:
+  case AtomicCode::Memory__atomic__wait32:
+  case AtomicCode::Atomic__fence:
+    return false;
+  case AtomicCode::Memory__atomic__wait64:
+    return true;
+  default:
+    return AtomicGroupI64[(static_cast<uint32_t>(SubCode) -
+                           AtomicGroupBegin) %
+                          AtomicGroupSize];
+  }
+}
+
+/// Getter of operand count. See "include/common/ast/instruction.h".
+uint32_t AtomicMemoryInstruction::getOperandNum() const {
+  const uint32_t Code = static_cast<uint32_t>(SubCode);
+  if (SubCode == AtomicCode::Atomic__fence) {
+    return 0;
+  } else if (SubCode == AtomicCode::Memory__atomic__notify) {
+    return 2;
+  } else if (Code < AtomicGroupBegin) {
+    /// Wait: address, expected value, and timeout.
+    return 3;
+  } else if (Code < static_cast<uint32_t>(AtomicCode::I32__atomic__store)) {
+    return 1;
+  } else if (Code <
+             static_cast<uint32_t>(AtomicCode::I32__atomic__rmw__cmpxchg)) {
+    return 2;
+  }
+  /// Compare exchange: address, expected value, and replacement.
+  return 3;
+}
+
+/// Getter of result. See "include/common/ast/instruction.h".
+bool AtomicMemoryInstruction::hasResult() const {
+  const uint32_t Code = static_cast<uint32_t>(SubCode);
+  if (SubCode == AtomicCode::Atomic__fence) {
+    return false;
+  }
+  return Code < static_cast<uint32_t>(AtomicCode::I32__atomic__store) ||
+         Code >= static_cast<uint32_t>(AtomicCode::I32__atomic__rmw__add);
+}
+
 /// Instruction node maker. See "include/common/ast/instruction.h".
 Expect<std::unique_ptr<Instruction>>
 makeInstructionNode(const Instruction::OpCode &Code) {
@@ -300,6 +757,44 @@ makeInstructionNode(const Instruction::OpCode &Code) {
       });
 }
 
+/// OpCode loader. See "include/common/ast/instruction.h".
+Expect<Instruction::OpCode> loadOpCode(FileMgr &Mgr) {
+  uint8_t Byte = 0;
+  if (auto Res = Mgr.readByte()) {
+    Byte = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+
+  /// The internal codes of prefixed instructions are not valid in binary.
+  if (Byte >= static_cast<uint8_t>(Instruction::OpCode::Memory__init) &&
+      Byte <= static_cast<uint8_t>(Instruction::OpCode::Memory__fill)) {
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  /// The SIMD and atomic sub-opcodes are read by the instruction nodes.
+  if (Byte != Instruction::PrefixFC) {
+    return static_cast<Instruction::OpCode>(Byte);
+  }
+
+  /// Read the sub-opcode of 0xFC prefix.
+  if (auto Res = Mgr.readU32()) {
+    switch (*Res) {
+    case 8:
+      return Instruction::OpCode::Memory__init;
+    case 9:
+      return Instruction::OpCode::Data__drop;
+    case 10:
+      return Instruction::OpCode::Memory__copy;
+    case 11:
+      return Instruction::OpCode::Memory__fill;
+    default:
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+  } else {
+    return Unexpect(Res);
+  }
+}
+
 /// Instruction node duplicater. See "include/common/ast/instruction.h".
 Expect<std::unique_ptr<Instruction>>
 makeInstructionNode(const Instruction &Instr) {
@@ -129,6 +129,14 @@ Expect<void> Module::loadBinary(FileMgr &Mgr) {
         return Unexpect(Res);
       }
       break;
+    case 0x0C:
+      if (DataCountSec == nullptr) {
+        DataCountSec = std::make_unique<DataCountSection>();
+      }
+      if (auto Res = DataCountSec->loadBinary(Mgr); !Res) {
+        return Unexpect(Res);
+      }
+      break;
     default:
       return Unexpect(ErrCode::InvalidGrammar);
     }
@@ -108,5 +108,15 @@ Expect<void> DataSection::loadContent(FileMgr &Mgr) {
   return Section::loadToVector(Mgr, Content);
 }
 
+/// Load data segment count. See "include/ast/section.h".
+Expect<void> DataCountSection::loadContent(FileMgr &Mgr) {
+  if (auto Res = Mgr.readU32()) {
+    Content = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 } // namespace AST
 } // namespace SSVM
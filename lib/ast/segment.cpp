@@ -92,17 +92,37 @@ Expect<void> CodeSegment::loadBinary(FileMgr &Mgr) {
 
 /// Load binary of DataSegment node. See "include/common/ast/segment.h".
 Expect<void> DataSegment::loadBinary(FileMgr &Mgr) {
-  /// Read target memory index.
+  /// Read the segment flag. 0 for active segment in memory 0, 1 for passive
+  /// segment, and 2 for active segment with explicit memory index.
+  uint32_t Flag = 0;
   if (auto Res = Mgr.readU32()) {
-    MemoryIdx = *Res;
+    Flag = *Res;
   } else {
     return Unexpect(Res);
   }
+  switch (Flag) {
+  case 0:
+    break;
+  case 1:
+    IsPassive = true;
+    break;
+  case 2:
+    /// Read target memory index.
+    if (auto Res = Mgr.readU32()) {
+      MemoryIdx = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    break;
+  default:
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
 
   /// Read the offset expression.
-  auto Expr = Segment::loadExpression(Mgr);
-  if (!Expr) {
-    return Unexpect(Expr);
+  if (!IsPassive) {
+    if (auto Res = Segment::loadExpression(Mgr); !Res) {
+      return Unexpect(Res);
+    }
   }
 
   /// Read initialization data.
@@ -13,7 +13,8 @@ Expect<void> Limit::loadBinary(FileMgr &Mgr) {
   } else {
     return Unexpect(Res);
   }
-  if (Type != LimitType::HasMin && Type != LimitType::HasMinMax) {
+  if (Type != LimitType::HasMin && Type != LimitType::HasMinMax &&
+      Type != LimitType::SharedHasMinMax) {
     return Unexpect(ErrCode::InvalidGrammar);
   }
 
@@ -23,7 +24,7 @@ Expect<void> Limit::loadBinary(FileMgr &Mgr) {
   } else {
     return Unexpect(Res);
   }
-  if (Type == LimitType::HasMinMax) {
+  if (Type != LimitType::HasMin) {
     if (auto Res = Mgr.readU32()) {
       Max = *Res;
     } else {
@@ -60,6 +61,7 @@ Expect<void> FunctionType::loadBinary(FileMgr &Mgr) {
       case ValType::I64:
       case ValType::F32:
       case ValType::F64:
+      case ValType::V128:
         break;
       default:
         return Unexpect(ErrCode::InvalidGrammar);
@@ -84,6 +86,7 @@ Expect<void> FunctionType::loadBinary(FileMgr &Mgr) {
       case ValType::I64:
       case ValType::F32:
       case ValType::F64:
+      case ValType::V128:
         break;
       default:
         return Unexpect(ErrCode::InvalidGrammar);
@@ -142,6 +145,7 @@ Expect<void> GlobalType::loadBinary(FileMgr &Mgr) {
   case ValType::I64:
   case ValType::F32:
   case ValType::F64:
+  case ValType::V128:
     break;
   default:
     return Unexpect(ErrCode::InvalidGrammar);
@@ -74,6 +74,7 @@ struct Compiler::CompileContext {
       std::tuple<unsigned int, llvm::Function *, SSVM::AST::CodeSegment *>>
       Functions;
   std::vector<llvm::GlobalVariable *> Globals;
+  std::vector<llvm::GlobalVariable *> Datas;
   std::vector<llvm::Function *> Ctors;
   llvm::GlobalVariable *LibCtx;
   llvm::Function *Trap;
@@ -121,6 +122,8 @@ static llvm::Type *toLLVMType(llvm::LLVMContext &Context,
     return llvm::Type::getFloatTy(Context);
   case SSVM::ValType::F64:
     return llvm::Type::getDoubleTy(Context);
+  case SSVM::ValType::V128:
+    return llvm::VectorType::get(llvm::Type::getInt64Ty(Context), 2);
   default:
     assert(false);
     __builtin_unreachable();
@@ -160,6 +163,9 @@ static llvm::Constant *toLLVMConstantZero(llvm::LLVMContext &Context,
     return llvm::ConstantFP::get(llvm::Type::getFloatTy(Context), 0.0f);
   case SSVM::ValType::F64:
     return llvm::ConstantFP::get(llvm::Type::getDoubleTy(Context), 0.0);
+  case SSVM::ValType::V128:
+    return llvm::ConstantAggregateZero::get(
+        llvm::VectorType::get(llvm::Type::getInt64Ty(Context), 2));
   default:
     assert(false);
     __builtin_unreachable();
@@ -353,6 +359,10 @@ public:
     case OpCode::Call_indirect: {
       return compileIndirectCallOp(Instr.getFuncIndex());
     }
+    case OpCode::Return_call:
+      return compileCallOp(Instr.getFuncIndex(), true);
+    case OpCode::Return_call_indirect:
+      return compileIndirectCallOp(Instr.getFuncIndex(), true);
     default:
       __builtin_unreachable();
     }
@@ -479,6 +489,27 @@ public:
     case OpCode::Memory__grow:
       Stack.back() = Builder.CreateCall(Context.MemoryGrow, {Stack.back()});
       break;
+    case OpCode::Memory__init:
+      return compileMemoryInitOp(Instr.getDataIndex());
+    case OpCode::Data__drop:
+      /// Data segments are constants in compiled module. Nothing to release.
+      break;
+    case OpCode::Memory__copy:
+    case OpCode::Memory__fill: {
+      llvm::Value *Len = Stack.back();
+      Stack.pop_back();
+      llvm::Value *Val = Stack.back();
+      Stack.pop_back();
+      llvm::Value *Dst = getMemoryPtr(Stack.back());
+      Stack.pop_back();
+      if (Instr.getOpCode() == OpCode::Memory__copy) {
+        Builder.CreateMemMove(Dst, 1, getMemoryPtr(Val), 1, Len);
+      } else {
+        Builder.CreateMemSet(Dst, Builder.CreateTrunc(Val, Builder.getInt8Ty()),
+                             Len, 1);
+      }
+      break;
+    }
     default:
       __builtin_unreachable();
     }
@@ -865,6 +896,389 @@ public:
     }
     return ErrCode::Success;
   }
+  ErrCode compile(const SSVM::AST::SIMDInstruction &Instr) {
+    using SSVM::AST::SIMDCode;
+    llvm::Type *I8x16 = llvm::VectorType::get(Builder.getInt8Ty(), 16);
+    llvm::Type *I16x8 = llvm::VectorType::get(Builder.getInt16Ty(), 8);
+    llvm::Type *I32x4 = llvm::VectorType::get(Builder.getInt32Ty(), 4);
+    llvm::Type *I64x2 = llvm::VectorType::get(Builder.getInt64Ty(), 2);
+    llvm::Type *F32x4 = llvm::VectorType::get(Builder.getFloatTy(), 4);
+    llvm::Type *F64x2 = llvm::VectorType::get(Builder.getDoubleTy(), 2);
+    const unsigned int Lane = Instr.getLaneIndex();
+
+    switch (Instr.getSIMDCode()) {
+    case SIMDCode::V128__load:
+      return compileLoadOp(Instr.getMemoryOffset(), I64x2);
+    case SIMDCode::V128__store:
+      return compileStoreOp(Instr.getMemoryOffset(), I64x2);
+    case SIMDCode::V128__const: {
+      const SSVM::uint128_t Value = Instr.getValue();
+      const uint64_t Lanes[2] = {static_cast<uint64_t>(Value),
+                                 static_cast<uint64_t>(Value >> 64)};
+      Stack.push_back(llvm::ConstantDataVector::get(VMContext, Lanes));
+      break;
+    }
+
+    case SIMDCode::I8x16__splat:
+      return compileSplatOp(I8x16, true);
+    case SIMDCode::I16x8__splat:
+      return compileSplatOp(I16x8, true);
+    case SIMDCode::I32x4__splat:
+      return compileSplatOp(I32x4, false);
+    case SIMDCode::I64x2__splat:
+      return compileSplatOp(I64x2, false);
+    case SIMDCode::F32x4__splat:
+      return compileSplatOp(F32x4, false);
+    case SIMDCode::F64x2__splat:
+      return compileSplatOp(F64x2, false);
+
+    case SIMDCode::I8x16__extract_lane_s:
+      Stack.back() = Builder.CreateSExt(
+          Builder.CreateExtractElement(toVector(Stack.back(), I8x16), Lane),
+          Builder.getInt32Ty());
+      break;
+    case SIMDCode::I8x16__extract_lane_u:
+      Stack.back() = Builder.CreateZExt(
+          Builder.CreateExtractElement(toVector(Stack.back(), I8x16), Lane),
+          Builder.getInt32Ty());
+      break;
+    case SIMDCode::I16x8__extract_lane_s:
+      Stack.back() = Builder.CreateSExt(
+          Builder.CreateExtractElement(toVector(Stack.back(), I16x8), Lane),
+          Builder.getInt32Ty());
+      break;
+    case SIMDCode::I16x8__extract_lane_u:
+      Stack.back() = Builder.CreateZExt(
+          Builder.CreateExtractElement(toVector(Stack.back(), I16x8), Lane),
+          Builder.getInt32Ty());
+      break;
+    case SIMDCode::I32x4__extract_lane:
+      Stack.back() =
+          Builder.CreateExtractElement(toVector(Stack.back(), I32x4), Lane);
+      break;
+    case SIMDCode::I64x2__extract_lane:
+      Stack.back() = Builder.CreateExtractElement(Stack.back(), Lane);
+      break;
+    case SIMDCode::F32x4__extract_lane:
+      Stack.back() =
+          Builder.CreateExtractElement(toVector(Stack.back(), F32x4), Lane);
+      break;
+    case SIMDCode::F64x2__extract_lane:
+      Stack.back() =
+          Builder.CreateExtractElement(toVector(Stack.back(), F64x2), Lane);
+      break;
+
+    case SIMDCode::I8x16__replace_lane:
+      return compileReplaceLaneOp(I8x16, Lane, true);
+    case SIMDCode::I16x8__replace_lane:
+      return compileReplaceLaneOp(I16x8, Lane, true);
+    case SIMDCode::I32x4__replace_lane:
+      return compileReplaceLaneOp(I32x4, Lane, false);
+    case SIMDCode::I64x2__replace_lane:
+      return compileReplaceLaneOp(I64x2, Lane, false);
+    case SIMDCode::F32x4__replace_lane:
+      return compileReplaceLaneOp(F32x4, Lane, false);
+    case SIMDCode::F64x2__replace_lane:
+      return compileReplaceLaneOp(F64x2, Lane, false);
+
+    case SIMDCode::I8x16__eq:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_EQ);
+    case SIMDCode::I8x16__ne:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_NE);
+    case SIMDCode::I8x16__lt_s:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_SLT);
+    case SIMDCode::I8x16__lt_u:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_ULT);
+    case SIMDCode::I8x16__gt_s:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_SGT);
+    case SIMDCode::I8x16__gt_u:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_UGT);
+    case SIMDCode::I8x16__le_s:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_SLE);
+    case SIMDCode::I8x16__le_u:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_ULE);
+    case SIMDCode::I8x16__ge_s:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_SGE);
+    case SIMDCode::I8x16__ge_u:
+      return compileVectorCmpOp(I8x16, llvm::CmpInst::ICMP_UGE);
+    case SIMDCode::I16x8__eq:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_EQ);
+    case SIMDCode::I16x8__ne:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_NE);
+    case SIMDCode::I16x8__lt_s:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_SLT);
+    case SIMDCode::I16x8__lt_u:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_ULT);
+    case SIMDCode::I16x8__gt_s:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_SGT);
+    case SIMDCode::I16x8__gt_u:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_UGT);
+    case SIMDCode::I16x8__le_s:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_SLE);
+    case SIMDCode::I16x8__le_u:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_ULE);
+    case SIMDCode::I16x8__ge_s:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_SGE);
+    case SIMDCode::I16x8__ge_u:
+      return compileVectorCmpOp(I16x8, llvm::CmpInst::ICMP_UGE);
+    case SIMDCode::I32x4__eq:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_EQ);
+    case SIMDCode::I32x4__ne:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_NE);
+    case SIMDCode::I32x4__lt_s:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_SLT);
+    case SIMDCode::I32x4__lt_u:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_ULT);
+    case SIMDCode::I32x4__gt_s:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_SGT);
+    case SIMDCode::I32x4__gt_u:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_UGT);
+    case SIMDCode::I32x4__le_s:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_SLE);
+    case SIMDCode::I32x4__le_u:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_ULE);
+    case SIMDCode::I32x4__ge_s:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_SGE);
+    case SIMDCode::I32x4__ge_u:
+      return compileVectorCmpOp(I32x4, llvm::CmpInst::ICMP_UGE);
+    case SIMDCode::I64x2__eq:
+      return compileVectorCmpOp(I64x2, llvm::CmpInst::ICMP_EQ);
+    case SIMDCode::I64x2__ne:
+      return compileVectorCmpOp(I64x2, llvm::CmpInst::ICMP_NE);
+    case SIMDCode::I64x2__lt_s:
+      return compileVectorCmpOp(I64x2, llvm::CmpInst::ICMP_SLT);
+    case SIMDCode::I64x2__gt_s:
+      return compileVectorCmpOp(I64x2, llvm::CmpInst::ICMP_SGT);
+    case SIMDCode::I64x2__le_s:
+      return compileVectorCmpOp(I64x2, llvm::CmpInst::ICMP_SLE);
+    case SIMDCode::I64x2__ge_s:
+      return compileVectorCmpOp(I64x2, llvm::CmpInst::ICMP_SGE);
+    case SIMDCode::F32x4__eq:
+      return compileVectorCmpOp(F32x4, llvm::CmpInst::FCMP_OEQ);
+    case SIMDCode::F32x4__ne:
+      return compileVectorCmpOp(F32x4, llvm::CmpInst::FCMP_UNE);
+    case SIMDCode::F32x4__lt:
+      return compileVectorCmpOp(F32x4, llvm::CmpInst::FCMP_OLT);
+    case SIMDCode::F32x4__gt:
+      return compileVectorCmpOp(F32x4, llvm::CmpInst::FCMP_OGT);
+    case SIMDCode::F32x4__le:
+      return compileVectorCmpOp(F32x4, llvm::CmpInst::FCMP_OLE);
+    case SIMDCode::F32x4__ge:
+      return compileVectorCmpOp(F32x4, llvm::CmpInst::FCMP_OGE);
+    case SIMDCode::F64x2__eq:
+      return compileVectorCmpOp(F64x2, llvm::CmpInst::FCMP_OEQ);
+    case SIMDCode::F64x2__ne:
+      return compileVectorCmpOp(F64x2, llvm::CmpInst::FCMP_UNE);
+    case SIMDCode::F64x2__lt:
+      return compileVectorCmpOp(F64x2, llvm::CmpInst::FCMP_OLT);
+    case SIMDCode::F64x2__gt:
+      return compileVectorCmpOp(F64x2, llvm::CmpInst::FCMP_OGT);
+    case SIMDCode::F64x2__le:
+      return compileVectorCmpOp(F64x2, llvm::CmpInst::FCMP_OLE);
+    case SIMDCode::F64x2__ge:
+      return compileVectorCmpOp(F64x2, llvm::CmpInst::FCMP_OGE);
+
+    case SIMDCode::V128__not:
+      Stack.back() = Builder.CreateNot(Stack.back());
+      break;
+    case SIMDCode::V128__and:
+      return compileVectorOp(I64x2, llvm::Instruction::And);
+    case SIMDCode::V128__or:
+      return compileVectorOp(I64x2, llvm::Instruction::Or);
+    case SIMDCode::V128__xor:
+      return compileVectorOp(I64x2, llvm::Instruction::Xor);
+    case SIMDCode::V128__andnot: {
+      llvm::Value *RHS = Builder.CreateNot(Stack.back());
+      Stack.pop_back();
+      Stack.back() = Builder.CreateAnd(Stack.back(), RHS);
+      break;
+    }
+    case SIMDCode::V128__bitselect: {
+      llvm::Value *C = Stack.back();
+      Stack.pop_back();
+      llvm::Value *V2 = Stack.back();
+      Stack.pop_back();
+      Stack.back() =
+          Builder.CreateOr(Builder.CreateAnd(Stack.back(), C),
+                           Builder.CreateAnd(V2, Builder.CreateNot(C)));
+      break;
+    }
+    case SIMDCode::V128__any_true:
+      Stack.back() = Builder.CreateZExt(
+          Builder.CreateICmpNE(
+              Builder.CreateBitCast(Stack.back(), Builder.getIntNTy(128)),
+              Builder.getIntN(128, 0)),
+          Builder.getInt32Ty());
+      break;
+
+    case SIMDCode::I8x16__neg:
+      Stack.back() =
+          fromVector(Builder.CreateNeg(toVector(Stack.back(), I8x16)));
+      break;
+    case SIMDCode::I16x8__neg:
+      Stack.back() =
+          fromVector(Builder.CreateNeg(toVector(Stack.back(), I16x8)));
+      break;
+    case SIMDCode::I32x4__neg:
+      Stack.back() =
+          fromVector(Builder.CreateNeg(toVector(Stack.back(), I32x4)));
+      break;
+    case SIMDCode::I64x2__neg:
+      Stack.back() = Builder.CreateNeg(Stack.back());
+      break;
+    case SIMDCode::I8x16__shl:
+      return compileVectorShiftOp(I8x16, llvm::Instruction::Shl);
+    case SIMDCode::I8x16__shr_s:
+      return compileVectorShiftOp(I8x16, llvm::Instruction::AShr);
+    case SIMDCode::I8x16__shr_u:
+      return compileVectorShiftOp(I8x16, llvm::Instruction::LShr);
+    case SIMDCode::I16x8__shl:
+      return compileVectorShiftOp(I16x8, llvm::Instruction::Shl);
+    case SIMDCode::I16x8__shr_s:
+      return compileVectorShiftOp(I16x8, llvm::Instruction::AShr);
+    case SIMDCode::I16x8__shr_u:
+      return compileVectorShiftOp(I16x8, llvm::Instruction::LShr);
+    case SIMDCode::I32x4__shl:
+      return compileVectorShiftOp(I32x4, llvm::Instruction::Shl);
+    case SIMDCode::I32x4__shr_s:
+      return compileVectorShiftOp(I32x4, llvm::Instruction::AShr);
+    case SIMDCode::I32x4__shr_u:
+      return compileVectorShiftOp(I32x4, llvm::Instruction::LShr);
+    case SIMDCode::I64x2__shl:
+      return compileVectorShiftOp(I64x2, llvm::Instruction::Shl);
+    case SIMDCode::I64x2__shr_s:
+      return compileVectorShiftOp(I64x2, llvm::Instruction::AShr);
+    case SIMDCode::I64x2__shr_u:
+      return compileVectorShiftOp(I64x2, llvm::Instruction::LShr);
+    case SIMDCode::I8x16__add:
+      return compileVectorOp(I8x16, llvm::Instruction::Add);
+    case SIMDCode::I8x16__sub:
+      return compileVectorOp(I8x16, llvm::Instruction::Sub);
+    case SIMDCode::I16x8__add:
+      return compileVectorOp(I16x8, llvm::Instruction::Add);
+    case SIMDCode::I16x8__sub:
+      return compileVectorOp(I16x8, llvm::Instruction::Sub);
+    case SIMDCode::I16x8__mul:
+      return compileVectorOp(I16x8, llvm::Instruction::Mul);
+    case SIMDCode::I32x4__add:
+      return compileVectorOp(I32x4, llvm::Instruction::Add);
+    case SIMDCode::I32x4__sub:
+      return compileVectorOp(I32x4, llvm::Instruction::Sub);
+    case SIMDCode::I32x4__mul:
+      return compileVectorOp(I32x4, llvm::Instruction::Mul);
+    case SIMDCode::I64x2__add:
+      return compileVectorOp(I64x2, llvm::Instruction::Add);
+    case SIMDCode::I64x2__sub:
+      return compileVectorOp(I64x2, llvm::Instruction::Sub);
+    case SIMDCode::I64x2__mul:
+      return compileVectorOp(I64x2, llvm::Instruction::Mul);
+
+    case SIMDCode::F32x4__add:
+      return compileVectorOp(F32x4, llvm::Instruction::FAdd);
+    case SIMDCode::F32x4__sub:
+      return compileVectorOp(F32x4, llvm::Instruction::FSub);
+    case SIMDCode::F32x4__mul:
+      return compileVectorOp(F32x4, llvm::Instruction::FMul);
+    case SIMDCode::F32x4__div:
+      return compileVectorOp(F32x4, llvm::Instruction::FDiv);
+    case SIMDCode::F64x2__add:
+      return compileVectorOp(F64x2, llvm::Instruction::FAdd);
+    case SIMDCode::F64x2__sub:
+      return compileVectorOp(F64x2, llvm::Instruction::FSub);
+    case SIMDCode::F64x2__mul:
+      return compileVectorOp(F64x2, llvm::Instruction::FMul);
+    case SIMDCode::F64x2__div:
+      return compileVectorOp(F64x2, llvm::Instruction::FDiv);
+    case SIMDCode::F32x4__sqrt:
+      Stack.back() = fromVector(Builder.CreateUnaryIntrinsic(
+          llvm::Intrinsic::sqrt, toVector(Stack.back(), F32x4)));
+      break;
+    case SIMDCode::F64x2__sqrt:
+      Stack.back() = fromVector(Builder.CreateUnaryIntrinsic(
+          llvm::Intrinsic::sqrt, toVector(Stack.back(), F64x2)));
+      break;
+    case SIMDCode::F32x4__convert_i32x4_s:
+      Stack.back() = fromVector(
+          Builder.CreateSIToFP(toVector(Stack.back(), I32x4), F32x4));
+      break;
+    case SIMDCode::F32x4__convert_i32x4_u:
+      Stack.back() = fromVector(
+          Builder.CreateUIToFP(toVector(Stack.back(), I32x4), F32x4));
+      break;
+
+    default:
+      /// Other SIMD instructions are only supported by the interpreter.
+      return ErrCode::Failed;
+    }
+    return ErrCode::Success;
+  }
+  ErrCode compile(const SSVM::AST::AtomicMemoryInstruction &Instr) {
+    using SSVM::AST::AtomicCode;
+    const auto Order = llvm::AtomicOrdering::SequentiallyConsistent;
+    const AtomicCode Code = Instr.getAtomicCode();
+    if (Code == AtomicCode::Atomic__fence) {
+      Builder.CreateFence(Order);
+      return ErrCode::Success;
+    }
+    if (Code == AtomicCode::Memory__atomic__notify ||
+        Code == AtomicCode::Memory__atomic__wait32 ||
+        Code == AtomicCode::Memory__atomic__wait64) {
+      /// Wait and notify are only supported by the interpreter.
+      return ErrCode::Failed;
+    }
+
+    const unsigned int Size = Instr.getAccessSize();
+    llvm::Type *AccessTy = Builder.getIntNTy(Size * 8);
+    llvm::Type *ValTy =
+        Instr.isI64() ? Builder.getInt64Ty() : Builder.getInt32Ty();
+    const uint32_t OperandNum = Instr.getOperandNum();
+    std::vector<llvm::Value *> Vals(Stack.end() - (OperandNum - 1),
+                                    Stack.end());
+    Stack.erase(Stack.end() - (OperandNum - 1), Stack.end());
+    for (auto &V : Vals) {
+      V = Builder.CreateTrunc(V, AccessTy);
+    }
+    llvm::Value *O = Stack.back();
+    Stack.pop_back();
+    if (Instr.getMemoryOffset() != 0) {
+      O = Builder.CreateAdd(O, Builder.getInt32(Instr.getMemoryOffset()));
+    }
+    llvm::Value *Ptr = Builder.CreateBitCast(
+        getMemoryPtr(O), llvm::PointerType::getUnqual(AccessTy));
+
+    llvm::Value *Old = nullptr;
+    const uint32_t Group =
+        (static_cast<uint32_t>(Code) -
+         static_cast<uint32_t>(AtomicCode::I32__atomic__load)) /
+        7;
+    switch (Group) {
+    case 0: {
+      auto *Load = Builder.CreateAlignedLoad(Ptr, Size);
+      Load->setAtomic(Order);
+      Old = Load;
+      break;
+    }
+    case 1: {
+      auto *Store = Builder.CreateAlignedStore(Vals[0], Ptr, Size);
+      Store->setAtomic(Order);
+      return ErrCode::Success;
+    }
+    case 8:
+      Old = Builder.CreateExtractValue(
+          Builder.CreateAtomicCmpXchg(Ptr, Vals[0], Vals[1], Order, Order), 0);
+      break;
+    default: {
+      static const llvm::AtomicRMWInst::BinOp Ops[] = {
+          llvm::AtomicRMWInst::Add, llvm::AtomicRMWInst::Sub,
+          llvm::AtomicRMWInst::And, llvm::AtomicRMWInst::Or,
+          llvm::AtomicRMWInst::Xor, llvm::AtomicRMWInst::Xchg};
+      Old = Builder.CreateAtomicRMW(Ops[Group - 2], Ptr, Vals[0], Order);
+      break;
+    }
+    }
+    Stack.push_back(Builder.CreateZExt(Old, ValTy));
+    return ErrCode::Success;
+  }
 
   void epilog() {
     if (F->getReturnType()->isVoidTy()) {
@@ -883,7 +1297,21 @@ public:
   }
 
 private:
-  ErrCode compileCallOp(const unsigned int FuncIndex) {
+  /// Mark the call as a tail call and return its result. The call must be a
+  /// sibling call when the prototypes are the same.
+  void compileTailReturn(llvm::CallInst *Call) {
+    Call->setTailCallKind(Call->getFunctionType() == F->getFunctionType()
+                              ? llvm::CallInst::TCK_MustTail
+                              : llvm::CallInst::TCK_Tail);
+    if (F->getReturnType()->isVoidTy()) {
+      Builder.CreateRetVoid();
+    } else {
+      Builder.CreateRet(Call);
+    }
+  }
+
+  ErrCode compileCallOp(const unsigned int FuncIndex,
+                        const bool IsTail = false) {
     const auto &FuncType =
         *Context.FunctionTypes[std::get<0>(Context.Functions[FuncIndex])];
     const auto &Function = std::get<1>(Context.Functions[FuncIndex]);
@@ -893,17 +1321,22 @@ private:
     }
     auto Begin = Stack.end() - FuncType.getParamTypes().size();
     auto End = Stack.end();
-    llvm::Value *Ret = Builder.CreateCall(
+    llvm::CallInst *Ret = Builder.CreateCall(
         Function, llvm::ArrayRef<llvm::Value *>(&*Begin, &*End));
     Stack.erase(Begin, End);
-    if (!FuncType.getReturnTypes().empty()) {
+    if (IsTail) {
+      compileTailReturn(Ret);
+      Builder.SetInsertPoint(
+          llvm::BasicBlock::Create(VMContext, "return_call.end", F));
+    } else if (!FuncType.getReturnTypes().empty()) {
       Stack.push_back(Ret);
     }
 
     return ErrCode::Success;
   }
 
-  ErrCode compileIndirectCallOp(const unsigned int FuncTypeIndex) {
+  ErrCode compileIndirectCallOp(const unsigned int FuncTypeIndex,
+                                const bool IsTail = false) {
     const auto &FuncType = *Context.FunctionTypes[FuncTypeIndex];
     if (Stack.size() < FuncType.getParamTypes().size()) {
       return ErrCode::Failed;
@@ -926,7 +1359,7 @@ private:
         Builder.CreateSwitch(Stack.back(), Error, Table.size());
 
     llvm::PHINode *PHIRet = nullptr;
-    if (!FuncType.getReturnTypes().empty()) {
+    if (!IsTail && !FuncType.getReturnTypes().empty()) {
       PHIRet = llvm::PHINode::Create(
           toLLVMType(VMContext, FuncType.getReturnTypes().front()),
           Table.size(), "", OK);
@@ -936,10 +1369,14 @@ private:
       llvm::BasicBlock *Entry = llvm::BasicBlock::Create(
           VMContext, "call_indirect." + std::to_string(Value), F);
       Builder.SetInsertPoint(Entry);
-      llvm::Value *Ret = Builder.CreateCall(
+      llvm::CallInst *Ret = Builder.CreateCall(
           Func, llvm::ArrayRef<llvm::Value *>(&*Begin, &*End));
-      Builder.CreateBr(OK);
       Switch->addCase(Builder.getInt32(Value), Entry);
+      if (IsTail) {
+        compileTailReturn(Ret);
+        continue;
+      }
+      Builder.CreateBr(OK);
       if (PHIRet) {
         PHIRet->addIncoming(Ret, Entry);
       }
@@ -963,6 +1400,30 @@ private:
     return ErrCode::Success;
   }
 
+  llvm::Value *getMemoryPtr(llvm::Value *Offset) {
+    return Builder.CreateInBoundsGEP(
+        Builder.CreateLoad(Context.Memory),
+        {Builder.CreateZExt(Offset, Builder.getInt64Ty())});
+  }
+
+  ErrCode compileMemoryInitOp(unsigned int DataIndex) {
+    if (DataIndex >= Context.Datas.size() || !Context.Datas[DataIndex]) {
+      return ErrCode::Failed;
+    }
+    llvm::Value *Len = Stack.back();
+    Stack.pop_back();
+    llvm::Value *Src = Stack.back();
+    Stack.pop_back();
+    llvm::Value *Dst = getMemoryPtr(Stack.back());
+    Stack.pop_back();
+
+    llvm::Value *SrcPtr = Builder.CreateInBoundsGEP(
+        Builder.CreateBitCast(Context.Datas[DataIndex], Builder.getInt8PtrTy()),
+        {Builder.CreateZExt(Src, Builder.getInt64Ty())});
+    Builder.CreateMemCpy(Dst, 1, SrcPtr, 1, Len);
+    return ErrCode::Success;
+  }
+
   ErrCode compileLoadOp(unsigned int Offset, llvm::Type *LoadTy) {
     llvm::Value *O = Stack.back();
     if (Offset != 0) {
@@ -1009,6 +1470,73 @@ private:
     return ErrCode::Success;
   }
 
+  /// The v128 values are kept as <2 x i64> on stack, and casted to the vector
+  /// types of lane shapes when operating.
+  llvm::Value *toVector(llvm::Value *V, llvm::Type *VecTy) {
+    return Builder.CreateBitCast(V, VecTy);
+  }
+  llvm::Value *fromVector(llvm::Value *V) {
+    return Builder.CreateBitCast(
+        V, llvm::VectorType::get(Builder.getInt64Ty(), 2));
+  }
+
+  ErrCode compileSplatOp(llvm::Type *VecTy, bool Trunc) {
+    llvm::Value *V = Stack.back();
+    if (Trunc) {
+      V = Builder.CreateTrunc(V, VecTy->getVectorElementType());
+    }
+    Stack.back() = fromVector(
+        Builder.CreateVectorSplat(VecTy->getVectorNumElements(), V));
+    return ErrCode::Success;
+  }
+
+  ErrCode compileReplaceLaneOp(llvm::Type *VecTy, unsigned int Lane,
+                               bool Trunc) {
+    llvm::Value *V = Stack.back();
+    Stack.pop_back();
+    if (Trunc) {
+      V = Builder.CreateTrunc(V, VecTy->getVectorElementType());
+    }
+    Stack.back() = fromVector(
+        Builder.CreateInsertElement(toVector(Stack.back(), VecTy), V, Lane));
+    return ErrCode::Success;
+  }
+
+  ErrCode compileVectorOp(llvm::Type *VecTy,
+                          llvm::Instruction::BinaryOps Op) {
+    llvm::Value *RHS = toVector(Stack.back(), VecTy);
+    Stack.pop_back();
+    Stack.back() = fromVector(
+        Builder.CreateBinOp(Op, toVector(Stack.back(), VecTy), RHS));
+    return ErrCode::Success;
+  }
+
+  ErrCode compileVectorShiftOp(llvm::Type *VecTy,
+                               llvm::Instruction::BinaryOps Op) {
+    llvm::Type *ElemTy = VecTy->getVectorElementType();
+    const unsigned int Bits = ElemTy->getIntegerBitWidth();
+    llvm::Value *Cnt =
+        Builder.CreateAnd(Stack.back(), Builder.getInt32(Bits - 1));
+    Stack.pop_back();
+    Cnt = Builder.CreateZExtOrTrunc(Cnt, ElemTy);
+    Stack.back() = fromVector(Builder.CreateBinOp(
+        Op, toVector(Stack.back(), VecTy),
+        Builder.CreateVectorSplat(VecTy->getVectorNumElements(), Cnt)));
+    return ErrCode::Success;
+  }
+
+  ErrCode compileVectorCmpOp(llvm::Type *VecTy, llvm::CmpInst::Predicate Pred) {
+    llvm::Value *RHS = toVector(Stack.back(), VecTy);
+    Stack.pop_back();
+    llvm::Value *Cmp =
+        Builder.CreateCmp(Pred, toVector(Stack.back(), VecTy), RHS);
+    /// The results are the lanes of all ones or all zeros.
+    llvm::Type *MaskTy = llvm::VectorType::getInteger(
+        llvm::cast<llvm::VectorType>(VecTy));
+    Stack.back() = fromVector(Builder.CreateSExt(Cmp, MaskTy));
+    return ErrCode::Success;
+  }
+
   void enterBlock(llvm::BasicBlock *JumpTarget, llvm::BasicBlock *NextTarget) {
     ControlStack.emplace_back(Stack.size(), JumpTarget, NextTarget);
   }
@@ -1341,6 +1869,21 @@ ErrCode Compiler::compile(const AST::MemorySection &MemorySection,
   auto &VMContext = Context->Context;
   std::vector<char> ResultData;
   for (const auto &DataSeg : DataSec.getContent()) {
+    /// Passive data segments are kept as constants for memory.init.
+    if (DataSeg->isPassive()) {
+      const auto &Data = DataSeg->getData();
+      llvm::Constant *Content = llvm::ConstantDataArray::getString(
+          VMContext,
+          llvm::StringRef(reinterpret_cast<const char *>(Data.data()),
+                          Data.size()),
+          false);
+      Context->Datas.push_back(new llvm::GlobalVariable(
+          Context->Module, Content->getType(), true,
+          llvm::GlobalVariable::PrivateLinkage, Content));
+      continue;
+    }
+    Context->Datas.push_back(nullptr);
+
     llvm::Constant *Temp =
         FunctionCompiler::evaluate(DataSeg->getInstrs(), *Context);
     const uint64_t Offset = llvm::cast<llvm::ConstantInt>(Temp)->getZExtValue();
@@ -20,6 +20,12 @@ ErrCode FunctionInstance::setFuncType(const ModuleInstance::FType *Type) {
   return ErrCode::Success;
 }
 
+/// Setter of function type ID. See "include/executor/instance/function.h".
+ErrCode FunctionInstance::setTypeID(unsigned int ID) {
+  TypeID = ID;
+  return ErrCode::Success;
+}
+
 /// Setter of host function. See "include/executor/instance/function.h".
 ErrCode FunctionInstance::setHostFuncAddr(unsigned int Addr) {
   if (!IsHostFunction) {
@@ -7,10 +7,12 @@ namespace Instance {
 
 /// Adder of function types. See "include/executor/instance/module.h".
 ErrCode ModuleInstance::addFuncType(const std::vector<ValType> &Params,
-                                    const std::vector<ValType> &Returns) {
+                                    const std::vector<ValType> &Returns,
+                                    unsigned int TypeID) {
   auto NewFuncType = std::make_unique<FType>();
   NewFuncType->Params = Params;
   NewFuncType->Returns = Returns;
+  NewFuncType->TypeID = TypeID;
   FuncTypes.push_back(std::move(NewFuncType));
   return ErrCode::Success;
 }
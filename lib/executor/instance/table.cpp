@@ -18,37 +18,33 @@ ErrCode TableInstance::setLimit(unsigned int Min, bool HasMax,
   HasMaxSize = HasMax;
   MinSize = Min;
   MaxSize = Max;
-  if (FuncElem.size() < MinSize) {
-    FuncElem.resize(MinSize);
+  if (FuncElems.size() < MinSize) {
+    FuncElems.resize(MinSize);
   }
   return ErrCode::Success;
 }
 
 /// Setter of initialization list. See "include/executor/instance/table.h".
 ErrCode TableInstance::setInitList(unsigned int Offset,
-                                   std::vector<unsigned int> &Addrs) {
-  if (HasMaxSize && Offset + Addrs.size() > MaxSize) {
+                                   std::vector<FuncElem> &Elems) {
+  if (HasMaxSize && Offset + Elems.size() > MaxSize) {
     return ErrCode::TableSizeExceeded;
   }
-  if (FuncElem.size() < Offset + Addrs.size()) {
-    unsigned int OriginSize = FuncElem.size();
-    FuncElem.resize(Offset + Addrs.size());
-    for (unsigned int I = OriginSize; I < FuncElem.size(); I++) {
-      FuncElem.at(I) = 0;
-    }
+  if (FuncElems.size() < Offset + Elems.size()) {
+    FuncElems.resize(Offset + Elems.size());
   }
-  for (auto It = Addrs.begin(); It != Addrs.end(); It++) {
-    FuncElem.at((It - Addrs.begin()) + Offset) = *It;
+  for (auto It = Elems.begin(); It != Elems.end(); It++) {
+    FuncElems.at((It - Elems.begin()) + Offset) = *It;
   }
   return ErrCode::Success;
 }
 
-/// Getter of address. See "include/executor/instance/table.h".
-ErrCode TableInstance::getElemAddr(unsigned int Idx, unsigned int &Addr) {
-  if (Idx >= FuncElem.size()) {
+/// Getter of function reference. See "include/executor/instance/table.h".
+ErrCode TableInstance::getElem(unsigned int Idx, FuncElem *&Elem) {
+  if (Idx >= FuncElems.size()) {
     return ErrCode::AccessForbidMemory;
   }
-  Addr = FuncElem[Idx];
+  Elem = &FuncElems[Idx];
   return ErrCode::Success;
 }
 
@@ -73,16 +73,23 @@ ErrCode Executor::instantiate(AST::TableSection *TabSec,
       return Status;
     }
 
-    /// Transfer function index to address and copy data to table instance
-    std::vector<unsigned int> FuncIdxList = (*ElemSeg)->getFuncIdxes();
+    /// Resolve function index to function instance with its type ID and copy
+    /// data to table instance
+    std::vector<Instance::TableInstance::FuncElem> Elems;
+    auto &FuncIdxList = (*ElemSeg)->getFuncIdxes();
     for (auto It = FuncIdxList.begin(); It != FuncIdxList.end(); It++) {
       unsigned int FuncAddr = 0;
+      Instance::FunctionInstance *FuncInst = nullptr;
       if ((Status = ModInst->getFuncAddr(*It, FuncAddr)) != ErrCode::Success) {
         return Status;
       }
-      *It = FuncAddr;
+      if ((Status = StoreMgr.getFunction(FuncAddr, FuncInst)) !=
+          ErrCode::Success) {
+        return Status;
+      }
+      Elems.push_back({FuncInst->getTypeID(), FuncInst});
     }
-    TabInst->setInitList(Offset, FuncIdxList);
+    TabInst->setInitList(Offset, Elems);
   }
 
   return Status;
@@ -20,7 +20,9 @@ ErrCode Executor::instantiate(AST::TypeSection *TypeSec) {
     /// Copy param and return lists to module instance.
     auto &Param = (*FuncType)->getParamTypes();
     auto &Return = (*FuncType)->getReturnTypes();
-    if ((Status = ModInst->addFuncType(Param, Return)) != ErrCode::Success) {
+    if ((Status = ModInst->addFuncType(
+             Param, Return, StoreMgr.getTypeID(Param, Return))) !=
+        ErrCode::Success) {
       return Status;
     }
   }
@@ -146,6 +146,9 @@ ErrCode Worker::execute(AST::CallControlInstruction &Instr) {
     return runCallOp(Instr);
   case OpCode::Call_indirect:
     return runCallIndirectOp(Instr);
+  case OpCode::Return_call:
+  case OpCode::Return_call_indirect:
+    return ErrCode::Unimplemented;
   default:
     __builtin_unreachable();
   }
@@ -352,6 +355,14 @@ ErrCode Worker::execute(AST::UnaryNumericInstruction &Instr) {
     __builtin_unreachable();
   }
 }
+ErrCode Worker::execute(AST::SIMDInstruction &Instr) {
+  /// SIMD instructions are only supported by the interpreter.
+  return ErrCode::Unimplemented;
+}
+ErrCode Worker::execute(AST::AtomicMemoryInstruction &Instr) {
+  /// Atomic memory instructions are only supported by the interpreter.
+  return ErrCode::Unimplemented;
+}
 ErrCode Worker::execute(AST::BinaryNumericInstruction &Instr) {
   Value Val2;
   StackMgr.pop(Val2);
@@ -588,12 +599,15 @@ ErrCode Worker::leaveBlock() {
 }
 
 ErrCode Worker::invokeFunction(unsigned int FuncAddr) {
-  /// Get Function Instance and module address.
+  /// Get Function Instance.
   Instance::FunctionInstance *FuncInst = nullptr;
   if (ErrCode Status = StoreMgr.getFunction(FuncAddr, FuncInst);
       Status != ErrCode::Success)
     return Status;
+  return invokeFunction(FuncInst);
+}
 
+ErrCode Worker::invokeFunction(Instance::FunctionInstance *FuncInst) {
   /// Get function type
   const Instance::ModuleInstance::FType *FuncType = FuncInst->getFuncType();
 
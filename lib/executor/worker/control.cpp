@@ -128,35 +128,19 @@ ErrCode Worker::runCallIndirectOp(AST::CallControlInstruction &Instr) {
   Value Idx;
   StackMgr.pop(Idx);
 
-  /// Get function address.
-  unsigned int FuncAddr;
-  if ((Status = TableInst->getElemAddr(retrieveValue<uint32_t>(Idx),
-                                       FuncAddr)) != ErrCode::Success) {
+  /// Get function reference entry.
+  Instance::TableInstance::FuncElem *Elem = nullptr;
+  if ((Status = TableInst->getElem(retrieveValue<uint32_t>(Idx), Elem)) !=
+      ErrCode::Success) {
     return Status;
   };
 
   /// Check function type.
-  Instance::FunctionInstance *FuncInst = nullptr;
-  if ((Status = StoreMgr.getFunction(FuncAddr, FuncInst)) != ErrCode::Success) {
-    return Status;
-  }
-  const Instance::ModuleInstance::FType *DstFuncType = FuncInst->getFuncType();
-  if (FuncType->Params.size() != DstFuncType->Params.size() ||
-      FuncType->Returns.size() != DstFuncType->Returns.size()) {
+  if (FuncType->TypeID != Elem->TypeID) {
     return ErrCode::TypeNotMatch;
   }
-  for (unsigned int I = 0; I < FuncType->Params.size(); I++) {
-    if (FuncType->Params[I] != DstFuncType->Params[I]) {
-      return ErrCode::TypeNotMatch;
-    }
-  }
-  for (unsigned int I = 0; I < FuncType->Returns.size(); I++) {
-    if (FuncType->Returns[I] != DstFuncType->Returns[I]) {
-      return ErrCode::TypeNotMatch;
-    }
-  }
 
-  return invokeFunction(FuncAddr);
+  return invokeFunction(Elem->Func);
 }
 
 } // namespace Executor
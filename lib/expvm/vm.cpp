@@ -10,18 +10,40 @@ namespace SSVM {
 namespace ExpVM {
 
 VM::VM(Configure &InputConfig)
-    : Config(InputConfig), Stage(VMStage::Inited), InterpreterEngine(&Measure),
+    : Config(InputConfig), Stage(VMStage::Inited),
+      InterpreterEngine(&Measure, Config.getStackCapacity()),
       Store(std::make_unique<Runtime::StoreManager>()), StoreRef(*Store.get()) {
   initVM();
 }
 
 VM::VM(Configure &InputConfig, Runtime::StoreManager &S)
-    : Config(InputConfig), Stage(VMStage::Inited), InterpreterEngine(&Measure),
-      StoreRef(S) {
+    : Config(InputConfig), Stage(VMStage::Inited),
+      InterpreterEngine(&Measure, Config.getStackCapacity()), StoreRef(S) {
   initVM();
 }
 
+void VM::setEngineModes(Interpreter::Interpreter &Engine) {
+  Engine.setRegisterTier(Config.getInterpreterTier() ==
+                         Configure::InterpreterTier::Register);
+  Engine.setTopCaching(Config.getInterpreterTier() ==
+                       Configure::InterpreterTier::CachedStack);
+  Engine.setTiered(Config.getInterpreterTier() ==
+                   Configure::InterpreterTier::Tiered);
+  switch (Config.getMeasureMode()) {
+  case Configure::MeasureMode::None:
+    Engine.setMeasureMode(Interpreter::MeasureMode::None);
+    break;
+  case Configure::MeasureMode::Count:
+    Engine.setMeasureMode(Interpreter::MeasureMode::Count);
+    break;
+  default:
+    Engine.setMeasureMode(Interpreter::MeasureMode::Metered);
+    break;
+  }
+}
+
 void VM::initVM() {
+  setEngineModes(InterpreterEngine);
   /// Set cost table and create import modules from configure.
   CostTab.setCostTable(Configure::VMType::Wasm);
   Measure.setCostTable(CostTab.getCostTable(Configure::VMType::Wasm));
@@ -93,13 +115,31 @@ Expect<void> VM::registerModule(const Runtime::ImportObject &Obj) {
   return InterpreterEngine.registerModule(StoreRef, Obj);
 }
 
+Expect<std::vector<ValVariant>>
+VM::invoke(Runtime::StoreManager &S, const uint32_t FuncAddr,
+           const std::vector<ValVariant> &Params) {
+  if (!Config.hasVMType(Configure::VMType::Ewasm)) {
+    return InterpreterEngine.invoke(S, FuncAddr, Params);
+  }
+  /// The reverted, out of cost, or trapped contract calls leave no changes.
+  S.beginCheckpoint();
+  auto Res = InterpreterEngine.invoke(S, FuncAddr, Params);
+  if (Res) {
+    S.commitCheckpoint();
+  } else {
+    S.rollbackCheckpoint();
+  }
+  return Res;
+}
+
 Expect<void> VM::registerModule(const std::string &Name,
                                 const AST::Module &Module) {
   /// Validate module.
   if (auto Res = ValidatorEngine.validate(Module); !Res) {
     return Unexpect(Res);
   }
-  return InterpreterEngine.registerModule(StoreRef, Module, Name);
+  return InterpreterEngine.registerModule(
+      StoreRef, Module, ValidatorEngine.getBranchTargets(), Name);
 }
 
 Expect<std::vector<ValVariant>>
@@ -140,19 +180,17 @@ VM::runWasmFile(const AST::Module &Module, const std::string &Func,
   if (auto Res = ValidatorEngine.validate(Module); !Res) {
     return Unexpect(Res);
   }
-  if (auto Res = InterpreterEngine.instantiateModule(StoreRef, Module); !Res) {
+  if (auto Res = InterpreterEngine.instantiateModule(
+          StoreRef, Module, ValidatorEngine.getBranchTargets());
+      !Res) {
     return Unexpect(Res);
   }
   const auto FuncExp = StoreRef.getFuncExports();
   if (FuncExp.find(Func) == FuncExp.cend()) {
     return Unexpect(ErrCode::WrongInstanceAddress);
   }
-  if (auto Res = InterpreterEngine.invoke(StoreRef, FuncExp.find(Func)->second,
-                                          Params)) {
-    return *Res;
-  } else {
-    return Unexpect(Res);
-  }
+  ImageStale = true;
+  return invoke(StoreRef, FuncExp.find(Func)->second, Params);
 }
 
 Expect<void> VM::loadWasm(const std::string &Path) {
@@ -183,6 +221,7 @@ Expect<void> VM::validate() {
     return Unexpect(ErrCode::WrongVMWorkflow);
   }
   if (auto Res = ValidatorEngine.validate(*Mod.get())) {
+    BranchTargets = ValidatorEngine.getBranchTargets();
     Stage = VMStage::Validated;
     return {};
   } else {
@@ -195,9 +234,10 @@ Expect<void> VM::instantiate() {
     /// When module is not validated, not instantiate.
     return Unexpect(ErrCode::ValidationFailed);
   }
-  if (auto Res =
-          InterpreterEngine.instantiateModule(StoreRef, *Mod.get(), "")) {
+  if (auto Res = InterpreterEngine.instantiateModule(StoreRef, *Mod.get(),
+                                                     BranchTargets, "")) {
     Stage = VMStage::Instantiated;
+    ImageStale = true;
     return {};
   } else {
     return Unexpect(Res);
@@ -211,7 +251,8 @@ VM::execute(const std::string &Func, const std::vector<ValVariant> &Params) {
   if (FuncExp.find(Func) == FuncExp.cend()) {
     return Unexpect(ErrCode::WrongInstanceAddress);
   }
-  return InterpreterEngine.invoke(StoreRef, FuncExp.find(Func)->second, Params);
+  ImageStale = true;
+  return invoke(StoreRef, FuncExp.find(Func)->second, Params);
 }
 
 Expect<std::vector<ValVariant>>
@@ -230,7 +271,89 @@ VM::execute(const std::string &Mod, const std::string &Func,
   if (FuncExp.find(Func) == FuncExp.cend()) {
     return Unexpect(ErrCode::WrongInstanceAddress);
   }
-  return InterpreterEngine.invoke(StoreRef, FuncExp.find(Func)->second, Params);
+  ImageStale = true;
+  return invoke(StoreRef, FuncExp.find(Func)->second, Params);
+}
+
+Expect<std::unique_ptr<Runtime::StoreManager>> VM::cloneStore() {
+  if (Stage < VMStage::Instantiated) {
+    return Unexpect(ErrCode::WrongVMWorkflow);
+  }
+  if (auto Res = StoreRef.clone(ImageStale)) {
+    ImageStale = false;
+    return Res;
+  } else {
+    return Unexpect(Res);
+  }
+}
+
+Expect<std::vector<ValVariant>>
+VM::execute(Runtime::StoreManager &Clone, const std::string &Func,
+            const std::vector<ValVariant> &Params) {
+  /// The function instances of the store cloned from should be alive.
+  if (!Clone.isCloneValid()) {
+    return Unexpect(ErrCode::WrongVMWorkflow);
+  }
+  /// Check exports for finding function address.
+  const auto FuncExp = Clone.getFuncExports();
+  if (FuncExp.find(Func) == FuncExp.cend()) {
+    return Unexpect(ErrCode::WrongInstanceAddress);
+  }
+  return invoke(Clone, FuncExp.find(Func)->second, Params);
+}
+
+Expect<std::vector<std::vector<ValVariant>>>
+VM::executeParallel(const std::string &Func,
+                    const std::vector<std::vector<ValVariant>> &ParamsList) {
+  /// Check exports for finding function address.
+  const auto FuncExp = StoreRef.getFuncExports();
+  if (FuncExp.find(Func) == FuncExp.cend()) {
+    return Unexpect(ErrCode::WrongInstanceAddress);
+  }
+  const uint32_t FuncAddr = FuncExp.find(Func)->second;
+  ImageStale = true;
+
+  /// The measurement is not thread-safe, so each thread measures in its own
+  /// copy limited by the remaining cost. The counts and costs are summed up
+  /// into the measurement of VM after joining.
+  Support::Measurement Base = Measure;
+  Base.clear();
+  Base.setPairCounting(false);
+  Base.getCostLimit() -= std::min(Measure.getCostSum(), Measure.getCostLimit());
+  Base.getCostSum() = 0;
+  std::vector<Support::Measurement> Measures(ParamsList.size(), Base);
+  std::vector<Expect<std::vector<ValVariant>>> Results(ParamsList.size());
+  std::vector<std::thread> Threads;
+  Threads.reserve(ParamsList.size());
+  for (uint32_t I = 0; I < ParamsList.size(); ++I) {
+    Threads.emplace_back([this, I, FuncAddr, &ParamsList, &Measures,
+                          &Results]() {
+      Interpreter::Interpreter Engine(&Measures[I], Config.getStackCapacity());
+      setEngineModes(Engine);
+      Results[I] = Engine.invoke(StoreRef, FuncAddr, ParamsList[I]);
+    });
+  }
+  for (auto &T : Threads) {
+    T.join();
+  }
+
+  /// The threads within the limit in total may still exceed it together.
+  bool Exceeded = false;
+  for (auto &M : Measures) {
+    Measure.addInstrCnt(M.getInstrCnt());
+    Exceeded |= !Measure.addCost(M.getCostSum());
+  }
+  std::vector<std::vector<ValVariant>> Returns;
+  for (auto &Res : Results) {
+    if (!Res) {
+      return Unexpect(Res);
+    }
+    Returns.push_back(std::move(*Res));
+  }
+  if (Exceeded) {
+    return Unexpect(ErrCode::CostLimitExceeded);
+  }
+  return Returns;
 }
 
 void VM::cleanup() {
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/ast/instruction.h"
+#include "common/value.h"
+#include "interpreter/interpreter.h"
+
+#include <atomic>
+#include <limits>
+
+namespace SSVM {
+namespace Interpreter {
+
+namespace {
+
+/// The atomic loads, stores, and read-modify-writes are in the groups of 7
+/// sub-opcodes from 0x10: load, store, add, sub, and, or, xor, xchg, and
+/// cmpxchg. See "include/common/ast/instruction.h".
+constexpr uint32_t GroupBegin = 0x10U;
+constexpr uint32_t GroupSize = 7U;
+enum class Group : uint32_t {
+  Load = 0,
+  Store,
+  Add,
+  Sub,
+  And,
+  Or,
+  Xor,
+  Xchg,
+  Cmpxchg
+};
+
+/// Run the atomic access of the integer of T in memory.
+///
+/// The operands are the address and the values of the integer type V. The
+/// narrow accesses wrap the operand values and zero-extend the results.
+template <typename T, typename V>
+Expect<void> runAccess(Runtime::Instance::MemoryInstance &MemInst,
+                       const uint32_t EA, const Group G, ValVariant *Args) {
+  T *Ptr;
+  if (auto Res = MemInst.getAtomicPointer<T>(EA)) {
+    Ptr = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  const T Val = static_cast<T>(retrieveValue<V>(Args[1]));
+  T Old = 0;
+  switch (G) {
+  case Group::Load:
+    Old = __atomic_load_n(Ptr, __ATOMIC_SEQ_CST);
+    break;
+  case Group::Store:
+    __atomic_store_n(Ptr, Val, __ATOMIC_SEQ_CST);
+    return {};
+  case Group::Add:
+    Old = __atomic_fetch_add(Ptr, Val, __ATOMIC_SEQ_CST);
+    break;
+  case Group::Sub:
+    Old = __atomic_fetch_sub(Ptr, Val, __ATOMIC_SEQ_CST);
+    break;
+  case Group::And:
+    Old = __atomic_fetch_and(Ptr, Val, __ATOMIC_SEQ_CST);
+    break;
+  case Group::Or:
+    Old = __atomic_fetch_or(Ptr, Val, __ATOMIC_SEQ_CST);
+    break;
+  case Group::Xor:
+    Old = __atomic_fetch_xor(Ptr, Val, __ATOMIC_SEQ_CST);
+    break;
+  case Group::Xchg:
+    Old = __atomic_exchange_n(Ptr, Val, __ATOMIC_SEQ_CST);
+    break;
+  case Group::Cmpxchg:
+    /// The old value is written back to Val when not equal.
+    Old = Val;
+    __atomic_compare_exchange_n(Ptr, &Old,
+                                static_cast<T>(retrieveValue<V>(Args[2])),
+                                false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    break;
+  default:
+    __builtin_unreachable();
+  }
+  Args[0] = static_cast<V>(Old);
+  return {};
+}
+
+} // namespace
+
+Expect<void> Interpreter::runAtomicOp(const Runtime::ByteCode &Instr,
+                                      ValVariant *Args) {
+  using AST::AtomicCode;
+  if (Instr.AtomicSubCode == AtomicCode::Atomic__fence) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return {};
+  }
+
+  /// Calculate EA = i + offset
+  if (retrieveValue<uint32_t>(Args[0]) >
+      std::numeric_limits<uint32_t>::max() - Instr.Index) {
+    return Unexpect(ErrCode::AccessForbidMemory);
+  }
+  const uint32_t EA = retrieveValue<uint32_t>(Args[0]) + Instr.Index;
+  auto &MemInst = *getMemInstByIdx(0);
+
+  switch (Instr.AtomicSubCode) {
+  case AtomicCode::Memory__atomic__notify:
+    if (auto Res =
+            MemInst.atomicNotify(EA, retrieveValue<uint32_t>(Args[1]))) {
+      Args[0] = *Res;
+      return {};
+    } else {
+      return Unexpect(Res);
+    }
+  case AtomicCode::Memory__atomic__wait32:
+    if (auto Res = MemInst.atomicWait(EA, retrieveValue<uint32_t>(Args[1]),
+                                      retrieveValue<int64_t>(Args[2]))) {
+      Args[0] = *Res;
+      return {};
+    } else {
+      return Unexpect(Res);
+    }
+  case AtomicCode::Memory__atomic__wait64:
+    if (auto Res = MemInst.atomicWait(EA, retrieveValue<uint64_t>(Args[1]),
+                                      retrieveValue<int64_t>(Args[2]))) {
+      Args[0] = *Res;
+      return {};
+    } else {
+      return Unexpect(Res);
+    }
+  default:
+    break;
+  }
+
+  const uint32_t Code = static_cast<uint32_t>(Instr.AtomicSubCode) - GroupBegin;
+  const Group G = static_cast<Group>(Code / GroupSize);
+  switch (Code % GroupSize) {
+  case 0:
+    return runAccess<uint32_t, uint32_t>(MemInst, EA, G, Args);
+  case 1:
+    return runAccess<uint64_t, uint64_t>(MemInst, EA, G, Args);
+  case 2:
+    return runAccess<uint8_t, uint32_t>(MemInst, EA, G, Args);
+  case 3:
+    return runAccess<uint16_t, uint32_t>(MemInst, EA, G, Args);
+  case 4:
+    return runAccess<uint8_t, uint64_t>(MemInst, EA, G, Args);
+  case 5:
+    return runAccess<uint16_t, uint64_t>(MemInst, EA, G, Args);
+  default:
+    return runAccess<uint32_t, uint64_t>(MemInst, EA, G, Args);
+  }
+}
+
+} // namespace Interpreter
+} // namespace SSVM
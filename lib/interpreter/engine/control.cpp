@@ -7,124 +7,142 @@
 namespace SSVM {
 namespace Interpreter {
 
-Expect<void>
-Interpreter::runBlockOp(const AST::BlockControlInstruction &Instr) {
-  /// Get result type for arity.
-  const ValType ResultType = Instr.getResultType();
-  uint32_t Arity = (ResultType == ValType::None) ? 0 : 1;
-
-  /// Create Label{ nothing } and push.
-  return enterBlock(Arity, nullptr, Instr.getBody());
-}
-
-Expect<void> Interpreter::runLoopOp(const AST::BlockControlInstruction &Instr) {
-  /// Get result type for arity.
-  const ValType ResultType = Instr.getResultType();
-  uint32_t Arity = (ResultType == ValType::None) ? 0 : 1;
-
-  /// Create Label{ loop-instruction } and push.
-  return enterBlock(Arity, &Instr, Instr.getBody());
-}
-
-Expect<void>
-Interpreter::runIfElseOp(const AST::IfElseControlInstruction &Instr) {
-  /// Get condition and result type for arity.
-  ValVariant Cond = StackMgr.pop();
-  ValType ResultType = Instr.getResultType();
-  uint32_t Arity = (ResultType == ValType::None) ? 0 : 1;
-
+template <typename Policy>
+Expect<void> Interpreter::runIfElseOp(const Runtime::ByteCode &Instr,
+                                      const ValVariant &Cond) {
   /// If non-zero, run if-statement; else, run else-statement.
   if (retrieveValue<uint32_t>(Cond) != 0) {
-    const auto &IfStatement = Instr.getIfStatement();
-    if (!IfStatement.empty()) {
-#ifndef ONNC_WASM
-      /// If-then case should add the cost.
-      if (!Measure->addInstrCost(OpCode::Else)) {
-        return Unexpect(ErrCode::CostLimitExceeded);
-      }
-#endif
-      return enterBlock(Arity, nullptr, IfStatement);
+    if (Instr.JumpElse == 1) {
+      /// Empty if-statement. Jump to the continuation.
+      InstrPdr.jump(&Instr + Instr.JumpEnd);
+      return {};
     }
   } else {
-    const auto &ElseStatement = Instr.getElseStatement();
-    if (!ElseStatement.empty()) {
+    if (Instr.JumpElse == Instr.JumpEnd) {
+      /// No else-statement. Jump to the continuation.
+      InstrPdr.jump(&Instr + Instr.JumpEnd);
+      return {};
+    }
+    /// Jump to the beginning of else-statement.
+    InstrPdr.jump(&Instr + Instr.JumpElse + 1);
+  }
 #ifndef ONNC_WASM
-      /// If-then case should add the cost.
-      if (!Measure->addInstrCost(OpCode::Else)) {
-        return Unexpect(ErrCode::CostLimitExceeded);
-      }
-#endif
-      return enterBlock(Arity, nullptr, ElseStatement);
+  /// If-then case should add the cost.
+  if constexpr (Policy::ChargeCost) {
+    if (!Measure->addInstrCost(OpCode::Else)) {
+      return Unexpect(ErrCode::CostLimitExceeded);
     }
   }
+#endif
   return {};
 }
 
-Expect<void> Interpreter::runBrOp(const AST::BrControlInstruction &Instr) {
-  return branchToLabel(Instr.getLabelIndex());
+template Expect<void>
+Interpreter::runIfElseOp<BarePolicy>(const Runtime::ByteCode &Instr,
+                                     const ValVariant &Cond);
+template Expect<void>
+Interpreter::runIfElseOp<CountPolicy>(const Runtime::ByteCode &Instr,
+                                      const ValVariant &Cond);
+template Expect<void>
+Interpreter::runIfElseOp<MeteredPolicy>(const Runtime::ByteCode &Instr,
+                                        const ValVariant &Cond);
+
+Expect<void> Interpreter::runElseOp(const Runtime::ByteCode &Instr) {
+  /// End of if-statement. Jump to the continuation.
+  InstrPdr.jump(&Instr + Instr.JumpEnd);
+  return {};
 }
 
-Expect<void> Interpreter::runBrIfOp(const AST::BrControlInstruction &Instr) {
-  ValVariant Cond = StackMgr.pop();
-  if (retrieveValue<uint32_t>(Cond) != 0) {
-    return runBrOp(Instr);
-  }
-  return {};
+Expect<void> Interpreter::runBrOp(const Runtime::ByteCode &Instr) {
+  return branchToLabel(Instr.StackErase, Instr.Arity, &Instr + Instr.JumpEnd);
 }
 
-Expect<void>
-Interpreter::runBrTableOp(const AST::BrTableControlInstruction &Instr) {
+Expect<void> Interpreter::runBrTableOp(const Runtime::ByteCode &Instr) {
   /// Get value on top of stack.
   uint32_t Value = retrieveValue<uint32_t>(StackMgr.pop());
 
-  /// Do branch.
-  const auto &LabelTable = Instr.getLabelTable();
-  if (Value < LabelTable.size()) {
-    return branchToLabel(LabelTable[Value]);
+  /// Do branch. Label entries are followed by the default label.
+  if (Value < Instr.Index) {
+    return runBrOp(*(&Instr + Value + 1));
   }
-  return branchToLabel(Instr.getLabelIndex());
+  return runBrOp(*(&Instr + Instr.Index + 1));
 }
 
 Expect<void> Interpreter::runReturnOp() { return leaveFunction(); }
 
 Expect<void> Interpreter::runCallOp(Runtime::StoreManager &StoreMgr,
-                                    const AST::CallControlInstruction &Instr) {
-  /// Get Function address.
-  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-  const uint32_t FuncAddr = *ModInst->getFuncAddr(Instr.getFuncIndex());
-  const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
+                                    const Runtime::ByteCode &Instr) {
+  /// Get Function instance.
+  const auto *FuncInst = StackMgr.getModule()->getFunc(Instr.Index);
   return enterFunction(StoreMgr, *FuncInst);
 }
 
 Expect<void>
 Interpreter::runCallIndirectOp(Runtime::StoreManager &StoreMgr,
-                               const AST::CallControlInstruction &Instr) {
-  /// Get Table Instance
-  const auto *TabInst = getTabInstByIdx(StoreMgr, 0);
+                               const Runtime::ByteCode &Instr) {
+  /// Pop the value i32.const i from the Stack.
+  ValVariant Idx = StackMgr.pop();
+
+  if (auto Res = getIndirectFuncInst(StoreMgr, Instr.Index,
+                                     retrieveValue<uint32_t>(Idx))) {
+    return enterFunction(StoreMgr, **Res);
+  } else {
+    return Unexpect(Res);
+  }
+}
 
-  /// Get function type at index x.
-  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-  const auto *TargetFuncType = *ModInst->getFuncType(Instr.getFuncIndex());
+Expect<void> Interpreter::runReturnCallOp(Runtime::StoreManager &StoreMgr,
+                                          const Runtime::ByteCode &Instr) {
+  /// Get Function instance.
+  const auto *FuncInst = StackMgr.getModule()->getFunc(Instr.Index);
+  return enterTailFunction(StoreMgr, *FuncInst);
+}
 
+Expect<void>
+Interpreter::runReturnCallIndirectOp(Runtime::StoreManager &StoreMgr,
+                                     const Runtime::ByteCode &Instr) {
   /// Pop the value i32.const i from the Stack.
   ValVariant Idx = StackMgr.pop();
 
-  /// Get function address.
-  uint32_t FuncAddr;
-  if (auto Res = TabInst->getElemAddr(retrieveValue<uint32_t>(Idx))) {
-    FuncAddr = *Res;
+  if (auto Res = getIndirectFuncInst(StoreMgr, Instr.Index,
+                                     retrieveValue<uint32_t>(Idx))) {
+    return enterTailFunction(StoreMgr, **Res);
+  } else {
+    return Unexpect(Res);
+  }
+}
+
+Expect<const Runtime::Instance::FunctionInstance *>
+Interpreter::getIndirectFuncInst(Runtime::StoreManager &StoreMgr,
+                                 const uint32_t TypeIdx,
+                                 const uint32_t ElemIdx) {
+  /// Get Table Instance
+  const auto *TabInst = getTabInstByIdx(0);
+
+  /// Get function type ID at index x.
+  const uint32_t TargetTypeID = *StackMgr.getModule()->getFuncTypeID(TypeIdx);
+
+  /// Get function reference entry.
+  const Runtime::Instance::TableInstance::FuncElem *Elem;
+  if (auto Res = TabInst->getElem(ElemIdx)) {
+    Elem = *Res;
   } else {
     return Unexpect(Res);
   }
 
   /// Check function type.
-  const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
-  const auto &FuncType = FuncInst->getFuncType();
-  if (TargetFuncType->Params != FuncType.Params ||
-      TargetFuncType->Returns != FuncType.Returns) {
+  if (Elem->TypeID != TargetTypeID) {
     return Unexpect(ErrCode::TypeNotMatch);
   }
-  return enterFunction(StoreMgr, *FuncInst);
+  return Elem->Func;
+}
+
+void Interpreter::runRegBrOp(ValVariant *Slots,
+                             const Runtime::ByteCode &Instr) {
+  /// Copy the results to the slots of the target label, and jump to the
+  /// continuation. The result slots are never below the target slots.
+  std::copy_n(Slots + Instr.Src1, Instr.Arity, Slots + Instr.Dst);
+  InstrPdr.jump(&Instr + Instr.JumpEnd);
 }
 
 } // namespace Interpreter
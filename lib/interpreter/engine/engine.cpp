@@ -1,18 +1,35 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "common/ast/instruction.h"
 #include "common/value.h"
+#include "interpreter/engine/regtranslator.h"
+#include "interpreter/engine/topcache.h"
+#include "interpreter/engine/translator.h"
 #include "interpreter/interpreter.h"
 #include "support/casting.h"
+#include "support/fault.h"
 #include "support/log.h"
 #include "support/measure.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 namespace SSVM {
 namespace Interpreter {
 
 Expect<void> Interpreter::runExpression(Runtime::StoreManager &StoreMgr,
                                         const AST::InstrVec &Instrs) {
-  /// Set instruction vector to instruction provider.
-  InstrPdr.pushInstrs(InstrProvider::SeqType::Expression, Instrs);
+  /// Translate the expression into byte code.
+  Runtime::ByteCodeSeq Code;
+  if (auto Res = Translator(Measure).translate(Instrs)) {
+    Code = std::move(*Res);
+  } else {
+    return Unexpect(Res);
+  }
+
+  /// Set byte code to instruction provider.
+  InstrPdr.pushInstrs(InstrProvider::SeqType::Expression, Code);
+  GasTrap = nullptr;
   return execute(StoreMgr);
 }
 
@@ -21,7 +38,7 @@ Interpreter::runFunction(Runtime::StoreManager &StoreMgr,
                          const Runtime::Instance::FunctionInstance &Func,
                          const std::vector<ValVariant> &Params) {
   /// Set start time.
-  if (Measure) {
+  if (Mode == MeasureMode::Metered) {
     Measure->getTimeRecorder().startRecord(TIMER_TAG_EXECUTION);
   }
 
@@ -31,20 +48,67 @@ Interpreter::runFunction(Runtime::StoreManager &StoreMgr,
   /// Reset and push a dummy frame into stack.
   InstrPdr.reset();
   StackMgr.reset();
+  GasTrap = nullptr;
+  TailRegEntered = false;
   /// FIXME: Add a dummy frame pusher in stack manager.
-  StackMgr.pushFrame(0, 0, 0);
+  StackMgr.pushFrame(nullptr, 0, 0);
 
   /// Push arguments.
   for (auto &Val : Params) {
     StackMgr.push(Val);
   }
 
-  /// Enter and execute function.
-  auto Res = enterFunction(StoreMgr, Func);
-  if (!Res) {
-    return Unexpect(Res);
+  /// Enter and execute function. The out-of-bound accesses to the guarded
+  /// memories jump back here, with the accessing instruction kept, and fail
+  /// as the checked ones.
+  Expect<void> Res;
+  Support::Fault FaultHandler;
+  CurrentFault = &FaultHandler;
+  if (PREPARE_FAULT(FaultHandler) != 0) {
+    /// The costs of the instructions not run in the block are returned.
+    const Runtime::ByteCodeMeter *Meter = InstrPdr.getMeter(
+        static_cast<const Runtime::ByteCode *>(FaultHandler.getAccess()));
+    switch (Mode) {
+    case MeasureMode::Count:
+      Res = Unexpect(
+          refundBlock<CountPolicy>(Meter, ErrCode::MemorySizeExceeded));
+      break;
+    case MeasureMode::Metered:
+      Res = Unexpect(
+          refundBlock<MeteredPolicy>(Meter, ErrCode::MemorySizeExceeded));
+      break;
+    default:
+      Res = Unexpect(ErrCode::MemorySizeExceeded);
+      break;
+    }
+  } else if (RegisterTier && !Func.isHostFunction()) {
+    Res = enterRegFunction(StoreMgr, Func, StackMgr.size() - Params.size());
+    if (!Res) {
+      CurrentFault = nullptr;
+      return Unexpect(Res);
+    }
+    Res = executeRegister(StoreMgr);
+  } else {
+    Res = enterFunction(StoreMgr, Func);
+    if (!Res) {
+      CurrentFault = nullptr;
+      return Unexpect(Res);
+    }
+    Res = execute(StoreMgr);
+    /// The stack-based dispatcher returns when tail calling a promoted
+    /// function. Run it, and continue the caller in stack-based byte code.
+    while (Res && TailRegEntered) {
+      TailRegEntered = false;
+      Res = executeRegister(StoreMgr);
+      if (Res) {
+        StackMgr.resize(TailRegEnd);
+        if (InstrPdr.getScopeSize() > 0) {
+          Res = execute(StoreMgr);
+        }
+      }
+    }
   }
-  Res = execute(StoreMgr);
+  CurrentFault = nullptr;
 
   if (Res) {
     LOG(DEBUG) << "Execution succeeded.";
@@ -58,7 +122,7 @@ Interpreter::runFunction(Runtime::StoreManager &StoreMgr,
   LOG(DEBUG) << "Done.";
 
   /// Print time cost.
-  if (Measure) {
+  if (Mode == MeasureMode::Metered) {
     uint64_t ExecTime =
         Measure->getTimeRecorder().stopRecord(TIMER_TAG_EXECUTION);
     uint64_t HostFuncTime =
@@ -87,521 +151,1853 @@ Interpreter::runFunction(Runtime::StoreManager &StoreMgr,
   return Unexpect(Res);
 }
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::ControlInstruction &Instr) {
-  switch (Instr.getOpCode()) {
-  case OpCode::Unreachable:
-    return Unexpect(ErrCode::Unreachable);
-  case OpCode::Nop:
-    return {};
-  case OpCode::Return:
-    return runReturnOp();
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+/// Instruction dispatching. With the computed goto extension, every handler
+/// fetches the next instruction and jumps to its handler directly through the
+/// dispatch table. Otherwise, the handlers are the cases of a switch.
+#if defined(SSVM_COMPUTED_GOTO) && (defined(__GNUC__) || defined(__clang__))
+#define SSVM_THREADED_DISPATCH
+#endif
+
+/// Fetch the next instruction. The costs of a straight-line block are added
+/// when fetching its beginning, and the limit is checked there. If the block
+/// exceeds the limit, the instruction to stop at is also checked.
+#define DISPATCH_FETCH()                                                       \
+  Instr = InstrPdr.getNextInstr();                                             \
+  if (Instr == nullptr) {                                                      \
+    goto ScopeEnd;                                                             \
+  }                                                                            \
+  if constexpr (Policy::CountInstr) {                                          \
+    if (Instr->BlockBegin || Instr == GasTrap) {                               \
+      if (auto Res = chargeBlock<Policy>(*Instr); !Res) {                      \
+        return Unexpect(Res);                                                  \
+      }                                                                        \
+    }                                                                          \
   }
-}
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::BlockControlInstruction &Instr) {
-  switch (Instr.getOpCode()) {
-  case OpCode::Block:
-    return runBlockOp(Instr);
-  case OpCode::Loop:
-    return runLoopOp(Instr);
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+/// Add the cost of an instruction charged one by one.
+#define DISPATCH_CHARGE(Code)                                                  \
+  Measure->incInstrCnt();                                                      \
+  if constexpr (Policy::ChargeCost) {                                          \
+    if (!Measure->addInstrCost(Code)) {                                        \
+      return Unexpect(ErrCode::CostLimitExceeded);                             \
+    }                                                                          \
   }
-}
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::IfElseControlInstruction &Instr) {
-  switch (Instr.getOpCode()) {
-  case OpCode::If:
-    return runIfElseOp(Instr);
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+/// Add the cost of a bulk memory instruction once more for every page of the
+/// length operand, before running it. The cost of the instruction itself is
+/// charged with its block. The product saturates instead of wrapping around,
+/// and running out of cost traps like the other instructions.
+#define DISPATCH_BULK_CHARGE(Code, Len)                                        \
+  if constexpr (Policy::ChargeCost) {                                          \
+    const uint64_t Pages =                                                     \
+        (static_cast<uint64_t>(retrieveValue<uint32_t>(Len)) +                 \
+         Runtime::Instance::MemoryInstance::PageSize - 1) /                    \
+        Runtime::Instance::MemoryInstance::PageSize;                           \
+    const uint64_t PageCost = Measure->getInstrCost(Code);                     \
+    if (!Measure->addCost(PageCost != 0 && Pages > UINT64_MAX / PageCost       \
+                              ? UINT64_MAX                                     \
+                              : PageCost * Pages)) {                           \
+      DISPATCH_TRAP(ErrCode::CostLimitExceeded);                               \
+    }                                                                          \
   }
-}
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::BrControlInstruction &Instr) {
-  switch (Instr.getOpCode()) {
-  case OpCode::Br:
-    return runBrOp(Instr);
-  case OpCode::Br_if:
-    return runBrIfOp(Instr);
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+#ifdef SSVM_THREADED_DISPATCH
+#define DISPATCH_LABEL(Op) Handler_##Op
+/// The dispatch table is a static local of each dispatching loop, built by the
+/// statement expression initializing it on the first run. The handlers are
+/// registered to the table `Table` being built.
+#define DISPATCH_TABLE(...)                                                    \
+  static const std::array<const void *, 256> DispatchTable = ({                \
+    std::array<const void *, 256> Table;                                       \
+    Table.fill(&&DISPATCH_LABEL(Unknown));                                     \
+    __VA_ARGS__                                                                \
+    Table;                                                                     \
+  })
+#define DISPATCH_REGISTER(Op)                                                  \
+  Table[static_cast<uint8_t>(OpCode::Op)] = &&DISPATCH_LABEL(Op)
+#define DISPATCH_SUPER_REGISTER(Op)                                            \
+  Table[static_cast<uint8_t>(Runtime::SuperCode::Op)] = &&DISPATCH_LABEL(Op)
+#define DISPATCH_REG_REGISTER(Op)                                              \
+  Table[static_cast<uint8_t>(Runtime::RegCode::Op)] = &&DISPATCH_LABEL(Op)
+#define DISPATCH_TIER_REGISTER(Op)                                             \
+  Table[static_cast<uint8_t>(Runtime::TierCode::Op)] = &&DISPATCH_LABEL(Op)
+/// Register handlers of all Wasm instructions to the dispatch table.
+#define DISPATCH_REGISTER_WASM()                                               \
+  DISPATCH_REGISTER(Unreachable);                                              \
+  DISPATCH_REGISTER(Nop);                                                      \
+  DISPATCH_REGISTER(Block);                                                    \
+  DISPATCH_REGISTER(Loop);                                                     \
+  DISPATCH_REGISTER(If);                                                       \
+  DISPATCH_REGISTER(Else);                                                     \
+  DISPATCH_REGISTER(Br);                                                       \
+  DISPATCH_REGISTER(Br_if);                                                    \
+  DISPATCH_REGISTER(Br_table);                                                 \
+  DISPATCH_REGISTER(Return);                                                   \
+  DISPATCH_REGISTER(Call);                                                     \
+  DISPATCH_REGISTER(Call_indirect);                                            \
+  DISPATCH_REGISTER(Return_call);                                              \
+  DISPATCH_REGISTER(Return_call_indirect);                                     \
+  DISPATCH_REGISTER(Drop);                                                     \
+  DISPATCH_REGISTER(Select);                                                   \
+  DISPATCH_REGISTER(Local__get);                                               \
+  DISPATCH_REGISTER(Local__set);                                               \
+  DISPATCH_REGISTER(Local__tee);                                               \
+  DISPATCH_REGISTER(Global__get);                                              \
+  DISPATCH_REGISTER(Global__set);                                              \
+  DISPATCH_REGISTER(I32__load);                                                \
+  DISPATCH_REGISTER(I64__load);                                                \
+  DISPATCH_REGISTER(F32__load);                                                \
+  DISPATCH_REGISTER(F64__load);                                                \
+  DISPATCH_REGISTER(I32__load8_s);                                             \
+  DISPATCH_REGISTER(I32__load8_u);                                             \
+  DISPATCH_REGISTER(I32__load16_s);                                            \
+  DISPATCH_REGISTER(I32__load16_u);                                            \
+  DISPATCH_REGISTER(I64__load8_s);                                             \
+  DISPATCH_REGISTER(I64__load8_u);                                             \
+  DISPATCH_REGISTER(I64__load16_s);                                            \
+  DISPATCH_REGISTER(I64__load16_u);                                            \
+  DISPATCH_REGISTER(I64__load32_s);                                            \
+  DISPATCH_REGISTER(I64__load32_u);                                            \
+  DISPATCH_REGISTER(I32__store);                                               \
+  DISPATCH_REGISTER(I64__store);                                               \
+  DISPATCH_REGISTER(F32__store);                                               \
+  DISPATCH_REGISTER(F64__store);                                               \
+  DISPATCH_REGISTER(I32__store8);                                              \
+  DISPATCH_REGISTER(I32__store16);                                             \
+  DISPATCH_REGISTER(I64__store8);                                              \
+  DISPATCH_REGISTER(I64__store16);                                             \
+  DISPATCH_REGISTER(I64__store32);                                             \
+  DISPATCH_REGISTER(Memory__grow);                                             \
+  DISPATCH_REGISTER(Memory__size);                                             \
+  DISPATCH_REGISTER(Memory__init);                                             \
+  DISPATCH_REGISTER(Data__drop);                                               \
+  DISPATCH_REGISTER(Memory__copy);                                             \
+  DISPATCH_REGISTER(Memory__fill);                                             \
+  DISPATCH_REGISTER(I32__const);                                               \
+  DISPATCH_REGISTER(I64__const);                                               \
+  DISPATCH_REGISTER(F32__const);                                               \
+  DISPATCH_REGISTER(F64__const);                                               \
+  DISPATCH_REGISTER(I32__eqz);                                                 \
+  DISPATCH_REGISTER(I64__eqz);                                                 \
+  DISPATCH_REGISTER(I32__clz);                                                 \
+  DISPATCH_REGISTER(I32__ctz);                                                 \
+  DISPATCH_REGISTER(I32__popcnt);                                              \
+  DISPATCH_REGISTER(I64__clz);                                                 \
+  DISPATCH_REGISTER(I64__ctz);                                                 \
+  DISPATCH_REGISTER(I64__popcnt);                                              \
+  DISPATCH_REGISTER(F32__abs);                                                 \
+  DISPATCH_REGISTER(F32__neg);                                                 \
+  DISPATCH_REGISTER(F32__ceil);                                                \
+  DISPATCH_REGISTER(F32__floor);                                               \
+  DISPATCH_REGISTER(F32__trunc);                                               \
+  DISPATCH_REGISTER(F32__nearest);                                             \
+  DISPATCH_REGISTER(F32__sqrt);                                                \
+  DISPATCH_REGISTER(F64__abs);                                                 \
+  DISPATCH_REGISTER(F64__neg);                                                 \
+  DISPATCH_REGISTER(F64__ceil);                                                \
+  DISPATCH_REGISTER(F64__floor);                                               \
+  DISPATCH_REGISTER(F64__trunc);                                               \
+  DISPATCH_REGISTER(F64__nearest);                                             \
+  DISPATCH_REGISTER(F64__sqrt);                                                \
+  DISPATCH_REGISTER(I32__wrap_i64);                                            \
+  DISPATCH_REGISTER(I32__trunc_f32_s);                                         \
+  DISPATCH_REGISTER(I32__trunc_f32_u);                                         \
+  DISPATCH_REGISTER(I32__trunc_f64_s);                                         \
+  DISPATCH_REGISTER(I32__trunc_f64_u);                                         \
+  DISPATCH_REGISTER(I64__extend_i32_s);                                        \
+  DISPATCH_REGISTER(I64__extend_i32_u);                                        \
+  DISPATCH_REGISTER(I64__trunc_f32_s);                                         \
+  DISPATCH_REGISTER(I64__trunc_f32_u);                                         \
+  DISPATCH_REGISTER(I64__trunc_f64_s);                                         \
+  DISPATCH_REGISTER(I64__trunc_f64_u);                                         \
+  DISPATCH_REGISTER(F32__convert_i32_s);                                       \
+  DISPATCH_REGISTER(F32__convert_i32_u);                                       \
+  DISPATCH_REGISTER(F32__convert_i64_s);                                       \
+  DISPATCH_REGISTER(F32__convert_i64_u);                                       \
+  DISPATCH_REGISTER(F32__demote_f64);                                          \
+  DISPATCH_REGISTER(F64__convert_i32_s);                                       \
+  DISPATCH_REGISTER(F64__convert_i32_u);                                       \
+  DISPATCH_REGISTER(F64__convert_i64_s);                                       \
+  DISPATCH_REGISTER(F64__convert_i64_u);                                       \
+  DISPATCH_REGISTER(F64__promote_f32);                                         \
+  DISPATCH_REGISTER(I32__reinterpret_f32);                                     \
+  DISPATCH_REGISTER(I64__reinterpret_f64);                                     \
+  DISPATCH_REGISTER(F32__reinterpret_i32);                                     \
+  DISPATCH_REGISTER(F64__reinterpret_i64);                                     \
+  DISPATCH_REGISTER(I32__eq);                                                  \
+  DISPATCH_REGISTER(I32__ne);                                                  \
+  DISPATCH_REGISTER(I32__lt_s);                                                \
+  DISPATCH_REGISTER(I32__lt_u);                                                \
+  DISPATCH_REGISTER(I32__gt_s);                                                \
+  DISPATCH_REGISTER(I32__gt_u);                                                \
+  DISPATCH_REGISTER(I32__le_s);                                                \
+  DISPATCH_REGISTER(I32__le_u);                                                \
+  DISPATCH_REGISTER(I32__ge_s);                                                \
+  DISPATCH_REGISTER(I32__ge_u);                                                \
+  DISPATCH_REGISTER(I64__eq);                                                  \
+  DISPATCH_REGISTER(I64__ne);                                                  \
+  DISPATCH_REGISTER(I64__lt_s);                                                \
+  DISPATCH_REGISTER(I64__lt_u);                                                \
+  DISPATCH_REGISTER(I64__gt_s);                                                \
+  DISPATCH_REGISTER(I64__gt_u);                                                \
+  DISPATCH_REGISTER(I64__le_s);                                                \
+  DISPATCH_REGISTER(I64__le_u);                                                \
+  DISPATCH_REGISTER(I64__ge_s);                                                \
+  DISPATCH_REGISTER(I64__ge_u);                                                \
+  DISPATCH_REGISTER(F32__eq);                                                  \
+  DISPATCH_REGISTER(F32__ne);                                                  \
+  DISPATCH_REGISTER(F32__lt);                                                  \
+  DISPATCH_REGISTER(F32__gt);                                                  \
+  DISPATCH_REGISTER(F32__le);                                                  \
+  DISPATCH_REGISTER(F32__ge);                                                  \
+  DISPATCH_REGISTER(F64__eq);                                                  \
+  DISPATCH_REGISTER(F64__ne);                                                  \
+  DISPATCH_REGISTER(F64__lt);                                                  \
+  DISPATCH_REGISTER(F64__gt);                                                  \
+  DISPATCH_REGISTER(F64__le);                                                  \
+  DISPATCH_REGISTER(F64__ge);                                                  \
+  DISPATCH_REGISTER(I32__add);                                                 \
+  DISPATCH_REGISTER(I32__sub);                                                 \
+  DISPATCH_REGISTER(I32__mul);                                                 \
+  DISPATCH_REGISTER(I32__div_s);                                               \
+  DISPATCH_REGISTER(I32__div_u);                                               \
+  DISPATCH_REGISTER(I32__rem_s);                                               \
+  DISPATCH_REGISTER(I32__rem_u);                                               \
+  DISPATCH_REGISTER(I32__and);                                                 \
+  DISPATCH_REGISTER(I32__or);                                                  \
+  DISPATCH_REGISTER(I32__xor);                                                 \
+  DISPATCH_REGISTER(I32__shl);                                                 \
+  DISPATCH_REGISTER(I32__shr_s);                                               \
+  DISPATCH_REGISTER(I32__shr_u);                                               \
+  DISPATCH_REGISTER(I32__rotl);                                                \
+  DISPATCH_REGISTER(I32__rotr);                                                \
+  DISPATCH_REGISTER(I64__add);                                                 \
+  DISPATCH_REGISTER(I64__sub);                                                 \
+  DISPATCH_REGISTER(I64__mul);                                                 \
+  DISPATCH_REGISTER(I64__div_s);                                               \
+  DISPATCH_REGISTER(I64__div_u);                                               \
+  DISPATCH_REGISTER(I64__rem_s);                                               \
+  DISPATCH_REGISTER(I64__rem_u);                                               \
+  DISPATCH_REGISTER(I64__and);                                                 \
+  DISPATCH_REGISTER(I64__or);                                                  \
+  DISPATCH_REGISTER(I64__xor);                                                 \
+  DISPATCH_REGISTER(I64__shl);                                                 \
+  DISPATCH_REGISTER(I64__shr_s);                                               \
+  DISPATCH_REGISTER(I64__shr_u);                                               \
+  DISPATCH_REGISTER(I64__rotl);                                                \
+  DISPATCH_REGISTER(I64__rotr);                                                \
+  DISPATCH_REGISTER(F32__add);                                                 \
+  DISPATCH_REGISTER(F32__sub);                                                 \
+  DISPATCH_REGISTER(F32__mul);                                                 \
+  DISPATCH_REGISTER(F32__div);                                                 \
+  DISPATCH_REGISTER(F32__min);                                                 \
+  DISPATCH_REGISTER(F32__max);                                                 \
+  DISPATCH_REGISTER(F32__copysign);                                            \
+  DISPATCH_REGISTER(F64__add);                                                 \
+  DISPATCH_REGISTER(F64__sub);                                                 \
+  DISPATCH_REGISTER(F64__mul);                                                 \
+  DISPATCH_REGISTER(F64__div);                                                 \
+  DISPATCH_REGISTER(F64__min);                                                 \
+  DISPATCH_REGISTER(F64__max);                                                 \
+  DISPATCH_REGISTER(F64__copysign);                                            \
+  DISPATCH_REGISTER(SIMD);                                                     \
+  DISPATCH_REGISTER(Atomic);
+#define DISPATCH_CASE(Op) DISPATCH_LABEL(Op) :
+#define DISPATCH_SUPER_CASE(Op) DISPATCH_LABEL(Op) :
+#define DISPATCH_REG_CASE(Op) DISPATCH_LABEL(Op) :
+#define DISPATCH_TIER_CASE(Op) DISPATCH_LABEL(Op) :
+#define DISPATCH_NEXT()                                                        \
+  do {                                                                         \
+    DISPATCH_FETCH();                                                          \
+    goto *DispatchTable[static_cast<uint8_t>(Instr->Code)];                    \
+  } while (0)
+#else
+#define DISPATCH_CASE(Op) case OpCode::Op:
+#define DISPATCH_SUPER_CASE(Op) case Runtime::SuperCode::Op:
+#define DISPATCH_REG_CASE(Op) case Runtime::RegCode::Op:
+#define DISPATCH_TIER_CASE(Op) case Runtime::TierCode::Op:
+#define DISPATCH_NEXT() goto Fetch
+#endif
+
+/// Stop running with the trap code. The traps are handled at the `Trap` label
+/// out of the dispatching path.
+#define DISPATCH_TRAP(Code)                                                    \
+  TrapCode = (Code);                                                           \
+  goto Trap
+
+/// Run the handler may trap, and dispatch the next instruction if succeeded.
+#define DISPATCH_RUN(...)                                                      \
+  if (auto Res = (__VA_ARGS__); !Res) {                                        \
+    DISPATCH_TRAP(Res.error());                                                \
+  }                                                                            \
+  DISPATCH_NEXT()
+
+/// Run the handler never traps on the top value of stack `Top` in place. The
+/// handlers access the values through the references of the variant members,
+/// so that the operand should not be a local copy which may be scalarized.
+#define DISPATCH_TOP(...)                                                      \
+  {                                                                            \
+    ValVariant &Top = Stack.getTop();                                          \
+    __VA_ARGS__;                                                               \
+  }                                                                            \
+  DISPATCH_NEXT()
+
+/// Run the handler may trap on the top value of stack `Top` in place.
+#define DISPATCH_TOP_RUN(...)                                                  \
+  {                                                                            \
+    ValVariant &Top = Stack.getTop();                                          \
+    DISPATCH_RUN(__VA_ARGS__);                                                 \
   }
-}
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::BrTableControlInstruction &Instr) {
-  switch (Instr.getOpCode()) {
-  case OpCode::Br_table:
-    return runBrTableOp(Instr);
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+/// Run the handler accessing the value stack through the stack manager. The
+/// cached top value is spilled before and reloaded after.
+#define DISPATCH_SYNC_RUN(...)                                                 \
+  Stack.spill();                                                               \
+  if (auto Res = (__VA_ARGS__); !Res) {                                        \
+    DISPATCH_TRAP(Res.error());                                                \
+  }                                                                            \
+  Stack.reload();                                                              \
+  DISPATCH_NEXT()
+
+/// Run the tail call, and return to the runtime if it entered a promoted
+/// function, which is run there before continuing in this dispatcher.
+#define DISPATCH_TAIL_RUN(...)                                                 \
+  Stack.spill();                                                               \
+  if (auto Res = (__VA_ARGS__); !Res) {                                        \
+    DISPATCH_TRAP(Res.error());                                                \
+  }                                                                            \
+  if (TailRegEntered) {                                                        \
+    return {};                                                                 \
+  }                                                                            \
+  Stack.reload();                                                              \
+  DISPATCH_NEXT()
+
+template <typename Policy>
+Expect<void> Interpreter::chargeBlock(const Runtime::ByteCode &Instr) {
+  /// The metering of the following instructions in the block are in the
+  /// following entries.
+  const Runtime::ByteCodeMeter *Meter = InstrPdr.getMeter(&Instr);
+  if constexpr (!Policy::ChargeCost) {
+    if (Measure->isPairCounting()) {
+      Measure->countPair(Instr.Code);
+    }
+    Measure->addInstrCnt(Meter->BlockCnt);
+    return {};
+  }
+
+  uint64_t &CostSum = Measure->getCostSum();
+  const uint64_t CostLimit = Measure->getCostLimit();
+  if (&Instr == GasTrap) {
+    /// Reached the instruction exceeding the limit.
+    GasTrap = nullptr;
+    Measure->addInstrCnt(GasTrapCnt);
+    CostSum = CostLimit;
+    return Unexpect(ErrCode::CostLimitExceeded);
+  }
+  if (Measure->isPairCounting()) {
+    Measure->countPair(Instr.Code);
+  }
+  if (CostSum <= CostLimit && Meter->BlockCost <= CostLimit - CostSum) {
+    Measure->addInstrCnt(Meter->BlockCnt);
+    CostSum += Meter->BlockCost;
+    return {};
   }
+
+  /// Find the first instruction exceeding the limit, and the instruction or
+  /// superinstruction containing it to stop at.
+  uint32_t Exceed = 0;
+  if (CostSum <= CostLimit) {
+    while (Meter->BlockCost - Meter[Exceed].RemainCost <=
+           CostLimit - CostSum) {
+      ++Exceed;
+    }
+  }
+  uint32_t Stop = 0;
+  while (true) {
+    const auto Code = (&Instr)[Stop].Code;
+    const uint32_t Length =
+        Code >= Runtime::SuperCode::Begin && Code <= Runtime::SuperCode::Last
+            ? Runtime::SuperCode::getLength(Code)
+            : 1;
+    if (Stop + Length > Exceed) {
+      break;
+    }
+    Stop += Length;
+  }
+  if (Stop == 0) {
+    Measure->addInstrCnt(Meter->BlockCnt - Meter[Exceed].RemainCnt);
+    CostSum = CostLimit;
+    return Unexpect(ErrCode::CostLimitExceeded);
+  }
+
+  /// Add the costs of the instructions before the stop.
+  const Runtime::ByteCodeMeter &Last = Meter[Stop - 1];
+  Measure->addInstrCnt(Meter->BlockCnt - Last.RemainCnt);
+  CostSum += Meter->BlockCost - Last.RemainCost;
+  GasTrap = &Instr + Stop;
+  GasTrapCnt = Last.RemainCnt - Meter[Exceed].RemainCnt;
+  GasUnchargedCost = Last.RemainCost;
+  GasUnchargedCnt = Last.RemainCnt;
+  return {};
 }
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::CallControlInstruction &Instr) {
-  switch (Instr.getOpCode()) {
-  case OpCode::Call:
-    return runCallOp(StoreMgr, Instr);
-  case OpCode::Call_indirect:
-    return runCallIndirectOp(StoreMgr, Instr);
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+template <typename Policy>
+ErrCode Interpreter::refundBlock(const Runtime::ByteCodeMeter *Meter,
+                                 const ErrCode Code) {
+  if constexpr (Policy::CountInstr) {
+    /// The instruction not in any sequence is a tail call replaced its
+    /// function. It ends its block, so nothing remains.
+    if (Meter == nullptr) {
+      return Code;
+    }
+    uint64_t Cost = Meter->RemainCost;
+    uint32_t Cnt = Meter->RemainCnt;
+    if (GasTrap) {
+      /// Only the instructions before the stop were charged.
+      Cost -= GasUnchargedCost;
+      Cnt -= GasUnchargedCnt;
+      GasTrap = nullptr;
+    }
+    if constexpr (Policy::ChargeCost) {
+      Measure->subCost(Cost);
+      /// Running out of cost uses up the limit, as in charging the blocks.
+      if (Code == ErrCode::CostLimitExceeded) {
+        Measure->getCostSum() = Measure->getCostLimit();
+      }
+    }
+    Measure->subInstrCnt(Cnt);
   }
+  return Code;
 }
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::ParametricInstruction &Instr) {
-  switch (Instr.getOpCode()) {
-  case OpCode::Drop:
-    StackMgr.pop();
-    return {};
-  case OpCode::Select: {
+template <typename Policy, bool CacheTop>
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr) {
+  const Runtime::ByteCode *Instr = nullptr;
+  /// Value stack access with the top value cached if enabled.
+  TopCache<CacheTop> Stack(StackMgr);
+  /// Error code of the trapped instruction.
+  ErrCode TrapCode = ErrCode::Success;
+
+#ifdef SSVM_THREADED_DISPATCH
+  /// Dispatch table of handlers indexed by OpCode, built once. Every handled
+  /// OpCode below should be registered here.
+  DISPATCH_TABLE(DISPATCH_REGISTER_WASM();
+                 DISPATCH_SUPER_REGISTER(LocalGetI32ConstI32Add);
+                 DISPATCH_SUPER_REGISTER(LocalGetI32ConstI32Sub);
+                 DISPATCH_SUPER_REGISTER(LocalGetI32Const);
+                 DISPATCH_SUPER_REGISTER(LocalGetLocalGet);
+                 DISPATCH_SUPER_REGISTER(I32ConstI32Add);
+                 DISPATCH_SUPER_REGISTER(I32LtSIf);
+                 DISPATCH_SUPER_REGISTER(I32EqzBrIf);
+                 DISPATCH_TIER_REGISTER(LoopHead););
+
+  /// Start from the first instruction.
+  DISPATCH_NEXT();
+#else
+Fetch:
+  DISPATCH_FETCH();
+  switch (Instr->Code) {
+#endif
+
+  /// Control instructions.
+  DISPATCH_CASE(Unreachable)
+    DISPATCH_TRAP(ErrCode::Unreachable);
+  DISPATCH_CASE(Nop)
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Block)
+  DISPATCH_CASE(Loop)
+    DISPATCH_NEXT();
+  DISPATCH_TIER_CASE(LoopHead) {
+    /// Count the loop iteration in tiered execution.
+    const auto *FuncInst = StackMgr.getModule()->getFunc(Instr->Index);
+    if (FuncInst->addHotness(1) < HotThreshold) {
+      DISPATCH_NEXT();
+    }
+    Stack.spill();
+    if (auto Res = promoteFunction(StoreMgr, *FuncInst); !Res) {
+      DISPATCH_TRAP(Res.error());
+    }
+    if (FuncInst->getLoopStart(Instr->Dst) == RegisterTranslator::NoLoopStart) {
+      /// Not reached. Keep running in stack-based byte code.
+      Stack.reload();
+      DISPATCH_NEXT();
+    }
+    /// Continue the hot loop in the promoted function. The rest of the block
+    /// is charged there instead, so it is refunded before, as well as the
+    /// stop at the instruction exceeding the limit.
+    refundBlock<Policy>(InstrPdr.getMeter(Instr), ErrCode::Success);
+    if (auto Res = runPromotedLoop(StoreMgr, *FuncInst, Instr->Dst); !Res) {
+      return Unexpect(Res);
+    }
+    Stack.reload();
+    DISPATCH_NEXT();
+  }
+  DISPATCH_CASE(If) {
+    ValVariant Cond = Stack.pop();
+    DISPATCH_RUN(runIfElseOp<Policy>(*Instr, Cond));
+  }
+  DISPATCH_CASE(Else)
+    DISPATCH_RUN(runElseOp(*Instr));
+  DISPATCH_CASE(Br)
+    DISPATCH_SYNC_RUN(runBrOp(*Instr));
+  DISPATCH_CASE(Br_if) {
+    ValVariant Cond = Stack.pop();
+    if (retrieveValue<uint32_t>(Cond) == 0) {
+      DISPATCH_NEXT();
+    }
+    DISPATCH_SYNC_RUN(runBrOp(*Instr));
+  }
+  DISPATCH_CASE(Br_table)
+    DISPATCH_SYNC_RUN(runBrTableOp(*Instr));
+  DISPATCH_CASE(Return)
+    DISPATCH_SYNC_RUN(runReturnOp());
+  DISPATCH_CASE(Call) {
+    /// Fast path of calling native functions.
+    const auto *FuncInst = StackMgr.getModule()->getFunc(Instr->Index);
+    if (!Tiered && !FuncInst->isHostFunction() &&
+        StackMgr.hasRoom(FuncInst->getFrameSize())) {
+      Stack.spill();
+      enterNativeFunction(StoreMgr, *FuncInst);
+      Stack.reload();
+      DISPATCH_NEXT();
+    }
+    DISPATCH_SYNC_RUN(runCallOp(StoreMgr, *Instr));
+  }
+  DISPATCH_CASE(Call_indirect)
+    DISPATCH_SYNC_RUN(runCallIndirectOp(StoreMgr, *Instr));
+  DISPATCH_CASE(Return_call)
+    DISPATCH_TAIL_RUN(runReturnCallOp(StoreMgr, *Instr));
+  DISPATCH_CASE(Return_call_indirect)
+    DISPATCH_TAIL_RUN(runReturnCallIndirectOp(StoreMgr, *Instr));
+
+  /// Parametric instructions.
+  DISPATCH_CASE(Drop)
+    Stack.pop();
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Select) {
     /// Pop the i32 value and select values from stack.
-    ValVariant CondVal = StackMgr.pop();
-    ValVariant Val2 = StackMgr.pop();
-    ValVariant Val1 = StackMgr.pop();
+    ValVariant CondVal = Stack.pop();
+    ValVariant Val2 = Stack.pop();
+    ValVariant Val1 = Stack.pop();
 
     /// Select the value.
     if (retrieveValue<uint32_t>(CondVal) == 0) {
-      StackMgr.push(Val2);
+      Stack.push(Val2);
     } else {
-      StackMgr.push(Val1);
+      Stack.push(Val1);
     }
-    return {};
+    DISPATCH_NEXT();
   }
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+
+  /// Variable instructions.
+  DISPATCH_CASE(Local__get)
+    Stack.push(StackMgr.getBottomN(StackMgr.getOffset(Instr->Index)));
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Local__set)
+    Stack.popTo(StackMgr.getBottomN(StackMgr.getOffset(Instr->Index)));
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Local__tee)
+    StackMgr.getBottomN(StackMgr.getOffset(Instr->Index)) = Stack.getTop();
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Global__get)
+    Stack.push(getGlobInstByIdx(Instr->Index)->getValue());
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Global__set)
+    getGlobInstByIdx(Instr->Index)->setValue(Stack.pop());
+    DISPATCH_NEXT();
+
+  /// Memory instructions.
+  DISPATCH_CASE(I32__load)
+    DISPATCH_TOP_RUN(runLoadOp<uint32_t>(*getMemInstByIdx(0), Top, *Instr));
+  DISPATCH_CASE(I64__load)
+    DISPATCH_TOP_RUN(runLoadOp<uint64_t>(*getMemInstByIdx(0), Top, *Instr));
+  DISPATCH_CASE(F32__load)
+    DISPATCH_TOP_RUN(runLoadOp<float>(*getMemInstByIdx(0), Top, *Instr));
+  DISPATCH_CASE(F64__load)
+    DISPATCH_TOP_RUN(runLoadOp<double>(*getMemInstByIdx(0), Top, *Instr));
+  DISPATCH_CASE(I32__load8_s)
+    DISPATCH_TOP_RUN(runLoadOp<int32_t>(*getMemInstByIdx(0), Top, *Instr, 8));
+  DISPATCH_CASE(I32__load8_u)
+    DISPATCH_TOP_RUN(runLoadOp<uint32_t>(*getMemInstByIdx(0), Top, *Instr, 8));
+  DISPATCH_CASE(I32__load16_s)
+    DISPATCH_TOP_RUN(runLoadOp<int32_t>(*getMemInstByIdx(0), Top, *Instr, 16));
+  DISPATCH_CASE(I32__load16_u)
+    DISPATCH_TOP_RUN(runLoadOp<uint32_t>(*getMemInstByIdx(0), Top, *Instr, 16));
+  DISPATCH_CASE(I64__load8_s)
+    DISPATCH_TOP_RUN(runLoadOp<int64_t>(*getMemInstByIdx(0), Top, *Instr, 8));
+  DISPATCH_CASE(I64__load8_u)
+    DISPATCH_TOP_RUN(runLoadOp<uint64_t>(*getMemInstByIdx(0), Top, *Instr, 8));
+  DISPATCH_CASE(I64__load16_s)
+    DISPATCH_TOP_RUN(runLoadOp<int64_t>(*getMemInstByIdx(0), Top, *Instr, 16));
+  DISPATCH_CASE(I64__load16_u)
+    DISPATCH_TOP_RUN(runLoadOp<uint64_t>(*getMemInstByIdx(0), Top, *Instr, 16));
+  DISPATCH_CASE(I64__load32_s)
+    DISPATCH_TOP_RUN(runLoadOp<int64_t>(*getMemInstByIdx(0), Top, *Instr, 32));
+  DISPATCH_CASE(I64__load32_u)
+    DISPATCH_TOP_RUN(runLoadOp<uint64_t>(*getMemInstByIdx(0), Top, *Instr, 32));
+  DISPATCH_CASE(I32__store) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<uint32_t>(
+        *getMemInstByIdx(0), Addr, Val, *Instr));
+  }
+  DISPATCH_CASE(I64__store) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<uint64_t>(
+        *getMemInstByIdx(0), Addr, Val, *Instr));
+  }
+  DISPATCH_CASE(F32__store) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<float>(
+        *getMemInstByIdx(0), Addr, Val, *Instr));
+  }
+  DISPATCH_CASE(F64__store) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<double>(
+        *getMemInstByIdx(0), Addr, Val, *Instr));
+  }
+  DISPATCH_CASE(I32__store8) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<uint32_t>(
+        *getMemInstByIdx(0), Addr, Val, *Instr, 8));
+  }
+  DISPATCH_CASE(I32__store16) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<uint32_t>(
+        *getMemInstByIdx(0), Addr, Val, *Instr, 16));
+  }
+  DISPATCH_CASE(I64__store8) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<uint64_t>(
+        *getMemInstByIdx(0), Addr, Val, *Instr, 8));
+  }
+  DISPATCH_CASE(I64__store16) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<uint64_t>(
+        *getMemInstByIdx(0), Addr, Val, *Instr, 16));
+  }
+  DISPATCH_CASE(I64__store32) {
+    ValVariant Val = Stack.pop();
+    ValVariant Addr = Stack.pop();
+    DISPATCH_RUN(runStoreOp<uint64_t>(
+        *getMemInstByIdx(0), Addr, Val, *Instr, 32));
+  }
+  DISPATCH_CASE(Memory__grow)
+    DISPATCH_SYNC_RUN(
+        runMemoryGrowOp(*getMemInstByIdx(0), StackMgr.getTop()));
+  DISPATCH_CASE(Memory__size)
+    DISPATCH_SYNC_RUN(runMemorySizeOp(*getMemInstByIdx(0)));
+  DISPATCH_CASE(Memory__init) {
+    ValVariant Len = Stack.pop();
+    ValVariant Src = Stack.pop();
+    ValVariant Dst = Stack.pop();
+    DISPATCH_BULK_CHARGE(OpCode::Memory__init, Len);
+    DISPATCH_RUN(runMemoryInitOp(
+        *getMemInstByIdx(0), *StackMgr.getModule()->getData(Instr->Index), Dst,
+        Src, Len));
+  }
+  DISPATCH_CASE(Data__drop)
+    runDataDropOp(*StackMgr.getModule()->getData(Instr->Index));
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Memory__copy) {
+    ValVariant Len = Stack.pop();
+    ValVariant Src = Stack.pop();
+    ValVariant Dst = Stack.pop();
+    DISPATCH_BULK_CHARGE(OpCode::Memory__copy, Len);
+    DISPATCH_RUN(runMemoryCopyOp(*getMemInstByIdx(0), Dst, Src, Len));
+  }
+  DISPATCH_CASE(Memory__fill) {
+    ValVariant Len = Stack.pop();
+    ValVariant Val = Stack.pop();
+    ValVariant Dst = Stack.pop();
+    DISPATCH_BULK_CHARGE(OpCode::Memory__fill, Len);
+    DISPATCH_RUN(runMemoryFillOp(*getMemInstByIdx(0), Dst, Val, Len));
   }
-}
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::VariableInstruction &Instr) {
-  /// Get variable index.
-  uint32_t Index = Instr.getVariableIndex();
-
-  /// Check OpCode and run the specific instruction.
-  switch (Instr.getOpCode()) {
-  case OpCode::Local__get:
-    return runLocalGetOp(Index);
-  case OpCode::Local__set:
-    return runLocalSetOp(Index);
-  case OpCode::Local__tee:
-    return runLocalTeeOp(Index);
-  case OpCode::Global__get:
-    return runGlobalGetOp(StoreMgr, Index);
-  case OpCode::Global__set:
-    return runGlobalSetOp(StoreMgr, Index);
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+  /// SIMD instructions. The operands are run in place on the value stack, and
+  /// the result replaces the first operand.
+  DISPATCH_CASE(SIMD) {
+    Stack.spill();
+    const uint32_t Base = StackMgr.size() - Instr->Arity;
+    if (Instr->Arity == 0) {
+      StackMgr.grow();
+    }
+    if (auto Res = runSIMDOp(*Instr, &StackMgr.getBottomN(Base)); !Res) {
+      DISPATCH_TRAP(Res.error());
+    }
+    StackMgr.resize(Base +
+                    (Instr->SubCode == AST::SIMDCode::V128__store ? 0 : 1));
+    Stack.reload();
+    DISPATCH_NEXT();
   }
-}
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::MemoryInstruction &Instr) {
-  auto *MemInst = getMemInstByIdx(StoreMgr, 0);
-  switch (Instr.getOpCode()) {
-  case OpCode::I32__load:
-    return runLoadOp<uint32_t>(*MemInst, Instr);
-  case OpCode::I64__load:
-    return runLoadOp<uint64_t>(*MemInst, Instr);
-  case OpCode::F32__load:
-    return runLoadOp<float>(*MemInst, Instr);
-  case OpCode::F64__load:
-    return runLoadOp<double>(*MemInst, Instr);
-  case OpCode::I32__load8_s:
-    return runLoadOp<int32_t>(*MemInst, Instr, 8);
-  case OpCode::I32__load8_u:
-    return runLoadOp<uint32_t>(*MemInst, Instr, 8);
-  case OpCode::I32__load16_s:
-    return runLoadOp<int32_t>(*MemInst, Instr, 16);
-  case OpCode::I32__load16_u:
-    return runLoadOp<uint32_t>(*MemInst, Instr, 16);
-  case OpCode::I64__load8_s:
-    return runLoadOp<int64_t>(*MemInst, Instr, 8);
-  case OpCode::I64__load8_u:
-    return runLoadOp<uint64_t>(*MemInst, Instr, 8);
-  case OpCode::I64__load16_s:
-    return runLoadOp<int64_t>(*MemInst, Instr, 16);
-  case OpCode::I64__load16_u:
-    return runLoadOp<uint64_t>(*MemInst, Instr, 16);
-  case OpCode::I64__load32_s:
-    return runLoadOp<int64_t>(*MemInst, Instr, 32);
-  case OpCode::I64__load32_u:
-    return runLoadOp<uint64_t>(*MemInst, Instr, 32);
-  case OpCode::I32__store:
-    return runStoreOp<uint32_t>(*MemInst, Instr);
-  case OpCode::I64__store:
-    return runStoreOp<uint64_t>(*MemInst, Instr);
-  case OpCode::F32__store:
-    return runStoreOp<float>(*MemInst, Instr);
-  case OpCode::F64__store:
-    return runStoreOp<double>(*MemInst, Instr);
-  case OpCode::I32__store8:
-    return runStoreOp<uint32_t>(*MemInst, Instr, 8);
-  case OpCode::I32__store16:
-    return runStoreOp<uint32_t>(*MemInst, Instr, 16);
-  case OpCode::I64__store8:
-    return runStoreOp<uint64_t>(*MemInst, Instr, 8);
-  case OpCode::I64__store16:
-    return runStoreOp<uint64_t>(*MemInst, Instr, 16);
-  case OpCode::I64__store32:
-    return runStoreOp<uint64_t>(*MemInst, Instr, 32);
-  case OpCode::Memory__grow:
-    return runMemoryGrowOp(*MemInst);
-  case OpCode::Memory__size:
-    return runMemorySizeOp(*MemInst);
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+  /// Atomic memory instructions. The operands are run in place on the value
+  /// stack as the SIMD instructions.
+  DISPATCH_CASE(Atomic) {
+    Stack.spill();
+    const uint32_t Base = StackMgr.size() - Instr->Arity;
+    if (Instr->Arity == 0) {
+      StackMgr.grow();
+    }
+    if (auto Res = runAtomicOp(*Instr, &StackMgr.getBottomN(Base)); !Res) {
+      DISPATCH_TRAP(Res.error());
+    }
+    /// The stores and `atomic.fence` have no result.
+    const auto Sub = Instr->AtomicSubCode;
+    const bool NoResult =
+        Sub == AST::AtomicCode::Atomic__fence ||
+        (Sub >= AST::AtomicCode::I32__atomic__store &&
+         Sub < AST::AtomicCode::I32__atomic__rmw__add);
+    StackMgr.resize(Base + (NoResult ? 0 : 1));
+    Stack.reload();
+    DISPATCH_NEXT();
   }
-}
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::ConstInstruction &Instr) {
-  StackMgr.push(Instr.getConstValue());
-  return {};
-}
+  /// Const instructions.
+  DISPATCH_CASE(I32__const)
+  DISPATCH_CASE(I64__const)
+  DISPATCH_CASE(F32__const)
+  DISPATCH_CASE(F64__const)
+    Stack.push(Instr->getNum());
+    DISPATCH_NEXT();
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::UnaryNumericInstruction &Instr) {
-  ValVariant &Val = StackMgr.getTop();
-  switch (Instr.getOpCode()) {
-  case OpCode::I32__eqz:
-    return runEqzOp<uint32_t>(Val);
-  case OpCode::I64__eqz:
-    return runEqzOp<uint64_t>(Val);
-  case OpCode::I32__clz:
-    return runClzOp<uint32_t>(Val);
-  case OpCode::I32__ctz:
-    return runCtzOp<uint32_t>(Val);
-  case OpCode::I32__popcnt:
-    return runPopcntOp<uint32_t>(Val);
-  case OpCode::I64__clz:
-    return runClzOp<uint64_t>(Val);
-  case OpCode::I64__ctz:
-    return runCtzOp<uint64_t>(Val);
-  case OpCode::I64__popcnt:
-    return runPopcntOp<uint64_t>(Val);
-  case OpCode::F32__abs:
-    return runAbsOp<float>(Val);
-  case OpCode::F32__neg:
-    return runNegOp<float>(Val);
-  case OpCode::F32__ceil:
-    return runCeilOp<float>(Val);
-  case OpCode::F32__floor:
-    return runFloorOp<float>(Val);
-  case OpCode::F32__trunc:
-    return runTruncOp<float>(Val);
-  case OpCode::F32__nearest:
-    return runNearestOp<float>(Val);
-  case OpCode::F32__sqrt:
-    return runSqrtOp<float>(Val);
-  case OpCode::F64__abs:
-    return runAbsOp<double>(Val);
-  case OpCode::F64__neg:
-    return runNegOp<double>(Val);
-  case OpCode::F64__ceil:
-    return runCeilOp<double>(Val);
-  case OpCode::F64__floor:
-    return runFloorOp<double>(Val);
-  case OpCode::F64__trunc:
-    return runTruncOp<double>(Val);
-  case OpCode::F64__nearest:
-    return runNearestOp<double>(Val);
-  case OpCode::F64__sqrt:
-    return runSqrtOp<double>(Val);
-  case OpCode::I32__wrap_i64:
-    return runWrapOp<uint64_t, uint32_t>(Val);
-  case OpCode::I32__trunc_f32_s:
-    return runTruncateOp<float, int32_t>(Val);
-  case OpCode::I32__trunc_f32_u:
-    return runTruncateOp<float, uint32_t>(Val);
-  case OpCode::I32__trunc_f64_s:
-    return runTruncateOp<double, int32_t>(Val);
-  case OpCode::I32__trunc_f64_u:
-    return runTruncateOp<double, uint32_t>(Val);
-  case OpCode::I64__extend_i32_s:
-    return runExtendOp<int32_t, uint64_t>(Val);
-  case OpCode::I64__extend_i32_u:
-    return runExtendOp<uint32_t, uint64_t>(Val);
-  case OpCode::I64__trunc_f32_s:
-    return runTruncateOp<float, int64_t>(Val);
-  case OpCode::I64__trunc_f32_u:
-    return runTruncateOp<float, uint64_t>(Val);
-  case OpCode::I64__trunc_f64_s:
-    return runTruncateOp<double, int64_t>(Val);
-  case OpCode::I64__trunc_f64_u:
-    return runTruncateOp<double, uint64_t>(Val);
-  case OpCode::F32__convert_i32_s:
-    return runConvertOp<int32_t, float>(Val);
-  case OpCode::F32__convert_i32_u:
-    return runConvertOp<uint32_t, float>(Val);
-  case OpCode::F32__convert_i64_s:
-    return runConvertOp<int64_t, float>(Val);
-  case OpCode::F32__convert_i64_u:
-    return runConvertOp<uint64_t, float>(Val);
-  case OpCode::F32__demote_f64:
-    return runDemoteOp<double, float>(Val);
-  case OpCode::F64__convert_i32_s:
-    return runConvertOp<int32_t, double>(Val);
-  case OpCode::F64__convert_i32_u:
-    return runConvertOp<uint32_t, double>(Val);
-  case OpCode::F64__convert_i64_s:
-    return runConvertOp<int64_t, double>(Val);
-  case OpCode::F64__convert_i64_u:
-    return runConvertOp<uint64_t, double>(Val);
-  case OpCode::F64__promote_f32:
-    return runPromoteOp<float, double>(Val);
-  case OpCode::I32__reinterpret_f32:
-    return runReinterpretOp<float, uint32_t>(Val);
-  case OpCode::I64__reinterpret_f64:
-    return runReinterpretOp<double, uint64_t>(Val);
-  case OpCode::F32__reinterpret_i32:
-    return runReinterpretOp<uint32_t, float>(Val);
-  case OpCode::F64__reinterpret_i64:
-    return runReinterpretOp<uint64_t, double>(Val);
-  default:
-    return Unexpect(ErrCode::ExecutionFailed);
+  /// Unary numeric instructions.
+  DISPATCH_CASE(I32__eqz)
+    DISPATCH_TOP(runEqzOp<uint32_t>(Top));
+  DISPATCH_CASE(I64__eqz)
+    DISPATCH_TOP(runEqzOp<uint64_t>(Top));
+  DISPATCH_CASE(I32__clz)
+    DISPATCH_TOP(runClzOp<uint32_t>(Top));
+  DISPATCH_CASE(I32__ctz)
+    DISPATCH_TOP(runCtzOp<uint32_t>(Top));
+  DISPATCH_CASE(I32__popcnt)
+    DISPATCH_TOP(runPopcntOp<uint32_t>(Top));
+  DISPATCH_CASE(I64__clz)
+    DISPATCH_TOP(runClzOp<uint64_t>(Top));
+  DISPATCH_CASE(I64__ctz)
+    DISPATCH_TOP(runCtzOp<uint64_t>(Top));
+  DISPATCH_CASE(I64__popcnt)
+    DISPATCH_TOP(runPopcntOp<uint64_t>(Top));
+  DISPATCH_CASE(F32__abs)
+    DISPATCH_TOP(runAbsOp<float>(Top));
+  DISPATCH_CASE(F32__neg)
+    DISPATCH_TOP(runNegOp<float>(Top));
+  DISPATCH_CASE(F32__ceil)
+    DISPATCH_TOP(runCeilOp<float>(Top));
+  DISPATCH_CASE(F32__floor)
+    DISPATCH_TOP(runFloorOp<float>(Top));
+  DISPATCH_CASE(F32__trunc)
+    DISPATCH_TOP(runTruncOp<float>(Top));
+  DISPATCH_CASE(F32__nearest)
+    DISPATCH_TOP(runNearestOp<float>(Top));
+  DISPATCH_CASE(F32__sqrt)
+    DISPATCH_TOP(runSqrtOp<float>(Top));
+  DISPATCH_CASE(F64__abs)
+    DISPATCH_TOP(runAbsOp<double>(Top));
+  DISPATCH_CASE(F64__neg)
+    DISPATCH_TOP(runNegOp<double>(Top));
+  DISPATCH_CASE(F64__ceil)
+    DISPATCH_TOP(runCeilOp<double>(Top));
+  DISPATCH_CASE(F64__floor)
+    DISPATCH_TOP(runFloorOp<double>(Top));
+  DISPATCH_CASE(F64__trunc)
+    DISPATCH_TOP(runTruncOp<double>(Top));
+  DISPATCH_CASE(F64__nearest)
+    DISPATCH_TOP(runNearestOp<double>(Top));
+  DISPATCH_CASE(F64__sqrt)
+    DISPATCH_TOP(runSqrtOp<double>(Top));
+  DISPATCH_CASE(I32__wrap_i64)
+    DISPATCH_TOP(runWrapOp<uint64_t, uint32_t>(Top));
+  DISPATCH_CASE(I32__trunc_f32_s)
+    DISPATCH_TOP_RUN(runTruncateOp<float, int32_t>(Top));
+  DISPATCH_CASE(I32__trunc_f32_u)
+    DISPATCH_TOP_RUN(runTruncateOp<float, uint32_t>(Top));
+  DISPATCH_CASE(I32__trunc_f64_s)
+    DISPATCH_TOP_RUN(runTruncateOp<double, int32_t>(Top));
+  DISPATCH_CASE(I32__trunc_f64_u)
+    DISPATCH_TOP_RUN(runTruncateOp<double, uint32_t>(Top));
+  DISPATCH_CASE(I64__extend_i32_s)
+    DISPATCH_TOP(runExtendOp<int32_t, uint64_t>(Top));
+  DISPATCH_CASE(I64__extend_i32_u)
+    DISPATCH_TOP(runExtendOp<uint32_t, uint64_t>(Top));
+  DISPATCH_CASE(I64__trunc_f32_s)
+    DISPATCH_TOP_RUN(runTruncateOp<float, int64_t>(Top));
+  DISPATCH_CASE(I64__trunc_f32_u)
+    DISPATCH_TOP_RUN(runTruncateOp<float, uint64_t>(Top));
+  DISPATCH_CASE(I64__trunc_f64_s)
+    DISPATCH_TOP_RUN(runTruncateOp<double, int64_t>(Top));
+  DISPATCH_CASE(I64__trunc_f64_u)
+    DISPATCH_TOP_RUN(runTruncateOp<double, uint64_t>(Top));
+  DISPATCH_CASE(F32__convert_i32_s)
+    DISPATCH_TOP(runConvertOp<int32_t, float>(Top));
+  DISPATCH_CASE(F32__convert_i32_u)
+    DISPATCH_TOP(runConvertOp<uint32_t, float>(Top));
+  DISPATCH_CASE(F32__convert_i64_s)
+    DISPATCH_TOP(runConvertOp<int64_t, float>(Top));
+  DISPATCH_CASE(F32__convert_i64_u)
+    DISPATCH_TOP(runConvertOp<uint64_t, float>(Top));
+  DISPATCH_CASE(F32__demote_f64)
+    DISPATCH_TOP(runDemoteOp<double, float>(Top));
+  DISPATCH_CASE(F64__convert_i32_s)
+    DISPATCH_TOP(runConvertOp<int32_t, double>(Top));
+  DISPATCH_CASE(F64__convert_i32_u)
+    DISPATCH_TOP(runConvertOp<uint32_t, double>(Top));
+  DISPATCH_CASE(F64__convert_i64_s)
+    DISPATCH_TOP(runConvertOp<int64_t, double>(Top));
+  DISPATCH_CASE(F64__convert_i64_u)
+    DISPATCH_TOP(runConvertOp<uint64_t, double>(Top));
+  DISPATCH_CASE(F64__promote_f32)
+    DISPATCH_TOP(runPromoteOp<float, double>(Top));
+  DISPATCH_CASE(I32__reinterpret_f32)
+    DISPATCH_TOP(runReinterpretOp<float, uint32_t>(Top));
+  DISPATCH_CASE(I64__reinterpret_f64)
+    DISPATCH_TOP(runReinterpretOp<double, uint64_t>(Top));
+  DISPATCH_CASE(F32__reinterpret_i32)
+    DISPATCH_TOP(runReinterpretOp<uint32_t, float>(Top));
+  DISPATCH_CASE(F64__reinterpret_i64)
+    DISPATCH_TOP(runReinterpretOp<uint64_t, double>(Top));
+
+  /// Binary numeric instructions.
+  DISPATCH_CASE(I32__eq) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runEqOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__ne) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runNeOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__lt_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLtOp<int32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__lt_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLtOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__gt_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGtOp<int32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__gt_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGtOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__le_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLeOp<int32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__le_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLeOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__ge_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGeOp<int32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__ge_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGeOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__eq) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runEqOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__ne) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runNeOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__lt_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLtOp<int64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__lt_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLtOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__gt_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGtOp<int64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__gt_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGtOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__le_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLeOp<int64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__le_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLeOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__ge_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGeOp<int64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__ge_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGeOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__eq) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runEqOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__ne) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runNeOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__lt) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLtOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__gt) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGtOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__le) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLeOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__ge) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGeOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__eq) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runEqOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__ne) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runNeOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__lt) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLtOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__gt) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGtOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__le) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runLeOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__ge) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runGeOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__add) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runAddOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__sub) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runSubOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__mul) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runMulOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__div_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runDivOp<int32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__div_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runDivOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__rem_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runRemOp<int32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__rem_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runRemOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__and) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runAndOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__or) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runOrOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__xor) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runXorOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__shl) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runShlOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__shr_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runShrOp<int32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__shr_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runShrOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__rotl) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runRotlOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I32__rotr) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runRotrOp<uint32_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__add) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runAddOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__sub) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runSubOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__mul) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runMulOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__div_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runDivOp<int64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__div_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runDivOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__rem_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runRemOp<int64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__rem_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runRemOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__and) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runAndOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__or) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runOrOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__xor) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runXorOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__shl) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runShlOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__shr_s) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runShrOp<int64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__shr_u) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runShrOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__rotl) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runRotlOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(I64__rotr) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runRotrOp<uint64_t>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__add) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runAddOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__sub) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runSubOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__mul) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runMulOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__div) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runDivOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__min) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runMinOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__max) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runMaxOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F32__copysign) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runCopysignOp<float>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__add) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runAddOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__sub) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runSubOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__mul) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runMulOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__div) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP_RUN(runDivOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__min) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runMinOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__max) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runMaxOp<double>(Top, Val2));
+  }
+  DISPATCH_CASE(F64__copysign) {
+    ValVariant Val2 = Stack.pop();
+    DISPATCH_TOP(runCopysignOp<double>(Top, Val2));
+  }
+
+  /// Superinstructions. Skip the following instructions in the sequence
+  /// before running. The last one is the current instruction when trapped.
+  DISPATCH_SUPER_CASE(LocalGetI32ConstI32Add) {
+    InstrPdr.jump(Instr + 3);
+    Stack.push(StackMgr.getBottomN(StackMgr.getOffset(Instr->Index)));
+    Instr += 2;
+    DISPATCH_TOP(runAddOp<uint32_t>(Top, (Instr - 1)->getNum()));
+  }
+  DISPATCH_SUPER_CASE(LocalGetI32ConstI32Sub) {
+    InstrPdr.jump(Instr + 3);
+    Stack.push(StackMgr.getBottomN(StackMgr.getOffset(Instr->Index)));
+    Instr += 2;
+    DISPATCH_TOP(runSubOp<uint32_t>(Top, (Instr - 1)->getNum()));
+  }
+  DISPATCH_SUPER_CASE(LocalGetI32Const) {
+    InstrPdr.jump(Instr + 2);
+    Stack.push(StackMgr.getBottomN(StackMgr.getOffset(Instr->Index)));
+    Stack.push((Instr + 1)->getNum());
+    DISPATCH_NEXT();
+  }
+  DISPATCH_SUPER_CASE(LocalGetLocalGet) {
+    InstrPdr.jump(Instr + 2);
+    Stack.push(StackMgr.getBottomN(StackMgr.getOffset(Instr->Index)));
+    ++Instr;
+    Stack.push(StackMgr.getBottomN(StackMgr.getOffset(Instr->Index)));
+    DISPATCH_NEXT();
+  }
+  DISPATCH_SUPER_CASE(I32ConstI32Add) {
+    InstrPdr.jump(Instr + 2);
+    const ValVariant Num = Instr->getNum();
+    ++Instr;
+    DISPATCH_TOP(runAddOp<uint32_t>(Top, Num));
+  }
+  DISPATCH_SUPER_CASE(I32LtSIf) {
+    InstrPdr.jump(Instr + 2);
+    ValVariant Val2 = Stack.pop();
+    ValVariant Cond = Stack.pop();
+    runLtOp<int32_t>(Cond, Val2);
+    ++Instr;
+    DISPATCH_RUN(runIfElseOp<Policy>(*Instr, Cond));
+  }
+  DISPATCH_SUPER_CASE(I32EqzBrIf) {
+    InstrPdr.jump(Instr + 2);
+    ValVariant Cond = Stack.pop();
+    runEqzOp<uint32_t>(Cond);
+    ++Instr;
+    if (retrieveValue<uint32_t>(Cond) == 0) {
+      DISPATCH_NEXT();
+    }
+    DISPATCH_SYNC_RUN(runBrOp(*Instr));
   }
-}
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
-                                  const AST::BinaryNumericInstruction &Instr) {
-  ValVariant Val2 = StackMgr.pop();
-  ValVariant &Val1 = StackMgr.getTop();
-
-  switch (Instr.getOpCode()) {
-  case OpCode::I32__eq:
-    return runEqOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__ne:
-    return runNeOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__lt_s:
-    return runLtOp<int32_t>(Val1, Val2);
-  case OpCode::I32__lt_u:
-    return runLtOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__gt_s:
-    return runGtOp<int32_t>(Val1, Val2);
-  case OpCode::I32__gt_u:
-    return runGtOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__le_s:
-    return runLeOp<int32_t>(Val1, Val2);
-  case OpCode::I32__le_u:
-    return runLeOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__ge_s:
-    return runGeOp<int32_t>(Val1, Val2);
-  case OpCode::I32__ge_u:
-    return runGeOp<uint32_t>(Val1, Val2);
-  case OpCode::I64__eq:
-    return runEqOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__ne:
-    return runNeOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__lt_s:
-    return runLtOp<int64_t>(Val1, Val2);
-  case OpCode::I64__lt_u:
-    return runLtOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__gt_s:
-    return runGtOp<int64_t>(Val1, Val2);
-  case OpCode::I64__gt_u:
-    return runGtOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__le_s:
-    return runLeOp<int64_t>(Val1, Val2);
-  case OpCode::I64__le_u:
-    return runLeOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__ge_s:
-    return runGeOp<int64_t>(Val1, Val2);
-  case OpCode::I64__ge_u:
-    return runGeOp<uint64_t>(Val1, Val2);
-  case OpCode::F32__eq:
-    return runEqOp<float>(Val1, Val2);
-  case OpCode::F32__ne:
-    return runNeOp<float>(Val1, Val2);
-  case OpCode::F32__lt:
-    return runLtOp<float>(Val1, Val2);
-  case OpCode::F32__gt:
-    return runGtOp<float>(Val1, Val2);
-  case OpCode::F32__le:
-    return runLeOp<float>(Val1, Val2);
-  case OpCode::F32__ge:
-    return runGeOp<float>(Val1, Val2);
-  case OpCode::F64__eq:
-    return runEqOp<double>(Val1, Val2);
-  case OpCode::F64__ne:
-    return runNeOp<double>(Val1, Val2);
-  case OpCode::F64__lt:
-    return runLtOp<double>(Val1, Val2);
-  case OpCode::F64__gt:
-    return runGtOp<double>(Val1, Val2);
-  case OpCode::F64__le:
-    return runLeOp<double>(Val1, Val2);
-  case OpCode::F64__ge:
-    return runGeOp<double>(Val1, Val2);
-  case OpCode::I32__add:
-    return runAddOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__sub:
-    return runSubOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__mul:
-    return runMulOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__div_s:
-    return runDivOp<int32_t>(Val1, Val2);
-  case OpCode::I32__div_u:
-    return runDivOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__rem_s:
-    return runRemOp<int32_t>(Val1, Val2);
-  case OpCode::I32__rem_u:
-    return runRemOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__and:
-    return runAndOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__or:
-    return runOrOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__xor:
-    return runXorOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__shl:
-    return runShlOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__shr_s:
-    return runShrOp<int32_t>(Val1, Val2);
-  case OpCode::I32__shr_u:
-    return runShrOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__rotl:
-    return runRotlOp<uint32_t>(Val1, Val2);
-  case OpCode::I32__rotr:
-    return runRotrOp<uint32_t>(Val1, Val2);
-  case OpCode::I64__add:
-    return runAddOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__sub:
-    return runSubOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__mul:
-    return runMulOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__div_s:
-    return runDivOp<int64_t>(Val1, Val2);
-  case OpCode::I64__div_u:
-    return runDivOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__rem_s:
-    return runRemOp<int64_t>(Val1, Val2);
-  case OpCode::I64__rem_u:
-    return runRemOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__and:
-    return runAndOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__or:
-    return runOrOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__xor:
-    return runXorOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__shl:
-    return runShlOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__shr_s:
-    return runShrOp<int64_t>(Val1, Val2);
-  case OpCode::I64__shr_u:
-    return runShrOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__rotl:
-    return runRotlOp<uint64_t>(Val1, Val2);
-  case OpCode::I64__rotr:
-    return runRotrOp<uint64_t>(Val1, Val2);
-  case OpCode::F32__add:
-    return runAddOp<float>(Val1, Val2);
-  case OpCode::F32__sub:
-    return runSubOp<float>(Val1, Val2);
-  case OpCode::F32__mul:
-    return runMulOp<float>(Val1, Val2);
-  case OpCode::F32__div:
-    return runDivOp<float>(Val1, Val2);
-  case OpCode::F32__min:
-    return runMinOp<float>(Val1, Val2);
-  case OpCode::F32__max:
-    return runMaxOp<float>(Val1, Val2);
-  case OpCode::F32__copysign:
-    return runCopysignOp<float>(Val1, Val2);
-  case OpCode::F64__add:
-    return runAddOp<double>(Val1, Val2);
-  case OpCode::F64__sub:
-    return runSubOp<double>(Val1, Val2);
-  case OpCode::F64__mul:
-    return runMulOp<double>(Val1, Val2);
-  case OpCode::F64__div:
-    return runDivOp<double>(Val1, Val2);
-  case OpCode::F64__min:
-    return runMinOp<double>(Val1, Val2);
-  case OpCode::F64__max:
-    return runMaxOp<double>(Val1, Val2);
-  case OpCode::F64__copysign:
-    return runCopysignOp<double>(Val1, Val2);
+#ifdef SSVM_THREADED_DISPATCH
+  DISPATCH_LABEL(Unknown) :
+#else
   default:
+#endif
     return Unexpect(ErrCode::ExecutionFailed);
+#ifndef SSVM_THREADED_DISPATCH
   }
+#endif
+
+ScopeEnd:
+  Stack.spill();
+  /// Run out the expressions.
+  if (InstrPdr.getScopeSize() == 0) {
+    return {};
+  }
+  /// Pop instruction sequence.
+  if (InstrPdr.getTopScopeType() == InstrProvider::SeqType::FunctionCall) {
+    if (auto Res = leaveFunction(); !Res) {
+      return Unexpect(Res);
+    }
+  } else {
+    if (auto Res = InstrPdr.popInstrs(); !Res) {
+      return Unexpect(Res);
+    }
+  }
+  Stack.reload();
+  DISPATCH_NEXT();
+
+Trap:
+  /// The costs of the instructions not run in the block are returned.
+  return Unexpect(refundBlock<Policy>(InstrPdr.getMeter(Instr), TrapCode));
 }
 
-Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr) {
-  /// Run instructions until end.
-  while (InstrPdr.getScopeSize() > 0) {
-    const AST::Instruction *Instr = InstrPdr.getNextInstr();
-    if (Instr == nullptr) {
-      /// Pop instruction sequence.
-      if (InstrPdr.getTopScopeType() == InstrProvider::SeqType::FunctionCall) {
-        if (auto Res = leaveFunction(); !Res) {
-          return Unexpect(Res);
-        }
-      } else if (InstrPdr.getTopScopeType() == InstrProvider::SeqType::Block) {
-        if (auto Res = leaveBlock(); !Res) {
-          return Unexpect(Res);
-        }
-      } else {
-        if (auto Res = InstrPdr.popInstrs(); !Res) {
-          return Unexpect(Res);
-        }
-      }
+#undef DISPATCH_TOP_RUN
+#undef DISPATCH_TOP
+#undef DISPATCH_TAIL_RUN
+#undef DISPATCH_SYNC_RUN
+#undef DISPATCH_RUN
+#undef DISPATCH_FETCH
+
+/// Run the handler may trap, and dispatch the next instruction if succeeded.
+#define DISPATCH_RUN(...)                                                      \
+  if (auto Res = (__VA_ARGS__); !Res) {                                        \
+    DISPATCH_TRAP(Res.error());                                                \
+  }                                                                            \
+  DISPATCH_NEXT()
+
+/// Fetch the next instruction and add the costs of the original instructions
+/// charged before running. Every function ends with `return`, so that there
+/// is always a next instruction.
+#define DISPATCH_FETCH()                                                       \
+  Instr = InstrPdr.getNextInstr();                                             \
+  if constexpr (Policy::CountInstr) {                                          \
+    for (uint32_t I = 0; I < Instr->PreCharge; ++I) {                          \
+      DISPATCH_CHARGE(InstrPdr.getCharges(Instr)[I]);                          \
+    }                                                                          \
+  }
+
+/// Add the costs of the original instructions charged after running, which
+/// are the `local.set` redirected from the instructions may trap.
+#define DISPATCH_POST_CHARGE()                                                 \
+  if constexpr (Policy::CountInstr) {                                          \
+    for (uint32_t I = Instr->PreCharge;                                        \
+         I < Instr->PreCharge + Instr->PostCharge; ++I) {                      \
+      DISPATCH_CHARGE(InstrPdr.getCharges(Instr)[I]);                          \
+    }                                                                          \
+  }
+
+/// Run the handler on the value of slot Src1 and store the result to Dst.
+#define DISPATCH_UNARY(...)                                                    \
+  {                                                                            \
+    ValVariant Val = Slots[Instr->Src1];                                       \
+    __VA_ARGS__(Val);                                                          \
+    Slots[Instr->Dst] = Val;                                                   \
+    DISPATCH_NEXT();                                                           \
+  }
+#define DISPATCH_UNARY_TRAP(...)                                               \
+  {                                                                            \
+    ValVariant Val = Slots[Instr->Src1];                                       \
+    if (auto Res = __VA_ARGS__(Val); !Res) {                                   \
+      DISPATCH_TRAP(Res.error());                                              \
+    }                                                                          \
+    Slots[Instr->Dst] = Val;                                                   \
+    DISPATCH_POST_CHARGE();                                                    \
+    DISPATCH_NEXT();                                                           \
+  }
+
+/// Run the handler on the values of slot Src1 and Src2 and store the result
+/// to Dst.
+#define DISPATCH_BINARY(...)                                                   \
+  {                                                                            \
+    ValVariant Val = Slots[Instr->Src1];                                       \
+    __VA_ARGS__(Val, Slots[Instr->Src2]);                                      \
+    Slots[Instr->Dst] = Val;                                                   \
+    DISPATCH_NEXT();                                                           \
+  }
+#define DISPATCH_BINARY_TRAP(...)                                              \
+  {                                                                            \
+    ValVariant Val = Slots[Instr->Src1];                                       \
+    if (auto Res = __VA_ARGS__(Val, Slots[Instr->Src2]); !Res) {               \
+      DISPATCH_TRAP(Res.error());                                              \
+    }                                                                          \
+    Slots[Instr->Dst] = Val;                                                   \
+    DISPATCH_POST_CHARGE();                                                    \
+    DISPATCH_NEXT();                                                           \
+  }
+
+/// Run the load handler on the address of slot Src1.
+#define DISPATCH_LOAD(T, BitWidth)                                             \
+  {                                                                            \
+    ValVariant Val = Slots[Instr->Src1];                                       \
+    if (auto Res = runLoadOp<T>(*getMemInstByIdx(0), Val, *Instr, BitWidth);  \
+        !Res) {                                                                \
+      DISPATCH_TRAP(Res.error());                                              \
+    }                                                                          \
+    Slots[Instr->Dst] = Val;                                                   \
+    DISPATCH_POST_CHARGE();                                                    \
+    DISPATCH_NEXT();                                                           \
+  }
+
+/// Run the store handler on the address of slot Src1 and the value of Src2.
+#define DISPATCH_STORE(T, BitWidth)                                            \
+  DISPATCH_RUN(runStoreOp<T>(*getMemInstByIdx(0), Slots[Instr->Src1],         \
+                             Slots[Instr->Src2], *Instr, BitWidth))
+
+/// Enter the function, and refresh the frame slots.
+#define DISPATCH_CALL(...)                                                     \
+  if (auto Res = (__VA_ARGS__); !Res) {                                        \
+    DISPATCH_TRAP(Res.error());                                                \
+  }                                                                            \
+  Slots = StackMgr.getRegSlots();                                              \
+  DISPATCH_NEXT()
+
+/// Enter the function replacing the current one, and refresh the frame slots.
+/// Returning from the host function may leave the function entered first.
+#define DISPATCH_TAIL_CALL(...)                                                \
+  if (auto Res = (__VA_ARGS__); !Res) {                                        \
+    DISPATCH_TRAP(Res.error());                                                \
+  }                                                                            \
+  if (InstrPdr.getScopeSize() == ScopeBase) {                                  \
+    return {};                                                                 \
+  }                                                                            \
+  Slots = StackMgr.getRegSlots();                                              \
+  DISPATCH_NEXT()
+
+template <typename Policy>
+Expect<void> Interpreter::executeRegister(Runtime::StoreManager &StoreMgr) {
+  const Runtime::ByteCode *Instr = nullptr;
+  /// Frame slots of the current function.
+  ValVariant *Slots = StackMgr.getRegSlots();
+  /// Scope count of the caller. The loop returns when the function entered
+  /// before returns, which may be called from the stack-based byte code.
+  const uint32_t ScopeBase = InstrPdr.getScopeSize() - 1;
+  /// Error code of the trapped instruction.
+  ErrCode TrapCode = ErrCode::Success;
+
+#ifdef SSVM_THREADED_DISPATCH
+  /// Dispatch table of handlers indexed by OpCode, built once. Every handled
+  /// OpCode below should be registered here.
+  DISPATCH_TABLE(DISPATCH_REGISTER_WASM(); DISPATCH_REG_REGISTER(Mov););
+
+  /// Start from the first instruction.
+  DISPATCH_NEXT();
+#else
+Fetch:
+  DISPATCH_FETCH();
+  switch (Instr->Code) {
+#endif
+
+  /// Control instructions.
+  DISPATCH_CASE(Unreachable)
+    DISPATCH_TRAP(ErrCode::Unreachable);
+  DISPATCH_CASE(Nop)
+    DISPATCH_NEXT();
+  DISPATCH_CASE(If)
+    DISPATCH_RUN(runIfElseOp<Policy>(*Instr, Slots[Instr->Src1]));
+  DISPATCH_CASE(Else)
+    DISPATCH_RUN(runElseOp(*Instr));
+  DISPATCH_CASE(Br)
+    runRegBrOp(Slots, *Instr);
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Br_if)
+    if (retrieveValue<uint32_t>(Slots[Instr->Src2]) != 0) {
+      runRegBrOp(Slots, *Instr);
+    }
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Br_table) {
+    /// Label entries are followed by the default label.
+    const uint32_t Value = retrieveValue<uint32_t>(Slots[Instr->Src1]);
+    runRegBrOp(Slots, *(Instr + std::min(Value, Instr->Index) + 1));
+    DISPATCH_NEXT();
+  }
+  DISPATCH_CASE(Return) {
+    /// Move the results to the beginning of frame.
+    std::copy_n(Slots + Instr->Src1, Instr->Arity, Slots);
+    if (auto Res = leaveRegFunction(Instr->Arity); !Res) {
+      DISPATCH_TRAP(Res.error());
+    }
+    if (InstrPdr.getScopeSize() == ScopeBase) {
+      return {};
+    }
+    Slots = StackMgr.getRegSlots();
+    DISPATCH_NEXT();
+  }
+  DISPATCH_CASE(Call) {
+    const auto *FuncInst = StackMgr.getModule()->getFunc(Instr->Index);
+    DISPATCH_CALL(enterRegFunction(StoreMgr, *FuncInst,
+                                   StackMgr.getOffset(Instr->Dst)));
+  }
+  DISPATCH_CASE(Call_indirect) {
+    auto FuncInst = getIndirectFuncInst(
+        StoreMgr, Instr->Index, retrieveValue<uint32_t>(Slots[Instr->Src1]));
+    if (!FuncInst) {
+      DISPATCH_TRAP(FuncInst.error());
+    }
+    DISPATCH_CALL(enterRegFunction(StoreMgr, **FuncInst,
+                                   StackMgr.getOffset(Instr->Dst)));
+  }
+  DISPATCH_CASE(Return_call) {
+    const auto *FuncInst = StackMgr.getModule()->getFunc(Instr->Index);
+    DISPATCH_TAIL_CALL(enterRegTailFunction(StoreMgr, *FuncInst, Instr->Dst));
+  }
+  DISPATCH_CASE(Return_call_indirect) {
+    auto FuncInst = getIndirectFuncInst(
+        StoreMgr, Instr->Index, retrieveValue<uint32_t>(Slots[Instr->Src1]));
+    if (!FuncInst) {
+      DISPATCH_TRAP(FuncInst.error());
+    }
+    DISPATCH_TAIL_CALL(enterRegTailFunction(StoreMgr, **FuncInst, Instr->Dst));
+  }
+
+  /// Parametric instructions. The condition slot of `select` is in Index.
+  DISPATCH_CASE(Select)
+    if (retrieveValue<uint32_t>(Slots[Instr->Index]) == 0) {
+      Slots[Instr->Dst] = Slots[Instr->Src2];
     } else {
-      OpCode Code = Instr->getOpCode();
-      if (Measure) {
-        Measure->incInstrCnt();
-        /// Add cost. Note: if-else case should be processed additionally.
-        if (!Measure->addInstrCost(Code)) {
-          return Unexpect(ErrCode::CostLimitExceeded);
-        }
-      }
-      /// Run instructions.
-      auto Res = dispatchInstruction(
-          Code, [this, &Instr, &StoreMgr](auto &&Arg) -> Expect<void> {
-            if constexpr (std::is_void_v<
-                              typename std::decay_t<decltype(Arg)>::type>) {
-              /// If the Code not matched, return null pointer.
-              return Unexpect(ErrCode::Unimplemented);
-            } else {
-              /// Make the instruction node according to Code.
-              return execute(
-                  StoreMgr,
-                  *static_cast<const typename std::decay_t<decltype(Arg)>::type
-                                   *>(Instr));
-            }
-          });
-      if (!Res) {
-        return Unexpect(Res);
+      Slots[Instr->Dst] = Slots[Instr->Src1];
+    }
+    DISPATCH_NEXT();
+
+  /// Variable instructions.
+  DISPATCH_REG_CASE(Mov)
+    Slots[Instr->Dst] = Slots[Instr->Src1];
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Global__get)
+    Slots[Instr->Dst] = getGlobInstByIdx(Instr->Index)->getValue();
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Global__set)
+    getGlobInstByIdx(Instr->Index)->setValue(Slots[Instr->Src1]);
+    DISPATCH_NEXT();
+
+  /// Memory instructions.
+  DISPATCH_CASE(I32__load)
+    DISPATCH_LOAD(uint32_t, 32);
+  DISPATCH_CASE(I64__load)
+    DISPATCH_LOAD(uint64_t, 64);
+  DISPATCH_CASE(F32__load)
+    DISPATCH_LOAD(float, 32);
+  DISPATCH_CASE(F64__load)
+    DISPATCH_LOAD(double, 64);
+  DISPATCH_CASE(I32__load8_s)
+    DISPATCH_LOAD(int32_t, 8);
+  DISPATCH_CASE(I32__load8_u)
+    DISPATCH_LOAD(uint32_t, 8);
+  DISPATCH_CASE(I32__load16_s)
+    DISPATCH_LOAD(int32_t, 16);
+  DISPATCH_CASE(I32__load16_u)
+    DISPATCH_LOAD(uint32_t, 16);
+  DISPATCH_CASE(I64__load8_s)
+    DISPATCH_LOAD(int64_t, 8);
+  DISPATCH_CASE(I64__load8_u)
+    DISPATCH_LOAD(uint64_t, 8);
+  DISPATCH_CASE(I64__load16_s)
+    DISPATCH_LOAD(int64_t, 16);
+  DISPATCH_CASE(I64__load16_u)
+    DISPATCH_LOAD(uint64_t, 16);
+  DISPATCH_CASE(I64__load32_s)
+    DISPATCH_LOAD(int64_t, 32);
+  DISPATCH_CASE(I64__load32_u)
+    DISPATCH_LOAD(uint64_t, 32);
+  DISPATCH_CASE(I32__store)
+    DISPATCH_STORE(uint32_t, 32);
+  DISPATCH_CASE(I64__store)
+    DISPATCH_STORE(uint64_t, 64);
+  DISPATCH_CASE(F32__store)
+    DISPATCH_STORE(float, 32);
+  DISPATCH_CASE(F64__store)
+    DISPATCH_STORE(double, 64);
+  DISPATCH_CASE(I32__store8)
+    DISPATCH_STORE(uint32_t, 8);
+  DISPATCH_CASE(I32__store16)
+    DISPATCH_STORE(uint32_t, 16);
+  DISPATCH_CASE(I64__store8)
+    DISPATCH_STORE(uint64_t, 8);
+  DISPATCH_CASE(I64__store16)
+    DISPATCH_STORE(uint64_t, 16);
+  DISPATCH_CASE(I64__store32)
+    DISPATCH_STORE(uint64_t, 32);
+  DISPATCH_CASE(Memory__grow) {
+    ValVariant Val = Slots[Instr->Src1];
+    if (auto Res = runMemoryGrowOp(*getMemInstByIdx(0), Val); !Res) {
+      DISPATCH_TRAP(Res.error());
+    }
+    Slots[Instr->Dst] = Val;
+    DISPATCH_POST_CHARGE();
+    DISPATCH_NEXT();
+  }
+  DISPATCH_CASE(Memory__size)
+    Slots[Instr->Dst] = getMemInstByIdx(0)->getDataPageSize();
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Memory__init)
+    DISPATCH_BULK_CHARGE(OpCode::Memory__init, Slots[Instr->Src1 + 2]);
+    DISPATCH_RUN(runMemoryInitOp(
+        *getMemInstByIdx(0), *StackMgr.getModule()->getData(Instr->Index),
+        Slots[Instr->Src1], Slots[Instr->Src1 + 1], Slots[Instr->Src1 + 2]));
+  DISPATCH_CASE(Data__drop)
+    runDataDropOp(*StackMgr.getModule()->getData(Instr->Index));
+    DISPATCH_NEXT();
+  DISPATCH_CASE(Memory__copy)
+    DISPATCH_BULK_CHARGE(OpCode::Memory__copy, Slots[Instr->Src1 + 2]);
+    DISPATCH_RUN(runMemoryCopyOp(*getMemInstByIdx(0), Slots[Instr->Src1],
+                                 Slots[Instr->Src1 + 1],
+                                 Slots[Instr->Src1 + 2]));
+  DISPATCH_CASE(Memory__fill)
+    DISPATCH_BULK_CHARGE(OpCode::Memory__fill, Slots[Instr->Src1 + 2]);
+    DISPATCH_RUN(runMemoryFillOp(*getMemInstByIdx(0), Slots[Instr->Src1],
+                                 Slots[Instr->Src1 + 1],
+                                 Slots[Instr->Src1 + 2]));
+
+  /// SIMD instructions. The operands are in the consecutive slots starting
+  /// from Src1, which is also the result slot.
+  DISPATCH_CASE(SIMD)
+    /// The cost of the prefix opcode is charged in fetching, and the cost of
+    /// the sub-opcode is added here.
+    if constexpr (Policy::ChargeCost) {
+      if (!Measure->addCost(Measure->getSIMDCost(Instr->SubCode))) {
+        return Unexpect(ErrCode::CostLimitExceeded);
       }
     }
+    DISPATCH_RUN(runSIMDOp(*Instr, Slots + Instr->Src1));
+
+  /// Atomic memory instructions. The operands are in the consecutive slots
+  /// starting from Src1 as the SIMD instructions.
+  DISPATCH_CASE(Atomic)
+    DISPATCH_RUN(runAtomicOp(*Instr, Slots + Instr->Src1));
+
+  /// Const instructions.
+  DISPATCH_CASE(I32__const)
+  DISPATCH_CASE(I64__const)
+  DISPATCH_CASE(F32__const)
+  DISPATCH_CASE(F64__const)
+    Slots[Instr->Dst] = Instr->getNum();
+    DISPATCH_NEXT();
+
+  /// Unary numeric instructions.
+  DISPATCH_CASE(I32__eqz)
+    DISPATCH_UNARY(runEqzOp<uint32_t>);
+  DISPATCH_CASE(I64__eqz)
+    DISPATCH_UNARY(runEqzOp<uint64_t>);
+  DISPATCH_CASE(I32__clz)
+    DISPATCH_UNARY(runClzOp<uint32_t>);
+  DISPATCH_CASE(I32__ctz)
+    DISPATCH_UNARY(runCtzOp<uint32_t>);
+  DISPATCH_CASE(I32__popcnt)
+    DISPATCH_UNARY(runPopcntOp<uint32_t>);
+  DISPATCH_CASE(I64__clz)
+    DISPATCH_UNARY(runClzOp<uint64_t>);
+  DISPATCH_CASE(I64__ctz)
+    DISPATCH_UNARY(runCtzOp<uint64_t>);
+  DISPATCH_CASE(I64__popcnt)
+    DISPATCH_UNARY(runPopcntOp<uint64_t>);
+  DISPATCH_CASE(F32__abs)
+    DISPATCH_UNARY(runAbsOp<float>);
+  DISPATCH_CASE(F32__neg)
+    DISPATCH_UNARY(runNegOp<float>);
+  DISPATCH_CASE(F32__ceil)
+    DISPATCH_UNARY(runCeilOp<float>);
+  DISPATCH_CASE(F32__floor)
+    DISPATCH_UNARY(runFloorOp<float>);
+  DISPATCH_CASE(F32__trunc)
+    DISPATCH_UNARY(runTruncOp<float>);
+  DISPATCH_CASE(F32__nearest)
+    DISPATCH_UNARY(runNearestOp<float>);
+  DISPATCH_CASE(F32__sqrt)
+    DISPATCH_UNARY(runSqrtOp<float>);
+  DISPATCH_CASE(F64__abs)
+    DISPATCH_UNARY(runAbsOp<double>);
+  DISPATCH_CASE(F64__neg)
+    DISPATCH_UNARY(runNegOp<double>);
+  DISPATCH_CASE(F64__ceil)
+    DISPATCH_UNARY(runCeilOp<double>);
+  DISPATCH_CASE(F64__floor)
+    DISPATCH_UNARY(runFloorOp<double>);
+  DISPATCH_CASE(F64__trunc)
+    DISPATCH_UNARY(runTruncOp<double>);
+  DISPATCH_CASE(F64__nearest)
+    DISPATCH_UNARY(runNearestOp<double>);
+  DISPATCH_CASE(F64__sqrt)
+    DISPATCH_UNARY(runSqrtOp<double>);
+  DISPATCH_CASE(I32__wrap_i64)
+    DISPATCH_UNARY(runWrapOp<uint64_t, uint32_t>);
+  DISPATCH_CASE(I32__trunc_f32_s)
+    DISPATCH_UNARY_TRAP(runTruncateOp<float, int32_t>);
+  DISPATCH_CASE(I32__trunc_f32_u)
+    DISPATCH_UNARY_TRAP(runTruncateOp<float, uint32_t>);
+  DISPATCH_CASE(I32__trunc_f64_s)
+    DISPATCH_UNARY_TRAP(runTruncateOp<double, int32_t>);
+  DISPATCH_CASE(I32__trunc_f64_u)
+    DISPATCH_UNARY_TRAP(runTruncateOp<double, uint32_t>);
+  DISPATCH_CASE(I64__extend_i32_s)
+    DISPATCH_UNARY(runExtendOp<int32_t, uint64_t>);
+  DISPATCH_CASE(I64__extend_i32_u)
+    DISPATCH_UNARY(runExtendOp<uint32_t, uint64_t>);
+  DISPATCH_CASE(I64__trunc_f32_s)
+    DISPATCH_UNARY_TRAP(runTruncateOp<float, int64_t>);
+  DISPATCH_CASE(I64__trunc_f32_u)
+    DISPATCH_UNARY_TRAP(runTruncateOp<float, uint64_t>);
+  DISPATCH_CASE(I64__trunc_f64_s)
+    DISPATCH_UNARY_TRAP(runTruncateOp<double, int64_t>);
+  DISPATCH_CASE(I64__trunc_f64_u)
+    DISPATCH_UNARY_TRAP(runTruncateOp<double, uint64_t>);
+  DISPATCH_CASE(F32__convert_i32_s)
+    DISPATCH_UNARY(runConvertOp<int32_t, float>);
+  DISPATCH_CASE(F32__convert_i32_u)
+    DISPATCH_UNARY(runConvertOp<uint32_t, float>);
+  DISPATCH_CASE(F32__convert_i64_s)
+    DISPATCH_UNARY(runConvertOp<int64_t, float>);
+  DISPATCH_CASE(F32__convert_i64_u)
+    DISPATCH_UNARY(runConvertOp<uint64_t, float>);
+  DISPATCH_CASE(F32__demote_f64)
+    DISPATCH_UNARY(runDemoteOp<double, float>);
+  DISPATCH_CASE(F64__convert_i32_s)
+    DISPATCH_UNARY(runConvertOp<int32_t, double>);
+  DISPATCH_CASE(F64__convert_i32_u)
+    DISPATCH_UNARY(runConvertOp<uint32_t, double>);
+  DISPATCH_CASE(F64__convert_i64_s)
+    DISPATCH_UNARY(runConvertOp<int64_t, double>);
+  DISPATCH_CASE(F64__convert_i64_u)
+    DISPATCH_UNARY(runConvertOp<uint64_t, double>);
+  DISPATCH_CASE(F64__promote_f32)
+    DISPATCH_UNARY(runPromoteOp<float, double>);
+  DISPATCH_CASE(I32__reinterpret_f32)
+    DISPATCH_UNARY(runReinterpretOp<float, uint32_t>);
+  DISPATCH_CASE(I64__reinterpret_f64)
+    DISPATCH_UNARY(runReinterpretOp<double, uint64_t>);
+  DISPATCH_CASE(F32__reinterpret_i32)
+    DISPATCH_UNARY(runReinterpretOp<uint32_t, float>);
+  DISPATCH_CASE(F64__reinterpret_i64)
+    DISPATCH_UNARY(runReinterpretOp<uint64_t, double>);
+
+  /// Binary numeric instructions.
+  DISPATCH_CASE(I32__eq)
+    DISPATCH_BINARY(runEqOp<uint32_t>);
+  DISPATCH_CASE(I32__ne)
+    DISPATCH_BINARY(runNeOp<uint32_t>);
+  DISPATCH_CASE(I32__lt_s)
+    DISPATCH_BINARY(runLtOp<int32_t>);
+  DISPATCH_CASE(I32__lt_u)
+    DISPATCH_BINARY(runLtOp<uint32_t>);
+  DISPATCH_CASE(I32__gt_s)
+    DISPATCH_BINARY(runGtOp<int32_t>);
+  DISPATCH_CASE(I32__gt_u)
+    DISPATCH_BINARY(runGtOp<uint32_t>);
+  DISPATCH_CASE(I32__le_s)
+    DISPATCH_BINARY(runLeOp<int32_t>);
+  DISPATCH_CASE(I32__le_u)
+    DISPATCH_BINARY(runLeOp<uint32_t>);
+  DISPATCH_CASE(I32__ge_s)
+    DISPATCH_BINARY(runGeOp<int32_t>);
+  DISPATCH_CASE(I32__ge_u)
+    DISPATCH_BINARY(runGeOp<uint32_t>);
+  DISPATCH_CASE(I64__eq)
+    DISPATCH_BINARY(runEqOp<uint64_t>);
+  DISPATCH_CASE(I64__ne)
+    DISPATCH_BINARY(runNeOp<uint64_t>);
+  DISPATCH_CASE(I64__lt_s)
+    DISPATCH_BINARY(runLtOp<int64_t>);
+  DISPATCH_CASE(I64__lt_u)
+    DISPATCH_BINARY(runLtOp<uint64_t>);
+  DISPATCH_CASE(I64__gt_s)
+    DISPATCH_BINARY(runGtOp<int64_t>);
+  DISPATCH_CASE(I64__gt_u)
+    DISPATCH_BINARY(runGtOp<uint64_t>);
+  DISPATCH_CASE(I64__le_s)
+    DISPATCH_BINARY(runLeOp<int64_t>);
+  DISPATCH_CASE(I64__le_u)
+    DISPATCH_BINARY(runLeOp<uint64_t>);
+  DISPATCH_CASE(I64__ge_s)
+    DISPATCH_BINARY(runGeOp<int64_t>);
+  DISPATCH_CASE(I64__ge_u)
+    DISPATCH_BINARY(runGeOp<uint64_t>);
+  DISPATCH_CASE(F32__eq)
+    DISPATCH_BINARY(runEqOp<float>);
+  DISPATCH_CASE(F32__ne)
+    DISPATCH_BINARY(runNeOp<float>);
+  DISPATCH_CASE(F32__lt)
+    DISPATCH_BINARY(runLtOp<float>);
+  DISPATCH_CASE(F32__gt)
+    DISPATCH_BINARY(runGtOp<float>);
+  DISPATCH_CASE(F32__le)
+    DISPATCH_BINARY(runLeOp<float>);
+  DISPATCH_CASE(F32__ge)
+    DISPATCH_BINARY(runGeOp<float>);
+  DISPATCH_CASE(F64__eq)
+    DISPATCH_BINARY(runEqOp<double>);
+  DISPATCH_CASE(F64__ne)
+    DISPATCH_BINARY(runNeOp<double>);
+  DISPATCH_CASE(F64__lt)
+    DISPATCH_BINARY(runLtOp<double>);
+  DISPATCH_CASE(F64__gt)
+    DISPATCH_BINARY(runGtOp<double>);
+  DISPATCH_CASE(F64__le)
+    DISPATCH_BINARY(runLeOp<double>);
+  DISPATCH_CASE(F64__ge)
+    DISPATCH_BINARY(runGeOp<double>);
+  DISPATCH_CASE(I32__add)
+    DISPATCH_BINARY(runAddOp<uint32_t>);
+  DISPATCH_CASE(I32__sub)
+    DISPATCH_BINARY(runSubOp<uint32_t>);
+  DISPATCH_CASE(I32__mul)
+    DISPATCH_BINARY(runMulOp<uint32_t>);
+  DISPATCH_CASE(I32__div_s)
+    DISPATCH_BINARY_TRAP(runDivOp<int32_t>);
+  DISPATCH_CASE(I32__div_u)
+    DISPATCH_BINARY_TRAP(runDivOp<uint32_t>);
+  DISPATCH_CASE(I32__rem_s)
+    DISPATCH_BINARY_TRAP(runRemOp<int32_t>);
+  DISPATCH_CASE(I32__rem_u)
+    DISPATCH_BINARY_TRAP(runRemOp<uint32_t>);
+  DISPATCH_CASE(I32__and)
+    DISPATCH_BINARY(runAndOp<uint32_t>);
+  DISPATCH_CASE(I32__or)
+    DISPATCH_BINARY(runOrOp<uint32_t>);
+  DISPATCH_CASE(I32__xor)
+    DISPATCH_BINARY(runXorOp<uint32_t>);
+  DISPATCH_CASE(I32__shl)
+    DISPATCH_BINARY(runShlOp<uint32_t>);
+  DISPATCH_CASE(I32__shr_s)
+    DISPATCH_BINARY(runShrOp<int32_t>);
+  DISPATCH_CASE(I32__shr_u)
+    DISPATCH_BINARY(runShrOp<uint32_t>);
+  DISPATCH_CASE(I32__rotl)
+    DISPATCH_BINARY(runRotlOp<uint32_t>);
+  DISPATCH_CASE(I32__rotr)
+    DISPATCH_BINARY(runRotrOp<uint32_t>);
+  DISPATCH_CASE(I64__add)
+    DISPATCH_BINARY(runAddOp<uint64_t>);
+  DISPATCH_CASE(I64__sub)
+    DISPATCH_BINARY(runSubOp<uint64_t>);
+  DISPATCH_CASE(I64__mul)
+    DISPATCH_BINARY(runMulOp<uint64_t>);
+  DISPATCH_CASE(I64__div_s)
+    DISPATCH_BINARY_TRAP(runDivOp<int64_t>);
+  DISPATCH_CASE(I64__div_u)
+    DISPATCH_BINARY_TRAP(runDivOp<uint64_t>);
+  DISPATCH_CASE(I64__rem_s)
+    DISPATCH_BINARY_TRAP(runRemOp<int64_t>);
+  DISPATCH_CASE(I64__rem_u)
+    DISPATCH_BINARY_TRAP(runRemOp<uint64_t>);
+  DISPATCH_CASE(I64__and)
+    DISPATCH_BINARY(runAndOp<uint64_t>);
+  DISPATCH_CASE(I64__or)
+    DISPATCH_BINARY(runOrOp<uint64_t>);
+  DISPATCH_CASE(I64__xor)
+    DISPATCH_BINARY(runXorOp<uint64_t>);
+  DISPATCH_CASE(I64__shl)
+    DISPATCH_BINARY(runShlOp<uint64_t>);
+  DISPATCH_CASE(I64__shr_s)
+    DISPATCH_BINARY(runShrOp<int64_t>);
+  DISPATCH_CASE(I64__shr_u)
+    DISPATCH_BINARY(runShrOp<uint64_t>);
+  DISPATCH_CASE(I64__rotl)
+    DISPATCH_BINARY(runRotlOp<uint64_t>);
+  DISPATCH_CASE(I64__rotr)
+    DISPATCH_BINARY(runRotrOp<uint64_t>);
+  DISPATCH_CASE(F32__add)
+    DISPATCH_BINARY(runAddOp<float>);
+  DISPATCH_CASE(F32__sub)
+    DISPATCH_BINARY(runSubOp<float>);
+  DISPATCH_CASE(F32__mul)
+    DISPATCH_BINARY(runMulOp<float>);
+  DISPATCH_CASE(F32__div)
+    DISPATCH_BINARY(runDivOp<float>);
+  DISPATCH_CASE(F32__min)
+    DISPATCH_BINARY(runMinOp<float>);
+  DISPATCH_CASE(F32__max)
+    DISPATCH_BINARY(runMaxOp<float>);
+  DISPATCH_CASE(F32__copysign)
+    DISPATCH_BINARY(runCopysignOp<float>);
+  DISPATCH_CASE(F64__add)
+    DISPATCH_BINARY(runAddOp<double>);
+  DISPATCH_CASE(F64__sub)
+    DISPATCH_BINARY(runSubOp<double>);
+  DISPATCH_CASE(F64__mul)
+    DISPATCH_BINARY(runMulOp<double>);
+  DISPATCH_CASE(F64__div)
+    DISPATCH_BINARY(runDivOp<double>);
+  DISPATCH_CASE(F64__min)
+    DISPATCH_BINARY(runMinOp<double>);
+  DISPATCH_CASE(F64__max)
+    DISPATCH_BINARY(runMaxOp<double>);
+  DISPATCH_CASE(F64__copysign)
+    DISPATCH_BINARY(runCopysignOp<double>);
+
+  /// Instructions folded away in translation.
+  DISPATCH_CASE(Block)
+  DISPATCH_CASE(Loop)
+  DISPATCH_CASE(Drop)
+  DISPATCH_CASE(Local__get)
+  DISPATCH_CASE(Local__set)
+  DISPATCH_CASE(Local__tee)
+#ifdef SSVM_THREADED_DISPATCH
+  DISPATCH_LABEL(Unknown) :
+#else
+  default:
+#endif
+    return Unexpect(ErrCode::ExecutionFailed);
+#ifndef SSVM_THREADED_DISPATCH
   }
-  /// Run out the expressions.
-  return {};
+#endif
+
+Trap:
+  return Unexpect(TrapCode);
 }
 
-Expect<void> Interpreter::enterBlock(const uint32_t Arity,
-                                     const AST::BlockControlInstruction *Instr,
-                                     const AST::InstrVec &Seq) {
-  /// Create label for block and push.
-  StackMgr.pushLabel(Arity, Instr);
+#undef DISPATCH_TAIL_CALL
+#undef DISPATCH_CALL
+#undef DISPATCH_STORE
+#undef DISPATCH_LOAD
+#undef DISPATCH_BINARY_TRAP
+#undef DISPATCH_BINARY
+#undef DISPATCH_UNARY_TRAP
+#undef DISPATCH_UNARY
+#undef DISPATCH_POST_CHARGE
+#undef DISPATCH_RUN
+#undef DISPATCH_TRAP
+#undef DISPATCH_NEXT
+#undef DISPATCH_TIER_CASE
+#undef DISPATCH_REG_CASE
+#undef DISPATCH_SUPER_CASE
+#undef DISPATCH_CASE
+#undef DISPATCH_BULK_CHARGE
+#undef DISPATCH_CHARGE
+#undef DISPATCH_FETCH
 
-  /// Jump to block body.
-  InstrPdr.pushInstrs(InstrProvider::SeqType::Block, Seq);
-  return {};
+Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr) {
+  if (TopCaching) {
+    switch (Mode) {
+    case MeasureMode::Count:
+      return execute<CountPolicy, true>(StoreMgr);
+    case MeasureMode::Metered:
+      return execute<MeteredPolicy, true>(StoreMgr);
+    default:
+      return execute<BarePolicy, true>(StoreMgr);
+    }
+  }
+  switch (Mode) {
+  case MeasureMode::Count:
+    return execute<CountPolicy, false>(StoreMgr);
+  case MeasureMode::Metered:
+    return execute<MeteredPolicy, false>(StoreMgr);
+  default:
+    return execute<BarePolicy, false>(StoreMgr);
+  }
 }
 
-Expect<void> Interpreter::leaveBlock() {
-  /// Pop label entry and the corresponding instruction sequence.
-  StackMgr.popLabel();
-  return InstrPdr.popInstrs();
+Expect<void> Interpreter::executeRegister(Runtime::StoreManager &StoreMgr) {
+  switch (Mode) {
+  case MeasureMode::Count:
+    return executeRegister<CountPolicy>(StoreMgr);
+  case MeasureMode::Metered:
+    return executeRegister<MeteredPolicy>(StoreMgr);
+  default:
+    return executeRegister<BarePolicy>(StoreMgr);
+  }
 }
 
 Expect<void>
@@ -614,10 +2010,13 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     /// Host function case: Push args and call function.
     auto &HostFunc = Func.getHostFunc();
     /// FIXME: If current frame is dummy frame, find memory instance from host
-    /// module, and then use nullptr if host module has no memory instance.
-    auto *MemoryInst = getMemInstByIdx(StoreMgr, 0);
+    /// module. Use nullptr if the module has no memory instance.
+    const auto *ModInst = StackMgr.getModule();
+    auto *MemoryInst = (ModInst != nullptr && ModInst->getMemNum() > 0)
+                           ? ModInst->getMemory(0)
+                           : nullptr;
 
-    if (Measure) {
+    if (Mode == MeasureMode::Metered) {
       /// Check host function cost.
       if (!Measure->addCost(HostFunc.getCost())) {
         return Unexpect(ErrCode::CostLimitExceeded);
@@ -627,11 +2026,17 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
       Measure->getTimeRecorder().startRecord(TIMER_TAG_HOSTFUNC);
     }
 
+    /// The results replacing the args may need more room.
+    if (FuncType.Returns.size() > FuncType.Params.size() &&
+        !StackMgr.hasRoom(FuncType.Returns.size() - FuncType.Params.size())) {
+      return Unexpect(ErrCode::StackOverflow);
+    }
+
     /// Run host function.
     /// FIXME: Pass memory instance pointer instead of reference and nullable.
     ErrCode Status = HostFunc.run(StackMgr, *MemoryInst);
 
-    if (Measure) {
+    if (Mode == MeasureMode::Metered) {
       /// Stop recording time of running host function.
       Measure->getTimeRecorder().stopRecord(TIMER_TAG_HOSTFUNC);
       Measure->getTimeRecorder().startRecord(TIMER_TAG_EXECUTION);
@@ -643,83 +2048,260 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     }
     return {};
   } else {
+    if (Tiered) {
+      return enterTieredFunction(StoreMgr, Func);
+    }
     /// Native function case: Push frame with locals and args.
-    StackMgr.pushFrame(Func.getModuleAddr(),   /// Module address
-                       FuncType.Params.size(), /// Arity
-                       FuncType.Returns.size() /// Coarity
-    );
-
-    /// Push local variables to stack.
-    for (auto &Def : Func.getLocals()) {
-      for (uint32_t i = 0; i < Def.first; i++) {
-        StackMgr.push(ValueFromType(Def.second));
-      }
+    if (!StackMgr.hasRoom(Func.getFrameSize())) {
+      return Unexpect(ErrCode::StackOverflow);
+    }
+    enterNativeFunction(StoreMgr, Func);
+    return {};
+  }
+}
+
+void Interpreter::enterNativeFunction(
+    Runtime::StoreManager &StoreMgr,
+    const Runtime::Instance::FunctionInstance &Func) {
+  /// Push frame on the args with the zero-filled locals. The zero values of
+  /// all value types are all zero bits.
+  const auto &FuncType = Func.getFuncType();
+  const auto *ModInst = StoreMgr.getModuleUnsafe(Func.getModuleAddr());
+  StackMgr.pushFrame(ModInst,                 /// Module instance
+                     FuncType.Params.size(),  /// Arity
+                     FuncType.Returns.size(), /// Coarity
+                     Func.getLocalNum()       /// Locals
+  );
+
+  /// Push function body to instruction provider.
+  InstrPdr.pushInstrs(InstrProvider::SeqType::FunctionCall, Func.getByteCode());
+}
+
+Expect<void> Interpreter::enterTieredFunction(
+    Runtime::StoreManager &StoreMgr,
+    const Runtime::Instance::FunctionInstance &Func, const bool IsTail) {
+  /// Count the call, and promote the function when it becomes hot.
+  if (!Func.isPromoted() && Func.addHotness(1) >= HotThreshold) {
+    if (auto Res = promoteFunction(StoreMgr, Func); !Res) {
+      return Unexpect(Res);
     }
+  }
+  if (!Func.isPromoted()) {
+    if (!StackMgr.hasRoom(Func.getFrameSize())) {
+      return Unexpect(ErrCode::StackOverflow);
+    }
+    enterNativeFunction(StoreMgr, Func);
+    return {};
+  }
 
-    /// Push function body to instruction provider.
-    InstrPdr.pushInstrs(InstrProvider::SeqType::FunctionCall);
+  /// Run the promoted function until it returns, and leave the results on the
+  /// top of stack. The functions called in it are all promoted.
+  const auto &FuncType = Func.getFuncType();
+  const uint32_t Offset = StackMgr.size() - FuncType.Params.size();
+  if (auto Res = enterRegFunction(StoreMgr, Func, Offset); !Res) {
+    return Unexpect(Res);
+  }
+  if (IsTail) {
+    /// The tail called function is run by the runtime after the stack-based
+    /// dispatcher returns, instead of nesting the register-based one.
+    TailRegEntered = true;
+    TailRegEnd = Offset + FuncType.Returns.size();
+    return {};
+  }
+  if (auto Res = executeRegister(StoreMgr); !Res) {
+    return Unexpect(Res);
+  }
+  StackMgr.resize(Offset + FuncType.Returns.size());
+  return {};
+}
+
+Expect<void> Interpreter::runPromotedLoop(
+    Runtime::StoreManager &StoreMgr,
+    const Runtime::Instance::FunctionInstance &Func, const uint32_t Loop) {
+  const uint32_t Start = Func.getLoopStart(Loop);
+  const uint32_t Offset = StackMgr.getOffset(0);
+  const uint32_t SlotEnd = Offset + Func.getSlotNum();
+  if (!StackMgr.hasRoom(SlotEnd > StackMgr.size() ? SlotEnd - StackMgr.size()
+                                                   : 0)) {
+    return Unexpect(ErrCode::StackOverflow);
+  }
+
+  /// The locals and the values of the outer blocks are in the same positions
+  /// of frame in both byte codes, so the frame is replaced in place.
+  const auto &FuncType = Func.getFuncType();
+  StackMgr.popRegFrame();
+  if (auto Res = InstrPdr.popInstrs(); !Res) {
+    return Unexpect(Res);
+  }
+  StackMgr.pushRegFrame(StoreMgr.getModuleUnsafe(Func.getModuleAddr()), Offset,
+                        FuncType.Returns.size(), Func.getSlotNum());
+  InstrPdr.pushInstrs(InstrProvider::SeqType::FunctionCall, Func.getRegCode());
+  InstrPdr.jump(Func.getRegCode().Instrs.data() + Start);
+  if (auto Res = executeRegister(StoreMgr); !Res) {
+    return Unexpect(Res);
+  }
+  StackMgr.resize(Offset + FuncType.Returns.size());
+  return {};
+}
 
-    /// Enter function block.
-    return enterBlock(FuncType.Returns.size(), nullptr, Func.getInstrs());
+Expect<void> Interpreter::promoteFunction(
+    Runtime::StoreManager &StoreMgr,
+    const Runtime::Instance::FunctionInstance &Func) {
+  while (!Func.isPromoted()) {
+    if (!Func.takePromotion()) {
+      /// Other thread is translating the function.
+      Func.waitPromotion();
+      continue;
+    }
+    /// Collect the function types for the call instructions.
+    const auto &ModInst = *StoreMgr.getModuleUnsafe(Func.getModuleAddr());
+    std::vector<const Runtime::Instance::FType *> FuncTypes;
+    FuncTypes.reserve(ModInst.getFuncNum());
+    for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+      const auto *FuncInst = *StoreMgr.getFunction(*ModInst.getFuncAddr(I));
+      FuncTypes.push_back(&FuncInst->getFuncType());
+    }
+    RegisterTranslator RegTrans(ModInst, FuncTypes);
+    if (auto Res = RegTrans.translate(Func)) {
+      Func.setPromotedCode(std::move(*Res), RegTrans.getSlotNum(),
+                           RegTrans.getLoopStarts());
+    } else {
+      Func.cancelPromotion();
+      return Unexpect(Res);
+    }
   }
+  return {};
 }
 
 Expect<void> Interpreter::leaveFunction() {
-  /// Pop the frame entry from the Stack.
-  const uint32_t LabelPoped = StackMgr.popFrame();
-  for (uint32_t I = 0; I < LabelPoped; ++I) {
-    InstrPdr.popInstrs();
+  /// Pop the frame entry from the Stack and the function body.
+  StackMgr.popFrame();
+  return InstrPdr.popInstrs();
+}
+
+Expect<void> Interpreter::enterTailFunction(
+    Runtime::StoreManager &StoreMgr,
+    const Runtime::Instance::FunctionInstance &Func) {
+  if (Func.isHostFunction()) {
+    /// Host function case: Run on the args, and return with the results.
+    if (auto Res = enterFunction(StoreMgr, Func); !Res) {
+      return Unexpect(Res);
+    }
+    return leaveFunction();
+  }
+
+  /// Native function case: Replace the frame and the function body with the
+  /// callee's ones, so that the frame stack is not grown.
+  StackMgr.popTailFrame(Func.getFuncType().Params.size());
+  if (auto Res = InstrPdr.popInstrs(); !Res) {
+    return Unexpect(Res);
+  }
+  if (Tiered) {
+    return enterTieredFunction(StoreMgr, Func, true);
+  }
+  return enterFunction(StoreMgr, Func);
+}
+
+Expect<void>
+Interpreter::enterRegFunction(Runtime::StoreManager &StoreMgr,
+                              const Runtime::Instance::FunctionInstance &Func,
+                              const uint32_t Offset) {
+  const auto &FuncType = Func.getFuncType();
+
+  if (Func.isHostFunction()) {
+    /// Host function case: Run with the args on the top of stack, and keep the
+    /// results at the offset.
+    const uint32_t Size = StackMgr.size();
+    StackMgr.resize(Offset + FuncType.Params.size());
+    if (auto Res = enterFunction(StoreMgr, Func); !Res) {
+      return Unexpect(Res);
+    }
+    StackMgr.resize(Size);
+    return {};
+  }
+
+  /// Native function case: Push frame on the args, and initialize the locals.
+  /// The functions called in register-based byte code are promoted first in
+  /// tiered execution.
+  if (Tiered && !Func.isPromoted()) {
+    if (auto Res = promoteFunction(StoreMgr, Func); !Res) {
+      return Unexpect(Res);
+    }
+  }
+  const uint32_t SlotEnd = Offset + Func.getSlotNum();
+  if (!StackMgr.hasRoom(SlotEnd > StackMgr.size() ? SlotEnd - StackMgr.size()
+                                                   : 0)) {
+    return Unexpect(ErrCode::StackOverflow);
   }
-  InstrPdr.popInstrs();
+  StackMgr.pushRegFrame(StoreMgr.getModuleUnsafe(Func.getModuleAddr()), Offset,
+                        FuncType.Returns.size(), Func.getSlotNum());
+  ValVariant *Slots = StackMgr.getRegSlots();
+  std::memset(Slots + FuncType.Params.size(), 0,
+              Func.getLocalNum() * sizeof(ValVariant));
+
+  /// Push register-based function body to instruction provider.
+  InstrPdr.pushInstrs(InstrProvider::SeqType::FunctionCall, Func.getRegCode());
   return {};
 }
 
-Expect<void> Interpreter::branchToLabel(const uint32_t Cnt) {
-  /// Get the L-th label from top of stack and the continuation instruction.
-  auto &L = StackMgr.getLabelWithCount(Cnt);
-  const AST::BlockControlInstruction *ContInstr = L.Target;
+Expect<void> Interpreter::leaveRegFunction(const uint32_t Arity) {
+  /// Leave only the results on stack when returning to the caller of runtime.
+  if (InstrPdr.getScopeSize() == 1) {
+    StackMgr.resize(StackMgr.getOffset(0) + Arity);
+  }
+  StackMgr.popRegFrame();
+  return InstrPdr.popInstrs();
+}
 
-  /// Pop L + 1 labels.
-  StackMgr.popLabel(Cnt + 1);
+Expect<void> Interpreter::enterRegTailFunction(
+    Runtime::StoreManager &StoreMgr,
+    const Runtime::Instance::FunctionInstance &Func, const uint32_t Idx) {
+  const auto &FuncType = Func.getFuncType();
+  ValVariant *Slots = StackMgr.getRegSlots();
 
-  /// Repeat LabelIndex + 1 times
-  for (uint32_t I = 0; I < Cnt + 1; I++) {
-    /// Pop the corresponding instruction sequence.
-    InstrPdr.popInstrs();
+  if (Func.isHostFunction()) {
+    /// Host function case: Run on the args, and return with the results.
+    if (auto Res = enterRegFunction(StoreMgr, Func, StackMgr.getOffset(Idx));
+        !Res) {
+      return Unexpect(Res);
+    }
+    std::copy_n(Slots + Idx, FuncType.Returns.size(), Slots);
+    return leaveRegFunction(FuncType.Returns.size());
   }
 
-  /// Jump to the continuation of Label
-  if (ContInstr != nullptr) {
-    return runLoopOp(*ContInstr);
+  /// Native function case: Move the args to the beginning of frame, and
+  /// replace the frame and the function body with the callee's ones.
+  const uint32_t Offset = StackMgr.getOffset(0);
+  std::copy_n(Slots + Idx, FuncType.Params.size(), Slots);
+  StackMgr.popRegFrame();
+  if (auto Res = InstrPdr.popInstrs(); !Res) {
+    return Unexpect(Res);
   }
+  return enterRegFunction(StoreMgr, Func, Offset);
+}
+
+Expect<void> Interpreter::branchToLabel(const uint32_t EraseCnt,
+                                        const uint32_t Arity,
+                                        const Runtime::ByteCode *Target) {
+  /// Erase the values under the results, and jump to the continuation.
+  StackMgr.stackErase(EraseCnt, Arity);
+  InstrPdr.jump(Target);
   return {};
 }
 
 Runtime::Instance::TableInstance *
-Interpreter::getTabInstByIdx(Runtime::StoreManager &StoreMgr,
-                             const uint32_t Idx) {
-  /// FIXME: Return nullptr when top frame is dummy frame.
-  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-  const uint32_t TabAddr = *ModInst->getTableAddr(Idx);
-  return *StoreMgr.getTable(TabAddr);
+Interpreter::getTabInstByIdx(const uint32_t Idx) {
+  return StackMgr.getModule()->getTable(Idx);
 }
 
 Runtime::Instance::MemoryInstance *
-Interpreter::getMemInstByIdx(Runtime::StoreManager &StoreMgr,
-                             const uint32_t Idx) {
-  /// FIXME: Return nullptr when top frame is dummy frame.
-  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-  const uint32_t MemAddr = *ModInst->getMemAddr(Idx);
-  return *StoreMgr.getMemory(MemAddr);
+Interpreter::getMemInstByIdx(const uint32_t Idx) {
+  return StackMgr.getModule()->getMemory(Idx);
 }
 
 Runtime::Instance::GlobalInstance *
-Interpreter::getGlobInstByIdx(Runtime::StoreManager &StoreMgr,
-                              const uint32_t Idx) {
-  /// FIXME: Return nullptr when top frame is dummy frame.
-  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-  const uint32_t GlobAddr = *ModInst->getGlobalAddr(Idx);
-  return *StoreMgr.getGlobal(GlobAddr);
+Interpreter::getGlobInstByIdx(const uint32_t Idx) {
+  return StackMgr.getModule()->getGlobal(Idx);
 }
 
 } // namespace Interpreter
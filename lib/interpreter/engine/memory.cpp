@@ -13,9 +13,10 @@ Interpreter::runMemorySizeOp(Runtime::Instance::MemoryInstance &MemInst) {
 }
 
 Expect<void>
-Interpreter::runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst) {
-  /// Pop N for growing page size.
-  uint32_t &N = retrieveValue<uint32_t>(StackMgr.getTop());
+Interpreter::runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst,
+                             ValVariant &Val) {
+  /// Get N for growing page size.
+  uint32_t &N = retrieveValue<uint32_t>(Val);
 
   /// Grow page and push result.
   const uint32_t CurrPageSize = MemInst.getDataPageSize();
@@ -27,5 +28,52 @@ Interpreter::runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst) {
   return {};
 }
 
+Expect<void> Interpreter::runMemoryInitOp(
+    Runtime::Instance::MemoryInstance &MemInst,
+    const Runtime::Instance::ModuleInstance::DataSegment &Seg,
+    const ValVariant &Dst, const ValVariant &Src, const ValVariant &Len) {
+  const uint32_t D = retrieveValue<uint32_t>(Dst);
+  const uint32_t S = retrieveValue<uint32_t>(Src);
+  const uint32_t N = retrieveValue<uint32_t>(Len);
+
+  /// Check the source range in data segment.
+  if (static_cast<uint64_t>(S) + N > Seg.getSize()) {
+    return Unexpect(ErrCode::AccessForbidMemory);
+  }
+  if (N == 0) {
+    /// Still check the destination boundary.
+    if (!MemInst.checkAccessBound(D)) {
+      return Unexpect(ErrCode::MemorySizeExceeded);
+    }
+    return {};
+  }
+  return MemInst.setBytes(Seg.Data, D, S, N);
+}
+
+void Interpreter::runDataDropOp(
+    Runtime::Instance::ModuleInstance::DataSegment &Seg) {
+  /// Mark the data segment dropped. The bytes are not released, for they may
+  /// be read by the other threads.
+  Seg.drop();
+}
+
+Expect<void>
+Interpreter::runMemoryCopyOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const ValVariant &Dst, const ValVariant &Src,
+                             const ValVariant &Len) {
+  return MemInst.copyBytes(retrieveValue<uint32_t>(Dst),
+                           retrieveValue<uint32_t>(Src),
+                           retrieveValue<uint32_t>(Len));
+}
+
+Expect<void>
+Interpreter::runMemoryFillOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const ValVariant &Dst, const ValVariant &Val,
+                             const ValVariant &Len) {
+  return MemInst.fillBytes(retrieveValue<uint32_t>(Dst),
+                           static_cast<uint8_t>(retrieveValue<uint32_t>(Val)),
+                           retrieveValue<uint32_t>(Len));
+}
+
 } // namespace Interpreter
 } // namespace SSVM
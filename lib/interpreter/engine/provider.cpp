@@ -5,7 +5,7 @@ namespace SSVM {
 namespace Interpreter {
 
 /// Getter for next instruction. See "include/interpreter/engine/provider.h".
-const AST::Instruction *InstrProvider::getNextInstr() {
+const Runtime::ByteCode *InstrProvider::getNextInstr() {
   /// Instruction sequence vector is empty.
   if (Iters.size() == 0) {
     return nullptr;
@@ -17,9 +17,22 @@ const AST::Instruction *InstrProvider::getNextInstr() {
   }
 
   /// Get instruction.
-  const AST::Instruction *Instr = (*Iters.back().Curr).get();
-  (Iters.back().Curr)++;
-  return Instr;
+  return Iters.back().Curr++;
+}
+
+/// Getter of gas metering. See "include/interpreter/engine/provider.h".
+const Runtime::ByteCodeMeter *
+InstrProvider::getMeter(const Runtime::ByteCode *Instr) const {
+  for (auto It = Iters.rbegin(); It != Iters.rend(); ++It) {
+    if (Instr >= It->Begin && Instr < It->End) {
+      /// The register-based byte code is charged by instructions.
+      if (It->Code->Meters.empty()) {
+        return nullptr;
+      }
+      return It->Code->Meters.data() + (Instr - It->Begin);
+    }
+  }
+  return nullptr;
 }
 
 /// Pop last instruction sequence and jump back. See
@@ -0,0 +1,651 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "interpreter/engine/regtranslator.h"
+
+#include <algorithm>
+
+namespace SSVM {
+namespace Interpreter {
+
+using OpCode = AST::Instruction::OpCode;
+
+namespace {
+
+/// Instructions which may trap or write memory. The folded `local.set` after
+/// them should be charged after running.
+bool isPostCharged(const OpCode Code) {
+  switch (Code) {
+  case OpCode::I32__load:
+  case OpCode::I64__load:
+  case OpCode::F32__load:
+  case OpCode::F64__load:
+  case OpCode::I32__load8_s:
+  case OpCode::I32__load8_u:
+  case OpCode::I32__load16_s:
+  case OpCode::I32__load16_u:
+  case OpCode::I64__load8_s:
+  case OpCode::I64__load8_u:
+  case OpCode::I64__load16_s:
+  case OpCode::I64__load16_u:
+  case OpCode::I64__load32_s:
+  case OpCode::I64__load32_u:
+  case OpCode::Memory__grow:
+  case OpCode::I32__div_s:
+  case OpCode::I32__div_u:
+  case OpCode::I32__rem_s:
+  case OpCode::I32__rem_u:
+  case OpCode::I64__div_s:
+  case OpCode::I64__div_u:
+  case OpCode::I64__rem_s:
+  case OpCode::I64__rem_u:
+  case OpCode::I32__trunc_f32_s:
+  case OpCode::I32__trunc_f32_u:
+  case OpCode::I32__trunc_f64_s:
+  case OpCode::I32__trunc_f64_u:
+  case OpCode::I64__trunc_f32_s:
+  case OpCode::I64__trunc_f32_u:
+  case OpCode::I64__trunc_f64_s:
+  case OpCode::I64__trunc_f64_u:
+    return true;
+  default:
+    return false;
+  }
+}
+
+} // namespace
+
+/// Translate function body. See "include/interpreter/engine/regtranslator.h".
+Expect<Runtime::ByteCodeSeq> RegisterTranslator::translate(
+    const Runtime::Instance::FunctionInstance &Func) {
+  const auto &FuncType = Func.getFuncType();
+  Code.clear();
+  ChargeLists.clear();
+  V128.clear();
+  Labels.clear();
+  Operands.clear();
+  Charges.clear();
+  LoopStarts.clear();
+  LocalNum = FuncType.Params.size();
+  for (auto &Def : Func.getLocals()) {
+    LocalNum += Def.first;
+  }
+  MaxHeight = 0;
+  HasLastResult = false;
+  IsDead = false;
+
+  /// The function body is the outermost label.
+  Labels.push_back({false, 0, 0, static_cast<uint32_t>(FuncType.Returns.size()),
+                    {}});
+  if (auto Res = translateInstrs(Func.getInstrs()); !Res) {
+    return Unexpect(Res);
+  }
+  leaveLabel();
+
+  /// Return the results in the stack position slots.
+  const uint32_t Pos = emit(OpCode::Return);
+  Code[Pos].Arity = FuncType.Returns.size();
+  Code[Pos].Src1 = LocalNum;
+  Runtime::ByteCodeSeq Seq;
+  Seq.Instrs = std::move(Code);
+  Seq.Charges = std::move(ChargeLists);
+  Seq.V128 = std::move(V128);
+  return Seq;
+}
+
+Expect<void> RegisterTranslator::translateInstrs(const AST::InstrVec &Instrs) {
+  for (uint32_t I = 0; I < Instrs.size(); ++I) {
+    if (IsDead) {
+      /// Skip the unreachable instructions.
+      skipInstrs(Instrs, I);
+      break;
+    }
+    auto &Instr = Instrs[I];
+    auto Res = dispatchInstruction(
+        Instr->getOpCode(), [this, &Instr](auto &&Arg) -> Expect<void> {
+          if constexpr (std::is_void_v<
+                            typename std::decay_t<decltype(Arg)>::type>) {
+            /// If the Code not matched, return null pointer.
+            return Unexpect(ErrCode::Unimplemented);
+          } else {
+            /// Translate the instruction node according to Code.
+            return translate(
+                *static_cast<const typename std::decay_t<decltype(Arg)>::type
+                                 *>(Instr.get()));
+          }
+        });
+    if (!Res) {
+      return Unexpect(Res);
+    }
+  }
+  return {};
+}
+
+void RegisterTranslator::skipInstrs(const AST::InstrVec &Instrs,
+                                    const uint32_t Begin) {
+  /// The unreachable loops are still counted, so that the order of loops
+  /// agrees with the stack-based byte code.
+  for (uint32_t I = Begin; I < Instrs.size(); ++I) {
+    const auto &Instr = *Instrs[I];
+    switch (Instr.getOpCode()) {
+    case OpCode::Block:
+    case OpCode::Loop:
+      if (Instr.getOpCode() == OpCode::Loop) {
+        LoopStarts.push_back(NoLoopStart);
+      }
+      skipInstrs(
+          static_cast<const AST::BlockControlInstruction &>(Instr).getBody());
+      break;
+    case OpCode::If: {
+      const auto &IfElse =
+          static_cast<const AST::IfElseControlInstruction &>(Instr);
+      skipInstrs(IfElse.getIfStatement());
+      skipInstrs(IfElse.getElseStatement());
+      break;
+    }
+    default:
+      break;
+    }
+  }
+}
+
+uint32_t RegisterTranslator::emit(const OpCode Code) {
+  /// Split the exceeded charges into `nop`s. Leave a charge room for the
+  /// redirected `local.set`.
+  uint32_t Begin = 0;
+  while (Charges.size() - Begin > Runtime::ByteCode::MaxCharge - 1) {
+    auto &Nop = this->Code.emplace_back(OpCode::Nop);
+    std::copy_n(Charges.begin() + Begin, Runtime::ByteCode::MaxCharge - 1,
+                ChargeLists.emplace_back().begin());
+    Nop.PreCharge = Runtime::ByteCode::MaxCharge - 1;
+    Begin += Runtime::ByteCode::MaxCharge - 1;
+  }
+  auto &Instr = this->Code.emplace_back(Code);
+  std::copy(Charges.begin() + Begin, Charges.end(),
+            ChargeLists.emplace_back().begin());
+  Instr.PreCharge = Charges.size() - Begin;
+  Charges.clear();
+  HasLastResult = false;
+  return this->Code.size() - 1;
+}
+
+uint32_t RegisterTranslator::emitBranch(const OpCode Code,
+                                        const uint32_t LabelIdx) {
+  const uint32_t Pos = emit(Code);
+  auto &Label = Labels[Labels.size() - LabelIdx - 1];
+  /// Branch to loop has no results in MVP.
+  const uint32_t Arity = Label.IsLoop ? 0 : Label.Arity;
+  this->Code[Pos].Arity = Arity;
+  this->Code[Pos].Dst = LocalNum + Label.Height;
+  if (Arity > 0) {
+    this->Code[Pos].Src1 = Operands[Operands.size() - Arity];
+  }
+  if (Label.IsLoop) {
+    /// Backward branch to the beginning of loop body.
+    this->Code[Pos].JumpEnd =
+        static_cast<int32_t>(Label.Start) - static_cast<int32_t>(Pos);
+  } else {
+    /// Forward branch. Resolve the offset when leaving the label.
+    Label.Pending.push_back(Pos);
+  }
+  return Pos;
+}
+
+void RegisterTranslator::flushCharge() {
+  if (!Charges.empty()) {
+    emit(OpCode::Nop);
+  }
+}
+
+void RegisterTranslator::storeLocal(const OpCode Code, const uint32_t Idx) {
+  Charges.push_back(Code);
+  const uint32_t Val = Operands.back();
+  const bool IsRead = std::find(Operands.begin(), Operands.end() - 1, Idx) !=
+                      Operands.end() - 1;
+  if (HasLastResult && !IsRead && Charges.size() == 1 &&
+      Val == LocalNum + Operands.size() - 1 &&
+      this->Code[LastResult].Dst == Val &&
+      this->Code[LastResult].PreCharge + this->Code[LastResult].PostCharge <
+          Runtime::ByteCode::MaxCharge) {
+    /// Redirect the result of the previous instruction to the local.
+    auto &Last = this->Code[LastResult];
+    auto &LastCharges = ChargeLists[LastResult];
+    if (isPostCharged(Last.Code)) {
+      LastCharges[Last.PreCharge + Last.PostCharge++] = Code;
+    } else {
+      LastCharges[Last.PreCharge++] = Code;
+    }
+    Last.Dst = Idx;
+    Charges.clear();
+    HasLastResult = false;
+    if (Code == OpCode::Local__tee) {
+      Operands.back() = Idx;
+    } else {
+      Operands.pop_back();
+    }
+    return;
+  }
+
+  /// Keep the old value for the operands referring to the local.
+  for (uint32_t I = 0; I < Operands.size() - 1; ++I) {
+    if (Operands[I] == Idx) {
+      materialize(I);
+    }
+  }
+  const uint32_t Pos = emit(Runtime::RegCode::Mov);
+  this->Code[Pos].Dst = Idx;
+  this->Code[Pos].Src1 = Val;
+  if (Code == OpCode::Local__set) {
+    Operands.pop_back();
+  }
+}
+
+uint32_t RegisterTranslator::pushOperand() {
+  Operands.push_back(LocalNum + Operands.size());
+  MaxHeight = std::max(MaxHeight, static_cast<uint32_t>(Operands.size()));
+  return Operands.back();
+}
+
+uint32_t RegisterTranslator::popOperand() {
+  const uint32_t Slot = Operands.back();
+  Operands.pop_back();
+  return Slot;
+}
+
+void RegisterTranslator::materialize(const uint32_t Pos) {
+  if (Operands[Pos] < LocalNum) {
+    const uint32_t MovPos = emit(Runtime::RegCode::Mov);
+    Code[MovPos].Dst = LocalNum + Pos;
+    Code[MovPos].Src1 = Operands[Pos];
+    Operands[Pos] = LocalNum + Pos;
+  }
+}
+
+void RegisterTranslator::materializeAll() {
+  for (uint32_t I = 0; I < Operands.size(); ++I) {
+    materialize(I);
+  }
+}
+
+void RegisterTranslator::enterLabel(const bool IsLoop, const ValType Type) {
+  Labels.push_back({IsLoop, static_cast<uint32_t>(Code.size()),
+                    static_cast<uint32_t>(Operands.size()),
+                    Type == ValType::None ? 0U : 1U,
+                    {}});
+  HasLastResult = false;
+}
+
+void RegisterTranslator::leaveLabel() {
+  auto &Label = Labels.back();
+  if (!IsDead) {
+    /// Results of the fall through should be in the stack position slots.
+    for (uint32_t I = 0; I < Label.Arity; ++I) {
+      materialize(Label.Height + I);
+    }
+    flushCharge();
+  }
+  const uint32_t EndPos = Code.size();
+  for (const uint32_t Pos : Label.Pending) {
+    Code[Pos].JumpEnd = EndPos - Pos;
+  }
+  Operands.resize(Label.Height);
+  for (uint32_t I = 0; I < Label.Arity; ++I) {
+    pushOperand();
+  }
+  Labels.pop_back();
+  HasLastResult = false;
+  IsDead = false;
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::ControlInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  switch (Instr.getOpCode()) {
+  case OpCode::Unreachable:
+    emit(OpCode::Unreachable);
+    IsDead = true;
+    break;
+  case OpCode::Return: {
+    const uint32_t Pos = emit(OpCode::Return);
+    const uint32_t Arity = Labels.front().Arity;
+    Code[Pos].Arity = Arity;
+    if (Arity > 0) {
+      Code[Pos].Src1 = Operands[Operands.size() - Arity];
+    }
+    IsDead = true;
+    break;
+  }
+  default:
+    /// Nop only adds its cost.
+    break;
+  }
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::BlockControlInstruction &Instr) {
+  /// Block: [Body...]
+  /// Loop:  [Body...]
+  Charges.push_back(Instr.getOpCode());
+  materializeAll();
+  if (Instr.getOpCode() == OpCode::Loop) {
+    /// The loop cost is added once before the body.
+    flushCharge();
+  }
+  enterLabel(Instr.getOpCode() == OpCode::Loop, Instr.getResultType());
+  if (Instr.getOpCode() == OpCode::Loop) {
+    LoopStarts.push_back(Code.size());
+  }
+  if (auto Res = translateInstrs(Instr.getBody()); !Res) {
+    return Unexpect(Res);
+  }
+  leaveLabel();
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::IfElseControlInstruction &Instr) {
+  /// If-else: [If] [IfStatement...] [Else] [ElseStatement...]
+  /// If:      [If] [IfStatement...]
+  Charges.push_back(Instr.getOpCode());
+  const uint32_t Cond = popOperand();
+  materializeAll();
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Src1 = Cond;
+  enterLabel(false, Instr.getResultType());
+  if (auto Res = translateInstrs(Instr.getIfStatement()); !Res) {
+    return Unexpect(Res);
+  }
+  uint32_t ElsePos = 0;
+  if (!Instr.getElseStatement().empty()) {
+    const auto &Label = Labels.back();
+    if (!IsDead) {
+      for (uint32_t I = 0; I < Label.Arity; ++I) {
+        materialize(Label.Height + I);
+      }
+      if (!Instr.getIfStatement().empty() && Code.size() == Pos + 1) {
+        /// Non-empty if-statement should not be taken as empty.
+        flushCharge();
+      }
+    }
+    ElsePos = emit(OpCode::Else);
+    Operands.resize(Label.Height);
+    IsDead = false;
+    if (auto Res = translateInstrs(Instr.getElseStatement()); !Res) {
+      return Unexpect(Res);
+    }
+  }
+  leaveLabel();
+  const uint32_t EndPos = Code.size();
+  if (ElsePos == 0) {
+    ElsePos = EndPos;
+  } else {
+    Code[ElsePos].JumpEnd = EndPos - ElsePos;
+  }
+  Code[Pos].JumpElse = ElsePos - Pos;
+  Code[Pos].JumpEnd = EndPos - Pos;
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::BrControlInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  if (Instr.getOpCode() == OpCode::Br) {
+    emitBranch(OpCode::Br, Instr.getLabelIndex());
+    IsDead = true;
+  } else {
+    const uint32_t Cond = popOperand();
+    const uint32_t Pos = emitBranch(OpCode::Br_if, Instr.getLabelIndex());
+    Code[Pos].Src2 = Cond;
+  }
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::BrTableControlInstruction &Instr) {
+  /// Br_table: [Br_table] [Label 0] ... [Label N-1] [Default label]
+  const auto &LabelTable = Instr.getLabelTable();
+  Charges.push_back(Instr.getOpCode());
+  const uint32_t Idx = popOperand();
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Index = LabelTable.size();
+  Code[Pos].Src1 = Idx;
+  for (uint32_t I = 0; I < LabelTable.size(); ++I) {
+    emitBranch(OpCode::Br, LabelTable[I]);
+  }
+  emitBranch(OpCode::Br, Instr.getLabelIndex());
+  IsDead = true;
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::CallControlInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  const Runtime::Instance::FType *Type = nullptr;
+  uint32_t Idx = 0;
+  if (!Instr.isIndirect()) {
+    Type = FuncTypes[Instr.getFuncIndex()];
+  } else {
+    Idx = popOperand();
+    if (auto Res = ModInst.getFuncType(Instr.getFuncIndex())) {
+      Type = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+  }
+
+  /// Arguments should be in the stack position slots, which are the locals of
+  /// the callee frame.
+  const uint32_t Base = Operands.size() - Type->Params.size();
+  for (uint32_t I = Base; I < Operands.size(); ++I) {
+    materialize(I);
+  }
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Index = Instr.getFuncIndex();
+  Code[Pos].Dst = LocalNum + Base;
+  Code[Pos].Src1 = Idx;
+  Operands.resize(Base);
+  for (uint32_t I = 0; I < Type->Returns.size(); ++I) {
+    pushOperand();
+  }
+  /// Tail call returns from the current function with the callee's results.
+  IsDead = Instr.isTailCall();
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::ParametricInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  if (Instr.getOpCode() == OpCode::Drop) {
+    popOperand();
+    return {};
+  }
+  const uint32_t Cond = popOperand();
+  const uint32_t Val2 = popOperand();
+  const uint32_t Val1 = popOperand();
+  const uint32_t Res = pushOperand();
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Dst = Res;
+  Code[Pos].Src1 = Val1;
+  Code[Pos].Src2 = Val2;
+  Code[Pos].Index = Cond;
+  LastResult = Pos;
+  HasLastResult = true;
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::VariableInstruction &Instr) {
+  const uint32_t Idx = Instr.getVariableIndex();
+  switch (Instr.getOpCode()) {
+  case OpCode::Local__get:
+    /// Refer to the local slot directly.
+    Charges.push_back(Instr.getOpCode());
+    Operands.push_back(Idx);
+    MaxHeight = std::max(MaxHeight, static_cast<uint32_t>(Operands.size()));
+    break;
+  case OpCode::Local__set:
+  case OpCode::Local__tee:
+    storeLocal(Instr.getOpCode(), Idx);
+    break;
+  case OpCode::Global__get: {
+    Charges.push_back(Instr.getOpCode());
+    const uint32_t Res = pushOperand();
+    const uint32_t Pos = emit(Instr.getOpCode());
+    Code[Pos].Dst = Res;
+    Code[Pos].Index = Idx;
+    LastResult = Pos;
+    HasLastResult = true;
+    break;
+  }
+  case OpCode::Global__set: {
+    Charges.push_back(Instr.getOpCode());
+    const uint32_t Val = popOperand();
+    const uint32_t Pos = emit(Instr.getOpCode());
+    Code[Pos].Src1 = Val;
+    Code[Pos].Index = Idx;
+    break;
+  }
+  default:
+    return Unexpect(ErrCode::InstructionTypeMismatch);
+  }
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::MemoryInstruction &Instr) {
+  const OpCode Code = Instr.getOpCode();
+  Charges.push_back(Code);
+  if (Code >= OpCode::I32__store && Code <= OpCode::I64__store32) {
+    const uint32_t Val = popOperand();
+    const uint32_t Addr = popOperand();
+    const uint32_t Pos = emit(Code);
+    this->Code[Pos].Src1 = Addr;
+    this->Code[Pos].Src2 = Val;
+    this->Code[Pos].Index = Instr.getMemoryOffset();
+    return {};
+  }
+  if (Code == OpCode::Data__drop) {
+    const uint32_t Pos = emit(Code);
+    this->Code[Pos].Index = Instr.getDataIndex();
+    return {};
+  }
+  if (Code == OpCode::Memory__init || Code == OpCode::Memory__copy ||
+      Code == OpCode::Memory__fill) {
+    /// The three operands should be in the consecutive stack position slots
+    /// starting from Src1.
+    const uint32_t Base = Operands.size() - 3;
+    for (uint32_t I = Base; I < Operands.size(); ++I) {
+      materialize(I);
+    }
+    const uint32_t Pos = emit(Code);
+    this->Code[Pos].Src1 = LocalNum + Base;
+    this->Code[Pos].Index = Instr.getDataIndex();
+    Operands.resize(Base);
+    return {};
+  }
+  uint32_t Val = 0;
+  if (Code != OpCode::Memory__size) {
+    Val = popOperand();
+  }
+  const uint32_t Res = pushOperand();
+  const uint32_t Pos = emit(Code);
+  this->Code[Pos].Dst = Res;
+  this->Code[Pos].Src1 = Val;
+  this->Code[Pos].Index = Instr.getMemoryOffset();
+  LastResult = Pos;
+  HasLastResult = true;
+  return {};
+}
+
+Expect<void> RegisterTranslator::translate(const AST::ConstInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  const uint32_t Res = pushOperand();
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Dst = Res;
+  Code[Pos].setNum(Instr.getConstValue());
+  LastResult = Pos;
+  HasLastResult = true;
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::UnaryNumericInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  const uint32_t Val = popOperand();
+  const uint32_t Res = pushOperand();
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Dst = Res;
+  Code[Pos].Src1 = Val;
+  LastResult = Pos;
+  HasLastResult = true;
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::BinaryNumericInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  const uint32_t Val2 = popOperand();
+  const uint32_t Val1 = popOperand();
+  const uint32_t Res = pushOperand();
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Dst = Res;
+  Code[Pos].Src1 = Val1;
+  Code[Pos].Src2 = Val2;
+  LastResult = Pos;
+  HasLastResult = true;
+  return {};
+}
+
+Expect<void> RegisterTranslator::translate(const AST::SIMDInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  /// The operands should be in the consecutive stack position slots starting
+  /// from Src1, and the result is stored to the first one.
+  const uint32_t Base = Operands.size() - Instr.getOperandNum();
+  for (uint32_t I = Base; I < Operands.size(); ++I) {
+    materialize(I);
+  }
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].SubCode = Instr.getSIMDCode();
+  Code[Pos].Src1 = LocalNum + Base;
+  switch (Instr.getSIMDCode()) {
+  case AST::SIMDCode::V128__load:
+  case AST::SIMDCode::V128__store:
+    Code[Pos].Index = Instr.getMemoryOffset();
+    break;
+  case AST::SIMDCode::V128__const:
+  case AST::SIMDCode::I8x16__shuffle:
+    Code[Pos].Index = V128.size();
+    V128.push_back(Instr.getValue());
+    break;
+  default:
+    Code[Pos].Index = Instr.getLaneIndex();
+    break;
+  }
+  Operands.resize(Base);
+  if (Instr.hasResult()) {
+    Code[Pos].Dst = pushOperand();
+  }
+  return {};
+}
+
+Expect<void>
+RegisterTranslator::translate(const AST::AtomicMemoryInstruction &Instr) {
+  Charges.push_back(Instr.getOpCode());
+  /// The operands should be in the consecutive stack position slots starting
+  /// from Src1, and the result is stored to the first one.
+  const uint32_t Base = Operands.size() - Instr.getOperandNum();
+  for (uint32_t I = Base; I < Operands.size(); ++I) {
+    materialize(I);
+  }
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].AtomicSubCode = Instr.getAtomicCode();
+  Code[Pos].Src1 = LocalNum + Base;
+  Code[Pos].Index = Instr.getMemoryOffset();
+  Operands.resize(Base);
+  if (Instr.hasResult()) {
+    Code[Pos].Dst = pushOperand();
+  }
+  return {};
+}
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -0,0 +1,552 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/ast/instruction.h"
+#include "common/value.h"
+#include "interpreter/interpreter.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace SSVM {
+namespace Interpreter {
+
+namespace {
+
+/// 128-bit vector types of the lane shapes. The vector extension of GCC and
+/// Clang lowers the lane-wise operations into the SIMD instructions of target,
+/// such as SSE2 on x86-64 and NEON on AArch64.
+typedef int8_t I8x16 __attribute__((vector_size(16)));
+typedef uint8_t U8x16 __attribute__((vector_size(16)));
+typedef int16_t I16x8 __attribute__((vector_size(16)));
+typedef uint16_t U16x8 __attribute__((vector_size(16)));
+typedef int32_t I32x4 __attribute__((vector_size(16)));
+typedef uint32_t U32x4 __attribute__((vector_size(16)));
+typedef int64_t I64x2 __attribute__((vector_size(16)));
+typedef uint64_t U64x2 __attribute__((vector_size(16)));
+typedef float F32x4 __attribute__((vector_size(16)));
+typedef double F64x2 __attribute__((vector_size(16)));
+
+/// Lane count of vector type.
+template <typename VT>
+constexpr uint32_t LaneNum = sizeof(VT) / sizeof(std::declval<VT>()[0]);
+
+/// Load the v128 value as vector type.
+template <typename VT> inline VT loadVec(const ValVariant &Val) {
+  VT V;
+  std::memcpy(&V, &retrieveValue<uint128_t>(Val), sizeof(VT));
+  return V;
+}
+
+/// Store the vector into the v128 value.
+template <typename VT> inline void storeVec(ValVariant &Val, const VT &V) {
+  uint128_t Raw;
+  std::memcpy(&Raw, &V, sizeof(VT));
+  Val = Raw;
+}
+
+/// Select lanes of A where the mask lanes are all ones, otherwise of B.
+template <typename VT, typename MT>
+inline VT selectVec(const MT &Mask, const VT &A, const VT &B) {
+  return reinterpret_cast<VT>((reinterpret_cast<MT>(A) & Mask) |
+                              (reinterpret_cast<MT>(B) & ~Mask));
+}
+
+/// Absolute value of signed integer lanes. The minimum value is kept.
+template <typename IT, typename UT> inline UT absVec(const UT &V) {
+  constexpr uint32_t Bits = sizeof(V[0]) * 8;
+  const UT Mask = reinterpret_cast<UT>(reinterpret_cast<IT>(V) >> (Bits - 1));
+  return (V ^ Mask) - Mask;
+}
+
+/// Unsigned rounding average of lanes without overflow.
+template <typename UT> inline UT avgrVec(const UT &A, const UT &B) {
+  return (A | B) - ((A ^ B) >> 1);
+}
+
+/// Check all lanes are non-zero.
+template <typename VT> inline uint32_t allTrueVec(const VT &V) {
+  for (uint32_t I = 0; I < LaneNum<VT>; ++I) {
+    if (V[I] == 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/// Gather the sign bits of signed integer lanes.
+template <typename VT> inline uint32_t bitmaskVec(const VT &V) {
+  uint32_t Mask = 0;
+  for (uint32_t I = 0; I < LaneNum<VT>; ++I) {
+    Mask |= static_cast<uint32_t>(V[I] < 0) << I;
+  }
+  return Mask;
+}
+
+/// Lane-wise min and max of floating-point lanes with the NaN and signed zero
+/// semantics of the scalar instructions.
+template <typename T> inline T minLane(T Z1, T Z2) {
+  if (std::isnan(Z2)) {
+    return Z2;
+  } else if (std::isnan(Z1)) {
+    return Z1;
+  } else if (Z1 == 0 && Z2 == 0 && std::signbit(Z1) != std::signbit(Z2)) {
+    return -0.0;
+  }
+  return std::min(Z1, Z2);
+}
+template <typename T> inline T maxLane(T Z1, T Z2) {
+  if (std::isnan(Z2)) {
+    return Z2;
+  } else if (std::isnan(Z1)) {
+    return Z1;
+  } else if (Z1 == 0 && Z2 == 0 && std::signbit(Z1) != std::signbit(Z2)) {
+    return 0.0;
+  }
+  return std::max(Z1, Z2);
+}
+template <typename VT> inline VT minVec(const VT &A, const VT &B) {
+  VT R;
+  for (uint32_t I = 0; I < LaneNum<VT>; ++I) {
+    R[I] = minLane(A[I], B[I]);
+  }
+  return R;
+}
+template <typename VT> inline VT maxVec(const VT &A, const VT &B) {
+  VT R;
+  for (uint32_t I = 0; I < LaneNum<VT>; ++I) {
+    R[I] = maxLane(A[I], B[I]);
+  }
+  return R;
+}
+template <typename VT> inline VT sqrtVec(const VT &V) {
+  VT R;
+  for (uint32_t I = 0; I < LaneNum<VT>; ++I) {
+    R[I] = std::sqrt(V[I]);
+  }
+  return R;
+}
+
+/// Saturating truncation of a floating-point lane to integer.
+template <typename IT> inline IT truncSatLane(float Z) {
+  if (std::isnan(Z)) {
+    return 0;
+  } else if (Z <= static_cast<float>(std::numeric_limits<IT>::min())) {
+    return std::numeric_limits<IT>::min();
+  } else if (Z >= static_cast<float>(std::numeric_limits<IT>::max())) {
+    return std::numeric_limits<IT>::max();
+  }
+  return static_cast<IT>(Z);
+}
+
+} // namespace
+
+Expect<void> Interpreter::runSIMDOp(const Runtime::ByteCode &Instr,
+                                    ValVariant *Args) {
+  using AST::SIMDCode;
+  ValVariant &Val = Args[0];
+  const uint32_t Lane = Instr.Index;
+
+  switch (Instr.SubCode) {
+  /// Memory instructions.
+  case SIMDCode::V128__load:
+  case SIMDCode::V128__store: {
+    /// Calculate EA = i + offset
+    if (retrieveValue<uint32_t>(Args[0]) >
+        std::numeric_limits<uint32_t>::max() - Instr.Index) {
+      return Unexpect(ErrCode::AccessForbidMemory);
+    }
+    const uint32_t EA = retrieveValue<uint32_t>(Args[0]) + Instr.Index;
+    auto &MemInst = *getMemInstByIdx(0);
+    if (Instr.SubCode == SIMDCode::V128__store) {
+      return MemInst.setArray(
+          reinterpret_cast<const uint8_t *>(&retrieveValue<uint128_t>(Args[1])),
+          EA, 16);
+    }
+    uint128_t Raw = 0;
+    if (auto Res =
+            MemInst.getArray(reinterpret_cast<uint8_t *>(&Raw), EA, 16);
+        !Res) {
+      return Unexpect(Res);
+    }
+    Val = Raw;
+    return {};
+  }
+
+  /// Constant and lane shuffling instructions.
+  case SIMDCode::V128__const:
+    Val = InstrPdr.getV128(Instr);
+    return {};
+  case SIMDCode::I8x16__shuffle: {
+    const U8x16 A = loadVec<U8x16>(Args[0]), B = loadVec<U8x16>(Args[1]);
+    const U8x16 Idx = loadVec<U8x16>(InstrPdr.getV128(Instr));
+    U8x16 R;
+    for (uint32_t I = 0; I < 16; ++I) {
+      R[I] = Idx[I] < 16 ? A[Idx[I]] : B[Idx[I] - 16];
+    }
+    storeVec(Val, R);
+    return {};
+  }
+  case SIMDCode::I8x16__swizzle: {
+    const U8x16 A = loadVec<U8x16>(Args[0]), Idx = loadVec<U8x16>(Args[1]);
+    U8x16 R;
+    for (uint32_t I = 0; I < 16; ++I) {
+      R[I] = Idx[I] < 16 ? A[Idx[I]] : 0;
+    }
+    storeVec(Val, R);
+    return {};
+  }
+
+  /// Splat instructions.
+  case SIMDCode::I8x16__splat:
+    storeVec(Val, U8x16{} + static_cast<uint8_t>(retrieveValue<uint32_t>(Val)));
+    return {};
+  case SIMDCode::I16x8__splat:
+    storeVec(Val,
+             U16x8{} + static_cast<uint16_t>(retrieveValue<uint32_t>(Val)));
+    return {};
+  case SIMDCode::I32x4__splat:
+    storeVec(Val, U32x4{} + retrieveValue<uint32_t>(Val));
+    return {};
+  case SIMDCode::I64x2__splat:
+    storeVec(Val, U64x2{} + retrieveValue<uint64_t>(Val));
+    return {};
+  case SIMDCode::F32x4__splat:
+    storeVec(Val, F32x4{} + retrieveValue<float>(Val));
+    return {};
+  case SIMDCode::F64x2__splat:
+    storeVec(Val, F64x2{} + retrieveValue<double>(Val));
+    return {};
+
+  /// Lane accessing instructions.
+  case SIMDCode::I8x16__extract_lane_s:
+    Val = static_cast<uint32_t>(
+        static_cast<int32_t>(loadVec<I8x16>(Val)[Lane]));
+    return {};
+  case SIMDCode::I8x16__extract_lane_u:
+    Val = static_cast<uint32_t>(loadVec<U8x16>(Val)[Lane]);
+    return {};
+  case SIMDCode::I16x8__extract_lane_s:
+    Val = static_cast<uint32_t>(
+        static_cast<int32_t>(loadVec<I16x8>(Val)[Lane]));
+    return {};
+  case SIMDCode::I16x8__extract_lane_u:
+    Val = static_cast<uint32_t>(loadVec<U16x8>(Val)[Lane]);
+    return {};
+  case SIMDCode::I32x4__extract_lane:
+    Val = static_cast<uint32_t>(loadVec<U32x4>(Val)[Lane]);
+    return {};
+  case SIMDCode::I64x2__extract_lane:
+    Val = static_cast<uint64_t>(loadVec<U64x2>(Val)[Lane]);
+    return {};
+  case SIMDCode::F32x4__extract_lane:
+    Val = static_cast<float>(loadVec<F32x4>(Val)[Lane]);
+    return {};
+  case SIMDCode::F64x2__extract_lane:
+    Val = static_cast<double>(loadVec<F64x2>(Val)[Lane]);
+    return {};
+  case SIMDCode::I8x16__replace_lane: {
+    U8x16 V = loadVec<U8x16>(Val);
+    V[Lane] = static_cast<uint8_t>(retrieveValue<uint32_t>(Args[1]));
+    storeVec(Val, V);
+    return {};
+  }
+  case SIMDCode::I16x8__replace_lane: {
+    U16x8 V = loadVec<U16x8>(Val);
+    V[Lane] = static_cast<uint16_t>(retrieveValue<uint32_t>(Args[1]));
+    storeVec(Val, V);
+    return {};
+  }
+  case SIMDCode::I32x4__replace_lane: {
+    U32x4 V = loadVec<U32x4>(Val);
+    V[Lane] = retrieveValue<uint32_t>(Args[1]);
+    storeVec(Val, V);
+    return {};
+  }
+  case SIMDCode::I64x2__replace_lane: {
+    U64x2 V = loadVec<U64x2>(Val);
+    V[Lane] = retrieveValue<uint64_t>(Args[1]);
+    storeVec(Val, V);
+    return {};
+  }
+  case SIMDCode::F32x4__replace_lane: {
+    F32x4 V = loadVec<F32x4>(Val);
+    V[Lane] = retrieveValue<float>(Args[1]);
+    storeVec(Val, V);
+    return {};
+  }
+  case SIMDCode::F64x2__replace_lane: {
+    F64x2 V = loadVec<F64x2>(Val);
+    V[Lane] = retrieveValue<double>(Args[1]);
+    storeVec(Val, V);
+    return {};
+  }
+
+/// Lane-wise binary operation of vector type VT with the expression Expr of
+/// the operands A and B.
+#define SIMD_BINARY(Code, VT, Expr)                                            \
+  case SIMDCode::Code: {                                                       \
+    const VT A = loadVec<VT>(Args[0]), B = loadVec<VT>(Args[1]);               \
+    storeVec(Val, Expr);                                                       \
+    return {};                                                                 \
+  }
+/// Lane-wise unary operation of vector type VT with the expression Expr of
+/// the operand A.
+#define SIMD_UNARY(Code, VT, Expr)                                             \
+  case SIMDCode::Code: {                                                       \
+    const VT A = loadVec<VT>(Args[0]);                                         \
+    storeVec(Val, Expr);                                                       \
+    return {};                                                                 \
+  }
+/// Lane-wise shift of vector type VT with the count modulo the lane width.
+#define SIMD_SHIFT(Code, VT, Op)                                               \
+  case SIMDCode::Code: {                                                       \
+    const VT A = loadVec<VT>(Args[0]);                                         \
+    const uint32_t Cnt =                                                       \
+        retrieveValue<uint32_t>(Args[1]) % (sizeof(A[0]) * 8);                 \
+    storeVec(Val, A Op Cnt);                                                   \
+    return {};                                                                 \
+  }
+
+  /// Comparison instructions. The results of vector comparisons are the lanes
+  /// of all ones or all zeros.
+  SIMD_BINARY(I8x16__eq, I8x16, A == B)
+  SIMD_BINARY(I8x16__ne, I8x16, A != B)
+  SIMD_BINARY(I8x16__lt_s, I8x16, A < B)
+  SIMD_BINARY(I8x16__lt_u, U8x16, A < B)
+  SIMD_BINARY(I8x16__gt_s, I8x16, A > B)
+  SIMD_BINARY(I8x16__gt_u, U8x16, A > B)
+  SIMD_BINARY(I8x16__le_s, I8x16, A <= B)
+  SIMD_BINARY(I8x16__le_u, U8x16, A <= B)
+  SIMD_BINARY(I8x16__ge_s, I8x16, A >= B)
+  SIMD_BINARY(I8x16__ge_u, U8x16, A >= B)
+  SIMD_BINARY(I16x8__eq, I16x8, A == B)
+  SIMD_BINARY(I16x8__ne, I16x8, A != B)
+  SIMD_BINARY(I16x8__lt_s, I16x8, A < B)
+  SIMD_BINARY(I16x8__lt_u, U16x8, A < B)
+  SIMD_BINARY(I16x8__gt_s, I16x8, A > B)
+  SIMD_BINARY(I16x8__gt_u, U16x8, A > B)
+  SIMD_BINARY(I16x8__le_s, I16x8, A <= B)
+  SIMD_BINARY(I16x8__le_u, U16x8, A <= B)
+  SIMD_BINARY(I16x8__ge_s, I16x8, A >= B)
+  SIMD_BINARY(I16x8__ge_u, U16x8, A >= B)
+  SIMD_BINARY(I32x4__eq, I32x4, A == B)
+  SIMD_BINARY(I32x4__ne, I32x4, A != B)
+  SIMD_BINARY(I32x4__lt_s, I32x4, A < B)
+  SIMD_BINARY(I32x4__lt_u, U32x4, A < B)
+  SIMD_BINARY(I32x4__gt_s, I32x4, A > B)
+  SIMD_BINARY(I32x4__gt_u, U32x4, A > B)
+  SIMD_BINARY(I32x4__le_s, I32x4, A <= B)
+  SIMD_BINARY(I32x4__le_u, U32x4, A <= B)
+  SIMD_BINARY(I32x4__ge_s, I32x4, A >= B)
+  SIMD_BINARY(I32x4__ge_u, U32x4, A >= B)
+  SIMD_BINARY(I64x2__eq, I64x2, A == B)
+  SIMD_BINARY(I64x2__ne, I64x2, A != B)
+  SIMD_BINARY(I64x2__lt_s, I64x2, A < B)
+  SIMD_BINARY(I64x2__gt_s, I64x2, A > B)
+  SIMD_BINARY(I64x2__le_s, I64x2, A <= B)
+  SIMD_BINARY(I64x2__ge_s, I64x2, A >= B)
+  SIMD_BINARY(F32x4__eq, F32x4, A == B)
+  SIMD_BINARY(F32x4__ne, F32x4, A != B)
+  SIMD_BINARY(F32x4__lt, F32x4, A < B)
+  SIMD_BINARY(F32x4__gt, F32x4, A > B)
+  SIMD_BINARY(F32x4__le, F32x4, A <= B)
+  SIMD_BINARY(F32x4__ge, F32x4, A >= B)
+  SIMD_BINARY(F64x2__eq, F64x2, A == B)
+  SIMD_BINARY(F64x2__ne, F64x2, A != B)
+  SIMD_BINARY(F64x2__lt, F64x2, A < B)
+  SIMD_BINARY(F64x2__gt, F64x2, A > B)
+  SIMD_BINARY(F64x2__le, F64x2, A <= B)
+  SIMD_BINARY(F64x2__ge, F64x2, A >= B)
+
+  /// Bitwise instructions.
+  SIMD_UNARY(V128__not, U64x2, ~A)
+  SIMD_BINARY(V128__and, U64x2, A & B)
+  SIMD_BINARY(V128__andnot, U64x2, A & ~B)
+  SIMD_BINARY(V128__or, U64x2, A | B)
+  SIMD_BINARY(V128__xor, U64x2, A ^ B)
+  case SIMDCode::V128__bitselect: {
+    const U64x2 A = loadVec<U64x2>(Args[0]), B = loadVec<U64x2>(Args[1]);
+    const U64x2 C = loadVec<U64x2>(Args[2]);
+    storeVec(Val, (A & C) | (B & ~C));
+    return {};
+  }
+  case SIMDCode::V128__any_true:
+    Val = static_cast<uint32_t>(retrieveValue<uint128_t>(Val) != 0);
+    return {};
+
+  /// Integer arithmetic instructions. The unsigned lanes wrap on overflow.
+  SIMD_UNARY(I8x16__abs, U8x16, (absVec<I8x16>(A)))
+  SIMD_UNARY(I8x16__neg, U8x16, -A)
+  SIMD_SHIFT(I8x16__shl, U8x16, <<)
+  SIMD_SHIFT(I8x16__shr_s, I8x16, >>)
+  SIMD_SHIFT(I8x16__shr_u, U8x16, >>)
+  SIMD_BINARY(I8x16__add, U8x16, A + B)
+  SIMD_BINARY(I8x16__sub, U8x16, A - B)
+  SIMD_BINARY(I8x16__min_s, I8x16, selectVec(A < B, A, B))
+  SIMD_BINARY(I8x16__min_u, U8x16, selectVec(A < B, A, B))
+  SIMD_BINARY(I8x16__max_s, I8x16, selectVec(A > B, A, B))
+  SIMD_BINARY(I8x16__max_u, U8x16, selectVec(A > B, A, B))
+  SIMD_BINARY(I8x16__avgr_u, U8x16, avgrVec(A, B))
+  SIMD_UNARY(I16x8__abs, U16x8, (absVec<I16x8>(A)))
+  SIMD_UNARY(I16x8__neg, U16x8, -A)
+  SIMD_SHIFT(I16x8__shl, U16x8, <<)
+  SIMD_SHIFT(I16x8__shr_s, I16x8, >>)
+  SIMD_SHIFT(I16x8__shr_u, U16x8, >>)
+  SIMD_BINARY(I16x8__add, U16x8, A + B)
+  SIMD_BINARY(I16x8__sub, U16x8, A - B)
+  SIMD_BINARY(I16x8__mul, U16x8, A * B)
+  SIMD_BINARY(I16x8__min_s, I16x8, selectVec(A < B, A, B))
+  SIMD_BINARY(I16x8__min_u, U16x8, selectVec(A < B, A, B))
+  SIMD_BINARY(I16x8__max_s, I16x8, selectVec(A > B, A, B))
+  SIMD_BINARY(I16x8__max_u, U16x8, selectVec(A > B, A, B))
+  SIMD_BINARY(I16x8__avgr_u, U16x8, avgrVec(A, B))
+  SIMD_UNARY(I32x4__abs, U32x4, (absVec<I32x4>(A)))
+  SIMD_UNARY(I32x4__neg, U32x4, -A)
+  SIMD_SHIFT(I32x4__shl, U32x4, <<)
+  SIMD_SHIFT(I32x4__shr_s, I32x4, >>)
+  SIMD_SHIFT(I32x4__shr_u, U32x4, >>)
+  SIMD_BINARY(I32x4__add, U32x4, A + B)
+  SIMD_BINARY(I32x4__sub, U32x4, A - B)
+  SIMD_BINARY(I32x4__mul, U32x4, A * B)
+  SIMD_BINARY(I32x4__min_s, I32x4, selectVec(A < B, A, B))
+  SIMD_BINARY(I32x4__min_u, U32x4, selectVec(A < B, A, B))
+  SIMD_BINARY(I32x4__max_s, I32x4, selectVec(A > B, A, B))
+  SIMD_BINARY(I32x4__max_u, U32x4, selectVec(A > B, A, B))
+  case SIMDCode::I32x4__dot_i16x8_s: {
+#if defined(__SSE2__)
+    __m128i A, B;
+    std::memcpy(&A, &retrieveValue<uint128_t>(Args[0]), 16);
+    std::memcpy(&B, &retrieveValue<uint128_t>(Args[1]), 16);
+    storeVec(Val, reinterpret_cast<U32x4>(_mm_madd_epi16(A, B)));
+#else
+    const I16x8 A = loadVec<I16x8>(Args[0]), B = loadVec<I16x8>(Args[1]);
+    U32x4 R;
+    for (uint32_t I = 0; I < 4; ++I) {
+      R[I] = static_cast<uint32_t>(int32_t(A[I * 2]) * int32_t(B[I * 2])) +
+             static_cast<uint32_t>(int32_t(A[I * 2 + 1]) *
+                                   int32_t(B[I * 2 + 1]));
+    }
+    storeVec(Val, R);
+#endif
+    return {};
+  }
+  SIMD_UNARY(I64x2__abs, U64x2, (absVec<I64x2>(A)))
+  SIMD_UNARY(I64x2__neg, U64x2, -A)
+  SIMD_SHIFT(I64x2__shl, U64x2, <<)
+  SIMD_SHIFT(I64x2__shr_s, I64x2, >>)
+  SIMD_SHIFT(I64x2__shr_u, U64x2, >>)
+  SIMD_BINARY(I64x2__add, U64x2, A + B)
+  SIMD_BINARY(I64x2__sub, U64x2, A - B)
+  SIMD_BINARY(I64x2__mul, U64x2, A * B)
+
+  /// Lane reduction instructions.
+  case SIMDCode::I8x16__all_true:
+    Val = allTrueVec(loadVec<U8x16>(Val));
+    return {};
+  case SIMDCode::I16x8__all_true:
+    Val = allTrueVec(loadVec<U16x8>(Val));
+    return {};
+  case SIMDCode::I32x4__all_true:
+    Val = allTrueVec(loadVec<U32x4>(Val));
+    return {};
+  case SIMDCode::I64x2__all_true:
+    Val = allTrueVec(loadVec<U64x2>(Val));
+    return {};
+  case SIMDCode::I8x16__bitmask: {
+#if defined(__SSE2__)
+    __m128i V;
+    std::memcpy(&V, &retrieveValue<uint128_t>(Val), 16);
+    Val = static_cast<uint32_t>(_mm_movemask_epi8(V));
+#else
+    Val = bitmaskVec(loadVec<I8x16>(Val));
+#endif
+    return {};
+  }
+  case SIMDCode::I16x8__bitmask:
+    Val = bitmaskVec(loadVec<I16x8>(Val));
+    return {};
+  case SIMDCode::I32x4__bitmask:
+    Val = bitmaskVec(loadVec<I32x4>(Val));
+    return {};
+  case SIMDCode::I64x2__bitmask:
+    Val = bitmaskVec(loadVec<I64x2>(Val));
+    return {};
+
+  /// Floating-point arithmetic instructions. The abs and neg only touch the
+  /// sign bits.
+  SIMD_UNARY(F32x4__abs, U32x4, A & 0x7FFFFFFFU)
+  SIMD_UNARY(F32x4__neg, U32x4, A ^ 0x80000000U)
+  SIMD_UNARY(F32x4__sqrt, F32x4, sqrtVec(A))
+  SIMD_BINARY(F32x4__add, F32x4, A + B)
+  SIMD_BINARY(F32x4__sub, F32x4, A - B)
+  SIMD_BINARY(F32x4__mul, F32x4, A * B)
+  SIMD_BINARY(F32x4__div, F32x4, A / B)
+  SIMD_BINARY(F32x4__min, F32x4, minVec(A, B))
+  SIMD_BINARY(F32x4__max, F32x4, maxVec(A, B))
+  SIMD_BINARY(F32x4__pmin, F32x4, selectVec(B < A, B, A))
+  SIMD_BINARY(F32x4__pmax, F32x4, selectVec(A < B, B, A))
+  SIMD_UNARY(F64x2__abs, U64x2, A & 0x7FFFFFFFFFFFFFFFULL)
+  SIMD_UNARY(F64x2__neg, U64x2, A ^ 0x8000000000000000ULL)
+  SIMD_UNARY(F64x2__sqrt, F64x2, sqrtVec(A))
+  SIMD_BINARY(F64x2__add, F64x2, A + B)
+  SIMD_BINARY(F64x2__sub, F64x2, A - B)
+  SIMD_BINARY(F64x2__mul, F64x2, A * B)
+  SIMD_BINARY(F64x2__div, F64x2, A / B)
+  SIMD_BINARY(F64x2__min, F64x2, minVec(A, B))
+  SIMD_BINARY(F64x2__max, F64x2, maxVec(A, B))
+  SIMD_BINARY(F64x2__pmin, F64x2, selectVec(B < A, B, A))
+  SIMD_BINARY(F64x2__pmax, F64x2, selectVec(A < B, B, A))
+
+#undef SIMD_BINARY
+#undef SIMD_UNARY
+#undef SIMD_SHIFT
+
+  /// Conversion instructions.
+  case SIMDCode::I32x4__trunc_sat_f32x4_s: {
+    const F32x4 A = loadVec<F32x4>(Val);
+    I32x4 R;
+    for (uint32_t I = 0; I < 4; ++I) {
+      R[I] = truncSatLane<int32_t>(A[I]);
+    }
+    storeVec(Val, R);
+    return {};
+  }
+  case SIMDCode::I32x4__trunc_sat_f32x4_u: {
+    const F32x4 A = loadVec<F32x4>(Val);
+    U32x4 R;
+    for (uint32_t I = 0; I < 4; ++I) {
+      R[I] = truncSatLane<uint32_t>(A[I]);
+    }
+    storeVec(Val, R);
+    return {};
+  }
+  case SIMDCode::F32x4__convert_i32x4_s: {
+    const I32x4 A = loadVec<I32x4>(Val);
+    F32x4 R;
+    for (uint32_t I = 0; I < 4; ++I) {
+      R[I] = static_cast<float>(A[I]);
+    }
+    storeVec(Val, R);
+    return {};
+  }
+  case SIMDCode::F32x4__convert_i32x4_u: {
+    const U32x4 A = loadVec<U32x4>(Val);
+    F32x4 R;
+    for (uint32_t I = 0; I < 4; ++I) {
+      R[I] = static_cast<float>(A[I]);
+    }
+    storeVec(Val, R);
+    return {};
+  }
+
+  default:
+    return Unexpect(ErrCode::InstructionTypeMismatch);
+  }
+}
+
+} // namespace Interpreter
+} // namespace SSVM
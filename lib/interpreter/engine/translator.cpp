@@ -0,0 +1,466 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "interpreter/engine/translator.h"
+
+#include <algorithm>
+#include <array>
+
+namespace SSVM {
+namespace Interpreter {
+
+using OpCode = AST::Instruction::OpCode;
+
+namespace {
+
+/// Instruction sequence of superinstruction.
+struct SuperPattern {
+  OpCode Super;
+  uint32_t Length;
+  std::array<OpCode, 3> Codes;
+};
+
+/// Superinstruction table chosen from the instruction pair frequencies dumped
+/// by `ssvm-bench --pairs`. The longer sequences are matched first.
+const std::array<SuperPattern, 7> SuperPatterns = {{
+    {Runtime::SuperCode::LocalGetI32ConstI32Add,
+     3,
+     {OpCode::Local__get, OpCode::I32__const, OpCode::I32__add}},
+    {Runtime::SuperCode::LocalGetI32ConstI32Sub,
+     3,
+     {OpCode::Local__get, OpCode::I32__const, OpCode::I32__sub}},
+    {Runtime::SuperCode::LocalGetI32Const,
+     2,
+     {OpCode::Local__get, OpCode::I32__const}},
+    {Runtime::SuperCode::LocalGetLocalGet,
+     2,
+     {OpCode::Local__get, OpCode::Local__get}},
+    {Runtime::SuperCode::I32ConstI32Add,
+     2,
+     {OpCode::I32__const, OpCode::I32__add}},
+    {Runtime::SuperCode::I32LtSIf, 2, {OpCode::I32__lt_s, OpCode::If}},
+    {Runtime::SuperCode::I32EqzBrIf, 2, {OpCode::I32__eqz, OpCode::Br_if}},
+}};
+
+} // namespace
+
+/// Translate instructions. See "include/interpreter/engine/translator.h".
+Expect<Runtime::ByteCodeSeq>
+Translator::translate(const AST::InstrVec &Instrs,
+                      const AST::BranchTargetVec &Targets) {
+  Code.clear();
+  V128.clear();
+  Labels.clear();
+  this->Targets = &Targets;
+  TargetPos = 0;
+  LoopCnt = 0;
+  Height = 0;
+  MaxHeight = 0;
+  /// The function body is the outermost label.
+  enterLabel(false, ValType::None);
+  if (auto Res = translateInstrs(Instrs); !Res) {
+    return Unexpect(Res);
+  }
+  leaveLabel();
+  if (TargetPos != Targets.size()) {
+    /// The targets are not of this instruction sequence.
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  Runtime::ByteCodeSeq Seq;
+  Seq.Meters = computeBlocks();
+  if (!IsPairCounting) {
+    fuseSuperInstrs(Seq.Meters);
+  }
+  Seq.Instrs = std::move(Code);
+  Seq.V128 = std::move(V128);
+  Seq.MaxHeight = MaxHeight;
+  return Seq;
+}
+
+Expect<void> Translator::translateInstrs(const AST::InstrVec &Instrs) {
+  for (auto &Instr : Instrs) {
+    auto Res = dispatchInstruction(
+        Instr->getOpCode(), [this, &Instr](auto &&Arg) -> Expect<void> {
+          if constexpr (std::is_void_v<
+                            typename std::decay_t<decltype(Arg)>::type>) {
+            /// If the Code not matched, return null pointer.
+            return Unexpect(ErrCode::Unimplemented);
+          } else {
+            /// Translate the instruction node according to Code.
+            return translate(
+                *static_cast<const typename std::decay_t<decltype(Arg)>::type
+                                 *>(Instr.get()));
+          }
+        });
+    if (!Res) {
+      return Unexpect(Res);
+    }
+  }
+  return {};
+}
+
+uint32_t Translator::emit(const OpCode Code) {
+  this->Code.emplace_back(Code);
+  return this->Code.size() - 1;
+}
+
+Expect<void> Translator::emitBranch(const OpCode Code,
+                                    const uint32_t LabelIdx) {
+  if (TargetPos >= Targets->size()) {
+    /// The branch is not resolved by validator.
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  const auto &Target = (*Targets)[TargetPos++];
+  if (Code == OpCode::Br_if) {
+    updateHeight(1, 0);
+  }
+  const uint32_t Pos = emit(Code);
+  this->Code[Pos].Arity = Target.Arity;
+  this->Code[Pos].StackErase = Target.StackErase;
+  auto &Label = Labels[Labels.size() - LabelIdx - 1];
+  if (Label.IsLoop) {
+    /// Backward branch to the beginning of loop body.
+    this->Code[Pos].JumpEnd =
+        static_cast<int32_t>(Label.Start) - static_cast<int32_t>(Pos);
+  } else {
+    /// Forward branch. Resolve the offset when leaving the label.
+    Label.Pending.push_back(Pos);
+  }
+  return {};
+}
+
+std::vector<Runtime::ByteCodeMeter> Translator::computeBlocks() {
+  /// Mark the beginnings of blocks. The `Else` markers and the label entries
+  /// of `br_table` are not run, and have no costs. Neither do the loop heads.
+  std::vector<bool> IsBegin(Code.size() + 1, false);
+  std::vector<bool> IsCharged(Code.size(), true);
+  IsBegin[0] = true;
+  for (uint32_t Pos = 0; Pos < Code.size(); ++Pos) {
+    const auto &Instr = Code[Pos];
+    switch (Instr.Code) {
+    case OpCode::If:
+      IsBegin[Pos + 1] = true;
+      if (Instr.JumpElse == Instr.JumpEnd) {
+        IsBegin[Pos + Instr.JumpEnd] = true;
+      } else {
+        IsBegin[Pos + Instr.JumpElse + 1] = true;
+      }
+      break;
+    case OpCode::Else:
+      IsCharged[Pos] = false;
+      IsBegin[Pos + Instr.JumpEnd] = true;
+      break;
+    case Runtime::TierCode::LoopHead:
+      IsCharged[Pos] = false;
+      break;
+    case OpCode::Br:
+    case OpCode::Br_if:
+      IsBegin[Pos + 1] = true;
+      IsBegin[Pos + Instr.JumpEnd] = true;
+      break;
+    case OpCode::Br_table:
+      for (uint32_t I = 1; I <= Instr.Index + 1; ++I) {
+        IsCharged[Pos + I] = false;
+        IsBegin[Pos + I + Code[Pos + I].JumpEnd] = true;
+      }
+      Pos += Instr.Index + 1;
+      IsBegin[Pos + 1] = true;
+      break;
+    case OpCode::Return:
+    case OpCode::Call:
+    case OpCode::Call_indirect:
+    case OpCode::Return_call:
+    case OpCode::Return_call_indirect:
+    case OpCode::Unreachable:
+      IsBegin[Pos + 1] = true;
+      break;
+    default:
+      break;
+    }
+  }
+
+  /// Sum up the costs backward. The remaining costs of an instruction are of
+  /// the following ones until the next beginning.
+  std::vector<Runtime::ByteCodeMeter> Meters(Code.size());
+  uint64_t Cost = 0;
+  uint32_t Cnt = 0;
+  for (uint32_t Pos = Code.size(); Pos-- > 0;) {
+    Meters[Pos].RemainCost = Cost;
+    Meters[Pos].RemainCnt = Cnt;
+    if (IsCharged[Pos]) {
+      if (Measure) {
+        Cost += Measure->getInstrCost(Code[Pos].Code);
+        if (Code[Pos].Code == OpCode::SIMD) {
+          Cost += Measure->getSIMDCost(Code[Pos].SubCode);
+        }
+      }
+      ++Cnt;
+    }
+    if (IsBegin[Pos] || (IsPairCounting && IsCharged[Pos])) {
+      Code[Pos].BlockBegin = Cnt != 0;
+      Meters[Pos].BlockCost = Cost;
+      Meters[Pos].BlockCnt = Cnt;
+      Cost = 0;
+      Cnt = 0;
+    }
+  }
+  return Meters;
+}
+
+void Translator::fuseSuperInstrs(
+    const std::vector<Runtime::ByteCodeMeter> &Meters) {
+  /// Only the first instruction of the sequence is replaced. The following
+  /// ones are kept for their immediates and for the branches jumping inside.
+  /// None of the instructions in a sequence traps before the last one. A
+  /// sequence is not fused across blocks, for the block costs are charged
+  /// when fetching the beginning.
+  uint32_t Pos = 0;
+  while (Pos < Code.size()) {
+    uint32_t Length = 1;
+    for (const auto &Pattern : SuperPatterns) {
+      if (Pos + Pattern.Length > Code.size()) {
+        continue;
+      }
+      bool IsMatched = true;
+      for (uint32_t I = 0; I < Pattern.Length; ++I) {
+        if (Code[Pos + I].Code != Pattern.Codes[I] ||
+            (I > 0 && Meters[Pos + I].BlockCnt != 0)) {
+          IsMatched = false;
+          break;
+        }
+      }
+      if (IsMatched) {
+        Code[Pos].Code = Pattern.Super;
+        Length = Pattern.Length;
+        break;
+      }
+    }
+    Pos += Length;
+  }
+}
+
+void Translator::updateHeight(const uint32_t PopNum, const uint32_t PushNum) {
+  /// The unreachable code may pop more values than pushed in the block, for
+  /// the stack is polymorphic there. Keep the height of the label beginning.
+  const uint32_t Bottom = Labels.back().Height;
+  Height = Height >= Bottom + PopNum ? Height - PopNum : Bottom;
+  Height += PushNum;
+  MaxHeight = std::max(MaxHeight, Height);
+}
+
+void Translator::enterLabel(const bool IsLoop, const ValType Type) {
+  Labels.push_back({IsLoop, static_cast<uint32_t>(Code.size()), Height,
+                    Type == ValType::None ? 0U : 1U,
+                    {}});
+}
+
+void Translator::leaveLabel() {
+  const uint32_t EndPos = Code.size();
+  for (const uint32_t Pos : Labels.back().Pending) {
+    Code[Pos].JumpEnd = EndPos - Pos;
+  }
+  /// Leave the results on the stack height of the label beginning.
+  Height = Labels.back().Height + Labels.back().Arity;
+  MaxHeight = std::max(MaxHeight, Height);
+  Labels.pop_back();
+}
+
+Expect<void> Translator::translate(const AST::ControlInstruction &Instr) {
+  emit(Instr.getOpCode());
+  return {};
+}
+
+Expect<void> Translator::translate(const AST::BlockControlInstruction &Instr) {
+  /// Block: [Block] [Body...]
+  /// Loop:  [Loop] [LoopHead] [Body...]
+  emit(Instr.getOpCode());
+  if (IsLoopCounting && Instr.getOpCode() == OpCode::Loop) {
+    /// The branches to loop jump back to the loop head.
+    enterLabel(true, Instr.getResultType());
+    const uint32_t Pos = emit(Runtime::TierCode::LoopHead);
+    Code[Pos].Index = LoopFuncIdx;
+    Code[Pos].Dst = LoopCnt++;
+  } else {
+    enterLabel(Instr.getOpCode() == OpCode::Loop, Instr.getResultType());
+  }
+  if (auto Res = translateInstrs(Instr.getBody()); !Res) {
+    return Unexpect(Res);
+  }
+  leaveLabel();
+  return {};
+}
+
+Expect<void>
+Translator::translate(const AST::IfElseControlInstruction &Instr) {
+  /// If-else: [If] [IfStatement...] [Else] [ElseStatement...]
+  /// If:      [If] [IfStatement...]
+  const uint32_t Pos = emit(Instr.getOpCode());
+  updateHeight(1, 0);
+  enterLabel(false, Instr.getResultType());
+  if (auto Res = translateInstrs(Instr.getIfStatement()); !Res) {
+    return Unexpect(Res);
+  }
+  uint32_t ElsePos = 0;
+  if (!Instr.getElseStatement().empty()) {
+    ElsePos = emit(OpCode::Else);
+    Height = Labels.back().Height;
+    if (auto Res = translateInstrs(Instr.getElseStatement()); !Res) {
+      return Unexpect(Res);
+    }
+  }
+  const uint32_t EndPos = Code.size();
+  leaveLabel();
+  if (ElsePos == 0) {
+    ElsePos = EndPos;
+  } else {
+    Code[ElsePos].JumpEnd = EndPos - ElsePos;
+  }
+  Code[Pos].JumpElse = ElsePos - Pos;
+  Code[Pos].JumpEnd = EndPos - Pos;
+  return {};
+}
+
+Expect<void> Translator::translate(const AST::BrControlInstruction &Instr) {
+  return emitBranch(Instr.getOpCode(), Instr.getLabelIndex());
+}
+
+Expect<void>
+Translator::translate(const AST::BrTableControlInstruction &Instr) {
+  /// Br_table: [Br_table] [Label 0] ... [Label N-1] [Default label]
+  const auto &LabelTable = Instr.getLabelTable();
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Index = LabelTable.size();
+  updateHeight(1, 0);
+  for (uint32_t I = 0; I < LabelTable.size(); ++I) {
+    if (auto Res = emitBranch(OpCode::Br, LabelTable[I]); !Res) {
+      return Unexpect(Res);
+    }
+  }
+  return emitBranch(OpCode::Br, Instr.getLabelIndex());
+}
+
+Expect<void> Translator::translate(const AST::CallControlInstruction &Instr) {
+  if (FuncTypes == nullptr) {
+    /// The function types are not set for the stack heights.
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  const Runtime::Instance::FType *Type = nullptr;
+  if (!Instr.isIndirect()) {
+    Type = (*FuncTypes)[Instr.getFuncIndex()];
+  } else if (auto Res = ModInst->getFuncType(Instr.getFuncIndex())) {
+    Type = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Index = Instr.getFuncIndex();
+  updateHeight(Type->Params.size() + (Instr.isIndirect() ? 1U : 0U),
+               Type->Returns.size());
+  return {};
+}
+
+Expect<void> Translator::translate(const AST::ParametricInstruction &Instr) {
+  emit(Instr.getOpCode());
+  if (Instr.getOpCode() == OpCode::Drop) {
+    updateHeight(1, 0);
+  } else {
+    updateHeight(3, 1);
+  }
+  return {};
+}
+
+Expect<void> Translator::translate(const AST::VariableInstruction &Instr) {
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].Index = Instr.getVariableIndex();
+  switch (Instr.getOpCode()) {
+  case OpCode::Local__get:
+  case OpCode::Global__get:
+    updateHeight(0, 1);
+    break;
+  case OpCode::Local__set:
+  case OpCode::Global__set:
+    updateHeight(1, 0);
+    break;
+  default:
+    break;
+  }
+  return {};
+}
+
+Expect<void> Translator::translate(const AST::MemoryInstruction &Instr) {
+  const OpCode Code = Instr.getOpCode();
+  const uint32_t Pos = emit(Code);
+  switch (Code) {
+  case OpCode::Memory__init:
+  case OpCode::Data__drop:
+    this->Code[Pos].Index = Instr.getDataIndex();
+    break;
+  default:
+    this->Code[Pos].Index = Instr.getMemoryOffset();
+    break;
+  }
+  if (Code >= OpCode::I32__store && Code <= OpCode::I64__store32) {
+    updateHeight(2, 0);
+  } else if (Code == OpCode::Memory__init || Code == OpCode::Memory__copy ||
+             Code == OpCode::Memory__fill) {
+    updateHeight(3, 0);
+  } else if (Code == OpCode::Memory__size) {
+    updateHeight(0, 1);
+  } else if (Code != OpCode::Data__drop) {
+    updateHeight(1, 1);
+  }
+  return {};
+}
+
+Expect<void> Translator::translate(const AST::ConstInstruction &Instr) {
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].setNum(Instr.getConstValue());
+  updateHeight(0, 1);
+  return {};
+}
+
+Expect<void> Translator::translate(const AST::UnaryNumericInstruction &Instr) {
+  emit(Instr.getOpCode());
+  updateHeight(1, 1);
+  return {};
+}
+
+Expect<void>
+Translator::translate(const AST::BinaryNumericInstruction &Instr) {
+  emit(Instr.getOpCode());
+  updateHeight(2, 1);
+  return {};
+}
+
+Expect<void> Translator::translate(const AST::SIMDInstruction &Instr) {
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].SubCode = Instr.getSIMDCode();
+  Code[Pos].Arity = Instr.getOperandNum();
+  switch (Instr.getSIMDCode()) {
+  case AST::SIMDCode::V128__load:
+  case AST::SIMDCode::V128__store:
+    Code[Pos].Index = Instr.getMemoryOffset();
+    break;
+  case AST::SIMDCode::V128__const:
+  case AST::SIMDCode::I8x16__shuffle:
+    Code[Pos].Index = V128.size();
+    V128.push_back(Instr.getValue());
+    break;
+  default:
+    Code[Pos].Index = Instr.getLaneIndex();
+    break;
+  }
+  updateHeight(Instr.getOperandNum(), Instr.hasResult() ? 1U : 0U);
+  return {};
+}
+
+Expect<void>
+Translator::translate(const AST::AtomicMemoryInstruction &Instr) {
+  const uint32_t Pos = emit(Instr.getOpCode());
+  Code[Pos].AtomicSubCode = Instr.getAtomicCode();
+  Code[Pos].Arity = Instr.getOperandNum();
+  Code[Pos].Index = Instr.getMemoryOffset();
+  updateHeight(Instr.getOperandNum(), Instr.hasResult() ? 1U : 0U);
+  return {};
+}
+
+} // namespace Interpreter
+} // namespace SSVM
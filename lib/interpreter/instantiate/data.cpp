@@ -15,6 +15,12 @@ Interpreter::resolveExpression(Runtime::StoreManager &StoreMgr,
   std::vector<uint32_t> Offsets;
   /// Iterate and evaluate offsets.
   for (const auto &DataSeg : DataSec.getContent()) {
+    /// Passive data segment has no offset.
+    if (DataSeg->isPassive()) {
+      Offsets.push_back(0);
+      continue;
+    }
+
     /// Run initialize expression.
     if (auto Res = runExpression(StoreMgr, DataSeg->getInstrs()); !Res) {
       return Unexpect(Res);
@@ -44,6 +50,16 @@ Expect<void> Interpreter::instantiate(
   auto ItDataSeg = DataSec.getContent().cbegin();
   auto ItOffset = Offsets.cbegin();
   while (ItOffset != Offsets.cend()) {
+    /// Passive data segment is kept in module instance for memory.init. Active
+    /// data segment is dropped after initialization.
+    if ((*ItDataSeg)->isPassive()) {
+      ModInst.addData((*ItDataSeg)->getData());
+      ++ItDataSeg;
+      ++ItOffset;
+      continue;
+    }
+    ModInst.addData({});
+
     /// Get memory instance.
     uint32_t MemAddr = *ModInst.getMemAddr((*ItDataSeg)->getIdx());
     auto *MemInst = *StoreMgr.getMemory(MemAddr);
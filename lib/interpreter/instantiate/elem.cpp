@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "common/ast/section.h"
 #include "interpreter/interpreter.h"
+#include "runtime/instance/function.h"
 #include "runtime/instance/module.h"
 #include "runtime/instance/table.h"
 
@@ -48,13 +49,15 @@ Expect<void> Interpreter::instantiate(
     uint32_t TabAddr = *ModInst.getTableAddr((*ItElemSeg)->getIdx());
     auto *TabInst = *StoreMgr.getTable(TabAddr);
 
-    /// Transfer function index to address and copy data to table instance.
-    auto FuncIdxList = (*ItElemSeg)->getFuncIdxes();
-    for (auto &Idx : FuncIdxList) {
-      uint32_t FuncAddr = *ModInst.getFuncAddr(Idx);
-      Idx = FuncAddr;
+    /// Resolve function index to function instance with its type ID and copy
+    /// data to table instance.
+    std::vector<Runtime::Instance::TableInstance::FuncElem> Elems;
+    Elems.reserve((*ItElemSeg)->getFuncIdxes().size());
+    for (const auto &Idx : (*ItElemSeg)->getFuncIdxes()) {
+      const auto *FuncInst = *StoreMgr.getFunction(*ModInst.getFuncAddr(Idx));
+      Elems.push_back({FuncInst->getTypeID(), FuncInst});
     }
-    if (auto Res = TabInst->setInitList(*ItOffset, FuncIdxList); !Res) {
+    if (auto Res = TabInst->setInitList(*ItOffset, Elems); !Res) {
       return Unexpect(Res);
     }
 
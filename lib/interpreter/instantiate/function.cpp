@@ -1,5 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "common/ast/section.h"
+#include "interpreter/engine/regtranslator.h"
+#include "interpreter/engine/translator.h"
 #include "runtime/instance/module.h"
 #include "runtime/instance/function.h"
 #include "interpreter/interpreter.h"
@@ -10,12 +12,30 @@ namespace Interpreter {
 /// Instantiate function instance. See "include/interpreter/interpreter.h".
 Expect<void> Interpreter::instantiate(
     Runtime::StoreManager &StoreMgr, Runtime::Instance::ModuleInstance &ModInst,
-    const AST::FunctionSection &FuncSec, const AST::CodeSection &CodeSec) {
+    const AST::FunctionSection &FuncSec, const AST::CodeSection &CodeSec,
+    const std::vector<AST::BranchTargetVec> &Targets) {
 
   /// Get the function type indices.
   auto &TypeIdxs = FuncSec.getContent();
   auto &CodeSegs = CodeSec.getContent();
 
+  /// Every function body should have its branch targets resolved by
+  /// validator.
+  if (Targets.size() != CodeSegs.size()) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+
+  /// Collect the function types of the imported and defined functions for the
+  /// call instructions.
+  std::vector<const Runtime::Instance::FType *> FuncTypes;
+  for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+    const auto *FuncInst = *StoreMgr.getFunction(*ModInst.getFuncAddr(I));
+    FuncTypes.push_back(&FuncInst->getFuncType());
+  }
+  for (const auto TypeIdx : TypeIdxs) {
+    FuncTypes.push_back(*ModInst.getFuncType(TypeIdx));
+  }
+
   /// Iterate through code segments to make function instances.
   for (uint32_t I = 0; I < CodeSegs.size(); ++I) {
     /// Make a new function instance.
@@ -24,6 +44,29 @@ Expect<void> Interpreter::instantiate(
         ModInst.Addr, *FuncType, CodeSegs[I]->getLocals(),
         CodeSegs[I]->getInstrs());
 
+    /// Translate function body into byte code with the block costs and the
+    /// stack height. The functions in tiered execution count the loop
+    /// iterations, and are translated into register-based byte code when they
+    /// become hot.
+    Translator Trans(Measure);
+    Trans.setFuncTypes(ModInst, FuncTypes);
+    if (Tiered) {
+      Trans.setLoopCounting(ModInst.getFuncNum());
+    }
+    if (auto Res = Trans.translate(CodeSegs[I]->getInstrs(), Targets[I])) {
+      NewFuncInst->setByteCode(std::move(*Res));
+    } else {
+      return Unexpect(Res);
+    }
+    if (RegisterTier) {
+      RegisterTranslator RegTrans(ModInst, FuncTypes);
+      if (auto Res = RegTrans.translate(*NewFuncInst)) {
+        NewFuncInst->setRegCode(std::move(*Res), RegTrans.getSlotNum());
+      } else {
+        return Unexpect(Res);
+      }
+    }
+
     /// Insert function instance to store manager.
     uint32_t NewFuncInstAddr;
     if (InsMode == InstantiateMode::Instantiate) {
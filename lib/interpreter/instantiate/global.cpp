@@ -20,9 +20,11 @@ Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
 
   /// Insert the temp. module instance to Store.
   uint32_t TmpModInstAddr = StoreMgr.pushModule(TmpMod);
+  auto *TmpModInst = *StoreMgr.getModule(TmpModInstAddr);
+  StoreMgr.resolveModule(*TmpModInst);
 
   /// Push a new frame {TmpModInst:{globaddrs}, locals:none}
-  StackMgr.pushFrame(TmpModInstAddr, 0, 0);
+  StackMgr.pushFrame(TmpModInst, 0, 0);
 
   /// Instantiate and initialize globals.
   for (const auto &GlobSeg : GlobSec.getContent()) {
@@ -121,7 +121,8 @@ Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
       /// Import matching.
       const auto *TargetInst = *StoreMgr.getMemory(TargetAddr);
       const auto *MemLim = MemType->getLimit();
-      if (!isLimitMatched(TargetInst->getHasMax(), TargetInst->getMin(),
+      if (TargetInst->isShared() != MemLim->isShared() ||
+          !isLimitMatched(TargetInst->getHasMax(), TargetInst->getMin(),
                           TargetInst->getMax(), MemLim->hasMax(),
                           MemLim->getMin(), MemLim->getMax())) {
         return Unexpect(ErrCode::ImportNotMatch);
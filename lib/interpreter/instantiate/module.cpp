@@ -8,9 +8,9 @@ namespace SSVM {
 namespace Interpreter {
 
 /// Instantiate module instance. See "include/executor/Interpreter.h".
-Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
-                                      const AST::Module &Mod,
-                                      const std::string &Name) {
+Expect<void> Interpreter::instantiate(
+    Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
+    const std::vector<AST::BranchTargetVec> &Targets, const std::string &Name) {
   /// Reset store manager, stack manager, and instruction provider.
   StoreMgr.reset();
   StackMgr.reset();
@@ -37,8 +37,10 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     auto &FuncTypes = TypeSec->getContent();
     for (auto &FuncType : FuncTypes) {
       /// Copy param and return lists to module instance.
-      ModInst->addFuncType(FuncType->getParamTypes(),
-                           FuncType->getReturnTypes());
+      ModInst->addFuncType(
+          FuncType->getParamTypes(), FuncType->getReturnTypes(),
+          Runtime::Instance::getTypeID(FuncType->getParamTypes(),
+                                       FuncType->getReturnTypes()));
     }
   }
 
@@ -54,7 +56,8 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
   const AST::FunctionSection *FuncSec = Mod.getFunctionSection();
   const AST::CodeSection *CodeSec = Mod.getCodeSection();
   if (FuncSec != nullptr && CodeSec != nullptr) {
-    if (auto Res = instantiate(StoreMgr, *ModInst, *FuncSec, *CodeSec); !Res) {
+    if (auto Res = instantiate(StoreMgr, *ModInst, *FuncSec, *CodeSec, Targets);
+        !Res) {
       return Unexpect(Res);
     }
   }
@@ -83,11 +86,14 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     }
   }
 
+  /// Resolve the instances of module for accessing by index in execution.
+  StoreMgr.resolveModule(*ModInst);
+
   /// Initialize the tables and memories
   /// Make a new frame {ModInst, locals:none} and push
-  StackMgr.pushFrame(ModInst->Addr, /// Module address
-                     0,             /// Arity
-                     0              /// Coarity
+  StackMgr.pushFrame(ModInst, /// Module instance
+                     0,       /// Arity
+                     0        /// Coarity
   );
   std::vector<uint32_t> ElemOffsets, DataOffsets;
 
@@ -13,11 +13,11 @@ namespace SSVM {
 namespace Interpreter {
 
 /// Instantiate Wasm Module. See "include/interpreter/interpreter.h".
-Expect<void> Interpreter::instantiateModule(Runtime::StoreManager &StoreMgr,
-                                            const AST::Module &Mod,
-                                            const std::string &Name) {
+Expect<void> Interpreter::instantiateModule(
+    Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
+    const std::vector<AST::BranchTargetVec> &Targets, const std::string &Name) {
   InsMode = InstantiateMode::Instantiate;
-  return instantiate(StoreMgr, Mod, Name);
+  return instantiate(StoreMgr, Mod, Targets, Name);
 }
 
 /// Register host module. See "include/interpreter/interpreter.h".
@@ -54,15 +54,16 @@ Expect<void> Interpreter::registerModule(Runtime::StoreManager &StoreMgr,
     ModInst->addGlobalAddr(Addr);
     ModInst->exportGlobal(Glob.first, ModInst->getGlobalNum() - 1);
   }
+  StoreMgr.resolveModule(*ModInst);
   return {};
 }
 
 /// Register Wasm module. See "include/interpreter/interpreter.h".
-Expect<void> Interpreter::registerModule(Runtime::StoreManager &StoreMgr,
-                                         const AST::Module &Mod,
-                                         const std::string &Name = "") {
+Expect<void> Interpreter::registerModule(
+    Runtime::StoreManager &StoreMgr, const AST::Module &Mod,
+    const std::vector<AST::BranchTargetVec> &Targets, const std::string &Name) {
   InsMode = InstantiateMode::ImportWasm;
-  return instantiate(StoreMgr, Mod, Name);
+  return instantiate(StoreMgr, Mod, Targets, Name);
 }
 
 /// Invoke function. See "include/interpreter/interpreter.h".
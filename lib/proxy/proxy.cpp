@@ -35,7 +35,7 @@ Expect<void> restore(Runtime::StoreManager &StoreMgr,
         auto *GlobInst = *StoreMgr.getGlobal(*Res);
         ValVariant Val = static_cast<uint64_t>(
             std::stoull(It->GetArray()[1].GetString(), 0, 16));
-        GlobInst->getValue() = Val;
+        GlobInst->setValue(Val);
       } else {
         return Unexpect(Res);
       }
@@ -63,11 +63,64 @@ Expect<void> restore(Runtime::StoreManager &StoreMgr,
       }
     }
   }
+
+  /// Apply the memory deltas on the base in order.
+  rapidjson::Value::ConstMemberIterator ItDelta =
+      Doc.FindMember("memory_delta");
+  if (ItDelta != Doc.MemberEnd()) {
+    for (auto It = ItDelta->value.Begin(); It != ItDelta->value.End(); ++It) {
+      /// Get memory address, page size, and the changed ranges.
+      const uint32_t Idx = It->GetArray()[0].GetUint();
+      const uint32_t Pages = It->GetArray()[1].GetUint();
+      Runtime::Instance::MemoryInstance *MemInst = nullptr;
+      if (auto Res = ModInst->getMemAddr(Idx)) {
+        MemInst = *StoreMgr.getMemory(*Res);
+      } else {
+        return Unexpect(Res);
+      }
+      if (Pages > MemInst->getDataPageSize()) {
+        if (auto Res = MemInst->growPage(Pages - MemInst->getDataPageSize());
+            !Res) {
+          return Unexpect(Res);
+        }
+      }
+      for (const auto &Range : It->GetArray()[2].GetArray()) {
+        const uint32_t Offset = Range.GetArray()[0].GetUint();
+        const std::string &Hex = Range.GetArray()[1].GetString();
+        Bytes MemVec;
+        boost::algorithm::unhex(Hex.begin(), Hex.end(),
+                                std::back_inserter(MemVec));
+        if (auto Res = MemInst->setBytes(MemVec, Offset, 0, MemVec.size());
+            !Res) {
+          return Unexpect(Res);
+        }
+      }
+    }
+  }
   return {};
 }
 
-/// Snapshot to JSON.
-Expect<void> snapshot(Runtime::StoreManager &StoreMgr, rapidjson::Value &Doc,
+/// Start tracking the changes of memories from the restored state.
+Expect<void> track(Runtime::StoreManager &StoreMgr) {
+  /// Get instantiated active module instance.
+  Runtime::Instance::ModuleInstance *ModInst;
+  if (auto Res = StoreMgr.getActiveModule()) {
+    ModInst = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+  for (uint32_t I = 0; I < ModInst->getMemNum(); ++I) {
+    auto *MemInst = *StoreMgr.getMemory(*ModInst->getMemAddr(I));
+    if (auto Res = MemInst->trackDirtyPages(); !Res) {
+      return Unexpect(Res);
+    }
+  }
+  return {};
+}
+
+/// Snapshot to JSON. The memories are in the deltas from the tracked base.
+Expect<void> snapshot(Runtime::StoreManager &StoreMgr, const std::string &Base,
+                      rapidjson::Value &Doc,
                       rapidjson::Document::AllocatorType &Alloc) {
   /// Get instantiated active module instance.
   Runtime::Instance::ModuleInstance *ModInst;
@@ -102,30 +155,51 @@ Expect<void> snapshot(Runtime::StoreManager &StoreMgr, rapidjson::Value &Doc,
 
   /// Iterate Memory instances.
   if (ModInst->getMemNum() > 0) {
+    rapidjson::Value BaseStr;
+    BaseStr.SetString(Base.c_str(), Alloc);
+    Doc.AddMember("base", BaseStr, Alloc);
     rapidjson::Value MemArr(rapidjson::kArrayType);
     for (uint32_t I = 0; I < ModInst->getMemNum(); ++I) {
-      /// Get address and data to string.
+      /// Get address and the dirty pages.
       uint32_t MemAddr = *ModInst->getMemAddr(I);
       auto *MemInst = *StoreMgr.getMemory(MemAddr);
-      const std::vector<uint8_t> &Data = MemInst->getDataVector();
-      std::string DataHex;
-      boost::algorithm::hex_lower(Data.begin(), Data.end(),
-                                  std::back_inserter(DataHex));
-
-      /// Insert into memory array.
-      if (DataHex.length() > 0) {
-        rapidjson::Value MemData(rapidjson::kArrayType);
-        rapidjson::Value Idx(I);
-        rapidjson::Value MemStr;
-        MemStr.SetString(DataHex.c_str(), Alloc);
-        MemData.PushBack(Idx, Alloc);
-        MemData.PushBack(MemStr, Alloc);
-        MemArr.PushBack(MemData, Alloc);
+      const uint8_t *Data = MemInst->getDataPtr();
+      const std::vector<uint32_t> Pages = MemInst->getDirtyPages();
+
+      /// Merge the contiguous dirty pages into ranges.
+      const uint32_t PageSize =
+          Runtime::Instance::MemoryInstance::DirtyPageSize;
+      rapidjson::Value RangeArr(rapidjson::kArrayType);
+      for (uint32_t Begin = 0; Begin < Pages.size();) {
+        uint32_t End = Begin + 1;
+        while (End < Pages.size() && Pages[End] == Pages[End - 1] + 1) {
+          ++End;
+        }
+        const uint32_t Offset = Pages[Begin] * PageSize;
+        std::string DataHex;
+        boost::algorithm::hex_lower(Data + Offset,
+                                    Data + Offset + (End - Begin) * PageSize,
+                                    std::back_inserter(DataHex));
+        rapidjson::Value RangeData(rapidjson::kArrayType);
+        rapidjson::Value OffsetVal(Offset);
+        rapidjson::Value DataStr;
+        DataStr.SetString(DataHex.c_str(), Alloc);
+        RangeData.PushBack(OffsetVal, Alloc);
+        RangeData.PushBack(DataStr, Alloc);
+        RangeArr.PushBack(RangeData, Alloc);
+        Begin = End;
       }
+
+      /// Insert into memory delta array.
+      rapidjson::Value MemData(rapidjson::kArrayType);
+      rapidjson::Value Idx(I);
+      rapidjson::Value PageCnt(MemInst->getDataPageSize());
+      MemData.PushBack(Idx, Alloc);
+      MemData.PushBack(PageCnt, Alloc);
+      MemData.PushBack(RangeArr, Alloc);
+      MemArr.PushBack(MemData, Alloc);
     }
-    if (MemArr.Size() > 0) {
-      Doc.AddMember("memory", MemArr, Alloc);
-    }
+    Doc.AddMember("memory_delta", MemArr, Alloc);
   }
   return {};
 }
@@ -327,13 +401,22 @@ void Proxy::executeVM() {
     }
   }
 
-  /// Restore VM state.
+  /// Restore VM state, and track the changes from it. The snapshot ID is the
+  /// base of the output snapshot.
+  std::string Base;
   if (Status == ErrCode::Success &&
       InputDoc["execution"].FindMember("vm_snapshot") !=
           InputDoc["execution"].MemberEnd()) {
-    if (auto Res = restore(VMUnit->getStoreManager(),
-                           InputDoc["execution"]["vm_snapshot"]);
-        !Res) {
+    const auto &Snapshot = InputDoc["execution"]["vm_snapshot"];
+    if (Snapshot.FindMember("id") != Snapshot.MemberEnd()) {
+      Base = Snapshot["id"].GetString();
+    }
+    if (auto Res = restore(VMUnit->getStoreManager(), Snapshot); !Res) {
+      Status = Res.error();
+    }
+  }
+  if (Status == ErrCode::Success) {
+    if (auto Res = track(VMUnit->getStoreManager()); !Res) {
       Status = Res.error();
     }
   }
@@ -383,8 +466,8 @@ void Proxy::executeVM() {
 
   /// Snapshot VM
   if (Status == ErrCode::Success) {
-    snapshot(VMUnit->getStoreManager(), OutputDoc["result"]["vm_snapshot"],
-             Allocator);
+    snapshot(VMUnit->getStoreManager(), Base,
+             OutputDoc["result"]["vm_snapshot"], Allocator);
   }
 }
 
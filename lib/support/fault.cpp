@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "support/fault.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include <signal.h>
+
+namespace SSVM {
+namespace Support {
+
+namespace {
+
+/// The 47-bit user address space holds at most 32768 reserved 4 GiB regions.
+constexpr const uint32_t MaxRegion = 32768;
+
+/// Registered regions of [Begin, End). The free slots have Begin of 0, and
+/// the slots being registered have Begin of Claimed. The registry is lock-free,
+/// so that the signal handler can read it.
+constexpr const uintptr_t Claimed = 1;
+std::atomic<uintptr_t> RegionBegin[MaxRegion];
+std::atomic<uintptr_t> RegionEnd[MaxRegion];
+std::atomic<uint32_t> RegionCnt{0};
+
+thread_local Fault *Current = nullptr;
+
+struct sigaction PrevSegv;
+struct sigaction PrevBus;
+std::once_flag InstallFlag;
+
+bool isInRegion(const uintptr_t Addr) {
+  const uint32_t Cnt = RegionCnt.load(std::memory_order_acquire);
+  for (uint32_t I = 0; I < Cnt; ++I) {
+    const uintptr_t Begin = RegionBegin[I].load(std::memory_order_acquire);
+    if (Begin > Claimed && Begin <= Addr &&
+        Addr < RegionEnd[I].load(std::memory_order_acquire)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void signalHandler(int Sig, siginfo_t *Info, void *Ctx) {
+  if (Current != nullptr && Current->getAccess() != nullptr &&
+      isInRegion(reinterpret_cast<uintptr_t>(Info->si_addr))) {
+    Current->jump();
+  }
+
+  /// Not a fault of guarded memory. Pass to the previous handler.
+  const struct sigaction &Prev = (Sig == SIGSEGV) ? PrevSegv : PrevBus;
+  if (Prev.sa_flags & SA_SIGINFO) {
+    Prev.sa_sigaction(Sig, Info, Ctx);
+  } else if (Prev.sa_handler == SIG_DFL || Prev.sa_handler == SIG_IGN) {
+    /// Restore the previous action, and the faulting instruction will raise
+    /// the signal again after return.
+    sigaction(Sig, &Prev, nullptr);
+  } else {
+    Prev.sa_handler(Sig);
+  }
+}
+
+void installHandler() {
+  struct sigaction Action {};
+  Action.sa_sigaction = &signalHandler;
+  /// Not to block the signal in the handler, because it may jump out. The
+  /// faults of guarded memory are raised with room on the thread stack, so
+  /// the handler runs there.
+  Action.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sigemptyset(&Action.sa_mask);
+  sigaction(SIGSEGV, &Action, &PrevSegv);
+  sigaction(SIGBUS, &Action, &PrevBus);
+}
+
+} // namespace
+
+Fault::Fault() : Prev(Current) { Current = this; }
+
+Fault::~Fault() { Current = Prev; }
+
+void Fault::jump() {
+  /// Restore the previous handler before jumping out of the frames.
+  Current = Prev;
+  siglongjmp(Buffer, 1);
+}
+
+bool Fault::registerRegion(const void *Begin, const size_t Size) {
+  std::call_once(InstallFlag, installHandler);
+  const uintptr_t B = reinterpret_cast<uintptr_t>(Begin);
+  for (uint32_t I = 0; I < MaxRegion; ++I) {
+    /// Claim the slot first, and publish the begin after the end, so that the
+    /// handler never sees a half-registered region.
+    uintptr_t Free = 0;
+    if (RegionBegin[I].load(std::memory_order_relaxed) == 0 &&
+        RegionBegin[I].compare_exchange_strong(Free, Claimed,
+                                               std::memory_order_acq_rel)) {
+      RegionEnd[I].store(B + Size, std::memory_order_release);
+      RegionBegin[I].store(B, std::memory_order_release);
+      uint32_t Cnt = RegionCnt.load(std::memory_order_relaxed);
+      while (Cnt < I + 1 && !RegionCnt.compare_exchange_weak(
+                                Cnt, I + 1, std::memory_order_acq_rel)) {
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void Fault::unregisterRegion(const void *Begin) {
+  const uintptr_t B = reinterpret_cast<uintptr_t>(Begin);
+  const uint32_t Cnt = RegionCnt.load(std::memory_order_acquire);
+  for (uint32_t I = 0; I < Cnt; ++I) {
+    if (RegionBegin[I].load(std::memory_order_relaxed) == B) {
+      RegionBegin[I].store(0, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+} // namespace Support
+} // namespace SSVM
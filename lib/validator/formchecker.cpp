@@ -10,6 +10,7 @@ void FormChecker::reset(bool CleanGlobal) {
   CtrlStack.clear();
   Locals.clear();
   Returns.clear();
+  BrTargets.clear();
 
   if (CleanGlobal) {
     Types.clear();
@@ -18,6 +19,7 @@ void FormChecker::reset(bool CleanGlobal) {
     Mems.clear();
     Globals.clear();
     NumImportGlobals = 0;
+    Datas = 0;
   }
 }
 
@@ -64,6 +66,8 @@ void FormChecker::addMemory(const AST::MemoryType &Mem) {
   Mems.emplace_back(Mems.size());
 }
 
+void FormChecker::addData(const uint32_t &Cnt) { Datas = Cnt; }
+
 void FormChecker::addGlobal(const AST::GlobalType &Glob, const bool IsImport) {
   /// Type in global is comfirmed in loading phase.
   Globals.emplace_back(ASTToVType(Glob.getValueType()),
@@ -89,6 +93,8 @@ VType FormChecker::ASTToVType(const ValType &V) {
     return VType::F32;
   case ValType::F64:
     return VType::F64;
+  case ValType::V128:
+    return VType::V128;
   default:
     return VType::Unknown;
   }
@@ -213,8 +219,11 @@ Expect<void> FormChecker::checkInstr(const AST::BrControlInstruction &Instr) {
     /// Branch out of stack
     return Unexpect(ErrCode::ValidationFailed);
   }
+  /// The resolved targets are recorded in the order of branches for
+  /// execution.
   switch (Instr.getOpCode()) {
   case OpCode::Br: {
+    BrTargets.push_back(getBranchTarget(N));
     if (auto Res = popTypes(CtrlStack[N].LabelTypes); !Res) {
       return Unexpect(Res);
     }
@@ -224,6 +233,7 @@ Expect<void> FormChecker::checkInstr(const AST::BrControlInstruction &Instr) {
     if (auto Res = popType(VType::I32); !Res) {
       return Unexpect(Res);
     }
+    BrTargets.push_back(getBranchTarget(N));
     if (auto Res = popTypes(CtrlStack[N].LabelTypes); !Res) {
       return Unexpect(Res);
     }
@@ -260,6 +270,10 @@ FormChecker::checkInstr(const AST::BrTableControlInstruction &Instr) {
     if (auto Res = popType(VType::I32); !Res) {
       return Unexpect(Res);
     }
+    for (auto &N : Instr.getLabelTable()) {
+      BrTargets.push_back(getBranchTarget(N));
+    }
+    BrTargets.push_back(getBranchTarget(M));
     if (auto Res = popTypes(CtrlStack[M].LabelTypes); !Res) {
       return Unexpect(Res);
     }
@@ -273,15 +287,18 @@ FormChecker::checkInstr(const AST::BrTableControlInstruction &Instr) {
 
 Expect<void> FormChecker::checkInstr(const AST::CallControlInstruction &Instr) {
   auto N = Instr.getFuncIndex();
+  uint32_t TypeIdx = 0;
   switch (Instr.getOpCode()) {
-  case OpCode::Call: {
+  case OpCode::Call:
+  case OpCode::Return_call:
     if (Funcs.size() <= N) {
       /// Call function index out of range
       return Unexpect(ErrCode::ValidationFailed);
     }
-    return StackTrans({Types[Funcs[N]].first}, {Types[Funcs[N]].second});
-  }
-  case OpCode::Call_indirect: {
+    TypeIdx = Funcs[N];
+    break;
+  case OpCode::Call_indirect:
+  case OpCode::Return_call_indirect:
     if (Tables.size() == 0) {
       return Unexpect(ErrCode::ValidationFailed);
     }
@@ -295,12 +312,24 @@ Expect<void> FormChecker::checkInstr(const AST::CallControlInstruction &Instr) {
     if (auto Res = popType(VType::I32); !Res) {
       return Unexpect(Res);
     }
-    return StackTrans({Types[N].first}, {Types[N].second});
-  }
-  default:
+    TypeIdx = N;
     break;
+  default:
+    return Unexpect(ErrCode::ValidationFailed);
   }
-  return Unexpect(ErrCode::ValidationFailed);
+
+  if (!Instr.isTailCall()) {
+    return StackTrans({Types[TypeIdx].first}, {Types[TypeIdx].second});
+  }
+  /// Tail call returns the results of callee, which should be the same as the
+  /// results of the current function.
+  if (Types[TypeIdx].second != Returns) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+  if (auto Res = popTypes(Types[TypeIdx].first); !Res) {
+    return Unexpect(Res);
+  }
+  return unreachable();
 }
 
 Expect<void> FormChecker::checkInstr(const AST::ParametricInstruction &Instr) {
@@ -388,6 +417,17 @@ Expect<void> FormChecker::checkInstr(const AST::VariableInstruction &Instr) {
 }
 
 Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
+  /// Data segment index must exist in memory.init and data.drop.
+  if (Instr.getOpCode() == OpCode::Memory__init ||
+      Instr.getOpCode() == OpCode::Data__drop) {
+    if (Instr.getDataIndex() >= Datas) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+  }
+  if (Instr.getOpCode() == OpCode::Data__drop) {
+    return {};
+  }
+
   /// Memory[0] must exist
   if (Mems.size() == 0) {
     return Unexpect(ErrCode::ValidationFailed);
@@ -439,6 +479,9 @@ Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
     break;
   case OpCode::Memory__size:
   case OpCode::Memory__grow:
+  case OpCode::Memory__init:
+  case OpCode::Memory__copy:
+  case OpCode::Memory__fill:
     break;
   default:
     return Unexpect(ErrCode::ValidationFailed);
@@ -481,6 +524,10 @@ Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
     return StackTrans({}, {VType::I32});
   case OpCode::Memory__grow:
     return StackTrans({VType::I32}, {VType::I32});
+  case OpCode::Memory__init:
+  case OpCode::Memory__copy:
+  case OpCode::Memory__fill:
+    return StackTrans({VType::I32, VType::I32, VType::I32}, {});
   default:
     break;
   }
@@ -675,6 +722,197 @@ FormChecker::checkInstr(const AST::BinaryNumericInstruction &Instr) {
   return Unexpect(ErrCode::ValidationFailed);
 }
 
+Expect<void> FormChecker::checkInstr(const AST::SIMDInstruction &Instr) {
+  using AST::SIMDCode;
+  const VType V128 = VType::V128;
+
+  /// Lane index must be less than the lane count.
+  uint32_t LaneNum = 0;
+  switch (Instr.getSIMDCode()) {
+  case SIMDCode::I8x16__extract_lane_s:
+  case SIMDCode::I8x16__extract_lane_u:
+  case SIMDCode::I8x16__replace_lane:
+    LaneNum = 16;
+    break;
+  case SIMDCode::I16x8__extract_lane_s:
+  case SIMDCode::I16x8__extract_lane_u:
+  case SIMDCode::I16x8__replace_lane:
+    LaneNum = 8;
+    break;
+  case SIMDCode::I32x4__extract_lane:
+  case SIMDCode::I32x4__replace_lane:
+  case SIMDCode::F32x4__extract_lane:
+  case SIMDCode::F32x4__replace_lane:
+    LaneNum = 4;
+    break;
+  case SIMDCode::I64x2__extract_lane:
+  case SIMDCode::I64x2__replace_lane:
+  case SIMDCode::F64x2__extract_lane:
+  case SIMDCode::F64x2__replace_lane:
+    LaneNum = 2;
+    break;
+  default:
+    break;
+  }
+  if (LaneNum > 0 && Instr.getLaneIndex() >= LaneNum) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+
+  switch (Instr.getSIMDCode()) {
+  case SIMDCode::V128__load:
+  case SIMDCode::V128__store:
+    /// Memory[0] must exist and 2 ^ align needs to <= 16.
+    if (Mems.size() == 0 || Instr.getMemoryAlign() > 4) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    if (Instr.getSIMDCode() == SIMDCode::V128__load) {
+      return StackTrans({VType::I32}, {V128});
+    }
+    return StackTrans({VType::I32, V128}, {});
+
+  case SIMDCode::V128__const:
+    return StackTrans({}, {V128});
+
+  case SIMDCode::I8x16__shuffle:
+    /// Shuffle lane indices must be less than 32.
+    for (uint32_t I = 0; I < 16; ++I) {
+      if (((Instr.getValue() >> (I * 8)) & 0xFFU) >= 32) {
+        return Unexpect(ErrCode::ValidationFailed);
+      }
+    }
+    return StackTrans({V128, V128}, {V128});
+
+  case SIMDCode::I8x16__splat:
+  case SIMDCode::I16x8__splat:
+  case SIMDCode::I32x4__splat:
+    return StackTrans({VType::I32}, {V128});
+  case SIMDCode::I64x2__splat:
+    return StackTrans({VType::I64}, {V128});
+  case SIMDCode::F32x4__splat:
+    return StackTrans({VType::F32}, {V128});
+  case SIMDCode::F64x2__splat:
+    return StackTrans({VType::F64}, {V128});
+
+  case SIMDCode::I8x16__extract_lane_s:
+  case SIMDCode::I8x16__extract_lane_u:
+  case SIMDCode::I16x8__extract_lane_s:
+  case SIMDCode::I16x8__extract_lane_u:
+  case SIMDCode::I32x4__extract_lane:
+    return StackTrans({V128}, {VType::I32});
+  case SIMDCode::I64x2__extract_lane:
+    return StackTrans({V128}, {VType::I64});
+  case SIMDCode::F32x4__extract_lane:
+    return StackTrans({V128}, {VType::F32});
+  case SIMDCode::F64x2__extract_lane:
+    return StackTrans({V128}, {VType::F64});
+
+  case SIMDCode::I8x16__replace_lane:
+  case SIMDCode::I16x8__replace_lane:
+  case SIMDCode::I32x4__replace_lane:
+    return StackTrans({V128, VType::I32}, {V128});
+  case SIMDCode::I64x2__replace_lane:
+    return StackTrans({V128, VType::I64}, {V128});
+  case SIMDCode::F32x4__replace_lane:
+    return StackTrans({V128, VType::F32}, {V128});
+  case SIMDCode::F64x2__replace_lane:
+    return StackTrans({V128, VType::F64}, {V128});
+
+  case SIMDCode::V128__not:
+  case SIMDCode::I8x16__abs:
+  case SIMDCode::I8x16__neg:
+  case SIMDCode::I16x8__abs:
+  case SIMDCode::I16x8__neg:
+  case SIMDCode::I32x4__abs:
+  case SIMDCode::I32x4__neg:
+  case SIMDCode::I64x2__abs:
+  case SIMDCode::I64x2__neg:
+  case SIMDCode::F32x4__abs:
+  case SIMDCode::F32x4__neg:
+  case SIMDCode::F32x4__sqrt:
+  case SIMDCode::F64x2__abs:
+  case SIMDCode::F64x2__neg:
+  case SIMDCode::F64x2__sqrt:
+  case SIMDCode::I32x4__trunc_sat_f32x4_s:
+  case SIMDCode::I32x4__trunc_sat_f32x4_u:
+  case SIMDCode::F32x4__convert_i32x4_s:
+  case SIMDCode::F32x4__convert_i32x4_u:
+    return StackTrans({V128}, {V128});
+
+  case SIMDCode::V128__any_true:
+  case SIMDCode::I8x16__all_true:
+  case SIMDCode::I8x16__bitmask:
+  case SIMDCode::I16x8__all_true:
+  case SIMDCode::I16x8__bitmask:
+  case SIMDCode::I32x4__all_true:
+  case SIMDCode::I32x4__bitmask:
+  case SIMDCode::I64x2__all_true:
+  case SIMDCode::I64x2__bitmask:
+    return StackTrans({V128}, {VType::I32});
+
+  case SIMDCode::I8x16__shl:
+  case SIMDCode::I8x16__shr_s:
+  case SIMDCode::I8x16__shr_u:
+  case SIMDCode::I16x8__shl:
+  case SIMDCode::I16x8__shr_s:
+  case SIMDCode::I16x8__shr_u:
+  case SIMDCode::I32x4__shl:
+  case SIMDCode::I32x4__shr_s:
+  case SIMDCode::I32x4__shr_u:
+  case SIMDCode::I64x2__shl:
+  case SIMDCode::I64x2__shr_s:
+  case SIMDCode::I64x2__shr_u:
+    return StackTrans({V128, VType::I32}, {V128});
+
+  case SIMDCode::V128__bitselect:
+    return StackTrans({V128, V128, V128}, {V128});
+
+  default:
+    /// Others are binary operations of two v128 values.
+    return StackTrans({V128, V128}, {V128});
+  }
+}
+
+Expect<void>
+FormChecker::checkInstr(const AST::AtomicMemoryInstruction &Instr) {
+  using AST::AtomicCode;
+  const AtomicCode Code = Instr.getAtomicCode();
+  if (Code == AtomicCode::Atomic__fence) {
+    return {};
+  }
+
+  /// Memory[0] must exist and 2 ^ align must equal to the access size.
+  if (Mems.size() == 0 || Instr.getMemoryAlign() >= 32 ||
+      (1U << Instr.getMemoryAlign()) != Instr.getAccessSize()) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
+
+  const VType I32 = VType::I32;
+  const VType T = Instr.isI64() ? VType::I64 : VType::I32;
+  switch (Code) {
+  case AtomicCode::Memory__atomic__notify:
+    return StackTrans({I32, I32}, {I32});
+  case AtomicCode::Memory__atomic__wait32:
+  case AtomicCode::Memory__atomic__wait64:
+    return StackTrans({I32, T, VType::I64}, {I32});
+  default:
+    break;
+  }
+  switch (Instr.getOperandNum()) {
+  case 1:
+    /// Loads.
+    return StackTrans({I32}, {T});
+  case 2:
+    /// Stores and read-modify-writes.
+    if (Instr.hasResult()) {
+      return StackTrans({I32, T}, {T});
+    }
+    return StackTrans({I32, T}, {});
+  default:
+    /// Compare exchanges.
+    return StackTrans({I32, T, T}, {T});
+  }
+}
+
 void FormChecker::pushType(VType V) { ValStack.emplace_front(V); }
 
 void FormChecker::pushTypes(const std::vector<VType> &Input) {
@@ -750,6 +988,15 @@ Expect<std::vector<VType>> FormChecker::popCtrl() {
   return Head.EndTypes;
 }
 
+AST::BranchTarget FormChecker::getBranchTarget(const uint32_t N) const {
+  const uint32_t Arity = CtrlStack[N].LabelTypes.size();
+  const size_t Height = CtrlStack[N].Height + Arity;
+  /// The stack may be lower than the target label in unreachable code.
+  return {static_cast<uint32_t>(
+              (ValStack.size() > Height) ? ValStack.size() - Height : 0),
+          Arity};
+}
+
 Expect<void> FormChecker::unreachable() {
   while (ValStack.size() > CtrlStack[0].Height) {
     if (auto Res = popType(); !Res) {
@@ -12,6 +12,7 @@ namespace Validator {
 Expect<void> Validator::validate(const AST::Module &Mod) {
   /// https://webassembly.github.io/spec/core/valid/modules.html
   Checker.reset(true);
+  BranchTargets.clear();
 
   /// Register type definitions into FormChecker.
   if (Mod.getTypeSection()) {
@@ -48,6 +49,18 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     }
   }
 
+  /// Register data segment count into FormChecker. The data count section is
+  /// needed by memory.init and data.drop, and must match the data section.
+  if (Mod.getDataCountSection() != nullptr) {
+    const uint32_t DataCnt = Mod.getDataCountSection()->getContent();
+    const uint32_t SegCnt =
+        Mod.getDataSection() ? Mod.getDataSection()->getContent().size() : 0;
+    if (DataCnt != SegCnt) {
+      return Unexpect(ErrCode::ValidationFailed);
+    }
+    Checker.addData(DataCnt);
+  }
+
   /// Validate function section and code section.
   if ((Mod.getFunctionSection() && !Mod.getCodeSection()) ||
       (!Mod.getFunctionSection() && Mod.getCodeSection())) {
@@ -118,7 +131,10 @@ Expect<void> Validator::validate(const AST::FunctionType &Func) {
 
 /// Validate Table type. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::TableType &Tab) {
-  /// Validate table limits.
+  /// Validate table limits. Only memories can be shared.
+  if (Tab.getLimit()->isShared()) {
+    return Unexpect(ErrCode::ValidationFailed);
+  }
   return validate(*Tab.getLimit(), LIMIT_TABLETYPE);
 }
 
@@ -169,13 +185,22 @@ Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
       Checker.addLocal(Val.second);
     }
   }
-  /// Validate function body expression.
-  return Checker.validate(CodeSeg.getInstrs(),
-                          Checker.getTypes()[TypeIdx].second);
+  /// Validate function body expression, and keep the branch targets.
+  if (auto Res = Checker.validate(CodeSeg.getInstrs(),
+                                  Checker.getTypes()[TypeIdx].second);
+      !Res) {
+    return Unexpect(Res);
+  }
+  BranchTargets.push_back(std::move(Checker.getBranchTargets()));
+  return {};
 }
 
 /// Validate Data segment. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::DataSegment &DataSeg) {
+  /// Passive data segment has no memory index and offset.
+  if (DataSeg.isPassive()) {
+    return {};
+  }
   /// Check memory index in context.
   const auto &MemVec = Checker.getMemories();
   if (DataSeg.getIdx() >= MemVec.size()) {
@@ -400,7 +425,7 @@ Expect<void> Validator::validateConstExpr(const AST::InstrVec &Instrs,
                                           const std::vector<ValType> &Returns,
                                           const bool RestrictGlobal) {
   for (auto &Instr : Instrs) {
-    /// Only these 5 instructions are constant.
+    /// Only these 5 instructions and the v128.const are constant.
     switch (Instr->getOpCode()) {
     case OpCode::Global__get:
       /// For global initialization case, global indices must be imported
@@ -416,6 +441,12 @@ Expect<void> Validator::validateConstExpr(const AST::InstrVec &Instrs,
     case OpCode::F32__const:
     case OpCode::F64__const:
       break;
+    case OpCode::SIMD:
+      if (static_cast<AST::SIMDInstruction *>(Instr.get())->getSIMDCode() !=
+          AST::SIMDCode::V128__const) {
+        return Unexpect(ErrCode::ValidationFailed);
+      }
+      break;
     default:
       return Unexpect(ErrCode::ValidationFailed);
     }
@@ -226,6 +226,7 @@ TEST(InstructionTest, LoadCallControlInstruction) {
   ///   1.  Load invalid empty instruction body.
   ///   2.  Load valid type index.
   ///   3.  Load valid function index.
+  ///   4.  Load valid function and type index of tail calls.
   SSVM::AST::Instruction::OpCode Op1 = SSVM::AST::Instruction::OpCode::Call;
   SSVM::AST::Instruction::OpCode Op2 =
       SSVM::AST::Instruction::OpCode::Call_indirect;
@@ -253,6 +254,20 @@ TEST(InstructionTest, LoadCallControlInstruction) {
   Mgr.setCode(Vec3);
   SSVM::AST::CallControlInstruction Ins4(Op2);
   EXPECT_TRUE(Ins4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  Mgr.setCode(Vec2);
+  SSVM::AST::CallControlInstruction Ins5(
+      SSVM::AST::Instruction::OpCode::Return_call);
+  EXPECT_TRUE(Ins5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins5.isTailCall() && !Ins5.isIndirect());
+
+  Mgr.clearBuffer();
+  Mgr.setCode(Vec3);
+  SSVM::AST::CallControlInstruction Ins6(
+      SSVM::AST::Instruction::OpCode::Return_call_indirect);
+  EXPECT_TRUE(Ins6.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins6.isTailCall() && Ins6.isIndirect());
 }
 
 TEST(InstructionTest, LoadVariableInstruction) {
@@ -283,6 +298,8 @@ TEST(InstructionTest, LoadMemoryInstruction) {
   ///   2.  Load invalid memory size or grow instruction.
   ///   3.  Load valid memory args.
   ///   4.  Load valid memory size instruction.
+  ///   5.  Load valid memory init instruction.
+  ///   6.  Load invalid memory copy instruction with non-zero memory index.
   SSVM::AST::Instruction::OpCode Op1 =
       SSVM::AST::Instruction::OpCode::I32__load;
   SSVM::AST::Instruction::OpCode Op2 =
@@ -319,6 +336,26 @@ TEST(InstructionTest, LoadMemoryInstruction) {
   Mgr.setCode(Vec4);
   SSVM::AST::MemoryInstruction Ins5(Op2);
   EXPECT_TRUE(Ins5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x83U, 0x80U, 0x80U, 0x80U, 0x00U, /// Data index.
+      0x00U                              /// Memory index.
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::MemoryInstruction Ins6(
+      SSVM::AST::Instruction::OpCode::Memory__init);
+  EXPECT_TRUE(Ins6.loadBinary(Mgr) && Mgr.getRemainSize() == 0 &&
+              Ins6.getDataIndex() == 3);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec6 = {
+      0x00U, 0x01U /// Invalid memory indices.
+  };
+  Mgr.setCode(Vec6);
+  SSVM::AST::MemoryInstruction Ins7(
+      SSVM::AST::Instruction::OpCode::Memory__copy);
+  EXPECT_FALSE(Ins7.loadBinary(Mgr));
 }
 
 TEST(InstructionTest, LoadConstInstruction) {
@@ -375,4 +412,136 @@ TEST(InstructionTest, LoadConstInstruction) {
   EXPECT_TRUE(Ins5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
 }
 
+TEST(InstructionTest, LoadSIMDInstruction) {
+  /// 9. Test SIMD instructions.
+  ///
+  ///   1.  Load invalid empty SIMD instruction.
+  ///   2.  Load invalid unknown sub-opcode.
+  ///   3.  Load v128.load instruction.
+  ///   4.  Load v128.const instruction.
+  ///   5.  Load i32x4.extract_lane instruction.
+  ///   6.  Load i32x4.add instruction with 2-byte sub-opcode.
+  SSVM::AST::Instruction::OpCode Op = SSVM::AST::Instruction::OpCode::SIMD;
+
+  Mgr.clearBuffer();
+  SSVM::AST::SIMDInstruction Ins1(Op);
+  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x62U /// Unsupported sub-opcode.
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::SIMDInstruction Ins2(Op);
+  EXPECT_FALSE(Ins2.loadBinary(Mgr));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x00U,       /// v128.load
+      0x04U, 0x10U /// Align and offset.
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::SIMDInstruction Ins3(Op);
+  EXPECT_TRUE(Ins3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x0CU,                                          /// v128.const
+      0x01U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, /// Low 64 bits.
+      0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x80U  /// High 64 bits.
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::SIMDInstruction Ins4(Op);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins4.getValue() ==
+              ((static_cast<SSVM::uint128_t>(1U) << 127) | 1U));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x1BU, /// i32x4.extract_lane
+      0x03U  /// Lane index.
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::SIMDInstruction Ins5(Op);
+  EXPECT_TRUE(Ins5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Ins5.getLaneIndex(), 3U);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec6 = {
+      0xAEU, 0x01U /// i32x4.add
+  };
+  Mgr.setCode(Vec6);
+  SSVM::AST::SIMDInstruction Ins6(Op);
+  EXPECT_TRUE(Ins6.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins6.getSIMDCode() == SSVM::AST::SIMDCode::I32x4__add);
+}
+
+TEST(InstructionTest, LoadAtomicMemoryInstruction) {
+  /// 10. Test atomic memory instructions.
+  ///
+  ///   1.  Load invalid empty atomic instruction.
+  ///   2.  Load invalid unknown sub-opcode.
+  ///   3.  Load invalid atomic.fence with non-zero reserved byte.
+  ///   4.  Load atomic.fence instruction.
+  ///   5.  Load i64.atomic.rmw16.cmpxchg_u instruction.
+  ///   6.  Load memory.atomic.wait32 instruction.
+  SSVM::AST::Instruction::OpCode Op = SSVM::AST::Instruction::OpCode::Atomic;
+
+  Mgr.clearBuffer();
+  SSVM::AST::AtomicMemoryInstruction Ins1(Op);
+  EXPECT_FALSE(Ins1.loadBinary(Mgr));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x04U /// Unsupported sub-opcode.
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::AtomicMemoryInstruction Ins2(Op);
+  EXPECT_FALSE(Ins2.loadBinary(Mgr));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x03U, /// atomic.fence
+      0x01U  /// Invalid reserved byte.
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::AtomicMemoryInstruction Ins3(Op);
+  EXPECT_FALSE(Ins3.loadBinary(Mgr));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x03U, /// atomic.fence
+      0x00U  /// Reserved byte.
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::AtomicMemoryInstruction Ins4(Op);
+  EXPECT_TRUE(Ins4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins4.getOperandNum() == 0 && !Ins4.hasResult());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x4DU,       /// i64.atomic.rmw16.cmpxchg_u
+      0x01U, 0x08U /// Align and offset.
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::AtomicMemoryInstruction Ins5(Op);
+  EXPECT_TRUE(Ins5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Ins5.getAccessSize(), 2U);
+  EXPECT_TRUE(Ins5.isI64() && Ins5.hasResult());
+  EXPECT_EQ(Ins5.getOperandNum(), 3U);
+  EXPECT_EQ(Ins5.getMemoryOffset(), 8U);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec6 = {
+      0x01U,       /// memory.atomic.wait32
+      0x02U, 0x00U /// Align and offset.
+  };
+  Mgr.setCode(Vec6);
+  SSVM::AST::AtomicMemoryInstruction Ins6(Op);
+  EXPECT_TRUE(Ins6.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Ins6.getAtomicCode() ==
+              SSVM::AST::AtomicCode::Memory__atomic__wait32);
+  EXPECT_EQ(Ins6.getOperandNum(), 3U);
+}
+
 } // namespace
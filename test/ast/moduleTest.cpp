@@ -78,7 +78,8 @@ TEST(ModuleTest, LoadInvalidSecModule) {
       0x09U, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U, /// Element section
       0x0AU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U, /// Code section
       0x0BU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U, /// Data section
-      0x0CU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U  /// Invalid section
+      0x0CU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U, /// Data count section
+      0x0DU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U  /// Invalid section
   };
   Mgr.setCode(Vec);
   EXPECT_FALSE(Mod.loadBinary(Mgr));
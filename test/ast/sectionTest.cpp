@@ -506,17 +506,20 @@ TEST(SectionTest, LoadDataSection) {
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec4 = {
-      0xABU, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 43
+      0xAEU, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 46
       0x03U,                             /// Vector length = 3
       /// vec[0]
+      0x02U,                             /// Flag with memory index
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U, /// Vector length = 4, "test"
       /// vec[1]
+      0x02U,                             /// Flag with memory index
       0xF9U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U, /// Vector length = 4, "test"
       /// vec[2]
+      0x02U,                             /// Flag with memory index
       0xF0U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U  /// Vector length = 4, "test"
@@ -26,6 +26,8 @@ TEST(TypeTest, LoadLimit) {
   ///   3.  Load limit with only min.
   ///   4.  Load invalid limit with fail of loading max.
   ///   5.  Load limit with min and max.
+  ///   6.  Load invalid shared limit without max.
+  ///   7.  Load shared limit with min and max.
   Mgr.clearBuffer();
   SSVM::AST::Limit Lim1;
   EXPECT_FALSE(Lim1.loadBinary(Mgr));
@@ -66,6 +68,27 @@ TEST(TypeTest, LoadLimit) {
   Mgr.setCode(Vec5);
   SSVM::AST::Limit Lim5;
   EXPECT_TRUE(Lim5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_FALSE(Lim5.isShared());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec6 = {
+      0x03U, /// Shared with min and max
+      0x01U  /// Min = 1
+  };
+  Mgr.setCode(Vec6);
+  SSVM::AST::Limit Lim6;
+  EXPECT_FALSE(Lim6.loadBinary(Mgr));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec7 = {
+      0x03U, /// Shared with min and max
+      0x01U, /// Min = 1
+      0x10U  /// Max = 16
+  };
+  Mgr.setCode(Vec7);
+  SSVM::AST::Limit Lim7;
+  EXPECT_TRUE(Lim7.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Lim7.isShared() && Lim7.hasMax() && Lim7.getMax() == 16);
 }
 
 TEST(TypeTest, LoadFunctionType) {
@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/atomicTest.cpp - Atomic execution tests -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the atomic memory instructions
+/// and the parallel execution on the shared memory.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace SSVM::Test;
+using SSVM::ErrCode;
+using SSVM::ValVariant;
+using SSVM::ExpVM::Configure;
+using Values = std::vector<uint64_t>;
+
+/// Memory argument of the natural alignment.
+SSVM::Bytes arg32(uint32_t Offset) { return code({{0x02}, leb(Offset)}); }
+SSVM::Bytes arg64(uint32_t Offset) { return code({{0x03}, leb(Offset)}); }
+
+/// Module adding 1 to the counter at address 0 for the times of parameter.
+SSVM::Bytes counterModule() {
+  ModuleBuilder B;
+  const uint32_t T0 = B.addType({0x7F}, {});
+  const uint32_t T1 = B.addType({}, {0x7F});
+  B.setMemory(1, 1, true);
+  B.addFunc(T0,
+            code({{0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x45, 0x0D, 0x01},
+                  i32Const(0), i32Const(1), atomic(0x1E), arg32(0),
+                  {0x1A, 0x20, 0x00}, i32Const(1),
+                  {0x6B, 0x21, 0x00, 0x0C, 0x00, 0x0B, 0x0B}}),
+            {}, "add");
+  B.addFunc(T1, code({i32Const(0), atomic(0x10), arg32(0)}), {}, "get");
+  return B.build();
+}
+
+TEST(AtomicTest, Instructions) {
+  const std::vector<std::pair<SSVM::Bytes, ErrCode>> Cases = {
+      /// i32.atomic.rmw.add returns the old values.
+      {code({i32Const(0), i32Const(5), atomic(0x1E), arg32(0), {0x1A},
+             i32Const(0), i32Const(7), atomic(0x1E), arg32(0), i32Const(0),
+             atomic(0x10), arg32(0), {0x6C}}),
+       ErrCode::Success},
+      /// i32.atomic.rmw.cmpxchg stores only on the expected value.
+      {code({i32Const(8), i32Const(3), atomic(0x17), arg32(0), i32Const(8),
+             i32Const(3), i32Const(9), atomic(0x48), arg32(0), i32Const(8),
+             i32Const(3), i32Const(11), atomic(0x48), arg32(0), {0x6A},
+             i32Const(8), atomic(0x10), arg32(0), {0x6A}}),
+       ErrCode::Success},
+      /// i64.atomic.rmw.cmpxchg, i64.atomic.rmw.sub, and i64.atomic.load.
+      {code({i32Const(16), i64Const(0), i64Const(0x1122334455667788),
+             atomic(0x49), arg64(0), {0x1A}, i32Const(16), i64Const(8),
+             atomic(0x26), arg64(0), {0x1A}, i32Const(16), atomic(0x11),
+             arg64(0), i64Const(0x1122334455667780), {0x51}, atomic(0x03),
+             {0x00}}),
+       ErrCode::Success},
+      /// memory.atomic.wait32 on the unexpected value, and
+      /// memory.atomic.notify without waiters.
+      {code({i32Const(0), i32Const(1), i64Const(0), atomic(0x01), arg32(0),
+             i32Const(10), {0x6C}, i32Const(0), i32Const(1), atomic(0x00),
+             arg32(0), {0x6A}}),
+       ErrCode::Success},
+      /// Unaligned atomic access.
+      {code({i32Const(1), atomic(0x10), arg32(0)}),
+       ErrCode::UnalignedAtomicAccess},
+      /// Out of bounds atomic access.
+      {code({i32Const(65536), atomic(0x10), arg32(0)}),
+       ErrCode::MemorySizeExceeded},
+  };
+  const Values Expects = {5 * 12, 3 + 9 + 9, 1, 10, 0, 0};
+  ModuleBuilder B;
+  const uint32_t T = B.addType({}, {0x7F});
+  B.setMemory(1, 1, true);
+  for (size_t I = 0; I < Cases.size(); ++I) {
+    B.addFunc(T, Cases[I].first, {}, "f" + std::to_string(I));
+  }
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the atomic instructions, the results, and the traps.
+  for (size_t I = 0; I < Cases.size(); ++I) {
+    SCOPED_TRACE(I);
+    const Outcome Res = runAll(Wasm, "f" + std::to_string(I));
+    EXPECT_EQ(Res.Code, Cases[I].second);
+    if (Res.Code == ErrCode::Success) {
+      EXPECT_EQ(Res.Values, Values{Expects[I]});
+    }
+  }
+}
+
+TEST(AtomicTest, ParallelMeasurement) {
+  constexpr uint32_t Threads = 4;
+  constexpr uint32_t Times = 1000;
+  const SSVM::Bytes Wasm = counterModule();
+  const Outcome One = runAll(Wasm, "add", {uint32_t(Times)});
+  ASSERT_EQ(One.Code, ErrCode::Success);
+  const std::vector<std::vector<ValVariant>> ParamsList(
+      Threads, std::vector<ValVariant>{uint32_t(Times)});
+
+  for (const auto Tier :
+       {Configure::InterpreterTier::Stack, Configure::InterpreterTier::Register,
+        Configure::InterpreterTier::CachedStack,
+        Configure::InterpreterTier::Tiered}) {
+    for (const auto Mode :
+         {Configure::MeasureMode::None, Configure::MeasureMode::Count,
+          Configure::MeasureMode::Metered}) {
+      SCOPED_TRACE(configName(Tier, Mode));
+      const bool Counted = Mode != Configure::MeasureMode::None;
+      const bool Metered = Mode == Configure::MeasureMode::Metered;
+      for (const uint64_t Limit : {UINT64_MAX, One.Cost * 3 / 2}) {
+        Configure Conf;
+        Conf.setInterpreterTier(Tier);
+        Conf.setMeasureMode(Mode);
+        SSVM::ExpVM::VM VM(Conf);
+        SSVM::Support::Measurement &Measure = VM.getMeasurement();
+        Measure.setCostTable(RunOptions().CostTab);
+        ASSERT_TRUE(VM.loadWasm(Wasm));
+        ASSERT_TRUE(VM.validate());
+        ASSERT_TRUE(VM.instantiate());
+        Measure.clear();
+        Measure.getCostSum() = 0;
+        Measure.getCostLimit() = Limit;
+        auto Res = VM.executeParallel("add", ParamsList);
+
+        /// 1. Test the threads are measured in the configured mode.
+        EXPECT_EQ(Measure.getInstrCnt(), Counted ? One.InstrCnt * Threads : 0);
+        if (Limit == UINT64_MAX || !Metered) {
+          EXPECT_TRUE(Res);
+          EXPECT_EQ(Measure.getCostSum(), Metered ? One.Cost * Threads : 0);
+        } else {
+          /// 2. Test the threads within the limit exceed it in total.
+          ASSERT_FALSE(Res);
+          EXPECT_EQ(Res.error(), ErrCode::CostLimitExceeded);
+          EXPECT_EQ(Measure.getCostSum(), Limit);
+        }
+
+        /// 3. Test the atomic additions of all threads are kept.
+        Measure.getCostLimit() = UINT64_MAX;
+        auto Cnt = VM.execute("get");
+        ASSERT_TRUE(Cnt);
+        EXPECT_EQ(SSVM::retrieveValue<uint32_t>((*Cnt)[0]), Threads * Times);
+      }
+    }
+  }
+}
+
+} // namespace
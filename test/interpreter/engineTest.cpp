@@ -0,0 +1,736 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/engineTest.cpp - execution unit tests -------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing functions in every interpreter
+/// tier and measurement mode.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace SSVM::Test;
+using SSVM::ErrCode;
+using SSVM::ValVariant;
+using Values = std::vector<uint64_t>;
+using SSVM::Runtime::Instance::MemoryInstance;
+
+class HostMulAdd : public SSVM::Runtime::HostFunction<HostMulAdd> {
+public:
+  HostMulAdd() : HostFunction(50) {}
+  ErrCode body(MemoryInstance &, uint32_t &Ret, uint32_t A, uint64_t B,
+               uint32_t C) {
+    Ret = A * 100 + static_cast<uint32_t>(B) * 10 + C;
+    return ErrCode::Success;
+  }
+};
+
+class HostCheck : public SSVM::Runtime::HostFunction<HostCheck> {
+public:
+  ErrCode body(MemoryInstance &, uint32_t Fail) {
+    return Fail ? ErrCode::ExecutionFailed : ErrCode::Success;
+  }
+};
+
+class HostModule : public SSVM::Runtime::ImportObject {
+public:
+  HostModule() : ImportObject("host") {
+    addHostFunc("muladd", std::make_unique<HostMulAdd>());
+    addHostFunc("check", std::make_unique<HostCheck>());
+  }
+};
+
+TEST(EngineTest, Arithmetic) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F, 0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x20, 0x00, 0x20, 0x01, 0x6A, /// (a + b)
+                0x20, 0x00, 0x20, 0x01, 0x6B, /// (a - b)
+                0x6C,                         /// *
+                0x20, 0x00, 0x41, 0x03, 0x74, /// (a << 3)
+                0x73                          /// ^
+            },
+            {}, "f");
+
+  /// 1. Test the operands and locals in the flat byte code.
+  const Outcome Res =
+      runAll(B.build(), "f", std::vector<ValVariant>{uint32_t(7), uint32_t(3)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({16}));
+}
+
+TEST(EngineTest, RecursiveCall) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x20, 0x00, 0x41, 0x02, 0x48, /// n < 2
+                0x04, 0x7F,                   /// if (result i32)
+                0x20, 0x00,                   ///   n
+                0x05,                         /// else
+                0x20, 0x00, 0x41, 0x01, 0x6B, ///   fib(n - 1)
+                0x10, 0x00,                   ///
+                0x20, 0x00, 0x41, 0x02, 0x6B, ///   fib(n - 2)
+                0x10, 0x00,                   ///
+                0x6A,                         ///   +
+                0x0B                          /// end
+            },
+            {}, "fib");
+
+  /// 1. Test the calls and the if-else branches.
+  const Outcome Res =
+      runAll(B.build(), "fib", std::vector<ValVariant>{uint32_t(20)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({6765}));
+}
+
+TEST(EngineTest, Loop) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7E}, {0x7E});
+  B.addFunc(T,
+            {
+                0x42, 0x01, 0x21, 0x01,       /// acc = 1
+                0x02, 0x40, 0x03, 0x40,       /// block loop
+                0x20, 0x00, 0x50, 0x0D, 0x01, ///   br_if 1 (n == 0)
+                0x20, 0x01, 0x20, 0x00, 0x7E, ///   acc * n
+                0x21, 0x01,                   ///   acc =
+                0x20, 0x00, 0x42, 0x01, 0x7D, ///   n - 1
+                0x21, 0x00,                   ///   n =
+                0x0C, 0x00,                   ///   br 0
+                0x0B, 0x0B,                   /// end end
+                0x20, 0x01                    /// acc
+            },
+            {{1, 0x7E}}, "fact");
+
+  /// 1. Test the loop and the branches out of it.
+  const Outcome Res =
+      runAll(B.build(), "fact", std::vector<ValVariant>{uint64_t(20)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({2432902008176640000ULL}));
+}
+
+TEST(EngineTest, BlockResults) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x02, 0x7F, 0x41, 0x01, /// block (result i32) 1
+                0x02, 0x7F, 0x41, 0x02, ///   block (result i32) 2
+                0x20, 0x00, 0x0D, 0x01, ///     br_if 1
+                0x1A, 0x41, 0x03,       ///     drop 3
+                0x0B, 0x6A,             ///   end +
+                0x0B                    /// end
+            },
+            {}, "f");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the values under the block results are kept.
+  Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(0)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({4}));
+
+  /// 2. Test the branch carries the result and drops the values under it.
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(1)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({2}));
+}
+
+TEST(EngineTest, BranchTable) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x02, 0x40, 0x02, 0x40, 0x02, 0x40, /// block block block
+                0x20, 0x00, 0x0E, 0x02,             ///   br_table
+                0x00, 0x01, 0x02,                   ///     0 1 (default 2)
+                0x0B, 0x41, 0x0A, 0x0F,             /// end return 10
+                0x0B, 0x41, 0x14, 0x0F,             /// end return 20
+                0x0B, 0x41, 0x1E                    /// end 30
+            },
+            {}, "f");
+  B.addFunc(T,
+            {
+                0x02, 0x7F, 0x02, 0x7F,       /// block block (result i32)
+                0x41, 0x07, 0x20, 0x00,       ///   7
+                0x0E, 0x02, 0x00, 0x01, 0x01, ///   br_table 0 1 1
+                0x0B, 0x41, 0x32, 0x6A,       /// end + 50
+                0x0B                          /// end
+            },
+            {}, "g");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the targets and the default target.
+  const uint32_t Expected[] = {10, 20, 30, 30};
+  for (uint32_t I = 0; I < 4; ++I) {
+    const Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{I});
+    EXPECT_EQ(Res.Code, ErrCode::Success);
+    EXPECT_EQ(Res.Values, Values({Expected[I]}));
+  }
+
+  /// 2. Test the targets carry the results.
+  Outcome Res = runAll(Wasm, "g", std::vector<ValVariant>{uint32_t(0)});
+  EXPECT_EQ(Res.Values, Values({57}));
+  Res = runAll(Wasm, "g", std::vector<ValVariant>{uint32_t(9)});
+  EXPECT_EQ(Res.Values, Values({7}));
+}
+
+TEST(EngineTest, BranchOutOfLoop) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x02, 0x7F, 0x41, 0x2A,       /// block (result i32) 42
+                0x03, 0x40,                   ///   loop
+                0x20, 0x01, 0x41, 0x01, 0x6A, ///     i + 1
+                0x22, 0x01,                   ///     i =
+                0x20, 0x00, 0x46,             ///     i == n
+                0x04, 0x40,                   ///     if
+                0x20, 0x01, 0x41, 0x03, 0x6C, ///       i * 3
+                0x0C, 0x02,                   ///       br 2
+                0x0B, 0x0C, 0x00,             ///     end br 0
+                0x0B,                         ///   end
+                0x0B                          /// end
+            },
+            {{1, 0x7F}}, "f");
+
+  /// 1. Test the branch out of the if and the loop drops the values under.
+  const Outcome Res =
+      runAll(B.build(), "f", std::vector<ValVariant>{uint32_t(5)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({15}));
+}
+
+TEST(EngineTest, Superinstructions) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x02, 0x40, 0x03, 0x40,                   /// block loop
+                0x20, 0x01, 0x20, 0x00, 0x48,             ///   i < n
+                0x45, 0x0D, 0x01,                         ///   br_if 1 (eqz)
+                0x20, 0x02, 0x20, 0x01, 0x6A, 0x21, 0x02, ///   s = s + i
+                0x20, 0x01, 0x41, 0x01, 0x6A, 0x21, 0x01, ///   i = i + 1
+                0x0C, 0x00, 0x0B, 0x0B,                   /// br 0 end end
+                0x20, 0x02, 0x41, 0x03, 0x6B,             /// s - 3
+                0x41, 0x0A, 0x6C,                         /// * 10
+                0x20, 0x02, 0x41, 0xE4, 0x00, 0x48,       /// s < 100
+                0x04, 0x7F, 0x41, 0x01,                   /// if 1
+                0x05, 0x41, 0x02, 0x0B,                   /// else 2 end
+                0x6A, 0x41, 0x05, 0x6A                    /// + + 5
+            },
+            {{2, 0x7F}}, "f");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the fused sequences with both ways of the if.
+  Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(10)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({426}));
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(20)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({1877}));
+
+  /// 2. Test the unfused byte code when counting pairs runs the same.
+  RunOptions Opts;
+  Opts.Prepare = [](SSVM::ExpVM::VM &VM) {
+    VM.getMeasurement().setPairCounting(true);
+  };
+  const Outcome Unfused =
+      runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(20)}, Opts);
+  EXPECT_EQ(Unfused.Values, Res.Values);
+  EXPECT_EQ(Unfused.InstrCnt, Res.InstrCnt);
+  EXPECT_EQ(Unfused.Cost, Res.Cost);
+
+  /// 3. Test running out of cost at each instruction inside the sequences.
+  for (uint64_t Limit = 0; Limit < Res.Cost; Limit += 3) {
+    SCOPED_TRACE(Limit);
+    Opts = RunOptions();
+    Opts.CostLimit = Limit;
+    const Outcome Trap =
+        runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(20)}, Opts);
+    EXPECT_EQ(Trap.Code, ErrCode::CostLimitExceeded);
+    EXPECT_EQ(Trap.Cost, Limit);
+    EXPECT_LE(Trap.InstrCnt, Res.InstrCnt);
+  }
+}
+
+TEST(EngineTest, RegisterOperands) {
+  ModuleBuilder B;
+  const uint32_t T1 = B.addType({0x7F}, {0x7F});
+  const uint32_t T3 = B.addType({0x7F, 0x7F, 0x7F}, {0x7F});
+  B.addFunc(T1,
+            {
+                0x20, 0x00,             /// a
+                0x41, 0x05, 0x21, 0x00, /// a = 5
+                0x20, 0x00, 0x6B        /// - a
+            },
+            {}, "f1");
+  B.addFunc(T1,
+            {
+                0x20, 0x00, 0x20, 0x00, /// a a
+                0x41, 0x02, 0x6C,       /// * 2
+                0x22, 0x00, 0x6A,       /// a = , +
+                0x20, 0x00, 0x6A        /// + a
+            },
+            {}, "f2");
+  const SSVM::Bytes GBody = {
+      0x20, 0x00, 0x41, 0xE4, 0x00, 0x6C, /// a * 100
+      0x20, 0x01, 0x41, 0x0A, 0x6C, 0x6A, /// + b * 10
+      0x20, 0x02, 0x6A                    /// + c
+  };
+  const uint32_t G = B.addFunc(T3, GBody);
+  B.addFunc(T1,
+            code({{
+                      0x20, 0x00,             /// a
+                      0x41, 0x07, 0x22, 0x00, /// a = 7
+                      0x20, 0x00, 0x10        /// a, call
+                  },
+                  leb(G)}),
+            {}, "f3");
+  SSVM::Bytes Deep;
+  for (uint8_t K = 0; K < 8; ++K) {
+    Deep = code({Deep, {0x20, 0x00, 0x41, K, 0x6A}});
+  }
+  Deep = code({Deep, SSVM::Bytes(7, 0x6B)});
+  B.addFunc(T1, Deep, {}, "f4");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the operands read from locals are not changed by later sets.
+  const std::vector<ValVariant> Params = {uint32_t(9)};
+  Outcome Res = runAll(Wasm, "f1", Params);
+  EXPECT_EQ(Res.Values, Values({4}));
+  Res = runAll(Wasm, "f2", Params);
+  EXPECT_EQ(Res.Values, Values({45}));
+
+  /// 2. Test the arguments of call are read in order.
+  Res = runAll(Wasm, "f3", Params);
+  EXPECT_EQ(Res.Values, Values({977}));
+
+  /// 3. Test the deep operand stack.
+  Res = runAll(Wasm, "f4", Params);
+  EXPECT_EQ(Res.Values, Values({4294967292U}));
+}
+
+TEST(EngineTest, StackOverflow) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x20, 0x00, 0x45, 0x04, 0x7F, /// if n == 0
+                0x41, 0x00, 0x05,             ///   0 else
+                0x20, 0x00, 0x41, 0x01, 0x6B, ///   f(n - 1)
+                0x10, 0x00,                   ///
+                0x41, 0x01, 0x6A, 0x0B        ///   + 1 end
+            },
+            {{4, 0x7E}}, "f");
+  const SSVM::Bytes Wasm = B.build();
+  RunOptions Opts;
+  Opts.StackCapacity = 4096;
+
+  /// 1. Test the deep recursion in the capacity.
+  Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(100)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({100}));
+
+  /// 2. Test the recursion over the capacity traps.
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(100000)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::StackOverflow);
+}
+
+TEST(EngineTest, CallIndirect) {
+  ModuleBuilder B;
+  const uint32_t T0 = B.addType({0x7F}, {0x7F});
+  const uint32_t T1 = B.addType({0x7F}, {0x7F});
+  const uint32_t T2 = B.addType({}, {0x7F});
+  const uint32_t F0 = B.addFunc(T0, {0x20, 0x00, 0x41, 0x01, 0x6A});
+  const uint32_t F1 = B.addFunc(T1, {0x20, 0x00, 0x41, 0x02, 0x6C});
+  const uint32_t F2 = B.addFunc(T2, {0x41, 0x07});
+  B.setTable(5, {F0, F1, F2});
+  B.addFunc(T0,
+            {
+                0x41, 0x0A, 0x20, 0x00, /// 10, i
+                0x11, 0x00, 0x00        /// call_indirect (type 0)
+            },
+            {}, "f");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the calls of the same and the equal types.
+  Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(0)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({11}));
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(1)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({20}));
+
+  /// 2. Test the call of a different type traps.
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(2)});
+  EXPECT_EQ(Res.Code, ErrCode::TypeNotMatch);
+
+  /// 3. Test the calls of the null entry and out of the table trap.
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(3)});
+  EXPECT_EQ(Res.Code, ErrCode::TypeNotMatch);
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(5)});
+  EXPECT_EQ(Res.Code, ErrCode::AccessForbidMemory);
+}
+
+TEST(EngineTest, TailCalls) {
+  ModuleBuilder B;
+  const uint32_t T0 = B.addType({0x7F, 0x7F}, {0x7F});
+  const uint32_t T1 = B.addType({0x7F}, {0x7F});
+  const uint32_t T2 = B.addType({}, {0x7F});
+  B.addFunc(T0,
+            {
+                0x20, 0x00, 0x45, 0x04, 0x40, /// if n == 0
+                0x20, 0x01, 0x0F, 0x0B,       ///   return acc end
+                0x20, 0x00, 0x41, 0x01, 0x6B, /// n - 1
+                0x20, 0x00, 0x20, 0x01, 0x6A, /// acc + n
+                0x12, 0x00                    /// return_call sum
+            },
+            {{2, 0x7E}}, "sum");
+  const uint32_t Even = B.addFunc(
+      T1,
+      {
+          0x20, 0x00, 0x45, 0x04, 0x40, /// if n == 0
+          0x41, 0x01, 0x0F, 0x0B,       ///   return 1 end
+          0x20, 0x00, 0x41, 0x01, 0x6B, /// n - 1
+          0x41, 0x01, 0x13, 0x01, 0x00  /// return_call_indirect odd
+      },
+      {}, "even");
+  const uint32_t Odd = B.addFunc(
+      T1,
+      {
+          0x20, 0x00, 0x45, 0x04, 0x40, /// if n == 0
+          0x41, 0x00, 0x0F, 0x0B,       ///   return 0 end
+          0x20, 0x00, 0x41, 0x01, 0x6B, /// n - 1
+          0x41, 0x00, 0x13, 0x01, 0x00  /// return_call_indirect even
+      });
+  B.setTable(2, {Even, Odd});
+  B.addFunc(T2,
+            {
+                0x41, 0x05, 0x41, 0x05, /// 5, 5,
+                0x41, 0x00,             /// 0
+                0x13, 0x00, 0x00        /// return_call_indirect (type 0)
+            },
+            {}, "mismatch");
+  const SSVM::Bytes Wasm = B.build();
+  RunOptions Opts;
+  Opts.StackCapacity = 4096;
+
+  /// 1. Test the tail calls deeper than the stack capacity.
+  Outcome Res = runAll(Wasm, "sum",
+                       std::vector<ValVariant>{uint32_t(100000), uint32_t(0)},
+                       Opts);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({uint32_t(5000050000ULL)}));
+
+  /// 2. Test the indirect tail calls between functions.
+  Res = runAll(Wasm, "even", std::vector<ValVariant>{uint32_t(100001)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({0}));
+  Res = runAll(Wasm, "even", std::vector<ValVariant>{uint32_t(100000)}, Opts);
+  EXPECT_EQ(Res.Values, Values({1}));
+
+  /// 3. Test the indirect tail call of mismatched type traps.
+  Res = runAll(Wasm, "mismatch", {}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::TypeNotMatch);
+}
+
+TEST(EngineTest, ImportedInstances) {
+  ModuleBuilder Lib;
+  const uint32_t LibT = Lib.addType({}, {0x7F});
+  Lib.setMemory(1, 0, false, "mem");
+  Lib.addGlobal(0x7F, false, i32Const(1000));
+  Lib.addGlobal(0x7F, false, i32Const(100), "base");
+  Lib.addFunc(LibT,
+              {
+                  0x41, 0x00, 0x28, 0x02, 0x00, /// load 0
+                  0x23, 0x00, 0x6A              /// + g0
+              },
+              {}, "get");
+  const SSVM::Bytes LibWasm = Lib.build();
+
+  ModuleBuilder B;
+  const uint32_t T0 = B.addType({}, {0x7F});
+  const uint32_t T1 = B.addType({0x7F}, {0x7F});
+  B.importFunc("lib", "get", T0);
+  B.importMemory("lib", "mem", 1);
+  B.importGlobal("lib", "base", 0x7F, false);
+  B.addGlobal(0x7F, false, i32Const(10));
+  B.addFunc(T1,
+            {
+                0x41, 0x00, 0x20, 0x00,       /// 0, x
+                0x36, 0x02, 0x00, 0x10, 0x00, /// store, call get
+                0x23, 0x00, 0x6A,             /// + g0
+                0x23, 0x01, 0x6A              /// + g1
+            },
+            {}, "f");
+  RunOptions Opts;
+  Opts.Prepare = [&LibWasm](SSVM::ExpVM::VM &VM) {
+    ASSERT_TRUE(VM.registerModule("lib", LibWasm));
+  };
+
+  /// 1. Test the imported memory and global, and the instances of the
+  /// callee module are used in its frame and restored after it returns.
+  const Outcome Res =
+      runAll(B.build(), "f", std::vector<ValVariant>{uint32_t(5)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({1115}));
+}
+
+TEST(EngineTest, ZeroLocals) {
+  ModuleBuilder B;
+  const uint32_t TV = B.addType({}, {});
+  const uint32_t T64 = B.addType({}, {0x7E});
+  SSVM::Bytes Dirty;
+  for (uint8_t K = 0; K < 16; ++K) {
+    Dirty = code({Dirty, i64Const(-1), {0x21, K}});
+  }
+  const uint32_t D = B.addFunc(TV, Dirty, {{16, 0x7E}});
+  const SSVM::Bytes Clean = {
+      0x20, 0x00, 0xAD, 0x20, 0x01, 0xAD, 0x84, /// i32 locals
+      0x20, 0x02, 0x84, 0x20, 0x03, 0x84,       /// i64 locals
+      0x20, 0x04, 0x84,                         ///
+      0x20, 0x05, 0xBC, 0xAD, 0x84,             /// f32 local
+      0x20, 0x06, 0xBD, 0x84                    /// f64 local
+  };
+  const uint32_t C =
+      B.addFunc(T64, Clean, {{2, 0x7F}, {3, 0x7E}, {1, 0x7D}, {1, 0x7C}});
+  B.addFunc(T64,
+            code({{0x10}, leb(D), {0x10}, leb(C), {0x10}, leb(D), {0x10},
+                  leb(C), {0x84}}),
+            {}, "f");
+
+  /// 1. Test the locals are zero in the stack dirtied by the previous call.
+  const Outcome Res = runAll(B.build(), "f");
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({0}));
+}
+
+TEST(EngineTest, HostFunction) {
+  ModuleBuilder B;
+  const uint32_t T0 = B.addType({0x7F, 0x7E, 0x7F}, {0x7F});
+  const uint32_t T1 = B.addType({0x7F}, {});
+  const uint32_t T2 = B.addType({0x7F}, {0x7F});
+  B.importFunc("host", "muladd", T0);
+  B.importFunc("host", "check", T1);
+  B.setMemory(1);
+  B.addFunc(T2,
+            {
+                0x41, 0x01, 0x41, 0x03, 0x42, 0x04, /// 1, 3, 4
+                0x20, 0x00, 0x10, 0x00,             /// x, call muladd
+                0x6A                                /// +
+            },
+            {}, "f");
+  B.addFunc(T2,
+            {
+                0x20, 0x00, 0x10, 0x01, /// x, call check
+                0x41, 0x01              /// 1
+            },
+            {}, "g");
+  const SSVM::Bytes Wasm = B.build();
+  HostModule Host;
+  RunOptions Opts;
+  Opts.Prepare = [&Host](SSVM::ExpVM::VM &VM) {
+    ASSERT_TRUE(VM.registerModule(Host));
+  };
+
+  /// 1. Test the arguments are read above the values under them, and the
+  /// host function cost is charged.
+  Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(5)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({346}));
+  const std::vector<uint64_t> Tab = RunOptions::defaultCostTab();
+  EXPECT_EQ(Res.Cost, Tab[0x41] * 2 + Tab[0x42] + Tab[0x20] + Tab[0x10] +
+                          Tab[0x6A] + 50);
+
+  /// 2. Test the host function without results, and its error traps.
+  Res = runAll(Wasm, "g", std::vector<ValVariant>{uint32_t(0)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({1}));
+  Res = runAll(Wasm, "g", std::vector<ValVariant>{uint32_t(1)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::ExecutionFailed);
+}
+
+TEST(EngineTest, CachedTop) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.setMemory(1);
+  B.addFunc(T,
+            {
+                0x02, 0x7F,                         /// block (result i32)
+                0x41, 0x00, 0x20, 0x00,             ///   0, x
+                0x36, 0x02, 0x00,                   ///   store
+                0x41, 0x00, 0x28, 0x02, 0x00,       ///   load 0
+                0x20, 0x00, 0x1A,                   ///   x, drop
+                0x41, 0x04, 0x20, 0x00, 0x41, 0x03, ///   4, x, 3
+                0x6C, 0x36, 0x02, 0x00,             ///   *, store
+                0x41, 0x04, 0x28, 0x02, 0x00,       ///   load 4
+                0x6A, 0x22, 0x01,                   ///   +, y =
+                0x20, 0x01, 0x41, 0x28, 0x4A,       ///   y > 40
+                0x04, 0x40,                         ///   if
+                0x20, 0x01, 0x41, 0xE8, 0x07,       ///     y, 1000
+                0x6A, 0x0F,                         ///     +, return
+                0x0B,                               ///   end
+                0x0B, 0x41, 0x07, 0x6A              /// end + 7
+            },
+            {{1, 0x7F}}, "f");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the cached top is spilled and reloaded around the memory
+  /// accesses, the drops and the blocks.
+  Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(5)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({27}));
+
+  /// 2. Test the return from the if inside the block.
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(20)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({1080}));
+}
+
+TEST(EngineTest, Traps) {
+  const std::vector<std::pair<SSVM::Bytes, ErrCode>> Cases = {
+      /// unreachable
+      {{0x41, 0x01, 0x1A, 0x00}, ErrCode::Unreachable},
+      /// i32.div_u by zero, i64.rem_s by zero
+      {{0x41, 0x01, 0x41, 0x00, 0x6E}, ErrCode::DivideByZero},
+      {{0x42, 0x01, 0x42, 0x00, 0x81, 0xA7}, ErrCode::DivideByZero},
+      /// i32.div_s overflow
+      {code({i32Const(INT32_MIN), i32Const(-1), {0x6D}}),
+       ErrCode::FloatPointException},
+      /// i32.trunc_f64_s of NaN and out of range
+      {code({f64Const(NAN), {0xAA}}), ErrCode::CastingError},
+      {code({f64Const(3e9), {0xAA}}), ErrCode::CastingError},
+  };
+  ModuleBuilder B;
+  const uint32_t T = B.addType({}, {0x7F});
+  for (size_t I = 0; I < Cases.size(); ++I) {
+    B.addFunc(T, Cases[I].first, {}, "f" + std::to_string(I));
+  }
+  B.addGlobal(0x7F, true, i32Const(0));
+  const uint32_t G = B.addFunc(T, {0x41, 0x07, 0x24, 0x00, 0x00});
+  B.addFunc(T,
+            code({{0x41, 0x01, 0x02, 0x7F, 0x10}, leb(G), {0x0B, 0x6A}}),
+            {}, "g");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the traps of instructions.
+  for (size_t I = 0; I < Cases.size(); ++I) {
+    SCOPED_TRACE(I);
+    const Outcome Res = runAll(Wasm, "f" + std::to_string(I));
+    EXPECT_EQ(Res.Code, Cases[I].second);
+  }
+
+  /// 2. Test the trap in a callee inside a block of the caller.
+  const Outcome Res = runAll(Wasm, "g");
+  EXPECT_EQ(Res.Code, ErrCode::Unreachable);
+}
+
+TEST(EngineTest, SelectAndGlobal) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addGlobal(0x7F, true, i32Const(5));
+  B.addFunc(T,
+            {
+                0x23, 0x00, 0x20, 0x00, 0x6A, 0x24, 0x00, /// g += x
+                0x41, 0x0A, 0x41, 0x14, 0x20, 0x00, 0x1B, /// x ? 10 : 20
+                0x23, 0x00, 0x6A                          /// + g
+            },
+            {}, "f");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the select and the global accesses.
+  Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(0)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({25}));
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(3)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({18}));
+}
+
+TEST(EngineTest, Opcodes) {
+  struct Case {
+    uint8_t Result;
+    SSVM::Bytes Body;
+    uint64_t Expected;
+  };
+  const std::vector<Case> Cases = {
+      /// i32.div_s, i32.rem_u, i32.shr_s, i32.rotl
+      {0x7F, code({i32Const(-7), i32Const(2), {0x6D}}), 0xFFFFFFFDU},
+      {0x7F, code({i32Const(-7), i32Const(2), {0x70}}), 1},
+      {0x7F, code({i32Const(-8), i32Const(1), {0x75}}), 0xFFFFFFFCU},
+      {0x7F, code({i32Const(INT32_MIN + 1), i32Const(1), {0x77}}), 3},
+      /// i32.clz + i32.ctz + i32.popcnt
+      {0x7F,
+       code({i32Const(1), {0x67}, i32Const(8), {0x68, 0x6A}, i32Const(255),
+             {0x69, 0x6A}}),
+       42},
+      /// i32.wrap_i64, i64.extend_i32_u, i64.extend_i32_s
+      {0x7F, code({i64Const(0x100000005LL), {0xA7}}), 5},
+      {0x7E, code({i32Const(-1), {0xAD}}), 0xFFFFFFFFU},
+      {0x7E, code({i32Const(-1), {0xAC}}), UINT64_MAX},
+      /// i64.rotr, i64.clz + i64.shr_u
+      {0x7E, code({i64Const(0x123456789LL), i64Const(4), {0x8A}}),
+       0x9000000012345678ULL},
+      {0x7E,
+       code({i64Const(1), {0x79}, i64Const(-1), i64Const(60), {0x88, 0x7C}}),
+       78},
+      /// f64.div, f64.floor, i32.trunc_f64_s
+      {0x7F, code({f64Const(7.0), f64Const(2.0), {0xA3, 0x9C, 0xAA}}), 3},
+      /// f32.sqrt, f64.promote_f32, i64.reinterpret_f64
+      {0x7E, code({f32Const(16.0F), {0x91, 0xBB, 0xBD}}),
+       0x4010000000000000ULL},
+      /// f64.min of zeros
+      {0x7E, code({f64Const(-0.0), f64Const(0.0), {0xA4, 0xBD}}),
+       0x8000000000000000ULL},
+      /// f64.convert_i64_s, f32.demote_f64, i32.reinterpret_f32
+      {0x7F, code({i64Const(-5), {0xB9, 0xB6, 0xBC}}), 0xC0A00000U},
+      /// i32.lt_u + 2 * i64.ge_s + 4 * f64.lt
+      {0x7F,
+       code({i32Const(-1), i32Const(1), {0x49}, i64Const(-1), i64Const(1),
+             {0x59}, i32Const(2), {0x6C, 0x6A}, f64Const(1.0), f64Const(2.0),
+             {0x63}, i32Const(4), {0x6C, 0x6A}}),
+       4},
+      /// f64.eq of NaN + 2 * f32.ne of NaN
+      {0x7F,
+       code({f64Const(NAN), f64Const(NAN), {0x61}, f32Const(NAN),
+             f32Const(NAN), {0x5C}, i32Const(2), {0x6C, 0x6A}}),
+       2},
+  };
+  ModuleBuilder B;
+  const uint32_t T32 = B.addType({}, {0x7F});
+  const uint32_t T64 = B.addType({}, {0x7E});
+  for (size_t I = 0; I < Cases.size(); ++I) {
+    B.addFunc(Cases[I].Result == 0x7F ? T32 : T64, Cases[I].Body, {},
+              "f" + std::to_string(I));
+  }
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the instructions through the dispatch.
+  for (size_t I = 0; I < Cases.size(); ++I) {
+    SCOPED_TRACE(I);
+    const Outcome Res = runAll(Wasm, "f" + std::to_string(I));
+    EXPECT_EQ(Res.Code, ErrCode::Success);
+    EXPECT_EQ(Res.Values, Values({Cases[I].Expected}));
+  }
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,407 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/helper.h - Execution test helpers -----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the builder of wasm modules and the runner of functions
+/// in every interpreter tier and measurement mode for the execution tests.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "expvm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SSVM {
+namespace Test {
+
+using ExpVM::Configure;
+
+/// Encode unsigned LEB128.
+inline Bytes leb(uint64_t Value) {
+  Bytes Res;
+  do {
+    uint8_t B = Value & 0x7FU;
+    Value >>= 7;
+    Res.push_back(Value ? (B | 0x80U) : B);
+  } while (Value);
+  return Res;
+}
+
+/// Encode signed LEB128.
+inline Bytes sleb(int64_t Value) {
+  Bytes Res;
+  while (true) {
+    uint8_t B = Value & 0x7FU;
+    Value >>= 7;
+    if ((Value == 0 && !(B & 0x40U)) || (Value == -1 && (B & 0x40U))) {
+      Res.push_back(B);
+      return Res;
+    }
+    Res.push_back(B | 0x80U);
+  }
+}
+
+/// Concatenate the parts of code.
+inline Bytes code(std::initializer_list<Bytes> Parts) {
+  Bytes Res;
+  for (const auto &Part : Parts) {
+    Res.insert(Res.end(), Part.begin(), Part.end());
+  }
+  return Res;
+}
+
+/// Instructions of constants.
+inline Bytes i32Const(int32_t Value) { return code({{0x41}, sleb(Value)}); }
+inline Bytes i64Const(int64_t Value) { return code({{0x42}, sleb(Value)}); }
+inline Bytes f32Const(float Value) {
+  Bytes Res(5, 0x43);
+  std::memcpy(&Res[1], &Value, 4);
+  return Res;
+}
+inline Bytes f64Const(double Value) {
+  Bytes Res(9, 0x44);
+  std::memcpy(&Res[1], &Value, 8);
+  return Res;
+}
+
+/// Instructions of SIMD by the sub-opcode, and of v128 constant.
+inline Bytes simd(uint32_t SubCode) { return code({{0xFD}, leb(SubCode)}); }
+inline Bytes v128Const(uint64_t Low, uint64_t High) {
+  Bytes Res = code({simd(0x0C), Bytes(16)});
+  std::memcpy(&Res[2], &Low, 8);
+  std::memcpy(&Res[10], &High, 8);
+  return Res;
+}
+
+/// Instructions of atomic memory by the sub-opcode.
+inline Bytes atomic(uint32_t SubCode) {
+  return code({{0xFE}, leb(SubCode)});
+}
+
+/// Encode name.
+inline Bytes name(const std::string &Str) {
+  return code({leb(Str.size()), Bytes(Str.begin(), Str.end())});
+}
+
+/// Builder of the binary of wasm module.
+///
+/// The imports should be added before the functions and globals defined in
+/// the module. The bodies and the initial expressions are given without the
+/// last `end` instruction.
+class ModuleBuilder {
+public:
+  /// Add a function type and return its index.
+  uint32_t addType(const Bytes &Params, const Bytes &Results) {
+    Types.push_back(code(
+        {{0x60}, leb(Params.size()), Params, leb(Results.size()), Results}));
+    return Types.size() - 1;
+  }
+
+  /// Import a function of the type and return its index.
+  uint32_t importFunc(const std::string &Mod, const std::string &Field,
+                      const uint32_t Type) {
+    Imports.push_back(code({name(Mod), name(Field), {0x00}, leb(Type)}));
+    return NumFuncs++;
+  }
+
+  /// Import a memory with the limit.
+  void importMemory(const std::string &Mod, const std::string &Field,
+                    const uint32_t Min) {
+    Imports.push_back(code({name(Mod), name(Field), {0x02, 0x00}, leb(Min)}));
+  }
+
+  /// Import a global of the value type and return its index.
+  uint32_t importGlobal(const std::string &Mod, const std::string &Field,
+                        const uint8_t Type, const bool Mut) {
+    Imports.push_back(
+        code({name(Mod), name(Field), {0x03, Type, uint8_t(Mut ? 1 : 0)}}));
+    return NumGlobals++;
+  }
+
+  /// Add a function of the type with the locals given in (count, type)
+  /// pairs, and return its index. The function is exported if named.
+  uint32_t addFunc(const uint32_t Type, const Bytes &Body,
+                   const std::vector<std::pair<uint32_t, uint8_t>> &Locals = {},
+                   const std::string &Export = "") {
+    Bytes Func = leb(Locals.size());
+    for (const auto &Local : Locals) {
+      Func = code({Func, leb(Local.first), {Local.second}});
+    }
+    Func = code({Func, Body, {0x0B}});
+    Funcs.push_back(leb(Type));
+    Bodies.push_back(code({leb(Func.size()), Func}));
+    if (!Export.empty()) {
+      exportEntry(Export, 0x00, NumFuncs);
+    }
+    return NumFuncs++;
+  }
+
+  /// Set the memory with the limits. The max is unset if 0.
+  void setMemory(const uint32_t Min, const uint32_t Max = 0,
+                 const bool Shared = false, const std::string &Export = "") {
+    Memory = Max ? code({{uint8_t(Shared ? 0x03 : 0x01)}, leb(Min), leb(Max)})
+                 : code({{0x00}, leb(Min)});
+    if (!Export.empty()) {
+      exportEntry(Export, 0x02, 0);
+    }
+  }
+
+  /// Set the table of the size with the function indices at offset 0.
+  void setTable(const uint32_t Size, const std::vector<uint32_t> &Elems) {
+    Table = code({{0x70, 0x00}, leb(Size)});
+    Elem = code({{0x00}, i32Const(0), {0x0B}, leb(Elems.size())});
+    for (const uint32_t Idx : Elems) {
+      Elem = code({Elem, leb(Idx)});
+    }
+  }
+
+  /// Add a global of the value type and return its index.
+  uint32_t addGlobal(const uint8_t Type, const bool Mut, const Bytes &Init,
+                     const std::string &Export = "") {
+    Globals.push_back(code({{Type, uint8_t(Mut ? 1 : 0)}, Init, {0x0B}}));
+    if (!Export.empty()) {
+      exportEntry(Export, 0x03, NumGlobals);
+    }
+    return NumGlobals++;
+  }
+
+  /// Add an active data segment at the offset, or a passive one if the
+  /// offset is negative, and return its index.
+  uint32_t addData(const int32_t Offset, const Bytes &Data) {
+    const Bytes Init = leb(Data.size());
+    if (Offset < 0) {
+      Datas.push_back(code({{0x01}, Init, Data}));
+    } else {
+      Datas.push_back(code({{0x00}, i32Const(Offset), {0x0B}, Init, Data}));
+    }
+    return Datas.size() - 1;
+  }
+
+  /// Set the start function.
+  void setStart(const uint32_t Func) { Start = leb(Func); }
+
+  /// Build the binary of module.
+  Bytes build() const {
+    Bytes Res = {0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00};
+    appendVec(Res, 0x01, Types);
+    appendVec(Res, 0x02, Imports);
+    appendVec(Res, 0x03, Funcs);
+    if (!Table.empty()) {
+      appendVec(Res, 0x04, {Table});
+    }
+    if (!Memory.empty()) {
+      appendVec(Res, 0x05, {Memory});
+    }
+    appendVec(Res, 0x06, Globals);
+    appendVec(Res, 0x07, Exports);
+    if (!Start.empty()) {
+      appendSec(Res, 0x08, Start);
+    }
+    if (!Elem.empty()) {
+      appendVec(Res, 0x09, {Elem});
+    }
+    if (!Datas.empty()) {
+      appendSec(Res, 0x0C, leb(Datas.size()));
+    }
+    appendVec(Res, 0x0A, Bodies);
+    appendVec(Res, 0x0B, Datas);
+    return Res;
+  }
+
+private:
+  void exportEntry(const std::string &Name, const uint8_t Kind,
+                   const uint32_t Idx) {
+    Exports.push_back(code({name(Name), {Kind}, leb(Idx)}));
+  }
+  static void appendSec(Bytes &Res, const uint8_t Id, const Bytes &Content) {
+    Res = code({Res, {Id}, leb(Content.size()), Content});
+  }
+  static void appendVec(Bytes &Res, const uint8_t Id,
+                        const std::vector<Bytes> &Entries) {
+    if (Entries.empty()) {
+      return;
+    }
+    Bytes Content = leb(Entries.size());
+    for (const auto &Entry : Entries) {
+      Content = code({Content, Entry});
+    }
+    appendSec(Res, Id, Content);
+  }
+
+  std::vector<Bytes> Types, Imports, Funcs, Globals, Exports, Bodies, Datas;
+  Bytes Table, Memory, Elem, Start;
+  uint32_t NumFuncs = 0, NumGlobals = 0;
+};
+
+/// Outcome of running a function in a configuration.
+struct Outcome {
+  /// Error code of the run, or `ErrCode::Success` if it returned.
+  ErrCode Code = ErrCode::Success;
+  /// Bits of the returned values. The v128 values take two.
+  std::vector<uint64_t> Values;
+  /// Measured instructions and cost of the run.
+  uint64_t InstrCnt = 0;
+  uint64_t Cost = 0;
+};
+
+/// Options of running functions.
+struct RunOptions {
+  /// Cost table indexed by opcode. Each opcode costs differently by default,
+  /// so that the mistaken charges are caught.
+  std::vector<uint64_t> CostTab = defaultCostTab();
+  uint64_t CostLimit = UINT64_MAX;
+  uint32_t StackCapacity = 1U << 20;
+  /// Called before loading the module, e.g. to register the imports.
+  std::function<void(ExpVM::VM &)> Prepare;
+
+  static std::vector<uint64_t> defaultCostTab() {
+    std::vector<uint64_t> Tab(256);
+    for (uint32_t I = 0; I < 256; ++I) {
+      Tab[I] = I % 7 + 1;
+    }
+    return Tab;
+  }
+};
+
+/// Name of the configuration for the failure messages.
+inline std::string configName(const Configure::InterpreterTier Tier,
+                              const Configure::MeasureMode Mode) {
+  static const char *Tiers[] = {"Stack", "Register", "CachedStack", "Tiered"};
+  static const char *Modes[] = {"None", "Count", "Metered"};
+  return std::string(Tiers[static_cast<uint8_t>(Tier)]) + "/" +
+         Modes[static_cast<uint8_t>(Mode)];
+}
+
+/// Run the exported function once in a new VM of the configuration.
+inline Outcome run(const Bytes &Wasm, const std::string &Func,
+                   const std::vector<ValVariant> &Params,
+                   const Configure::InterpreterTier Tier,
+                   const Configure::MeasureMode Mode,
+                   const RunOptions &Opts = {}) {
+  Configure Conf;
+  Conf.setInterpreterTier(Tier);
+  Conf.setMeasureMode(Mode);
+  Conf.setStackCapacity(Opts.StackCapacity);
+  ExpVM::VM VM(Conf);
+  Support::Measurement &Measure = VM.getMeasurement();
+  Measure.setCostTable(Opts.CostTab);
+  if (Opts.Prepare) {
+    Opts.Prepare(VM);
+  }
+  Outcome Res;
+  if (auto Ret = VM.loadWasm(Wasm); !Ret) {
+    ADD_FAILURE() << "load failed " << static_cast<uint32_t>(Ret.error());
+    Res.Code = Ret.error();
+    return Res;
+  }
+  if (auto Ret = VM.validate(); !Ret) {
+    ADD_FAILURE() << "validate failed " << static_cast<uint32_t>(Ret.error());
+    Res.Code = Ret.error();
+    return Res;
+  }
+  if (auto Ret = VM.instantiate(); !Ret) {
+    ADD_FAILURE() << "instantiate failed "
+                  << static_cast<uint32_t>(Ret.error());
+    Res.Code = Ret.error();
+    return Res;
+  }
+
+  /// Measure the run only, without the start function.
+  Measure.clear();
+  Measure.getCostSum() = 0;
+  Measure.getCostLimit() = Opts.CostLimit;
+  auto Ret = VM.execute(Func, Params);
+  Res.InstrCnt = Measure.getInstrCnt();
+  Res.Cost = Measure.getCostSum();
+  if (!Ret) {
+    Res.Code = Ret.error();
+    return Res;
+  }
+  std::vector<ValType> Types;
+  for (const auto &Entry : VM.getFunctionList()) {
+    if (Entry.first == Func) {
+      Types = Entry.second.Returns;
+    }
+  }
+  EXPECT_EQ(Types.size(), Ret->size());
+  for (size_t I = 0; I < Types.size() && I < Ret->size(); ++I) {
+    const ValVariant &Val = (*Ret)[I];
+    switch (Types[I]) {
+    case ValType::I32:
+    case ValType::F32:
+      Res.Values.push_back(retrieveValue<uint32_t>(Val));
+      break;
+    case ValType::V128: {
+      const uint128_t V = retrieveValue<uint128_t>(Val);
+      Res.Values.push_back(static_cast<uint64_t>(V));
+      Res.Values.push_back(static_cast<uint64_t>(V >> 64));
+      break;
+    }
+    default:
+      Res.Values.push_back(retrieveValue<uint64_t>(Val));
+      break;
+    }
+  }
+  return Res;
+}
+
+/// Run the exported function in every interpreter tier and measurement mode,
+/// and check the runs agree on the results, the errors, the instruction
+/// counts, and the costs. The unmeasured runs count nothing.
+///
+/// \returns the outcome of the stack tier in metered mode.
+inline Outcome runAll(const Bytes &Wasm, const std::string &Func,
+                      const std::vector<ValVariant> &Params = {},
+                      const RunOptions &Opts = {}) {
+  const Outcome Ref = run(Wasm, Func, Params, Configure::InterpreterTier::Stack,
+                          Configure::MeasureMode::Metered, Opts);
+  for (const auto Tier :
+       {Configure::InterpreterTier::Stack, Configure::InterpreterTier::Register,
+        Configure::InterpreterTier::CachedStack,
+        Configure::InterpreterTier::Tiered}) {
+    for (const auto Mode :
+         {Configure::MeasureMode::None, Configure::MeasureMode::Count,
+          Configure::MeasureMode::Metered}) {
+      SCOPED_TRACE(configName(Tier, Mode));
+      const Outcome Res = run(Wasm, Func, Params, Tier, Mode, Opts);
+      /// The runs out of cost return in the metered mode only.
+      if (Ref.Code != ErrCode::CostLimitExceeded ||
+          Mode == Configure::MeasureMode::Metered) {
+        EXPECT_EQ(Res.Code, Ref.Code);
+        EXPECT_EQ(Res.Values, Ref.Values);
+      }
+      switch (Mode) {
+      case Configure::MeasureMode::None:
+        EXPECT_EQ(Res.InstrCnt, 0U);
+        EXPECT_EQ(Res.Cost, 0U);
+        break;
+      case Configure::MeasureMode::Count:
+        if (Ref.Code != ErrCode::CostLimitExceeded) {
+          EXPECT_EQ(Res.InstrCnt, Ref.InstrCnt);
+        }
+        EXPECT_EQ(Res.Cost, 0U);
+        break;
+      default:
+        EXPECT_EQ(Res.InstrCnt, Ref.InstrCnt);
+        EXPECT_EQ(Res.Cost, Ref.Cost);
+        break;
+      }
+    }
+  }
+  return Ref;
+}
+
+} // namespace Test
+} // namespace SSVM
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/memoryTest.cpp - memory execution tests -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the memory instructions.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using namespace SSVM::Test;
+using SSVM::ErrCode;
+using SSVM::ValVariant;
+using Values = std::vector<uint64_t>;
+
+TEST(MemoryTest, BulkMemory) {
+  ModuleBuilder B;
+  const uint32_t T0 = B.addType({}, {0x7F});
+  const uint32_t T1 = B.addType({0x7F}, {0x7F});
+  B.setMemory(1);
+  B.addData(-1, {'h', 'e', 'l', 'l', 'o'});
+  B.addFunc(T0,
+            {
+                0x41, 0xE4, 0x00, 0x41, 0x00, 0x41, 0x05, /// 100, 0, 5
+                0xFC, 0x08, 0x00, 0x00,                   /// memory.init
+                0x41, 0xC8, 0x01, 0x41, 0xE4, 0x00,       /// 200, 100
+                0x41, 0x05, 0xFC, 0x0A, 0x00, 0x00,       /// 5, memory.copy
+                0x41, 0xAC, 0x02, 0x41, 0xC1, 0x00,       /// 300, 'A'
+                0x41, 0x03, 0xFC, 0x0B, 0x00,             /// 3, memory.fill
+                0x41, 0xE5, 0x00, 0x41, 0xE4, 0x00,       /// 101, 100
+                0x41, 0x04, 0xFC, 0x0A, 0x00, 0x00,       /// 4, memory.copy
+                0x41, 0xE4, 0x00, 0x28, 0x02, 0x00,       /// load 100
+                0x41, 0xC8, 0x01, 0x28, 0x02, 0x00, 0x73, /// ^ load 200
+                0x41, 0xAC, 0x02, 0x2D, 0x00, 0x00, 0x6A  /// + load8_u 300
+            },
+            {}, "f");
+  B.addFunc(T1,
+            {
+                0xFC, 0x09, 0x00,                   /// data.drop
+                0x41, 0x00, 0x41, 0x00, 0x20, 0x00, /// 0, 0, n
+                0xFC, 0x08, 0x00, 0x00,             /// memory.init
+                0x41, 0x01                          /// 1
+            },
+            {}, "g");
+  B.addFunc(T1,
+            {
+                0x41, 0x00, 0x41, 0x00, 0x20, 0x00, /// 0, 0, n
+                0xFC, 0x0B, 0x00,                   /// memory.fill
+                0x41, 0x01                          /// 1
+            },
+            {}, "h");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the init, the copies, the overlapping copy and the fill.
+  Outcome Res = runAll(Wasm, "f");
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({593217}));
+
+  /// 2. Test the dropped segment is empty.
+  Res = runAll(Wasm, "g", std::vector<ValVariant>{uint32_t(0)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  Res = runAll(Wasm, "g", std::vector<ValVariant>{uint32_t(1)});
+  EXPECT_EQ(Res.Code, ErrCode::AccessForbidMemory);
+
+  /// 3. Test the fill out of the memory traps.
+  Res = runAll(Wasm, "h", std::vector<ValVariant>{uint32_t(65536)});
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  Res = runAll(Wasm, "h", std::vector<ValVariant>{uint32_t(65537)});
+  EXPECT_EQ(Res.Code, ErrCode::MemorySizeExceeded);
+}
+
+/// Instantiate the module and check its memory is guarded.
+bool isGuarded(const SSVM::Bytes &Wasm) {
+  SSVM::ExpVM::Configure Conf;
+  SSVM::ExpVM::VM VM(Conf);
+  EXPECT_TRUE(VM.loadWasm(Wasm));
+  EXPECT_TRUE(VM.validate());
+  EXPECT_TRUE(VM.instantiate());
+  return (*VM.getStoreManager().getMemory(0))->isGuarded();
+}
+
+TEST(MemoryTest, GuardedAccess) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.setMemory(1);
+  B.addFunc(T,
+            {
+                0x20, 0x00, 0x28, 0x02, 0x00, /// i32.load (a)
+                0x41, 0x01, 0x6A              /// + 1
+            },
+            {}, "load");
+  B.addFunc(T,
+            {
+                0x20, 0x00, 0x41, 0x07,      /// a, 7
+                0x36, 0x02, 0x00, 0x41, 0x01 /// i32.store, 1
+            },
+            {}, "store");
+  const SSVM::Bytes Wasm = B.build();
+  const std::vector<std::vector<ValVariant>> Addrs = {
+      {uint32_t(65532)}, {uint32_t(65534)}, {uint32_t(0x7FFFFFFF)}};
+
+  /// 1. Test the accesses to the guarded memory, where the out-of-bound ones
+  /// fault in the guard pages.
+  ASSERT_TRUE(isGuarded(Wasm));
+  std::vector<Outcome> Guarded;
+  for (const auto &Addr : Addrs) {
+    Guarded.push_back(runAll(Wasm, "load", Addr));
+    Guarded.push_back(runAll(Wasm, "store", Addr));
+  }
+
+  /// 2. Test the accesses to the checked memory fail with the same code.
+  auto &Pool = SSVM::Runtime::MemoryPool::getInstance();
+  Pool.setEnabled(false);
+  EXPECT_FALSE(isGuarded(Wasm));
+  std::vector<Outcome> Checked;
+  for (const auto &Addr : Addrs) {
+    Checked.push_back(runAll(Wasm, "load", Addr));
+    Checked.push_back(runAll(Wasm, "store", Addr));
+  }
+  Pool.setEnabled(true);
+
+  for (size_t I = 0; I < Guarded.size(); ++I) {
+    SCOPED_TRACE(I);
+    EXPECT_EQ(Guarded[I].Code,
+              I < 2 ? ErrCode::Success : ErrCode::MemorySizeExceeded);
+    EXPECT_EQ(Checked[I].Code, Guarded[I].Code);
+    EXPECT_EQ(Checked[I].InstrCnt, Guarded[I].InstrCnt);
+    EXPECT_EQ(Checked[I].Cost, Guarded[I].Cost);
+  }
+}
+
+TEST(MemoryTest, CheckpointAccess) {
+  ModuleBuilder B;
+  const uint32_t T0 = B.addType({0x7F}, {0x7F});
+  const uint32_t T1 = B.addType({}, {0x7F});
+  B.setMemory(1);
+  B.addGlobal(0x7F, true, i32Const(0));
+  /// Write the global and the memory, and then access at the address.
+  const SSVM::Bytes Prologue = {
+      0x41, 0x05, 0x24, 0x00, /// global = 5
+      0x41, 0x00, 0x41, 0x09, /// 0, 9
+      0x36, 0x02, 0x00        /// i32.store
+  };
+  B.addFunc(T0,
+            code({Prologue,
+                  {
+                      0x20, 0x00, 0x28, 0x02, 0x00 /// i32.load (a)
+                  }}),
+            {}, "load");
+  B.addFunc(T0,
+            code({Prologue,
+                  {
+                      0x20, 0x00, 0x41, 0x07,      /// a, 7
+                      0x36, 0x02, 0x00, 0x41, 0x01 /// i32.store, 1
+                  }}),
+            {}, "store");
+  B.addFunc(T1,
+            {
+                0x23, 0x00, 0x41, 0x00, /// global, 0
+                0x28, 0x02, 0x00, 0x6A  /// + i32.load
+            },
+            {}, "get");
+  const SSVM::Bytes Wasm = B.build();
+  const std::vector<ValVariant> Out = {uint32_t(65534)};
+  SSVM::ExpVM::Configure Conf;
+  Conf.addVMType(SSVM::ExpVM::Configure::VMType::Ewasm);
+
+  /// 1. Test the out-of-bound load and store in the checkpoint of Ewasm run
+  /// fail with the same code as out of checkpoints, and are rolled back.
+  for (const std::string Func : {"load", "store"}) {
+    SCOPED_TRACE(Func);
+    const Outcome Res = runAll(Wasm, Func, Out);
+    EXPECT_EQ(Res.Code, ErrCode::MemorySizeExceeded);
+    SSVM::ExpVM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(Wasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    auto Ret = VM.execute(Func, Out);
+    ASSERT_FALSE(Ret);
+    EXPECT_EQ(Ret.error(), Res.Code);
+    Ret = VM.execute("get");
+    ASSERT_TRUE(Ret);
+    EXPECT_EQ(SSVM::retrieveValue<uint32_t>((*Ret)[0]), 0U);
+  }
+
+  /// 2. Test the trapped Ewasm run of module is rolled back too.
+  SSVM::ExpVM::VM VM(Conf);
+  auto Ret = VM.runWasmFile(Wasm, "load", Out);
+  ASSERT_FALSE(Ret);
+  EXPECT_EQ(Ret.error(), ErrCode::MemorySizeExceeded);
+  Ret = VM.execute("get");
+  ASSERT_TRUE(Ret);
+  EXPECT_EQ(SSVM::retrieveValue<uint32_t>((*Ret)[0]), 0U);
+}
+
+} // namespace
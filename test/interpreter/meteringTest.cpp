@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/meteringTest.cpp - metering unit tests ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the instruction counts and the costs
+/// measured in execution.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using namespace SSVM::Test;
+using SSVM::ErrCode;
+using SSVM::ValVariant;
+using Values = std::vector<uint64_t>;
+
+/// Cost of the opcode in the default cost table.
+uint64_t cost(const uint8_t Code) {
+  return RunOptions::defaultCostTab()[Code];
+}
+
+TEST(MeteringTest, InstructionCosts) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x02, 0x40, 0x03, 0x40,       /// block loop
+                0x20, 0x00, 0x45, 0x0D, 0x01, ///   br_if 1 (n == 0)
+                0x20, 0x00, 0x41, 0x01, 0x6B, ///   n - 1
+                0x21, 0x00, 0x0C, 0x00,       ///   n = , br 0
+                0x0B, 0x0B, 0x41, 0x03        /// end end 3
+            },
+            {}, "f");
+  B.addFunc(T,
+            {
+                0x20, 0x00, 0x04, 0x40, /// if
+                0x05, 0x01, 0x0B,       /// else nop end
+                0x41, 0x09              /// 9
+            },
+            {}, "g");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the instructions are counted and charged once per run. The
+  /// loops are not charged again on branches, and the ends are free.
+  const uint64_t Iter = cost(0x20) * 2 + cost(0x45) + cost(0x0D) +
+                        cost(0x41) + cost(0x6B) + cost(0x21) + cost(0x0C);
+  const uint64_t Exit = cost(0x20) + cost(0x45) + cost(0x0D);
+  Outcome Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(3)});
+  EXPECT_EQ(Res.Values, Values({3}));
+  EXPECT_EQ(Res.InstrCnt, 2U + 3U * 8U + 3U + 1U);
+  EXPECT_EQ(Res.Cost, cost(0x02) + cost(0x03) + 3 * Iter + Exit + cost(0x41));
+
+  /// 2. Test the if charges the else only when entering a non-empty branch.
+  Res = runAll(Wasm, "g", std::vector<ValVariant>{uint32_t(1)});
+  EXPECT_EQ(Res.InstrCnt, 3U);
+  EXPECT_EQ(Res.Cost, cost(0x20) + cost(0x04) + cost(0x41));
+  Res = runAll(Wasm, "g", std::vector<ValVariant>{uint32_t(0)});
+  EXPECT_EQ(Res.InstrCnt, 4U);
+  EXPECT_EQ(Res.Cost,
+            cost(0x20) + cost(0x04) + cost(0x05) + cost(0x01) + cost(0x41));
+
+  /// 3. Test the instruction over the limit is counted, and the cost is
+  /// pinned at the limit.
+  RunOptions Opts;
+  Opts.CostLimit = cost(0x02) + cost(0x03) + cost(0x20);
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(3)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::CostLimitExceeded);
+  EXPECT_EQ(Res.InstrCnt, 4U);
+  EXPECT_EQ(Res.Cost, Opts.CostLimit);
+  Opts.CostLimit -= 1;
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{uint32_t(3)}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::CostLimitExceeded);
+  EXPECT_EQ(Res.InstrCnt, 3U);
+  EXPECT_EQ(Res.Cost, Opts.CostLimit);
+}
+
+TEST(MeteringTest, MeasureModes) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x20, 0x00, 0x41, 0x02, 0x6C, /// n * 2
+                0x41, 0x01, 0x6A              /// + 1
+            },
+            {}, "f");
+  const SSVM::Bytes Wasm = B.build();
+  const std::vector<ValVariant> Params = {uint32_t(20)};
+  const Outcome Full = runAll(Wasm, "f", Params);
+  EXPECT_EQ(Full.Values, Values({41}));
+  RunOptions Opts;
+  Opts.CostLimit = 1;
+
+  for (const auto Tier :
+       {Configure::InterpreterTier::Stack, Configure::InterpreterTier::Register,
+        Configure::InterpreterTier::CachedStack,
+        Configure::InterpreterTier::Tiered}) {
+    SCOPED_TRACE(static_cast<uint32_t>(Tier));
+    /// 1. Test the metered mode stops at the limit.
+    Outcome Res =
+        run(Wasm, "f", Params, Tier, Configure::MeasureMode::Metered, Opts);
+    EXPECT_EQ(Res.Code, ErrCode::CostLimitExceeded);
+    EXPECT_EQ(Res.InstrCnt, 1U);
+
+    /// 2. Test the count mode counts without charging the limit.
+    Res = run(Wasm, "f", Params, Tier, Configure::MeasureMode::Count, Opts);
+    EXPECT_EQ(Res.Code, ErrCode::Success);
+    EXPECT_EQ(Res.Values, Full.Values);
+    EXPECT_EQ(Res.InstrCnt, Full.InstrCnt);
+    EXPECT_EQ(Res.Cost, 0U);
+
+    /// 3. Test the bare mode measures nothing.
+    Res = run(Wasm, "f", Params, Tier, Configure::MeasureMode::None, Opts);
+    EXPECT_EQ(Res.Code, ErrCode::Success);
+    EXPECT_EQ(Res.Values, Full.Values);
+    EXPECT_EQ(Res.InstrCnt, 0U);
+    EXPECT_EQ(Res.Cost, 0U);
+  }
+}
+
+TEST(MeteringTest, BulkMemoryCosts) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.setMemory(2);
+  B.addFunc(T,
+            {
+                0x41, 0x00, 0x41, 0x00, 0x20, 0x00, /// 0, 0, n
+                0xFC, 0x0B, 0x00,                   /// memory.fill
+                0x41, 0x01                          /// 1
+            },
+            {}, "f");
+  const SSVM::Bytes Wasm = B.build();
+  const std::vector<ValVariant> Params = {uint32_t(65537)};
+
+  /// 1. Test the fill is charged once more for every page it writes.
+  const uint64_t Base = cost(0x41) * 2 + cost(0x20) + cost(0xCB);
+  Outcome Res = runAll(Wasm, "f", Params);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.InstrCnt, 5U);
+  EXPECT_EQ(Res.Cost, Base + cost(0xCB) * 2 + cost(0x41));
+
+  /// 2. Test running out of cost on the pages refunds the rest of the block.
+  RunOptions Opts;
+  Opts.CostLimit = Base + cost(0xCB);
+  Res = runAll(Wasm, "f", Params, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::CostLimitExceeded);
+  EXPECT_EQ(Res.InstrCnt, 4U);
+  EXPECT_EQ(Res.Cost, Opts.CostLimit);
+
+  /// 3. Test the cost of pages saturates instead of wrapping around.
+  Opts = RunOptions();
+  Opts.CostTab[0xCB] = uint64_t(1) << 50;
+  Res = runAll(Wasm, "f", std::vector<ValVariant>{UINT32_MAX}, Opts);
+  EXPECT_EQ(Res.Code, ErrCode::CostLimitExceeded);
+  EXPECT_EQ(Res.InstrCnt, 4U);
+  EXPECT_EQ(Res.Cost, UINT64_MAX);
+}
+
+} // namespace
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/simdTest.cpp - SIMD execution tests ---------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the SIMD instructions.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace SSVM::Test;
+using SSVM::ErrCode;
+using SSVM::ValVariant;
+using Values = std::vector<uint64_t>;
+
+/// Lanes of i32x4 or i16x8 packed in two 64-bit halves.
+Values i32x4(uint32_t A, uint32_t B, uint32_t C, uint32_t D) {
+  return {A | (uint64_t(B) << 32), C | (uint64_t(D) << 32)};
+}
+Values i16x8(uint16_t A, uint16_t B, uint16_t C, uint16_t D, uint16_t E,
+             uint16_t F, uint16_t G, uint16_t H) {
+  return {A | (uint64_t(B) << 16) | (uint64_t(C) << 32) | (uint64_t(D) << 48),
+          E | (uint64_t(F) << 16) | (uint64_t(G) << 32) | (uint64_t(H) << 48)};
+}
+
+/// Options charging the SIMD sub-opcodes differently.
+RunOptions simdOptions() {
+  RunOptions Opts;
+  Opts.Prepare = [](SSVM::ExpVM::VM &VM) {
+    std::vector<uint64_t> Tab(256);
+    for (uint32_t I = 0; I < 256; ++I) {
+      Tab[I] = I % 5 + 1;
+    }
+    VM.getMeasurement().setSIMDCostTable(Tab);
+  };
+  return Opts;
+}
+
+TEST(SIMDTest, Instructions) {
+  const Values A = i32x4(1, 2, 3, 4);
+  const Values Seq = {0x0706050403020100ULL, 0x0F0E0D0C0B0A0908ULL};
+  const Values Seq2 = {0x1716151413121110ULL, 0x1F1E1D1C1B1A1918ULL};
+  const Values I16 = i16x8(1, 2, 3, 4, 5, 6, 7, 8);
+  const std::vector<std::pair<SSVM::Bytes, Values>> Cases = {
+      /// i32x4.splat, i32x4.mul, i32x4.add
+      {code({v128Const(A[0], A[1]), i32Const(10), simd(0x11), simd(0xB5),
+             v128Const(i32x4(5, 6, 7, 8)[0], i32x4(5, 6, 7, 8)[1]),
+             simd(0xAE)}),
+       i32x4(15, 26, 37, 48)},
+      /// i8x16.shuffle
+      {code({v128Const(Seq[0], Seq[1]), v128Const(Seq2[0], Seq2[1]),
+             simd(0x0D),
+             {31, 0, 30, 1, 29, 2, 28, 3, 27, 4, 26, 5, 25, 6, 24, 7}}),
+       {0x031C021D011E001FULL, 0x07180619051A041BULL}},
+      /// i8x16.eq, i8x16.bitmask in i32x4.splat
+      {code({v128Const(0x00FF00FF00FF00FFULL, 0x00FF00FF00FF00FFULL),
+             v128Const(UINT64_MAX, UINT64_MAX), simd(0x23), simd(0x64),
+             simd(0x11)}),
+       i32x4(0x5555, 0x5555, 0x5555, 0x5555)},
+      /// i32x4.dot_i16x8_s
+      {code({v128Const(I16[0], I16[1]), v128Const(I16[0], I16[1]),
+             simd(0xBA)}),
+       i32x4(5, 25, 61, 113)},
+      /// f32x4.convert_i32x4_s, f32x4.add, i32x4.trunc_sat_f32x4_s
+      {code({v128Const(A[0], A[1]), simd(0xFA), v128Const(0, 0), simd(0xFA),
+             simd(0xE4), simd(0xF8)}),
+       A},
+      /// v128.xor
+      {code({v128Const(Seq[0], Seq[1]), v128Const(Seq[0], Seq[1]),
+             simd(0x51)}),
+       {0, 0}},
+  };
+  ModuleBuilder B;
+  const uint32_t T = B.addType({}, {0x7B});
+  for (size_t I = 0; I < Cases.size(); ++I) {
+    B.addFunc(T, Cases[I].first, {}, "f" + std::to_string(I));
+  }
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the lane-wise instructions and their costs.
+  for (size_t I = 0; I < Cases.size(); ++I) {
+    SCOPED_TRACE(I);
+    const Outcome Res = runAll(Wasm, "f" + std::to_string(I), {},
+                               simdOptions());
+    EXPECT_EQ(Res.Code, ErrCode::Success);
+    EXPECT_EQ(Res.Values, Cases[I].second);
+  }
+}
+
+TEST(SIMDTest, Frames) {
+  const Values A = i32x4(1, 2, 3, 4);
+  ModuleBuilder B;
+  const uint32_t T0 = B.addType({0x7B, 0x7F}, {0x7B});
+  const uint32_t T1 = B.addType({}, {0x7B});
+  B.setMemory(1);
+  B.addGlobal(0x7B, true, v128Const(0, 0));
+  /// Keep the v128 parameter in a local across the global write.
+  B.addFunc(T0,
+            code({{0x20, 0x00, 0x21, 0x02, 0x20, 0x01}, simd(0x11),
+                  {0x24, 0x00, 0x20, 0x02, 0x23, 0x00}, simd(0xAE)}),
+            {{1, 0x7B}});
+  /// Pass the v128 through a call, a local, the memory, and the global.
+  B.addFunc(T1,
+            code({v128Const(A[0], A[1]), i32Const(5), {0x10, 0x00, 0x21, 0x00},
+                  i32Const(0), {0x20, 0x00}, simd(0x0B), {0x04, 0x10},
+                  i32Const(0), simd(0x00), {0x04, 0x10}, {0x23, 0x00},
+                  simd(0xAE)}),
+            {{1, 0x7B}}, "f");
+  const SSVM::Bytes Wasm = B.build();
+
+  /// 1. Test the v128 values are kept whole in the frames.
+  const Outcome Res = runAll(Wasm, "f", {}, simdOptions());
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, i32x4(11, 12, 13, 14));
+}
+
+} // namespace
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/tieringTest.cpp - tiered execution tests ----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of promoting the hot functions in the tiered
+/// execution.
+///
+//===----------------------------------------------------------------------===//
+
+#include "helper.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace SSVM::Test;
+using SSVM::ErrCode;
+using SSVM::ValVariant;
+using SSVM::ExpVM::Configure;
+using Values = std::vector<uint64_t>;
+
+/// Run the function in the tiered execution and check the function of Name
+/// is promoted after the run.
+bool isPromoted(const SSVM::Bytes &Wasm, const std::string &Func,
+                const std::vector<ValVariant> &Params,
+                const std::string &Name) {
+  Configure Conf;
+  Conf.setInterpreterTier(Configure::InterpreterTier::Tiered);
+  SSVM::ExpVM::VM VM(Conf);
+  EXPECT_TRUE(VM.loadWasm(Wasm));
+  EXPECT_TRUE(VM.validate());
+  EXPECT_TRUE(VM.instantiate());
+  EXPECT_TRUE(VM.execute(Func, Params));
+  SSVM::Runtime::StoreManager &Store = VM.getStoreManager();
+  const auto Exports = Store.getFuncExports();
+  const auto It = Exports.find(Name);
+  if (It == Exports.cend()) {
+    ADD_FAILURE() << "no function " << Name;
+    return false;
+  }
+  return (*Store.getFunction(It->second))->isPromoted();
+}
+
+TEST(TieringTest, HotCalls) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T, {0x20, 0x00, 0x41, 0x03, 0x6C, 0x41, 0x01, 0x6A}, {},
+            "callee");
+  B.addFunc(T,
+            {
+                0x02, 0x40, 0x03, 0x40,       /// block loop
+                0x20, 0x00, 0x45, 0x0D, 0x01, ///   br_if 1 (n == 0)
+                0x20, 0x01, 0x20, 0x00,       ///   acc, n
+                0x10, 0x00, 0x10, 0x00,       ///   callee(callee(
+                0x10, 0x00, 0x10, 0x00,       ///     callee(callee(n))))
+                0x6A, 0x21, 0x01,             ///   acc += ...
+                0x20, 0x00, 0x41, 0x01, 0x6B, ///   n - 1
+                0x21, 0x00, 0x0C, 0x00,       ///   n = n - 1, br 0
+                0x0B, 0x0B, 0x20, 0x01        /// end end acc
+            },
+            {{1, 0x7F}}, "hot");
+  const SSVM::Bytes Wasm = B.build();
+  const std::vector<ValVariant> Hot = {uint32_t(300)};
+  const std::vector<ValVariant> Cold = {uint32_t(100)};
+
+  /// 1. Test the function called over the threshold is promoted, while the
+  /// loop calling it is not hot.
+  EXPECT_TRUE(isPromoted(Wasm, "hot", Hot, "callee"));
+  EXPECT_FALSE(isPromoted(Wasm, "hot", Hot, "hot"));
+  EXPECT_FALSE(isPromoted(Wasm, "hot", Cold, "callee"));
+
+  /// 2. Test the promoted calls give the same results, counts, and costs.
+  const Outcome Res = runAll(Wasm, "hot", Hot);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({81 * 300 * 301 / 2 + 40 * 300}));
+
+  /// 3. Test running out of cost after the promotion.
+  RunOptions Opts;
+  Opts.CostLimit = Res.Cost * 9 / 10;
+  const Outcome Out = runAll(Wasm, "hot", Hot, Opts);
+  EXPECT_EQ(Out.Code, ErrCode::CostLimitExceeded);
+  EXPECT_EQ(Out.Cost, Opts.CostLimit);
+}
+
+TEST(TieringTest, OnStackReplacement) {
+  ModuleBuilder B;
+  const uint32_t T = B.addType({0x7F}, {0x7F});
+  B.addFunc(T,
+            {
+                0x41, 0x07,                   /// 7 under the loop
+                0x02, 0x40, 0x03, 0x40,       /// block loop
+                0x20, 0x00, 0x45, 0x0D, 0x01, ///   br_if 1 (n == 0)
+                0x20, 0x01, 0x41, 0x1F, 0x6C, ///   acc * 31
+                0x20, 0x00, 0x6A, 0x21, 0x01, ///   acc = acc * 31 + n
+                0x20, 0x02, 0x20, 0x00, 0xAD, ///   wide + extend(n)
+                0x7C, 0x21, 0x02,             ///   wide = wide + n
+                0x20, 0x00, 0x41, 0x01, 0x6B, ///   n - 1
+                0x21, 0x00, 0x0C, 0x00,       ///   n = n - 1, br 0
+                0x0B, 0x0B,                   /// end end
+                0x20, 0x01, 0x6A,             /// 7 + acc
+                0x20, 0x02, 0xA7, 0x6A        /// + wrap(wide)
+            },
+            {{1, 0x7F}, {1, 0x7E}}, "osr");
+  const SSVM::Bytes Wasm = B.build();
+  const std::vector<ValVariant> Long = {uint32_t(5000)};
+
+  /// 1. Test the long loop is replaced in the promoted function.
+  EXPECT_TRUE(isPromoted(Wasm, "osr", Long, "osr"));
+  EXPECT_FALSE(isPromoted(Wasm, "osr", {uint32_t(100)}, "osr"));
+
+  /// 2. Test the replaced loop keeps the locals and the operand under it.
+  const Outcome Res = runAll(Wasm, "osr", Long);
+  EXPECT_EQ(Res.Code, ErrCode::Success);
+  EXPECT_EQ(Res.Values, Values({559425575}));
+
+  /// 3. Test running out of cost around and after the replacement. The block
+  /// charged in the stack-based byte code is not charged again.
+  const uint64_t Replaced =
+      Res.Cost * SSVM::Interpreter::Interpreter::HotThreshold / 5000;
+  for (const uint64_t Limit :
+       {Replaced - 20, Replaced, Replaced + 20, Res.Cost * 2 / 3}) {
+    RunOptions Opts;
+    Opts.CostLimit = Limit;
+    const Outcome Out = runAll(Wasm, "osr", Long, Opts);
+    EXPECT_EQ(Out.Code, ErrCode::CostLimitExceeded);
+    EXPECT_EQ(Out.Cost, Limit);
+  }
+}
+
+} // namespace
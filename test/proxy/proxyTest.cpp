@@ -14,6 +14,8 @@
 #include "gtest/gtest.h"
 
 #include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 
 #include <cstdlib>
 #include <fstream>
@@ -109,6 +111,63 @@ TEST(ProxyTest, Calc__mrc) {
   std::string RetStr = Doc["result"]["return_value"].GetArray()[0].GetString();
   EXPECT_EQ(int64_t(std::strtoull(RetStr.c_str(), nullptr, 10)), int64_t(238));
 }
+
+TEST(ProxyTest, Calc__delta) {
+  /// Run input-mplus-delta.json: mplus(255), original 9 in stored memory
+  SSVM::Proxy::Proxy VMProxy;
+  VMProxy.setInputJSONPath("inputJSONTestData/input-mplus-delta.json");
+  VMProxy.setOutputJSONPath("outputJSONTestData/output-mplus-delta.json");
+  VMProxy.setWasmPath(WasmPath);
+  VMProxy.runRequest();
+
+  /// Check the memory delta from the base in output JSON file
+  std::ifstream OutputFS("outputJSONTestData/output-mplus-delta.json",
+                         std::ios::binary);
+  EXPECT_TRUE(OutputFS.is_open());
+  rapidjson::Document Doc;
+  readJSONFile(Doc, OutputFS);
+  ASSERT_NE(Doc.FindMember("result"), Doc.MemberEnd());
+  auto &Snapshot = Doc["result"]["vm_snapshot"];
+  ASSERT_NE(Snapshot.FindMember("memory_delta"), Snapshot.MemberEnd());
+  EXPECT_EQ(std::string(Snapshot["base"].GetString()), "calc-9");
+  EXPECT_EQ(Snapshot.FindMember("memory"), Snapshot.MemberEnd());
+  auto Delta = Snapshot["memory_delta"].GetArray();
+  ASSERT_EQ(Delta.Size(), 1U);
+  EXPECT_EQ(Delta[0][0].GetUint(), 0U);
+  auto Ranges = Delta[0][2].GetArray();
+  ASSERT_EQ(Ranges.Size(), 1U);
+  EXPECT_EQ(Ranges[0][0].GetUint(), 0U);
+  EXPECT_EQ(Ranges[0][1].GetStringLength(), 8192U);
+
+  /// Run mrc() on the base with the delta applied
+  rapidjson::Document InputDoc;
+  std::ifstream InputFS("inputJSONTestData/input-mrc.json", std::ios::binary);
+  readJSONFile(InputDoc, InputFS);
+  auto &InSnapshot = InputDoc["execution"]["vm_snapshot"];
+  InSnapshot["memory"][0][1].SetString("0000000000000000000000000000000009");
+  rapidjson::Value InDelta;
+  InDelta.CopyFrom(Snapshot["memory_delta"], InputDoc.GetAllocator());
+  InSnapshot.AddMember("memory_delta", InDelta, InputDoc.GetAllocator());
+  rapidjson::StringBuffer StrBuf;
+  rapidjson::Writer<rapidjson::StringBuffer> Writer(StrBuf);
+  InputDoc.Accept(Writer);
+  std::ofstream("outputJSONTestData/input-mrc-delta.json")
+      << StrBuf.GetString();
+
+  SSVM::Proxy::Proxy RestoreProxy;
+  RestoreProxy.setInputJSONPath("outputJSONTestData/input-mrc-delta.json");
+  RestoreProxy.setOutputJSONPath("outputJSONTestData/output-mrc-delta.json");
+  RestoreProxy.setWasmPath(WasmPath);
+  RestoreProxy.runRequest();
+  std::ifstream RestoreFS("outputJSONTestData/output-mrc-delta.json",
+                          std::ios::binary);
+  rapidjson::Document RestoreDoc;
+  readJSONFile(RestoreDoc, RestoreFS);
+  std::string RetStr =
+      RestoreDoc["result"]["return_value"].GetArray()[0].GetString();
+  EXPECT_EQ(int64_t(std::strtoull(RetStr.c_str(), nullptr, 10)),
+            int64_t(0xFF + 9));
+}
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/runtime/journalTest.cpp - checkpoint unit tests ---------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the journaled checkpoints of memory,
+/// table, and global instances.
+///
+//===----------------------------------------------------------------------===//
+
+#include "runtime/storemgr.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace SSVM::Runtime;
+using namespace SSVM::Runtime::Instance;
+
+uint32_t load(MemoryInstance &Mem, const uint32_t Offset) {
+  uint32_t Value = 0;
+  EXPECT_TRUE(Mem.loadValue(Value, Offset, 4));
+  return Value;
+}
+
+void store(MemoryInstance &Mem, const uint32_t Offset, const uint32_t Value) {
+  EXPECT_TRUE(Mem.storeValue(Value, Offset, 4));
+}
+
+uint32_t get(GlobalInstance &Glob) {
+  return SSVM::retrieveValue<uint32_t>(Glob.getValue());
+}
+
+TEST(JournalTest, MemoryRollbackAfterGrow) {
+  constexpr const uint32_t PageSize = MemoryInstance::PageSize;
+  MemoryInstance Mem(SSVM::AST::Limit(1, 8));
+  store(Mem, 0, 1001);
+
+  /// 1. Test the grown pages are dropped and the writes are restored.
+  Mem.begin();
+  store(Mem, 0, 2001);
+  ASSERT_TRUE(Mem.growPage(2));
+  store(Mem, PageSize, 2002);
+  store(Mem, 2 * PageSize + 16, 2003);
+  EXPECT_EQ(Mem.getDataPageSize(), 3U);
+  Mem.rollback();
+  EXPECT_EQ(Mem.getDataPageSize(), 1U);
+  EXPECT_EQ(load(Mem, 0), 1001U);
+  EXPECT_FALSE(Mem.storeValue(uint32_t(0), PageSize, 4));
+
+  /// 2. Test the pages grown again after rollback are zero.
+  ASSERT_TRUE(Mem.growPage(2));
+  EXPECT_EQ(load(Mem, PageSize), 0U);
+  EXPECT_EQ(load(Mem, 2 * PageSize + 16), 0U);
+
+  /// 3. Test the pages grown before the checkpoint are restored, not dropped.
+  store(Mem, PageSize, 3001);
+  Mem.begin();
+  store(Mem, PageSize, 3002);
+  ASSERT_TRUE(Mem.growPage(1));
+  Mem.rollback();
+  EXPECT_EQ(Mem.getDataPageSize(), 3U);
+  EXPECT_EQ(load(Mem, PageSize), 3001U);
+}
+
+TEST(JournalTest, MemoryNestedCheckpoints) {
+  MemoryInstance Mem(SSVM::AST::Limit(1));
+  store(Mem, 0, 1001);
+  store(Mem, 8192, 1002);
+
+  /// 1. Test the rollback of an inner checkpoint keeps the outer writes.
+  Mem.begin();
+  store(Mem, 0, 2001);
+  Mem.begin();
+  EXPECT_EQ(Mem.getCheckpointDepth(), 2U);
+  store(Mem, 0, 2002);
+  store(Mem, 8192, 2003);
+  Mem.rollback();
+  EXPECT_EQ(Mem.getCheckpointDepth(), 1U);
+  EXPECT_EQ(load(Mem, 0), 2001U);
+  EXPECT_EQ(load(Mem, 8192), 1002U);
+
+  /// 2. Test the commit of an inner checkpoint is rolled back by the outer.
+  Mem.begin();
+  store(Mem, 8192, 3001);
+  Mem.commit();
+  EXPECT_EQ(load(Mem, 8192), 3001U);
+  Mem.rollback();
+  EXPECT_EQ(Mem.getCheckpointDepth(), 0U);
+  EXPECT_EQ(load(Mem, 0), 1001U);
+  EXPECT_EQ(load(Mem, 8192), 1002U);
+
+  /// 3. Test the repeated checkpoints record the pages written again.
+  for (uint32_t I = 0; I < 4; ++I) {
+    const uint32_t Last = load(Mem, 0);
+    Mem.begin();
+    store(Mem, 0, 4000 + I);
+    Mem.rollback();
+    EXPECT_EQ(load(Mem, 0), Last);
+    Mem.begin();
+    store(Mem, 0, 5000 + I);
+    Mem.commit();
+    EXPECT_EQ(load(Mem, 0), 5000U + I);
+  }
+
+  /// 4. Test the bulk writes are recorded.
+  Mem.begin();
+  EXPECT_TRUE(Mem.fillBytes(4000, 0xFF, 8000));
+  EXPECT_TRUE(Mem.copyBytes(16, 8192, 4));
+  Mem.rollback();
+  EXPECT_EQ(load(Mem, 4000), 0U);
+  EXPECT_EQ(load(Mem, 8192), 1002U);
+  EXPECT_EQ(load(Mem, 16), 0U);
+}
+
+TEST(JournalTest, MemoryStoreUnchecked) {
+  /// 1. Test the guarded memory stores unchecked only out of checkpoints.
+  MemoryInstance Mem(SSVM::AST::Limit(1));
+  EXPECT_EQ(Mem.canStoreUnchecked(), Mem.isGuarded());
+  Mem.begin();
+  Mem.begin();
+  EXPECT_FALSE(Mem.canStoreUnchecked());
+  Mem.commit();
+  EXPECT_FALSE(Mem.canStoreUnchecked());
+  Mem.rollback();
+  EXPECT_EQ(Mem.canStoreUnchecked(), Mem.isGuarded());
+}
+
+TEST(JournalTest, TableRestore) {
+  FType Type;
+  const std::vector<std::pair<uint32_t, SSVM::ValType>> Locals;
+  FunctionInstance F1(0, Type, Locals, SSVM::AST::InstrVec{});
+  FunctionInstance F2(0, Type, Locals, SSVM::AST::InstrVec{});
+  TableInstance Tab(SSVM::ElemType::Func, SSVM::AST::Limit(4));
+  ASSERT_TRUE(Tab.setInitList(0, {TableInstance::FuncElem{1, &F1}}));
+
+  /// 1. Test the elements are restored in nested checkpoints.
+  Tab.begin();
+  ASSERT_TRUE(Tab.setInitList(0, {TableInstance::FuncElem{2, &F2},
+                                  TableInstance::FuncElem{2, &F2}}));
+  Tab.begin();
+  ASSERT_TRUE(Tab.setInitList(1, {TableInstance::FuncElem{1, &F1}}));
+  ASSERT_TRUE(Tab.setInitList(3, {TableInstance::FuncElem{1, &F1}}));
+  Tab.rollback();
+  EXPECT_EQ((*Tab.getElem(1))->Func, &F2);
+  EXPECT_EQ((*Tab.getElem(3))->Func, nullptr);
+  Tab.rollback();
+  EXPECT_EQ((*Tab.getElem(0))->Func, &F1);
+  EXPECT_EQ((*Tab.getElem(0))->TypeID, 1U);
+  EXPECT_EQ((*Tab.getElem(1))->Func, nullptr);
+  EXPECT_EQ((*Tab.getElem(1))->TypeID, UINT32_MAX);
+
+  /// 2. Test the committed elements are kept.
+  Tab.begin();
+  ASSERT_TRUE(Tab.setInitList(2, {TableInstance::FuncElem{2, &F2}}));
+  Tab.commit();
+  EXPECT_EQ((*Tab.getElem(2))->Func, &F2);
+}
+
+TEST(JournalTest, GlobalRestore) {
+  GlobalInstance Glob(SSVM::ValType::I32, SSVM::ValMut::Var, uint32_t(7));
+
+  /// 1. Test the value is restored in nested checkpoints.
+  Glob.begin();
+  Glob.setValue(uint32_t(8));
+  Glob.setValue(uint32_t(9));
+  Glob.begin();
+  Glob.setValue(uint32_t(10));
+  Glob.rollback();
+  EXPECT_EQ(get(Glob), 9U);
+  Glob.begin();
+  Glob.setValue(uint32_t(11));
+  Glob.commit();
+  EXPECT_EQ(get(Glob), 11U);
+  Glob.rollback();
+  EXPECT_EQ(get(Glob), 7U);
+
+  /// 2. Test the rollback with no checkpoint changes nothing.
+  Glob.setValue(uint32_t(12));
+  Glob.rollback();
+  EXPECT_EQ(get(Glob), 12U);
+}
+
+TEST(JournalTest, StoreCheckpoint) {
+  StoreManager Store;
+  auto Mem = std::make_unique<MemoryInstance>(SSVM::AST::Limit(1, 2));
+  MemoryInstance *MemInst = Mem.get();
+  Store.pushMemory(Mem);
+  auto Glob = std::make_unique<GlobalInstance>(
+      SSVM::ValType::I32, SSVM::ValMut::Var, uint32_t(7));
+  GlobalInstance *GlobInst = Glob.get();
+  Store.pushGlobal(Glob);
+
+  /// 1. Test the store rolls back all instances together.
+  Store.beginCheckpoint();
+  store(*MemInst, 0, 1001);
+  GlobInst->setValue(uint32_t(8));
+  Store.beginCheckpoint();
+  ASSERT_TRUE(MemInst->growPage(1));
+  GlobInst->setValue(uint32_t(9));
+  Store.commitCheckpoint();
+  Store.rollbackCheckpoint();
+  EXPECT_EQ(load(*MemInst, 0), 0U);
+  EXPECT_EQ(MemInst->getDataPageSize(), 1U);
+  EXPECT_EQ(get(*GlobInst), 7U);
+}
+
+} // namespace
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/runtime/memoryTest.cpp - memory instance unit tests -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of cloning memory instances and tracking the
+/// dirty pages.
+///
+//===----------------------------------------------------------------------===//
+
+#include "runtime/instance/memory.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using SSVM::Runtime::Instance::MemoryInstance;
+
+uint32_t load(MemoryInstance &Mem, const uint32_t Offset) {
+  uint32_t Value = 0;
+  EXPECT_TRUE(Mem.loadValue(Value, Offset, 4));
+  return Value;
+}
+
+void store(MemoryInstance &Mem, const uint32_t Offset, const uint32_t Value) {
+  EXPECT_TRUE(Mem.storeValue(Value, Offset, 4));
+}
+
+TEST(MemoryInstanceTest, Clone) {
+  /// 1. Test the clones see the pages when cloned.
+  MemoryInstance Mem(SSVM::AST::Limit(1, 4));
+  store(Mem, 0, 1001);
+  store(Mem, 40000, 1002);
+  auto A = Mem.clone();
+  auto B = Mem.clone();
+  ASSERT_TRUE(A && B);
+  MemoryInstance &MemA = **A;
+  MemoryInstance &MemB = **B;
+  EXPECT_EQ(MemA.getDataPageSize(), 1U);
+  EXPECT_EQ(MemA.getMax(), 4U);
+  EXPECT_EQ(load(MemA, 0), 1001U);
+  EXPECT_EQ(load(MemB, 40000), 1002U);
+
+  /// 2. Test the write in a clone is invisible to the template and others.
+  store(MemA, 0, 2001);
+  EXPECT_EQ(load(MemA, 0), 2001U);
+  EXPECT_EQ(load(Mem, 0), 1001U);
+  EXPECT_EQ(load(MemB, 0), 1001U);
+  store(MemB, 40000, 3002);
+  EXPECT_EQ(load(Mem, 40000), 1002U);
+  EXPECT_EQ(load(MemA, 40000), 1002U);
+
+  /// 3. Test the write in the template is invisible to the clones.
+  store(Mem, 4, 1003);
+  EXPECT_EQ(load(MemA, 4), 0U);
+  EXPECT_EQ(load(MemB, 4), 0U);
+
+  /// 4. Test the grown pages of a clone are zeroed and not in the template.
+  ASSERT_TRUE(MemA.growPage(2));
+  EXPECT_EQ(MemA.getDataPageSize(), 3U);
+  EXPECT_EQ(Mem.getDataPageSize(), 1U);
+  EXPECT_EQ(load(MemA, 2 * MemoryInstance::PageSize), 0U);
+  store(MemA, 2 * MemoryInstance::PageSize, 2004);
+  EXPECT_FALSE(Mem.storeValue(uint32_t(0), MemoryInstance::PageSize, 4));
+
+  /// 5. Test the clone after refreshing sees the current pages, and the
+  /// earlier clones do not.
+  auto C = Mem.clone(true);
+  ASSERT_TRUE(C);
+  EXPECT_EQ(load(**C, 4), 1003U);
+  EXPECT_EQ(load(**C, 0), 1001U);
+  EXPECT_EQ(load(MemB, 4), 0U);
+  EXPECT_EQ(load(MemA, 0), 2001U);
+
+  /// 6. Test destructing a clone keeps the template and the other clones.
+  auto D = Mem.clone();
+  ASSERT_TRUE(D);
+  {
+    auto Tmp = std::move(*D);
+    store(*Tmp, 8, 5005);
+  }
+  EXPECT_EQ(load(Mem, 8), 0U);
+  EXPECT_EQ(load(**C, 8), 0U);
+}
+
+TEST(MemoryInstanceTest, TrackDirtyPages) {
+  using Pages = std::vector<uint32_t>;
+  constexpr const uint32_t Size = MemoryInstance::DirtyPageSize;
+  /// 1. Test the writes on a large memory with all pages non-zero.
+  MemoryInstance Mem(SSVM::AST::Limit(64, 128));
+  const uint32_t Cnt = Mem.getDataPageSize() * MemoryInstance::PageSize / Size;
+  for (uint32_t I = 0; I < Cnt; ++I) {
+    store(Mem, I * Size, I + 1);
+  }
+  ASSERT_TRUE(Mem.trackDirtyPages());
+  EXPECT_EQ(Mem.getDirtyPages(), Pages());
+  store(Mem, 3 * Size + 8, 1001);
+  store(Mem, 900 * Size, 1002);
+  EXPECT_EQ(Mem.getDirtyPages(), Pages({3, 900}));
+
+  /// 2. Test the delta stays small when tracking again, and the writes are
+  /// kept in the new base.
+  for (uint32_t Round = 0; Round < 8; ++Round) {
+    ASSERT_TRUE(Mem.trackDirtyPages());
+    EXPECT_EQ(Mem.getDirtyPages(), Pages());
+    store(Mem, (Round * 97 + 5) * Size, 2000 + Round);
+    EXPECT_EQ(Mem.getDirtyPages(), Pages({Round * 97 + 5}));
+  }
+  EXPECT_EQ(load(Mem, 3 * Size + 8), 1001U);
+  EXPECT_EQ(load(Mem, 900 * Size), 1002U);
+  EXPECT_EQ(load(Mem, 5 * Size), 2000U);
+  EXPECT_EQ(load(Mem, 7 * Size), 8U);
+
+  /// 3. Test the grown pages written are dirty until tracking again.
+  ASSERT_TRUE(Mem.growPage(1));
+  store(Mem, Cnt * Size + 4, 3001);
+  EXPECT_EQ(Mem.getDirtyPages(), Pages({684, Cnt}));
+  ASSERT_TRUE(Mem.trackDirtyPages());
+  EXPECT_EQ(Mem.getDirtyPages(), Pages());
+  EXPECT_EQ(load(Mem, Cnt * Size + 4), 3001U);
+  store(Mem, (Cnt + 1) * Size, 3002);
+  EXPECT_EQ(Mem.getDirtyPages(), Pages({Cnt + 1}));
+
+  /// 4. Test tracking again after cloning keeps the clone unchanged.
+  auto A = Mem.clone(true);
+  ASSERT_TRUE(A);
+  store(Mem, 10 * Size, 4001);
+  ASSERT_TRUE(Mem.trackDirtyPages());
+  EXPECT_EQ(Mem.getDirtyPages(), Pages());
+  store(Mem, 11 * Size, 4002);
+  ASSERT_TRUE(Mem.trackDirtyPages());
+  EXPECT_EQ(load(Mem, 10 * Size), 4001U);
+  EXPECT_EQ(load(Mem, 11 * Size), 4002U);
+  EXPECT_EQ(load(**A, 10 * Size), 11U);
+  EXPECT_EQ(load(**A, 11 * Size), 12U);
+  EXPECT_EQ(load(**A, (Cnt + 1) * Size), 3002U);
+}
+
+TEST(MemoryInstanceTest, TrackWrittenPages) {
+  using Pages = std::vector<uint32_t>;
+  constexpr const uint32_t Size = MemoryInstance::DirtyPageSize;
+  /// 1. Test tracking a large memory with a few pages written and read.
+  MemoryInstance Mem(SSVM::AST::Limit(1024));
+  store(Mem, 1 * Size, 1001);
+  store(Mem, 5000 * Size + 16, 1002);
+  EXPECT_EQ(load(Mem, 7000 * Size), 0U);
+  ASSERT_TRUE(Mem.trackDirtyPages());
+  EXPECT_EQ(Mem.getDirtyPages(), Pages());
+  EXPECT_EQ(load(Mem, 1 * Size), 1001U);
+  EXPECT_EQ(load(Mem, 5000 * Size + 16), 1002U);
+  EXPECT_EQ(load(Mem, 7000 * Size), 0U);
+
+  /// 2. Test the writes after tracking are in the delta, and the clones see
+  /// the tracked base.
+  store(Mem, 1 * Size, 2001);
+  store(Mem, 7000 * Size, 2002);
+  EXPECT_EQ(Mem.getDirtyPages(), Pages({1, 7000}));
+  auto A = Mem.clone();
+  ASSERT_TRUE(A);
+  EXPECT_EQ(load(**A, 1 * Size), 1001U);
+  EXPECT_EQ(load(**A, 5000 * Size + 16), 1002U);
+  EXPECT_EQ(load(**A, 7000 * Size), 0U);
+}
+
+} // namespace
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/runtime/mempoolTest.cpp - memory pool unit tests --------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the pool of guarded memory regions.
+///
+//===----------------------------------------------------------------------===//
+
+#include "runtime/mempool.h"
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+using SSVM::Runtime::MemoryPool;
+MemoryPool &Pool = MemoryPool::getInstance();
+
+TEST(MemoryPoolTest, ReuseZeroed) {
+  /// 1. Test the released region is reused with its touched pages zeroed.
+  Pool.setCapacity(0);
+  Pool.setCapacity(MemoryPool::DefaultCapacity);
+  uint8_t *Data = Pool.acquire(2);
+  ASSERT_NE(Data, nullptr);
+  Data[0] = 0x5A;
+  Data[MemoryPool::PageSize + 7] = 0xA5;
+  Pool.release(Data, 2);
+  EXPECT_EQ(Pool.getFreeCount(), 1U);
+
+  /// 2. Test the committed pages are adjusted for the next memory.
+  uint8_t *Reused = Pool.acquire(3);
+  ASSERT_EQ(Reused, Data);
+  EXPECT_EQ(Pool.getFreeCount(), 0U);
+  EXPECT_EQ(Reused[0], 0U);
+  EXPECT_EQ(Reused[MemoryPool::PageSize + 7], 0U);
+  EXPECT_EQ(Reused[2 * MemoryPool::PageSize], 0U);
+  Reused[3 * MemoryPool::PageSize - 1] = 1;
+  Pool.release(Reused, 3);
+
+  Reused = Pool.acquire(1);
+  ASSERT_EQ(Reused, Data);
+  EXPECT_EQ(Reused[MemoryPool::PageSize - 1], 0U);
+  Pool.release(Reused, 1);
+}
+
+TEST(MemoryPoolTest, ConcurrentRelease) {
+  /// 3. Test the concurrent releases keep at most the capacity of regions.
+  const uint32_t Cap = 4;
+  const uint32_t Cnt = 16;
+  Pool.setCapacity(0);
+  Pool.setCapacity(Cap);
+  std::vector<uint8_t *> Regions;
+  for (uint32_t I = 0; I < Cnt; ++I) {
+    Regions.push_back(Pool.acquire(1));
+    ASSERT_NE(Regions.back(), nullptr);
+    Regions.back()[0] = 1;
+  }
+  std::vector<std::thread> Threads;
+  for (uint32_t I = 0; I < Cnt; ++I) {
+    Threads.emplace_back([Data = Regions[I]]() { Pool.release(Data, 1); });
+  }
+  for (auto &T : Threads) {
+    T.join();
+  }
+  EXPECT_EQ(Pool.getFreeCount(), Cap);
+
+  /// 4. Test the kept regions are all zeroed.
+  for (uint32_t I = 0; I < Cap; ++I) {
+    uint8_t *Data = Pool.acquire(1);
+    ASSERT_NE(Data, nullptr);
+    EXPECT_EQ(Data[0], 0U);
+    Regions[I] = Data;
+  }
+  for (uint32_t I = 0; I < Cap; ++I) {
+    Pool.release(Regions[I], 1);
+  }
+  Pool.setCapacity(MemoryPool::DefaultCapacity);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
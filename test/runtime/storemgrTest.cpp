@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/runtime/storemgrTest.cpp - store manager unit tests -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of cloning stores.
+///
+//===----------------------------------------------------------------------===//
+
+#include "runtime/storemgr.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+
+namespace {
+
+using namespace SSVM::Runtime;
+using namespace SSVM::Runtime::Instance;
+
+/// Make a store with a module of a function, a table referring to it, a
+/// memory, and a mutable global.
+std::unique_ptr<StoreManager> makeStore(const FType &Type) {
+  auto Store = std::make_unique<StoreManager>();
+  auto Mod = std::make_unique<ModuleInstance>("test");
+  ModuleInstance *ModInst = Mod.get();
+  const uint32_t ModAddr = Store->pushModule(Mod);
+  auto Func = std::make_unique<FunctionInstance>(
+      ModAddr, Type, std::vector<std::pair<uint32_t, SSVM::ValType>>{},
+      SSVM::AST::InstrVec{});
+  const FunctionInstance *FuncInst = Func.get();
+  ModInst->addFuncAddr(Store->pushFunction(Func));
+  auto Tab = std::make_unique<TableInstance>(SSVM::ElemType::Func,
+                                             SSVM::AST::Limit(2));
+  EXPECT_TRUE(Tab->setInitList(
+      0, {TableInstance::FuncElem{FuncInst->getTypeID(), FuncInst}}));
+  ModInst->addTableAddr(Store->pushTable(Tab));
+  auto Mem = std::make_unique<MemoryInstance>(SSVM::AST::Limit(1));
+  EXPECT_TRUE(Mem->storeValue(uint32_t(1001), 0, 4));
+  ModInst->addMemAddr(Store->pushMemory(Mem));
+  auto Glob = std::make_unique<GlobalInstance>(
+      SSVM::ValType::I32, SSVM::ValMut::Var, uint32_t(7));
+  ModInst->addGlobalAddr(Store->pushGlobal(Glob));
+  Store->resolveModule(*ModInst);
+  return Store;
+}
+
+uint32_t load(MemoryInstance &Mem, const uint32_t Offset) {
+  uint32_t Value = 0;
+  EXPECT_TRUE(Mem.loadValue(Value, Offset, 4));
+  return Value;
+}
+
+TEST(StoreManagerTest, Clone) {
+  FType Type;
+  auto Store = makeStore(Type);
+  ModuleInstance *Mod = *Store->getModule(0);
+
+  /// 1. Test the owned instances are copied in the same addresses, and the
+  /// module of clone resolves to them.
+  auto A = Store->clone();
+  auto B = Store->clone();
+  ASSERT_TRUE(A && B);
+  ModuleInstance *ModA = *(*A)->getModule(0);
+  ModuleInstance *ModB = *(*B)->getModule(0);
+  EXPECT_NE(ModA, Mod);
+  EXPECT_NE(ModA->getMemory(0), Mod->getMemory(0));
+  EXPECT_EQ(ModA->getMemory(0), *(*A)->getMemory(0));
+  EXPECT_NE(ModA->getTable(0), Mod->getTable(0));
+  EXPECT_EQ(ModA->getTable(0), *(*A)->getTable(0));
+  EXPECT_NE(ModA->getGlobal(0), Mod->getGlobal(0));
+  EXPECT_EQ(ModA->getGlobal(0), *(*A)->getGlobal(0));
+
+  /// 2. Test the functions are shared, also by the copied table entries.
+  EXPECT_EQ(ModA->getFunc(0), Mod->getFunc(0));
+  EXPECT_EQ((*ModA->getTable(0)->getElem(0))->Func, Mod->getFunc(0));
+
+  /// 3. Test the writes in a clone are invisible to the template and others.
+  EXPECT_TRUE(ModA->getMemory(0)->storeValue(uint32_t(2001), 0, 4));
+  ModA->getGlobal(0)->setValue(uint32_t(8));
+  EXPECT_TRUE(ModA->getTable(0)->setInitList(
+      1, {TableInstance::FuncElem{Mod->getFunc(0)->getTypeID(),
+                                  Mod->getFunc(0)}}));
+  EXPECT_EQ(load(*ModA->getMemory(0), 0), 2001U);
+  EXPECT_EQ(load(*Mod->getMemory(0), 0), 1001U);
+  EXPECT_EQ(load(*ModB->getMemory(0), 0), 1001U);
+  EXPECT_EQ(std::get<uint32_t>(Mod->getGlobal(0)->getValue()), 7U);
+  EXPECT_EQ(std::get<uint32_t>(ModB->getGlobal(0)->getValue()), 7U);
+  EXPECT_EQ((*Mod->getTable(0)->getElem(1))->Func, nullptr);
+  EXPECT_EQ((*ModB->getTable(0)->getElem(1))->Func, nullptr);
+
+  /// 4. Test the clones are valid while the template is alive, and so are
+  /// the clones of a clone.
+  auto C = (*A)->clone();
+  ASSERT_TRUE(C);
+  EXPECT_EQ(load(*(*(*C)->getModule(0))->getMemory(0), 0), 2001U);
+  EXPECT_TRUE(Store->isCloneValid());
+  EXPECT_TRUE((*A)->isCloneValid());
+  EXPECT_TRUE((*C)->isCloneValid());
+
+  /// 5. Test the clones are invalid after the template is destructed, even
+  /// if the clone cloned from is alive.
+  Store.reset();
+  EXPECT_FALSE((*A)->isCloneValid());
+  EXPECT_FALSE((*B)->isCloneValid());
+  EXPECT_FALSE((*C)->isCloneValid());
+  EXPECT_EQ(load(*ModB->getMemory(0), 0), 1001U);
+}
+
+TEST(StoreManagerTest, CloneReset) {
+  /// 6. Test the clones are invalid after the template is reset.
+  FType Type;
+  auto Store = makeStore(Type);
+  auto A = Store->clone();
+  ASSERT_TRUE(A);
+  EXPECT_TRUE((*A)->isCloneValid());
+  Store->reset();
+  EXPECT_FALSE((*A)->isCloneValid());
+  EXPECT_TRUE(Store->isCloneValid());
+}
+
+} // namespace
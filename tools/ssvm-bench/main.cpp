@@ -0,0 +1,298 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/value.h"
+#include "expvm/configure.h"
+#include "expvm/vm.h"
+#include "runtime/mempool.h"
+#include "support/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include <sys/resource.h>
+
+namespace {
+
+/// Gas limit of every function call in corpus mode to bound the runaway ones.
+constexpr uint64_t kCorpusGasLimit = 1000000ULL;
+/// Count of the most frequent instruction pairs to dump.
+constexpr uint32_t kPairDumpCount = 40;
+
+/// Count executed instruction pairs instead of the benchmark.
+bool CountPairs = false;
+/// Run in the register tier of interpreter.
+bool RegisterTier = false;
+/// Run in the cached stack tier of interpreter.
+bool CacheTop = false;
+/// Run in the tiered execution of interpreter.
+bool Tiered = false;
+/// Measurement mode of interpreter.
+SSVM::ExpVM::Configure::MeasureMode Mode =
+    SSVM::ExpVM::Configure::MeasureMode::Metered;
+std::vector<uint64_t> PairCnt(65536, 0ULL);
+
+/// Make the configure of VM from options.
+SSVM::ExpVM::Configure makeConfigure() {
+  SSVM::ExpVM::Configure Conf;
+  if (RegisterTier) {
+    Conf.setInterpreterTier(SSVM::ExpVM::Configure::InterpreterTier::Register);
+  } else if (CacheTop) {
+    Conf.setInterpreterTier(
+        SSVM::ExpVM::Configure::InterpreterTier::CachedStack);
+  } else if (Tiered) {
+    Conf.setInterpreterTier(SSVM::ExpVM::Configure::InterpreterTier::Tiered);
+  }
+  Conf.setMeasureMode(Mode);
+  return Conf;
+}
+
+struct BenchResult {
+  uint64_t Calls = 0;
+  uint64_t InstrCnt = 0;
+  uint64_t NanoSec = 0;
+};
+
+/// Run function once with the gas limit and accumulate the result.
+void runOnce(SSVM::ExpVM::VM &VM, const std::string &Func,
+             const std::vector<SSVM::ValVariant> &Params, const uint64_t Limit,
+             BenchResult &Result) {
+  auto &Measure = VM.getMeasurement();
+  Measure.clear();
+  Measure.getCostLimit() = Limit;
+  Measure.getCostSum() = 0;
+  Measure.setPairCounting(CountPairs);
+  auto Start = std::chrono::steady_clock::now();
+  VM.execute(Func, Params);
+  auto Stop = std::chrono::steady_clock::now();
+  if (CountPairs) {
+    const auto &Cnt = Measure.getPairCount();
+    for (uint32_t I = 0; I < PairCnt.size(); I++) {
+      PairCnt[I] += Cnt[I];
+    }
+  }
+  Result.Calls++;
+  Result.InstrCnt += Measure.getInstrCnt();
+  Result.NanoSec +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Stop - Start)
+          .count();
+}
+
+/// Run every exported function with zero arguments.
+bool runCorpus(const std::string &Path, const uint32_t Repeat,
+               BenchResult &Result) {
+  SSVM::ExpVM::Configure Conf = makeConfigure();
+  SSVM::ExpVM::VM VM(Conf);
+  VM.getMeasurement().setPairCounting(CountPairs);
+  if (!VM.loadWasm(Path) || !VM.validate() || !VM.instantiate()) {
+    return false;
+  }
+  for (auto &Func : VM.getFunctionList()) {
+    std::vector<SSVM::ValVariant> Params;
+    for (auto Type : Func.second.Params) {
+      Params.push_back(SSVM::ValueFromType(Type));
+    }
+    for (uint32_t I = 0; I < Repeat; I++) {
+      runOnce(VM, Func.first, Params, kCorpusGasLimit, Result);
+    }
+  }
+  return true;
+}
+
+/// Get the count of minor page faults of the process.
+uint64_t getPageFaults() {
+  struct rusage Usage;
+  getrusage(RUSAGE_SELF, &Usage);
+  return static_cast<uint64_t>(Usage.ru_minflt);
+}
+
+/// Instantiate the module Repeat times, and run the function of each instance
+/// once if given.
+bool runInstances(const std::string &Path, const uint32_t Repeat,
+                  const std::string &Func,
+                  const std::vector<SSVM::ValVariant> &Params) {
+  SSVM::ExpVM::Configure Conf = makeConfigure();
+  SSVM::ExpVM::VM VM(Conf);
+  if (!VM.loadWasm(Path) || !VM.validate()) {
+    return false;
+  }
+  uint64_t NanoSec = 0;
+  const uint64_t Faults = getPageFaults();
+  for (uint32_t I = 0; I < Repeat; I++) {
+    /// Instantiation resets the store, and releases the previous instance.
+    auto Start = std::chrono::steady_clock::now();
+    if (!VM.instantiate()) {
+      return false;
+    }
+    if (!Func.empty()) {
+      VM.execute(Func, Params);
+    }
+    auto Stop = std::chrono::steady_clock::now();
+    NanoSec +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Stop - Start)
+            .count();
+  }
+  std::cout << Path << ": " << Repeat << " instances, " << NanoSec / 1000
+            << " us, " << NanoSec / std::max(Repeat, 1U)
+            << " ns per instance, " << getPageFaults() - Faults
+            << " page faults" << std::endl;
+  return true;
+}
+
+void printResult(const std::string &Name, const BenchResult &Result) {
+  std::cout << Name << ": " << Result.Calls << " calls, " << Result.InstrCnt
+            << " instructions, " << Result.NanoSec / 1000 << " us";
+  if (Result.NanoSec > 0) {
+    std::cout << ", "
+              << static_cast<uint64_t>(static_cast<double>(Result.InstrCnt) *
+                                       1000 / Result.NanoSec)
+              << " M instructions per second";
+  }
+  std::cout << std::endl;
+}
+
+/// Dump the most frequent instruction pairs.
+void printPairs() {
+  std::vector<uint32_t> Pairs(PairCnt.size());
+  uint64_t Total = 0;
+  for (uint32_t I = 0; I < PairCnt.size(); I++) {
+    Pairs[I] = I;
+    Total += PairCnt[I];
+  }
+  std::sort(Pairs.begin(), Pairs.end(), [](uint32_t A, uint32_t B) {
+    return PairCnt[A] > PairCnt[B] || (PairCnt[A] == PairCnt[B] && A < B);
+  });
+  std::cout << "Instruction pairs (previous current count ratio):"
+            << std::endl;
+  for (uint32_t I = 0; I < kPairDumpCount && PairCnt[Pairs[I]] > 0; I++) {
+    std::cout << std::hex << std::setfill('0') << "0x" << std::setw(2)
+              << (Pairs[I] >> 8) << " 0x" << std::setw(2) << (Pairs[I] & 0xFF)
+              << std::dec << std::setfill(' ') << " " << PairCnt[Pairs[I]]
+              << " " << std::fixed << std::setprecision(2)
+              << static_cast<double>(PairCnt[Pairs[I]]) * 100 / Total << "%"
+              << std::endl;
+  }
+}
+
+} // namespace
+
+int main(int Argc, char *Argv[]) {
+  while (Argc > 1 && std::strncmp(Argv[1], "--", 2) == 0 &&
+         std::strcmp(Argv[1], "--corpus") != 0 &&
+         std::strcmp(Argv[1], "--instances") != 0) {
+    if (std::strcmp(Argv[1], "--pairs") == 0) {
+      /// Count executed instruction pairs with the following arguments.
+      CountPairs = true;
+    } else if (std::strcmp(Argv[1], "--register") == 0) {
+      RegisterTier = true;
+    } else if (std::strcmp(Argv[1], "--cache-top") == 0) {
+      /// Cache the top value of stack in the stack-based loop.
+      CacheTop = true;
+    } else if (std::strcmp(Argv[1], "--tiered") == 0) {
+      /// Start in the stack-based loop and promote the hot functions.
+      Tiered = true;
+    } else if (std::strcmp(Argv[1], "--count") == 0) {
+      /// Count instructions without gas.
+      Mode = SSVM::ExpVM::Configure::MeasureMode::Count;
+    } else if (std::strcmp(Argv[1], "--bare") == 0) {
+      /// Run without measurement.
+      Mode = SSVM::ExpVM::Configure::MeasureMode::None;
+    } else if (std::strcmp(Argv[1], "--no-pool") == 0) {
+      /// Map and unmap the memory of every instance.
+      SSVM::Runtime::MemoryPool::getInstance().setCapacity(0);
+    } else {
+      std::cout << "Unknown option " << Argv[1] << std::endl;
+      return 1;
+    }
+    Argc--;
+    Argv++;
+  }
+  if (Argc < 3) {
+    /// Arg0: ./ssvm-bench
+    /// Arg1: repeat times
+    /// Arg2: wasm file, --corpus followed by wasm files, or --instances
+    ///       followed by wasm file
+    /// Arg3: invoke function name
+    /// Arg4...: inputs
+    std::cout << "Usage: ./ssvm-bench [--pairs] "
+                 "[--register|--cache-top|--tiered] "
+                 "[--count|--bare] repeat wasm_file.wasm func_name [args...]"
+              << std::endl
+              << "       ./ssvm-bench [--pairs] "
+                 "[--register|--cache-top|--tiered] "
+                 "[--count|--bare] repeat --corpus wasm_files..."
+              << std::endl
+              << "       ./ssvm-bench [--register|--cache-top|--tiered] "
+                 "[--count|--bare] [--no-pool] repeat --instances "
+                 "wasm_file.wasm [func_name [args...]]"
+              << std::endl;
+    return 0;
+  }
+  SSVM::Log::setErrorLoggingLevel();
+  const uint32_t Repeat = std::stoul(Argv[1]);
+
+  if (std::strcmp(Argv[2], "--corpus") == 0) {
+    /// Run all exported functions of the wasm files.
+    BenchResult Total;
+    for (int I = 3; I < Argc; I++) {
+      BenchResult Result;
+      if (!runCorpus(Argv[I], Repeat, Result)) {
+        std::cout << Argv[I] << ": skipped" << std::endl;
+        continue;
+      }
+      printResult(Argv[I], Result);
+      Total.Calls += Result.Calls;
+      Total.InstrCnt += Result.InstrCnt;
+      Total.NanoSec += Result.NanoSec;
+    }
+    printResult("Total", Total);
+    if (CountPairs) {
+      printPairs();
+    }
+    return 0;
+  }
+
+  if (std::strcmp(Argv[2], "--instances") == 0) {
+    /// Instantiate the short-lived instances of the wasm file.
+    if (Argc < 4) {
+      std::cout << "Wasm file is required." << std::endl;
+      return 1;
+    }
+    std::vector<SSVM::ValVariant> Params;
+    for (int I = 5; I < Argc; I++) {
+      Params.push_back(static_cast<uint32_t>(std::stoul(Argv[I])));
+    }
+    if (!runInstances(Argv[3], Repeat, Argc > 4 ? Argv[4] : "", Params)) {
+      std::cout << " Failed to instantiate " << Argv[3] << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  if (Argc < 4) {
+    std::cout << "Function name is required." << std::endl;
+    return 1;
+  }
+  SSVM::ExpVM::Configure Conf = makeConfigure();
+  SSVM::ExpVM::VM VM(Conf);
+  VM.getMeasurement().setPairCounting(CountPairs);
+  if (!VM.loadWasm(std::string(Argv[2])) || !VM.validate() ||
+      !VM.instantiate()) {
+    std::cout << " Failed to instantiate " << Argv[2] << std::endl;
+    return 1;
+  }
+  std::vector<SSVM::ValVariant> Params;
+  for (int I = 4; I < Argc; I++) {
+    Params.push_back(static_cast<uint32_t>(std::stoul(Argv[I])));
+  }
+  BenchResult Result;
+  for (uint32_t I = 0; I < Repeat; I++) {
+    runOnce(VM, Argv[3], Params, UINT64_MAX, Result);
+  }
+  printResult(Argv[3], Result);
+  if (CountPairs) {
+    printPairs();
+  }
+  return 0;
+}